@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-23     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_chan.h"
+
+
+#define CHAN_SWITCH_IDLE        0
+#define CHAN_SWITCH_QUEUED      1
+#define CHAN_SWITCH_INFLIGHT    2
+
+#define CHAN_REQ_SURVEY         1
+#define CHAN_REQ_SET            2
+
+
+
+/***
+ * @brief   切换到信道 ch，并从此刻起重新计算失联
+ */
+static void nRF24L01_Chan_Apply(nrf24_t nrf24, rt_uint8_t ch, const char *reason)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+    rt_uint8_t from = nrf24->nrf24_cfg.rf_ch.rf_ch;
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH, ch);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    chan->switches++;
+    chan->consecutive_fail = 0;
+    chan->last_rx_tick = rt_tick_get();
+    LOG_I("LOG:%d. nrf24 chan %s: %d (%dMHz) -> %d (%dMHz).",Record.ulog_cnt++, reason, from, 2400 + from, ch, 2400 + ch);
+}
+
+
+/***
+ * @brief   勘测一轮：逐个信道读 RPD，结束后恢复原信道和原角色
+ * @note    射频线程在此忙等约 30ms，期间收不到数据，PTX 的对端会重发
+ */
+static void nRF24L01_Chan_Survey_Pass(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+    rt_uint8_t home_ch = nrf24->nrf24_cfg.rf_ch.rf_ch;
+    rt_uint8_t home_role = nrf24->nrf24_cfg.config.prim_rx;
+    rt_uint32_t dwell = NRF24_CHAN_DWELL_US * (SystemCoreClock / 1000000U);
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    if(home_role != ROLE_PRX){
+        nRF24L01_Set_Role_Mode(nrf24, ROLE_PRX);
+    }
+
+    for(rt_uint8_t ch = 0; ch < NRF24_CHAN_COUNT; ch++)
+    {
+        rt_uint32_t start;
+
+        nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH, ch);
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        start = nRF24L01_Debug_Get_Cycles();
+        while(nRF24L01_Debug_Get_Cycles() - start < dwell);
+        if(nRF24L01_Read_Reg_Data(nrf24, NRF24REG_RPD) & 0x01){
+            chan->hits[ch]++;
+        }
+        nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    }
+
+    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH, home_ch);
+    if(home_role != ROLE_PRX){
+        nRF24L01_Set_Role_Mode(nrf24, (nrf24_role_et)home_role);
+    }
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+    chan->passes++;
+}
+
+
+/***
+ * @brief   信道 ch 的得分：它及两侧 spread 个信道的占用次数之和
+ */
+static rt_uint32_t nRF24L01_Chan_Score(struct nRF24L01_CHAN_STRUCT *chan, rt_uint8_t ch, rt_uint8_t spread)
+{
+    rt_uint32_t score = 0;
+
+    for(rt_int16_t c = (rt_int16_t)ch - spread; c <= (rt_int16_t)ch + spread; c++){
+        if(c >= 0 && c < NRF24_CHAN_COUNT){
+            score += chan->hits[c];
+        }
+    }
+    return score;
+}
+
+
+/***
+ * @brief   勘测结束：选出得分最低的信道，PTX 比当前信道好出 NRF24_CHAN_HYST 以上就发起切换
+ */
+static void nRF24L01_Chan_Survey_Done(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+    rt_uint8_t cur = nrf24->nrf24_cfg.rf_ch.rf_ch;
+    /* 2Mbps 占用 2MHz 带宽，两侧各多看 1 个信道 */
+    rt_uint8_t spread = nrf24->nrf24_cfg.rf_setup.rf_dr_high ? 2 : 1;
+
+    chan->best = cur;
+    chan->cur_score = nRF24L01_Chan_Score(chan, cur, spread);
+    chan->best_score = chan->cur_score;
+    for(rt_uint8_t ch = NRF24_CHAN_MIN; ch <= NRF24_CHAN_MAX; ch++)
+    {
+        rt_uint32_t score = nRF24L01_Chan_Score(chan, ch, spread);
+        if(score < chan->best_score){
+            chan->best_score = score;
+            chan->best = ch;
+        }
+    }
+    chan->surveys++;
+
+    LOG_I("LOG:%d. nrf24 chan survey: %d passes, best %d (%d hits), current %d (%d hits).",Record.ulog_cnt++,
+          chan->passes, chan->best, chan->best_score, cur, chan->cur_score);
+
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX && !NRF24_CHAN_LOCKED
+       && chan->best != cur && chan->cur_score > chan->best_score + NRF24_CHAN_HYST)
+    {
+        chan->switch_ch = chan->best;
+        chan->switch_state = CHAN_SWITCH_QUEUED;
+    }
+}
+
+
+/***
+ * @brief   开始一次勘测，清空上一次的结果
+ */
+static void nRF24L01_Chan_Survey_Start(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    rt_memset(chan->hits, 0, sizeof(chan->hits));
+    chan->passes = 0;
+    chan->survey_left = NRF24_CHAN_PASSES;
+}
+
+
+
+/***
+ * @brief   初始化信道勘测与切换
+ */
+void nRF24L01_Chan_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    rt_memset(chan, 0, sizeof(struct nRF24L01_CHAN_STRUCT));
+    chan->best = NRF24_CHAN_HOME;
+    chan->last_rx_tick = rt_tick_get();
+#if NRF24_CHAN_AUTO_S > 0
+    chan->next_auto_tick = rt_tick_get() + rt_tick_from_millisecond(NRF24_CHAN_AUTO_S * 1000);
+#endif
+}
+
+
+/***
+ * @brief   PTX 的 TX_DS / MAX_RT
+ * @return  1 : 事件属于 SWITCH，已处理   0 : 交给后面的层
+ */
+int nRF24L01_Chan_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    // 1. SWITCH 已送达对端才切换；失败则留在当前信道
+    if(chan->switch_state == CHAN_SWITCH_INFLIGHT)
+    {
+        chan->switch_state = CHAN_SWITCH_IDLE;
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+            LOG_W("LOG:%d. nrf24 chan: peer did not ack the switch to %d, staying at %d.",Record.ulog_cnt++,
+                  chan->switch_ch, nrf24->nrf24_cfg.rf_ch.rf_ch);
+        }
+        else{
+            nRF24L01_Chan_Apply(nrf24, chan->switch_ch, "switch");
+        }
+        return 1;
+    }
+
+    // 2. 对端可能没跟上切换（SWITCH 的应答丢失），连续失败就回到上电信道，对端空闲超时后也会回来
+    if(irq_flags & NRF24BITMASK_MAX_RT){
+        chan->consecutive_fail++;
+    }
+    else{
+        chan->consecutive_fail = 0;
+    }
+    if(chan->consecutive_fail >= NRF24_CHAN_LOST && nrf24->nrf24_cfg.rf_ch.rf_ch != NRF24_CHAN_HOME && !nRF24L01_Hop_Active(nrf24)){
+        chan->fallbacks++;
+        nRF24L01_Chan_Apply(nrf24, NRF24_CHAN_HOME, "lost");
+    }
+
+    return 0;
+}
+
+
+/***
+ * @brief   处理 SWITCH；PRX 顺带记录最后一次收到数据的时刻
+ * @return  1 : SWITCH，已处理   0 : 其它数据
+ */
+int nRF24L01_Chan_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    chan->last_rx_tick = rt_tick_get();
+    if(NRF24_CHAN_LOCKED || len != NRF24_CHAN_SWITCH_SIZE || data[0] != (NRF24_CHAN_MARK | NRF24_CHAN_SWITCH)
+       || data[2] < NRF24_CHAN_MIN || data[2] > NRF24_CHAN_MAX){
+        return 0;
+    }
+
+    // 自动应答还没发完，切换信道要等应答（最长带 32 字节 ACK 载荷）离开空口
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX)
+    {
+        chan->peer_ch = data[2];
+        chan->peer_pending = 1;
+        chan->peer_deadline_cycles = nRF24L01_Debug_Get_Cycles() + (NRF24_TURN_SETTLE_US + NRF24_TURN_MARGIN_US
+                                   + nRF24L01_Air_Us(&nrf24->nrf24_cfg, 32)) * (SystemCoreClock / 1000000U);
+    }
+
+    return 1;
+}
+
+
+/***
+ * @brief   推进信道勘测与切换，在射频线程中调用
+ */
+void nRF24L01_Chan_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+    rt_bool_t ptx = (nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX);
+
+    // 1. msh 请求；跳频时信道由跳频决定，不勘测也不切换
+    if(chan->req != 0 && nRF24L01_Hop_Active(nrf24)){
+        chan->req = 0;
+        LOG_W("LOG:%d. nrf24 chan: frequency hopping is on, request ignored.",Record.ulog_cnt++);
+    }
+    else if(chan->req == CHAN_REQ_SURVEY){
+        chan->req = 0;
+        nRF24L01_Chan_Survey_Start(nrf24);
+    }
+    else if(chan->req == CHAN_REQ_SET){
+        chan->req = 0;
+        if(ptx && !NRF24_CHAN_LOCKED && chan->switch_state == CHAN_SWITCH_IDLE){
+            chan->switch_ch = chan->req_ch;
+            chan->switch_state = CHAN_SWITCH_QUEUED;
+        }
+    }
+#if NRF24_CHAN_AUTO_S > 0
+    if(ptx && chan->survey_left == 0 && !nRF24L01_Hop_Active(nrf24) && (rt_int32_t)(rt_tick_get() - chan->next_auto_tick) >= 0){
+        chan->next_auto_tick = rt_tick_get() + rt_tick_from_millisecond(NRF24_CHAN_AUTO_S * 1000);
+        nRF24L01_Chan_Survey_Start(nrf24);
+    }
+#endif
+
+    // 2. PRX：跟随对端的 SWITCH；非上电信道下长时间收不到包则回到上电信道等对端
+    if(!ptx)
+    {
+        if(chan->peer_pending && (rt_int32_t)(nRF24L01_Debug_Get_Cycles() - chan->peer_deadline_cycles) >= 0){
+            chan->peer_pending = 0;
+            if(chan->peer_ch != nrf24->nrf24_cfg.rf_ch.rf_ch){
+                nRF24L01_Chan_Apply(nrf24, chan->peer_ch, "peer");
+            }
+        }
+        if(nrf24->nrf24_cfg.rf_ch.rf_ch != NRF24_CHAN_HOME && !NRF24_CHAN_LOCKED && !nRF24L01_Hop_Active(nrf24) && !nRF24L01_Duplex_Active(nrf24)
+           && rt_tick_get() - chan->last_rx_tick >= rt_tick_from_millisecond(NRF24_CHAN_IDLE_MS)){
+            chan->fallbacks++;
+            nRF24L01_Chan_Apply(nrf24, NRF24_CHAN_HOME, "idle");
+        }
+    }
+
+    // 3. 勘测一轮；PTX 要等芯片 TX FIFO 发空，不打断正在发送的数据包
+    if(chan->survey_left > 0 && !nRF24L01_Turn_Busy(nrf24)
+       && (!ptx || (nrf24->tx_queue.sent == nrf24->tx_queue.done && nRF24L01_Link_Tx_Allowed(nrf24))))
+    {
+        nRF24L01_Chan_Survey_Pass(nrf24);
+        if(--chan->survey_left == 0){
+            nRF24L01_Chan_Survey_Done(nrf24);
+        }
+        return;
+    }
+
+    // 4. PTX：芯片 TX FIFO 里的数据发完后以当前信道发 SWITCH
+    if(ptx && chan->switch_state == CHAN_SWITCH_QUEUED && nrf24->tx_queue.sent == nrf24->tx_queue.done
+       && !nRF24L01_Turn_Busy(nrf24) && nRF24L01_Link_Tx_Allowed(nrf24) && !nRF24L01_Hop_Busy(nrf24))
+    {
+        rt_uint8_t frame[NRF24_CHAN_SWITCH_SIZE] = { NRF24_CHAN_MARK | NRF24_CHAN_SWITCH, ++chan->seq, chan->switch_ch };
+
+        nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, sizeof(frame));
+        chan->switch_state = CHAN_SWITCH_INFLIGHT;
+    }
+}
+
+
+/***
+ * @brief   勘测中、或 SWITCH 排队 / 在途时暂停从软件队列补充数据
+ */
+rt_bool_t nRF24L01_Chan_Tx_Allowed(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    return (chan->survey_left == 0 && chan->switch_state == CHAN_SWITCH_IDLE) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   SWITCH 在途，其它层不能再往芯片 TX FIFO 写入
+ */
+rt_bool_t nRF24L01_Chan_Busy(nrf24_t nrf24)
+{
+    return (nrf24->chan.switch_state == CHAN_SWITCH_INFLIGHT) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   射频线程等待 IRQ 信号量的超时：勘测中逐轮推进，PRX 等待切换时刻或空闲超时
+ */
+rt_int32_t nRF24L01_Chan_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+    rt_int32_t timeout = RT_WAITING_FOREVER, left;
+
+    if(chan->req || chan->survey_left > 0 || chan->peer_pending || chan->switch_state == CHAN_SWITCH_QUEUED){
+        return 1;
+    }
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX && nrf24->nrf24_cfg.rf_ch.rf_ch != NRF24_CHAN_HOME && !NRF24_CHAN_LOCKED
+       && !nRF24L01_Duplex_Active(nrf24)){
+        left = (rt_int32_t)(chan->last_rx_tick + rt_tick_from_millisecond(NRF24_CHAN_IDLE_MS) - rt_tick_get());
+        timeout = (left > 0) ? left : 1;
+    }
+#if NRF24_CHAN_AUTO_S > 0
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX){
+        left = (rt_int32_t)(chan->next_auto_tick - rt_tick_get());
+        timeout = (left > 0) ? left : 1;
+    }
+#endif
+    return timeout;
+}
+
+
+
+/***
+ * @brief   请求切换到信道 ch，由射频线程排队 SWITCH 与对端协商后切换
+ * @return  RT_EOK : 已提交   -RT_EINVAL : 信道超出 NRF24_CHAN_MIN ~ NRF24_CHAN_MAX
+ *          -RT_ERROR : 只有 PTX 能发起切换（PRX 跟随对端），或组网时信道已锁定
+ */
+int nRF24L01_Chan_Set(nrf24_t nrf24, rt_uint8_t ch)
+{
+    struct nRF24L01_CHAN_STRUCT *chan = &nrf24->chan;
+
+    if(ch < NRF24_CHAN_MIN || ch > NRF24_CHAN_MAX){
+        return -RT_EINVAL;
+    }
+    if(NRF24_CHAN_LOCKED || nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        return -RT_ERROR;
+    }
+
+    chan->req_ch = ch;
+    chan->req = CHAN_REQ_SET;
+    nRF24L01_Wakeup(nrf24);
+
+    return RT_EOK;
+}
+
+
+
+/***
+ * @brief msh 命令：信道勘测结果与切换
+ * @note  nrf24_chan                 打印当前信道和最近一次勘测的占用率（%）
+ *        nrf24_chan survey          发起勘测，PTX 勘测完自动切到最干净的信道
+ *        nrf24_chan set <ch>        PTX 手动切换信道（双方协商）
+ *        nrf24_chan reset           清零统计
+ */
+static void nrf24_chan_cmd(int argc, char **argv)
+{
+    struct nRF24L01_CHAN_STRUCT *chan;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    chan = &_nrf24->chan;
+
+    if (argc > 1 && rt_strcmp(argv[1], "survey") == 0)
+    {
+        chan->req = CHAN_REQ_SURVEY;
+        nRF24L01_Wakeup(_nrf24);
+        rt_kprintf("[nrf24] survey started, %d passes (about %d ms).\r\n", NRF24_CHAN_PASSES,
+                   NRF24_CHAN_PASSES * NRF24_CHAN_COUNT * (NRF24_CHAN_DWELL_US + 40) / 1000);
+        return;
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "set") == 0)
+    {
+        int ch = atoi(argv[2]);
+        if (ch < NRF24_CHAN_MIN || ch > NRF24_CHAN_MAX){
+            rt_kprintf("[nrf24] channel %d ~ %d.\r\n", NRF24_CHAN_MIN, NRF24_CHAN_MAX);
+            return;
+        }
+        if (nRF24L01_Chan_Set(_nrf24, ch) != RT_EOK){
+            rt_kprintf("[nrf24] only an unlocked PTX can switch channel.\r\n");
+            return;
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        chan->surveys = chan->switches = chan->fallbacks = 0;
+    }
+
+    rt_kprintf("[nrf24] channel %d (%dMHz), home %d%s, %d surveys, %d switches, %d fallbacks%s\r\n",
+               _nrf24->nrf24_cfg.rf_ch.rf_ch, 2400 + _nrf24->nrf24_cfg.rf_ch.rf_ch, NRF24_CHAN_HOME,
+               NRF24_CHAN_LOCKED ? " (locked)" : "", chan->surveys, chan->switches, chan->fallbacks,
+               (chan->survey_left > 0) ? ", surveying" : "");
+    if (chan->passes == 0){
+        return;
+    }
+
+    rt_kprintf("  last survey: %d passes, best %d (%d hits), current %d (%d hits)\r\n",
+               chan->passes, chan->best, chan->best_score, _nrf24->nrf24_cfg.rf_ch.rf_ch, chan->cur_score);
+    rt_kprintf("  busy %%  +0  +1  +2  +3  +4  +5  +6  +7  +8  +9 +10 +11 +12 +13 +14 +15\r\n");
+    for (rt_uint8_t row = 0; row < NRF24_CHAN_COUNT; row += 16)
+    {
+        rt_kprintf("  %3d   ", row);
+        for (rt_uint8_t ch = row; ch < row + 16 && ch < NRF24_CHAN_COUNT; ch++){
+            rt_kprintf("%4d", chan->hits[ch] * 100 / chan->passes);
+        }
+        rt_kprintf("\r\n");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_chan_cmd, nrf24_chan, rpd channel survey and switch [survey | set <ch> | reset]);
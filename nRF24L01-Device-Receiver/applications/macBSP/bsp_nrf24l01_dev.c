@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-10-02     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_dev.h"
+
+#if NRF24_USE_DEVICE && !(defined(RT_USING_DEVICE) && defined(RT_USING_DEVICE_IPC))
+#error "NRF24_USE_DEVICE needs RT_USING_DEVICE and RT_USING_DEVICE_IPC (rt_rbb)"
+#endif
+
+
+#if NRF24_USE_DEVICE
+/***
+ * @brief   最后一个使用者关闭设备：丢弃缓冲中尚未取出的包，已被 BLK_GET 取出的包仍由持有者归还
+ */
+static rt_err_t nRF24L01_Dev_Close(rt_device_t dev)
+{
+    struct nRF24L01_DEV_STRUCT *ndev = (struct nRF24L01_DEV_STRUCT *)dev;
+    rt_rbb_blk_t blk;
+
+    while (rt_sem_trytake(&ndev->rx_sem) == RT_EOK){
+        blk = rt_rbb_blk_get(&ndev->rbb);
+        if (blk != RT_NULL){
+            rt_rbb_blk_free(&ndev->rbb, blk);
+        }
+    }
+
+    return RT_EOK;
+}
+
+
+/***
+ * @brief   拷贝读出最早的一包，不阻塞
+ * @return  读出的字节数，载荷长于 size 时截断；没有数据时为 0
+ */
+static rt_size_t nRF24L01_Dev_Read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct nRF24L01_DEV_STRUCT *ndev = (struct nRF24L01_DEV_STRUCT *)dev;
+    rt_rbb_blk_t blk;
+    rt_size_t len;
+
+    if (rt_sem_trytake(&ndev->rx_sem) != RT_EOK){
+        return 0;
+    }
+    blk = rt_rbb_blk_get(&ndev->rbb);
+    if (blk == RT_NULL){
+        return 0;
+    }
+
+    len = rt_rbb_blk_size(blk) - NRF24_DEV_BLK_HEADER;
+    if (len > size){
+        len = size;
+    }
+    rt_memcpy(buffer, rt_rbb_blk_buf(blk) + NRF24_DEV_BLK_HEADER, len);
+    rt_rbb_blk_free(&ndev->rbb, blk);
+
+    return len;
+}
+
+
+/***
+ * @brief   把数据按 NRF24_DEV_PAYLOAD_SIZE 字节切包，直接组进描述符、以 NRF24_DEV_MARK 开头放入软件发送队列，由射频线程发送（需要应答）
+ * @return  已放入队列的字节数，队列或描述符池满时少于 size
+ */
+static rt_size_t nRF24L01_Dev_Write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct nRF24L01_DEV_STRUCT *ndev = (struct nRF24L01_DEV_STRUCT *)dev;
+    nrf24_t nrf24 = ndev->nrf24;
+    const uint8_t *data = (const uint8_t *)buffer;
+    rt_size_t done = 0;
+    nrf24_pkt_t pkt;
+    uint8_t chunk;
+
+    if (nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        rt_set_errno(-RT_ERROR);
+        return 0;
+    }
+
+    while (done < size)
+    {
+        chunk = (size - done > NRF24_DEV_PAYLOAD_SIZE) ? NRF24_DEV_PAYLOAD_SIZE : (uint8_t)(size - done);
+        pkt = nRF24L01_Pkt_Alloc(nrf24);
+        if (pkt != RT_NULL){
+            pkt->data[0] = NRF24_DEV_MARK;
+            rt_memcpy(&pkt->data[1], &data[done], chunk);
+            pkt->len = chunk + 1;
+        }
+        if (pkt == RT_NULL || nRF24L01_Send_Pkt(nrf24, pkt, nRF24_SEND_NEED_ACK) < 0){
+            ndev->tx_dropped++;
+            rt_set_errno(-RT_EFULL);
+            break;
+        }
+        ndev->tx_packets++;
+        done += chunk;
+    }
+
+    return done;
+}
+
+
+/***
+ * @brief   取出最早的一包，返回它在环形缓冲中的位置，不拷贝
+ */
+static rt_err_t nRF24L01_Dev_Blk_Get(struct nRF24L01_DEV_STRUCT *ndev, struct nrf24_dev_rx *rx)
+{
+    rt_err_t result;
+    rt_uint8_t *buf;
+
+    result = rt_sem_take(&ndev->rx_sem, rx->timeout);
+    if (result != RT_EOK){
+        return result;
+    }
+    rx->blk = rt_rbb_blk_get(&ndev->rbb);
+    if (rx->blk == RT_NULL){
+        return -RT_EEMPTY;
+    }
+
+    buf = rt_rbb_blk_buf(rx->blk);
+    rx->pipe  = buf[0];
+    rx->flags = buf[1];
+    rx->data  = buf + NRF24_DEV_BLK_HEADER;
+    rx->len   = rt_rbb_blk_size(rx->blk) - NRF24_DEV_BLK_HEADER;
+
+    return RT_EOK;
+}
+
+
+static rt_err_t nRF24L01_Dev_Control(rt_device_t dev, int cmd, void *args)
+{
+    struct nRF24L01_DEV_STRUCT *ndev = (struct nRF24L01_DEV_STRUCT *)dev;
+    nrf24_t nrf24 = ndev->nrf24;
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    rt_uint8_t *val = (rt_uint8_t *)args;
+    rt_uint8_t rate = cfg->rf_setup.rf_dr_low ? NRF24_LINK_250K : (cfg->rf_setup.rf_dr_high ? NRF24_LINK_2M : NRF24_LINK_1M);
+
+    if (args == RT_NULL){
+        return -RT_EINVAL;
+    }
+
+    switch (cmd)
+    {
+        case NRF24_CTRL_SET_CHANNEL:    return nRF24L01_Chan_Set(nrf24, *val);
+        case NRF24_CTRL_GET_CHANNEL:    *val = cfg->rf_ch.rf_ch;                        break;
+        case NRF24_CTRL_SET_RATE:       return nRF24L01_Link_Set(nrf24, *val, cfg->rf_setup.rf_pwr);
+        case NRF24_CTRL_GET_RATE:       *val = rate;                                    break;
+        case NRF24_CTRL_SET_POWER:      return nRF24L01_Link_Set(nrf24, rate, *val);
+        case NRF24_CTRL_GET_POWER:      *val = cfg->rf_setup.rf_pwr;                    break;
+        case NRF24_CTRL_SET_ROLE:
+        {
+            if (*val != ROLE_PTX && *val != ROLE_PRX){
+                return -RT_EINVAL;
+            }
+            if (nRF24L01_Duplex_Active(nrf24)){
+                return -RT_ERROR;
+            }
+            ndev->role_req = *val + 1;
+            nRF24L01_Wakeup(nrf24);
+        }break;
+        case NRF24_CTRL_GET_ROLE:       *val = cfg->config.prim_rx;                     break;
+        case NRF24_CTRL_BLK_GET:        return nRF24L01_Dev_Blk_Get(ndev, (struct nrf24_dev_rx *)args);
+        case NRF24_CTRL_BLK_FREE:
+        {
+            struct nrf24_dev_rx *rx = (struct nrf24_dev_rx *)args;
+            if (rx->blk == RT_NULL){
+                return -RT_EINVAL;
+            }
+            rt_rbb_blk_free(&ndev->rbb, rx->blk);
+            rx->blk  = RT_NULL;
+            rx->data = RT_NULL;
+        }break;
+
+        default: return -RT_ENOSYS;
+    }
+
+    return RT_EOK;
+}
+
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops nrf24_dev_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    nRF24L01_Dev_Close,
+    nRF24L01_Dev_Read,
+    nRF24L01_Dev_Write,
+    nRF24L01_Dev_Control,
+};
+#endif
+#endif /* NRF24_USE_DEVICE */
+
+
+
+/***
+ * @brief   注册与实例同名的字符设备，在 nRF24L01_Init 末尾调用
+ */
+int nRF24L01_Dev_Register(nrf24_t nrf24)
+{
+#if NRF24_USE_DEVICE
+    struct nRF24L01_DEV_STRUCT *ndev = &nrf24->dev;
+    struct rt_device *dev = &ndev->parent;
+
+    ndev->nrf24 = nrf24;
+    rt_rbb_init(&ndev->rbb, ndev->buf, sizeof(ndev->buf), ndev->blk_set, NRF24_DEV_RBB_BLKS);
+    rt_sem_init(&ndev->rx_sem, nrf24->name, 0, RT_IPC_FLAG_FIFO);
+
+    dev->type = RT_Device_Class_Char;
+#ifdef RT_USING_DEVICE_OPS
+    dev->ops = &nrf24_dev_ops;
+#else
+    dev->init    = RT_NULL;
+    dev->open    = RT_NULL;
+    dev->close   = nRF24L01_Dev_Close;
+    dev->read    = nRF24L01_Dev_Read;
+    dev->write   = nRF24L01_Dev_Write;
+    dev->control = nRF24L01_Dev_Control;
+#endif
+    dev->user_data = nrf24;
+
+    return rt_device_register(dev, nrf24->name, RT_DEVICE_FLAG_RDWR);
+#else
+    return RT_EOK;
+#endif
+}
+
+
+
+/***
+ * @brief   交给应用的一包是设备数据（NRF24_DEV_MARK 开头）时，去掉类型字节再放入设备的环形块缓冲，设备未打开时直接返回
+ * @note    只拷贝一次：从描述符拷进环形缓冲，之后读线程用 NRF24_CTRL_BLK_GET 原地访问
+ */
+void nRF24L01_Dev_Input(nrf24_t nrf24, nrf24_pkt_t pkt)
+{
+#if NRF24_USE_DEVICE
+    struct nRF24L01_DEV_STRUCT *ndev = &nrf24->dev;
+    rt_rbb_blk_t blk;
+    rt_uint8_t *buf;
+
+    if (ndev->parent.ref_count == 0 || pkt->len < 2 || pkt->data[0] != NRF24_DEV_MARK){
+        return;
+    }
+
+    blk = rt_rbb_blk_alloc(&ndev->rbb, pkt->len - 1 + NRF24_DEV_BLK_HEADER);
+    if (blk == RT_NULL){
+        ndev->rx_dropped++;
+        return;
+    }
+    buf = rt_rbb_blk_buf(blk);
+    buf[0] = pkt->pipe;
+    buf[1] = pkt->flags;
+    rt_memcpy(buf + NRF24_DEV_BLK_HEADER, &pkt->data[1], pkt->len - 1);
+    rt_rbb_blk_put(blk);
+
+    ndev->rx_packets++;
+    rt_sem_release(&ndev->rx_sem);
+    if (ndev->parent.rx_indicate != RT_NULL){
+        ndev->parent.rx_indicate(&ndev->parent, pkt->len - 1);
+    }
+#endif
+}
+
+
+
+/***
+ * @brief   执行设备的角色切换请求，在射频线程中调用
+ * @note    PTX 要等芯片 TX FIFO 中的数据包全部完成，TX_DS / MAX_RT 会再次唤醒射频线程；
+ *          切换前清空两个 FIFO，PRX 残留的 ACK 载荷和未读的包都作废
+ */
+void nRF24L01_Dev_Service(nrf24_t nrf24)
+{
+#if NRF24_USE_DEVICE
+    struct nRF24L01_DEV_STRUCT *ndev = &nrf24->dev;
+    rt_uint8_t role;
+
+    if (ndev->role_req == 0){
+        return;
+    }
+    role = ndev->role_req - 1;
+    if (role == nrf24->nrf24_cfg.config.prim_rx){
+        ndev->role_req = 0;
+        return;
+    }
+    if (nrf24->tx_queue.sent != nrf24->tx_queue.done || nRF24L01_Turn_Busy(nrf24)){
+        return;
+    }
+    ndev->role_req = 0;
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    nRF24L01_Flush_RX_FIFO(nrf24);
+    nRF24L01_Set_Role_Mode(nrf24, (nrf24_role_et)role);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    LOG_I("LOG:%d. %s role -> %s.",Record.ulog_cnt++, nrf24->name, (role == ROLE_PRX) ? "PRX" : "PTX");
+#endif
+}
+
+
+
+#if NRF24_USE_DEVICE
+/***
+ * @brief msh 命令：通过设备接口收发，演示 rt_device 的用法
+ * @note  nrf24_io                打印当前实例设备的统计
+ *        nrf24_io read           用 NRF24_CTRL_BLK_GET 取出缓冲中全部的包并打印（设备需已由别处打开）
+ *        nrf24_io write <text>   用 rt_device_write 发送一段文本
+ */
+static void nrf24_io_cmd(int argc, char **argv)
+{
+    struct nRF24L01_DEV_STRUCT *ndev;
+    rt_device_t dev;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    ndev = &_nrf24->dev;
+    dev = rt_device_find(_nrf24->name);
+    if (dev == RT_NULL){
+        rt_kprintf("[nrf24] device %s not registered.\r\n", _nrf24->name);
+        return;
+    }
+
+    if (argc > 1 && rt_strcmp(argv[1], "read") == 0)
+    {
+        struct nrf24_dev_rx rx = { .timeout = 0 };
+
+        while (rt_device_control(dev, NRF24_CTRL_BLK_GET, &rx) == RT_EOK){
+            rt_kprintf("  p%d %2d bytes%s:", rx.pipe, rx.len, (rx.flags & NRF24_PKT_FLAG_RPD) ? " (rpd)" : "");
+            for (rt_uint8_t i = 0; i < rx.len; i++){
+                rt_kprintf(" %02x", rx.data[i]);
+            }
+            rt_kprintf("\r\n");
+            rt_device_control(dev, NRF24_CTRL_BLK_FREE, &rx);
+        }
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "write") == 0)
+    {
+        if (rt_device_open(dev, RT_DEVICE_OFLAG_RDWR) != RT_EOK){
+            rt_kprintf("[nrf24] open %s failed.\r\n", _nrf24->name);
+            return;
+        }
+        rt_kprintf("[nrf24] %d bytes queued.\r\n", rt_device_write(dev, 0, argv[2], rt_strlen(argv[2])));
+        rt_device_close(dev);
+    }
+
+    rt_kprintf("[nrf24] device %s: refs %d, rx %d, dropped %d, queued %d, tx %d, tx dropped %d\r\n",
+               _nrf24->name, dev->ref_count, ndev->rx_packets, ndev->rx_dropped, ndev->rx_sem.value,
+               ndev->tx_packets, ndev->tx_dropped);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_io_cmd, nrf24_io, nrf24 device io [read | write <text>]);
+#endif
@@ -12,6 +12,7 @@
 
 #include "bsp_sys.h"
 #include "bsp_nrf24l01_spi.h"
+#include "bsp_nrf24l01_sim.h"
 
 
 // 以下是一些模式的枚举 ---------------------------------------------------------------------------------------------
@@ -104,15 +105,23 @@ typedef enum
 
 /***
  * nRF24L01 的空中数据速率模式枚举
- * ADR_1Mbps : 距离更远，抗干扰好
- * ADR_2Mbps : 延迟更低，带宽更高
+ * ADR_1Mbps   : 距离更远，抗干扰好
+ * ADR_2Mbps   : 延迟更低，带宽更高
+ * ADR_250Kbps : 灵敏度最高，距离最远（RF_DR_LOW = 1，此时 RF_DR_HIGH 无效）
  */
 typedef enum
 {
     ADR_1Mbps = 0,
     ADR_2Mbps = 1,
+    ADR_250Kbps = 2,
 } nrf24_adr_et;
 
+/***
+ * SETUP_RETR.ARD 与自动重发延时的换算：延时 = (ARD + 1) * 250us，与空中速率无关
+ */
+#define NRF24_ARD_US(code)      (((code) + 1) * 250)
+#define NRF24_ARD_CODE(us)      ((us) / 250 - 1)
+
 
 /***
  * nRF24L01的待机模式的枚举
@@ -232,6 +241,8 @@ struct nRF24L01_Flag_Struct{
     uint8_t activated_features      :1;
     uint8_t using_irq               :1;
     uint8_t status;
+    /* 本次 TX_DS / MAX_RT 时读出的 OBSERVE_TX，统计和链路自适应共用 */
+    uint8_t observe_tx;
 }__attribute__((aligned(1)));
 
 
@@ -245,8 +256,10 @@ struct nRF24L01_PORT_API
 {
     /* 创建spi设备句柄 */
     struct rt_spi_device *spi_dev_nrf24;
-    /* nRF24L01的IRQ引脚的RTT引脚编号 */
-    rt_uint8_t nRF24L01_IRQ_Pin_Num;
+    /* 当前使用的 SPI 时钟（Hz），由 nRF24L01_SPI_Negotiate_Speed 协商得到 */
+    rt_uint32_t spi_hz;
+    /* 这片 nRF24L01 的 SPI 总线、CE / CSN / IRQ 引脚 */
+    const struct nRF24L01_HW_CFG *hw;
 };
 typedef struct nRF24L01_PORT_API *nrf24_port_api_t;
 
@@ -260,8 +273,10 @@ struct nRF24L01_FUNC_OPS
     int (* nrf24_send_then_recv)(struct nRF24L01_PORT_API *port_api, const uint8_t *tbuf, uint8_t tlen, uint8_t *rbuf, uint8_t rlen);
     int (* nrf24_send_then_send)(struct nRF24L01_PORT_API *port_api, const uint8_t *tbuf1, uint8_t tlen1, const uint8_t *tbuf2, uint8_t tlen2);
     int (* nrf24_write)(struct nRF24L01_PORT_API *port_api, const uint8_t *buf, uint8_t len);
-    int (* nrf24_set_ce)(void);
-    int (* nrf24_reset_ce)(void);
+    int (* nrf24_transfer)(struct nRF24L01_PORT_API *port_api, const uint8_t *tbuf, uint8_t *rbuf, uint8_t len);
+    int (* nrf24_set_spi_hz)(struct nRF24L01_PORT_API *port_api, rt_uint32_t hz);
+    int (* nrf24_set_ce)(struct nRF24L01_PORT_API *port_api);
+    int (* nrf24_reset_ce)(struct nRF24L01_PORT_API *port_api);
 };
 
 
@@ -270,11 +285,103 @@ typedef struct nRF24L01_STRUCT *nrf24_t;
 
 /***
  * nRF24L01的软件回调函数，这个回调与事件相关
+ * nrf24l01_tx_done : pipe 为 NRF24_PIPE_NONE 表示发送失败；
+ *                    packet_id 为 nRF24L01_Send_Async 返回的编号，同步发送的数据包为 NRF24_PACKET_ID_NONE
+ * nrf24l01_rx_pkt  : 以描述符交付一包应用数据，设置后取代 nrf24l01_rx_ind；描述符的所有权随之交给应用，
+ *                    用完后调用 nRF24L01_Pkt_Free，可以跨线程持有，但持有期间占用池中的一个描述符
+ * nrf24l01_msg_ind : 分片重组完成的整条消息，或可靠传输层按序交付的报文，data 只在回调期间有效
+ * nrf24l01_req_ind : 收到切换引擎的请求，把应答写入 resp 并返回长度（不超过 NRF24_TURN_PAYLOAD_SIZE），
+ *                    运行在射频线程中，应尽快返回；为 NULL 时原样回送请求
  */
 struct nrf24_callback
 {
     void (*nrf24l01_rx_ind)(nrf24_t nrf24, uint8_t *data, uint8_t len, int pipe);
-    void (*nrf24l01_tx_done)(nrf24_t nrf24, rt_uint8_t pipe);
+    void (*nrf24l01_rx_pkt)(nrf24_t nrf24, nrf24_pkt_t pkt);
+    void (*nrf24l01_tx_done)(nrf24_t nrf24, rt_uint8_t pipe, rt_uint16_t packet_id);
+    void (*nrf24l01_msg_ind)(nrf24_t nrf24, uint8_t *data, rt_uint16_t len, int pipe);
+    uint8_t (*nrf24l01_req_ind)(nrf24_t nrf24, const uint8_t *req, uint8_t len, uint8_t *resp);
+};
+
+
+
+/***
+ * nRF24L01 的软件发送队列
+ * NRF24_TXQ_DEPTH        : 软件队列深度，必须为 2 的幂
+ * NRF24_HW_TX_FIFO_DEPTH : 芯片 TX FIFO 深度
+ * NRF24_HW_RX_FIFO_DEPTH : 芯片 RX FIFO 深度
+ * NRF24_PACKET_ID_NONE   : 无效的数据包编号
+ */
+#define NRF24_TXQ_DEPTH         8
+#define NRF24_HW_TX_FIFO_DEPTH  3
+#define NRF24_HW_RX_FIFO_DEPTH  3
+#define NRF24_PACKET_ID_NONE    0
+
+/* 槽位只存描述符指针，数据包完成（成功或失败）时描述符还回池中 */
+struct nRF24L01_TX_SLOT
+{
+    rt_uint16_t id;
+    rt_uint8_t  ack_mode;
+    nrf24_pkt_t pkt;
+};
+
+/***
+ * 三个自由递增的下标把环形队列分成两段：
+ * [done, sent) : 已写入芯片 TX FIFO，等待 TX_DS / MAX_RT
+ * [sent, put)  : 仍在软件队列中，等待写入芯片
+ */
+struct nRF24L01_TX_QUEUE
+{
+    struct nRF24L01_TX_SLOT slot[NRF24_TXQ_DEPTH];
+    volatile rt_uint8_t put;
+    rt_uint8_t  sent;
+    volatile rt_uint8_t done;
+    rt_uint16_t next_id;
+    /* 同步接口最近写入的一包的长度，TX_DS 时计入统计 */
+    rt_uint8_t  sync_len;
+};
+
+/***
+ * ACK Payload 记账
+ * 芯片按管道先进先出地随应答发出 ACK 载荷，写入时记下长度，该管道收到下一包时出队，发送统计在此时计入；
+ * 芯片 TX FIFO 由各管道共用，全部管道合计最多 NRF24_HW_TX_FIFO_DEPTH 包；清空 TX FIFO 时未发出的载荷直接作废
+ * NRF24_ACK_FROM_SEND : 长度的最高位，标记由 nRF24L01_Send_Packet 写入、发出时要释放 send_sem 的载荷
+ */
+#define NRF24_ACK_FROM_SEND     0x80
+
+struct nRF24L01_ACK_PIPE
+{
+    rt_uint8_t  len[NRF24_HW_TX_FIFO_DEPTH];
+    rt_uint8_t  put;
+    rt_uint8_t  get;
+};
+
+/***
+ * 寄存器影子
+ * 驱动保存一份可写寄存器的副本，位更新直接基于副本计算，省掉读回的那一次 SPI；
+ * 重新配置时先把参数结构体装入影子，只有与芯片不一致的寄存器被标记为脏并写入
+ * valid : bit n 置位表示寄存器 n 的影子与芯片一致
+ * dirty : bit n 置位表示影子已修改、尚未写入芯片
+ * STATUS / OBSERVE_TX / RPD / FIFO_STATUS 由芯片自己改变，不进影子；
+ * 5 字节的地址寄存器 RX_ADDR_P0 / RX_ADDR_P1 / TX_ADDR 单独存放，只能整体暂存和写入
+ */
+#define NRF24_SHADOW_REG_NUM    0x1E
+#define NRF24_SHADOW_VOLATILE   ((1UL << NRF24REG_STATUS) | (1UL << NRF24REG_OBSERVE_TX) | \
+                                 (1UL << NRF24REG_RPD) | (1UL << NRF24REG_FIFO_STATUS))
+#define NRF24_SHADOW_ADDR_REGS  ((1UL << NRF24REG_RX_ADDR_P0) | (1UL << NRF24REG_RX_ADDR_P1) | (1UL << NRF24REG_TX_ADDR))
+
+struct nRF24L01_SHADOW_STRUCT
+{
+    rt_uint8_t  reg[NRF24_SHADOW_REG_NUM];
+    rt_uint8_t  rx_addr_p0[5];
+    rt_uint8_t  rx_addr_p1[5];
+    rt_uint8_t  tx_addr[5];
+    rt_uint32_t valid;
+    rt_uint32_t dirty;
+
+    /* 统计：实际写入次数、值未变而省掉的写入、位更新省掉的读回 */
+    rt_uint32_t writes;
+    rt_uint32_t skipped;
+    rt_uint32_t reads_saved;
 };
 
 /***
@@ -282,16 +389,60 @@ struct nrf24_callback
  */
 struct nRF24L01_STRUCT
 {
+    /* 实例名，msh 命令按名字选择实例 */
+    const char *name;
+    /* 已初始化的实例链表 */
+    struct nRF24L01_STRUCT *next;
+    /* IRQ 引脚、定时器和各层请求都通过它唤醒射频线程 */
+    struct rt_semaphore irq_sem;
+    /* 发送完成信号量 */
+    struct rt_semaphore send_sem;
     /* nRF24L01 的硬件接口以及API函数接口结构体 */
     struct nRF24L01_PORT_API port_api;
     /* nRF24L01 的参数配置结构体 */
     struct nRF24L01_PARAMETER_STRUCT nrf24_cfg;
     /* nRF24L01 的标志位的结构体 */
     struct nRF24L01_Flag_Struct nrf24_flags;
+    /* 寄存器影子 */
+    struct nRF24L01_SHADOW_STRUCT shadow;
     /* 创建nRF24L01的操作函数句柄 */
     struct nRF24L01_FUNC_OPS nrf24_ops;
     /* nRF24L01的事件回调函数句柄 */
     struct nrf24_callback nrf24_cb;
+    /* 收发共用的数据包描述符池 */
+    struct nRF24L01_PKT_POOL pkt_pool;
+    /* nRF24L01的软件发送队列 */
+    struct nRF24L01_TX_QUEUE tx_queue;
+    /* 各管道已写入、尚未随应答发出的 ACK 载荷 */
+    struct nRF24L01_ACK_PIPE ack_pipe[6];
+    /* 每个接收管道一个帧解码器 */
+    struct nRF24L01_DECODER_STRUCT decoder[6];
+    /* 分片 / 重组层 */
+    struct nRF24L01_FRAG_STRUCT frag;
+    /* 滑动窗口可靠传输层 */
+    struct nRF24L01_ARQ_STRUCT arq;
+    /* 快速收发切换引擎 */
+    struct nRF24L01_TURN_STRUCT turn;
+    /* 星型网络中心的各管道接收队列 */
+    struct nRF24L01_HUB_STRUCT hub;
+    /* 地址轮换（多于 6 个节点） */
+    struct nRF24L01_ROTATE_STRUCT rotate;
+    /* TDMA 超帧调度 */
+    struct nRF24L01_TDMA_STRUCT tdma;
+    /* 链路自适应 */
+    struct nRF24L01_LINK_STRUCT link;
+    /* 信道勘测与切换 */
+    struct nRF24L01_CHAN_STRUCT chan;
+    /* 跳频 */
+    struct nRF24L01_HOP_STRUCT hop;
+    /* 链路统计 */
+    struct nRF24L01_STAT_STRUCT stat;
+    /* IRQ 时刻和 IRQ -> 服务延时直方图 */
+    struct nRF24L01_LATENCY_STRUCT latency;
+    /* 所属的全双工链路，不属于时为 RT_NULL */
+    struct nRF24L01_DUPLEX_STRUCT *duplex;
+    /* 与实例同名的 RT-Thread 设备 */
+    struct nRF24L01_DEV_STRUCT dev;
 };
 
 
@@ -302,12 +453,16 @@ struct nRF24L01_STRUCT
 
 
 
-// 外部信号量声明 -------------------------------------------------------------------
-extern rt_sem_t nrf24_send_sem;
-extern rt_sem_t nrf24_irq_sem;
+// 外部变量声明 -------------------------------------------------------------------
+/* msh 命令操作的实例，缺省为第一个初始化的实例，可用 nrf24_dev 切换 */
 extern nrf24_t _nrf24;
 
 // 函数声明 -------------------------------------------------------------------
+int nRF24L01_Init(nrf24_t nrf24, const char *name, const struct nRF24L01_HW_CFG *hw,
+                  const struct nrf24_callback *cb, nrf24_role_et role);
+int nRF24L01_Start(nrf24_t nrf24);
+nrf24_t nRF24L01_Find(const char *name);
+void nRF24L01_Wakeup(nrf24_t nrf24);
 int nRF24L01_Param_Config(nrf24_param_t param);
 int nRF24L01_Check_SPI_Community(nrf24_t port_ops);
 int nRF24L01_Update_Parameter(nrf24_t nrf24);
@@ -315,32 +470,123 @@ int nRF24L01_Read_Onchip_Parameter(nrf24_t nrf24);
 uint8_t nRF24L01_Read_Reg_Data(nrf24_t nrf24, uint8_t reg_addr);
 void nRF24L01_Write_Reg_Data(nrf24_t nrf24, uint8_t reg_addr, uint8_t data);
 void nRF24L01_Write_Reg_Bits(nrf24_t nrf24, uint8_t reg_addr, uint8_t mask, uint8_t value);
+void nRF24L01_Shadow_Invalidate(nrf24_t nrf24);
+void nRF24L01_Shadow_Set(nrf24_t nrf24, uint8_t reg_addr, uint8_t data);
+void nRF24L01_Shadow_Stage(nrf24_t nrf24);
+int nRF24L01_Shadow_Flush(nrf24_t nrf24);
 uint8_t nRF24L01_Read_Status_Register(nrf24_t nrf24);
 void nRF24L01_Clear_Status_Register(nrf24_t nrf24, uint8_t bitmask);
 void nRF24L01_Clear_IRQ_Flags(nrf24_t nrf24);
 rt_uint8_t nRF24L01_Read_IRQ_Status(nrf24_t nrf24);
 void nRF24L01_Clear_Observe_TX(nrf24_t nrf24);
 uint8_t nRF24L01_Read_Top_RXFIFO_Width(nrf24_t nrf24);
+uint8_t nRF24L01_Read_Top_RXFIFO_Width_Status(nrf24_t nrf24, uint8_t *status);
 void nRF24L01_Enter_Power_Down_Mode(nrf24_t nrf24);
 void nRF24L01_Enter_Power_Up_Mode(nrf24_t nrf24);
 void nRF24L01_Write_Tx_Payload_Ack(nrf24_t nrf24, const uint8_t *buf, uint8_t len);
 void nRF24L01_Write_Tx_Payload_NoAck(nrf24_t nrf24, const uint8_t *buf, uint8_t len);
-void nRF24L01_Write_Tx_Payload_InAck(nrf24_t nrf24, uint8_t pipe, const uint8_t *buf, uint8_t len);
+int nRF24L01_Write_Tx_Payload_InAck(nrf24_t nrf24, uint8_t pipe, const uint8_t *buf, uint8_t len);
+rt_uint8_t nRF24L01_Ack_Pending(nrf24_t nrf24, uint8_t pipe);
 void nRF24L01_Read_Rx_Payload(nrf24_t nrf24, uint8_t *buf, uint8_t len);
+void nRF24L01_Read_Rx_Frame(nrf24_t nrf24, uint8_t *frame, uint8_t len);
 void nRF24L01_Flush_TX_FIFO(nrf24_t nrf24);
+void nRF24L01_TxQueue_Rewind(nrf24_t nrf24);
+rt_uint32_t nRF24L01_Air_Us(nrf24_param_t cfg, rt_uint8_t payload_len);
 void nRF24L01_Flush_RX_FIFO(nrf24_t nrf24);
 void NRF24L01_Set_TxAddr(nrf24_t nrf24, rt_uint8_t *addr_buf, rt_uint8_t length);
 int nRF24L01_Send_Packet(nrf24_t nrf24, uint8_t *data, uint8_t len, uint8_t pipe, ack_mode_et ack_mode);
+void nRF24L01_TxQueue_Init(nrf24_t nrf24);
+int nRF24L01_Send_Async(nrf24_t nrf24, const uint8_t *data, uint8_t len, ack_mode_et ack_mode);
+int nRF24L01_Send_Pkt(nrf24_t nrf24, nrf24_pkt_t pkt, ack_mode_et ack_mode);
+void nRF24L01_Pkt_Init(nrf24_t nrf24);
+nrf24_pkt_t nRF24L01_Pkt_Alloc(nrf24_t nrf24);
+void nRF24L01_Pkt_Free(nrf24_pkt_t pkt);
+void nRF24L01_Pkt_Deliver(nrf24_t nrf24, nrf24_pkt_t pkt);
+void nRF24L01_Frag_Init(nrf24_t nrf24);
+int nRF24L01_Frag_Send(nrf24_t nrf24, const uint8_t *msg, rt_uint16_t len, ack_mode_et ack_mode, rt_int32_t timeout);
+int nRF24L01_Frag_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+void nRF24L01_ARQ_Init(nrf24_t nrf24);
+int nRF24L01_ARQ_Send(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_int32_t timeout);
+int nRF24L01_ARQ_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+void nRF24L01_ARQ_Service(nrf24_t nrf24);
+rt_int32_t nRF24L01_ARQ_Next_Timeout(nrf24_t nrf24);
+void nRF24L01_Turn_Init(nrf24_t nrf24);
+int nRF24L01_Transact(nrf24_t nrf24, const uint8_t *req, uint8_t len, uint8_t *resp, rt_uint32_t timeout_us, rt_uint32_t *rtt_us);
+int nRF24L01_Turn_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Turn_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Turn_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Turn_Busy(nrf24_t nrf24);
+rt_int32_t nRF24L01_Turn_Next_Timeout(nrf24_t nrf24);
+void nRF24L01_Hub_Init(nrf24_t nrf24);
+void nRF24L01_Hub_Pipe_Addr(nrf24_param_t param, rt_uint8_t pipe, rt_uint8_t *addr);
+int nRF24L01_Hub_Set_Consumer(nrf24_t nrf24, rt_uint8_t pipe, nrf24_hub_consumer_t consumer, rt_uint16_t quantum);
+int nRF24L01_Hub_Input(nrf24_t nrf24, nrf24_pkt_t pkt);
+void nRF24L01_Rotate_Init(nrf24_t nrf24);
+int nRF24L01_Rotate_Set_Nodes(nrf24_t nrf24, rt_uint8_t nodes);
+int nRF24L01_Rotate_Set_Node(nrf24_t nrf24, rt_int8_t id);
+int nRF24L01_Rotate_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Rotate_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Rotate_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Rotate_Tx_Allowed(nrf24_t nrf24);
+rt_int32_t nRF24L01_Rotate_Next_Timeout(nrf24_t nrf24);
+void nRF24L01_Tdma_Init(nrf24_t nrf24);
+int nRF24L01_Tdma_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Tdma_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Tdma_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Tdma_Tx_Allowed(nrf24_t nrf24);
+rt_int32_t nRF24L01_Tdma_Next_Timeout(nrf24_t nrf24);
+void nRF24L01_Link_Init(nrf24_t nrf24);
+int nRF24L01_Link_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Link_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Link_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Link_Tx_Allowed(nrf24_t nrf24);
+rt_int32_t nRF24L01_Link_Next_Timeout(nrf24_t nrf24);
+int nRF24L01_Link_Set(nrf24_t nrf24, rt_uint8_t rate, rt_uint8_t power);
+void nRF24L01_Chan_Init(nrf24_t nrf24);
+int nRF24L01_Chan_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Chan_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Chan_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Chan_Tx_Allowed(nrf24_t nrf24);
+rt_bool_t nRF24L01_Chan_Busy(nrf24_t nrf24);
+rt_int32_t nRF24L01_Chan_Next_Timeout(nrf24_t nrf24);
+int nRF24L01_Chan_Set(nrf24_t nrf24, rt_uint8_t ch);
+void nRF24L01_Hop_Init(nrf24_t nrf24);
+void nRF24L01_Hop_Enable(nrf24_t nrf24, rt_bool_t on);
+int nRF24L01_Hop_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+int nRF24L01_Hop_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags);
+void nRF24L01_Hop_Service(nrf24_t nrf24);
+rt_bool_t nRF24L01_Hop_Tx_Allowed(nrf24_t nrf24);
+rt_bool_t nRF24L01_Hop_Active(nrf24_t nrf24);
+rt_bool_t nRF24L01_Hop_Busy(nrf24_t nrf24);
+rt_int32_t nRF24L01_Hop_Next_Timeout(nrf24_t nrf24);
+void nRF24L01_Stat_Init(nrf24_t nrf24);
+void nRF24L01_Stat_Reset(nrf24_t nrf24);
+void nRF24L01_Stat_Snapshot(nrf24_t nrf24, struct nrf24_stat_snapshot *snap);
+int nRF24L01_Duplex_Init(struct nRF24L01_DUPLEX_STRUCT *duplex, nrf24_t tx, nrf24_t rx, nrf24_duplex_rx_t rx_ind);
+rt_bool_t nRF24L01_Duplex_Active(nrf24_t nrf24);
+int nRF24L01_Duplex_Send(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len, rt_int32_t timeout);
+int nRF24L01_Duplex_Write(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, rt_size_t len, rt_int32_t timeout);
+int nRF24L01_Duplex_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe);
+void nRF24L01_Duplex_Service(nrf24_t nrf24);
+rt_int32_t nRF24L01_Duplex_Next_Timeout(nrf24_t nrf24);
+int nRF24L01_Dev_Register(nrf24_t nrf24);
+void nRF24L01_Dev_Input(nrf24_t nrf24, nrf24_pkt_t pkt);
+void nRF24L01_Dev_Service(nrf24_t nrf24);
 void nRF24L01_Set_Role_Mode(nrf24_t nrf24, nrf24_role_et mode);
 void nRF24L01_Ensure_RWW_Features_Activated(nrf24_t nrf24);
 int nRF24L01_Run(nrf24_t nrf24);
 
 // bsp_nrf24l01_spi 文件中函数声明 -------------------------------------------------------------------
 int nRF24L01_SPI_Init(nrf24_port_api_t port_api);
-int nRF24L01_IQR_GPIO_Config(nrf24_port_api_t port_api);
+int nRF24L01_IQR_GPIO_Config(nrf24_t nrf24);
+int nRF24L01_SPI_Negotiate_Speed(nrf24_t nrf24);
+
+// bsp_nrf24l01_sim 文件中函数声明 -------------------------------------------------------------------
+int nRF24L01_Sim_Init(nrf24_t nrf24);
+nrf24_t nRF24L01_Sim_Add_Node(const char *name, nrf24_role_et role, const struct nrf24_callback *cb);
 
 // bsp_nrf24l01_message 文件中函数声明
-void nrf24l01_order_to_pipe(uint8_t order, nrf24_pipe_et pipe_num);
+void nrf24l01_order_to_pipe(uint8_t order);
 
 // 以下是寄存器列表 ---------------------------------------------------------------------------------------------
 
@@ -356,6 +602,7 @@ void nrf24l01_order_to_pipe(uint8_t order, nrf24_pipe_et pipe_num);
 #define NRF24CMD_ACTIVATE        0x50  // 使能命令，后接数据 0x73
 #define NRF24CMD_R_RX_PL_WID     0x60  // 读顶层接收FIFO大小
 #define NRF24CMD_W_ACK_PAYLOAD   0xA8  // RX模式下使用，写应答发送缓冲区
+#define NRF24CMD_NOP             0xFF  // 空操作，可用于读取STATUS
 
 // 寄存器映射
 #define NRF24REG_CONFIG          0x00  // 配置收发状态，CRC校验模式以及收发状态响应方式
@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-29     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_duplex.h"
+
+#if NRF24_USE_DUPLEX && !NRF24_USE_DUAL_RADIO
+#error "NRF24_USE_DUPLEX needs two nRF24L01, turn on NRF24_USE_DUAL_RADIO"
+#endif
+
+
+#define DUPLEX_SEG(duplex, seq)     (&(duplex)->seg[(seq) & (NRF24_DUPLEX_WINDOW - 1)])
+
+
+
+/***
+ * @brief   复位两个方向的窗口和统计计数
+ */
+static void nRF24L01_Duplex_Reset(struct nRF24L01_DUPLEX_STRUCT *duplex)
+{
+    rt_memset(duplex->seg, 0, sizeof(duplex->seg));
+    duplex->snd_una = 0;
+    duplex->snd_nxt = 0;
+    duplex->order   = 0;
+    duplex->rto     = rt_tick_from_millisecond(NRF24_DUPLEX_RTO_MS);
+
+    duplex->rcv_nxt     = 0;
+    duplex->bitmap      = 0;
+    duplex->ack_cum     = 0;
+    duplex->ack_sack    = 0;
+    duplex->ack_pending = 0;
+
+    duplex->tx_segments      = 0;
+    duplex->tx_acked_bytes   = 0;
+    duplex->retransmits      = 0;
+    duplex->timeouts         = 0;
+    duplex->acks_piggybacked = 0;
+    duplex->acks_pure        = 0;
+    duplex->rx_delivered     = 0;
+    duplex->rx_bytes         = 0;
+    duplex->rx_duplicates    = 0;
+    duplex->rx_out_of_window = 0;
+}
+
+
+
+/***
+ * @brief   把一片 PTX 和一片 PRX 组成全双工链路
+ * @param   tx / rx   已 nRF24L01_Init、尚未 nRF24L01_Start 的两个实例，角色分别为 PTX / PRX
+ *          rx_ind    按序收到的数据，可为 RT_NULL
+ * @note    两片的信道在这里写入配置，nRF24L01_Start 时生效，因此必须在射频线程启动前调用
+ */
+int nRF24L01_Duplex_Init(struct nRF24L01_DUPLEX_STRUCT *duplex, nrf24_t tx, nrf24_t rx, nrf24_duplex_rx_t rx_ind)
+{
+    if (tx == RT_NULL || rx == RT_NULL || tx == rx
+        || tx->nrf24_cfg.config.prim_rx != ROLE_PTX || rx->nrf24_cfg.config.prim_rx != ROLE_PRX){
+        return -RT_EINVAL;
+    }
+
+    rt_memset(duplex, 0, sizeof(struct nRF24L01_DUPLEX_STRUCT));
+    duplex->tx = tx;
+    duplex->rx = rx;
+    duplex->rx_ind = rx_ind;
+    nRF24L01_Duplex_Reset(duplex);
+
+#if NRF24_DUPLEX_SIDE == 0
+    tx->nrf24_cfg.rf_ch.rf_ch = NRF24_DUPLEX_CH_A;
+    rx->nrf24_cfg.rf_ch.rf_ch = NRF24_DUPLEX_CH_B;
+#else
+    tx->nrf24_cfg.rf_ch.rf_ch = NRF24_DUPLEX_CH_B;
+    rx->nrf24_cfg.rf_ch.rf_ch = NRF24_DUPLEX_CH_A;
+#endif
+    tx->duplex = duplex;
+    rx->duplex = duplex;
+
+    return RT_EOK;
+}
+
+
+
+/***
+ * @brief   该实例是否属于一条全双工链路，信道勘测 / 切换据此不把 PRX 拉回上电信道
+ */
+rt_bool_t nRF24L01_Duplex_Active(nrf24_t nrf24)
+{
+    return (nrf24->duplex != RT_NULL) ? RT_TRUE : RT_FALSE;
+}
+
+
+
+/***
+ * @brief   把一条报文放入发送窗口，由 PTX 一片的 nRF24L01_Run 负责发送、重传
+ * @param   data/len  报文内容，1 ~ NRF24_DUPLEX_PAYLOAD_SIZE 字节
+ *          timeout   窗口已满时最长等待的 tick 数，RT_WAITING_FOREVER 为一直等待
+ * @return  >=0 : 报文序号   -RT_EINVAL : 参数错误   -RT_ETIMEOUT : 等待窗口超时
+ * @note    窗口满时会让出 CPU 等待确认，因此不能在 nRF24L01 服务线程中调用
+ */
+int nRF24L01_Duplex_Send(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len, rt_int32_t timeout)
+{
+    struct nRF24L01_DUPLEX_SEG *seg;
+    rt_tick_t start = rt_tick_get();
+    rt_uint8_t seq;
+
+    if (len == 0 || len > NRF24_DUPLEX_PAYLOAD_SIZE){
+        return -RT_EINVAL;
+    }
+
+    for (;;)
+    {
+        rt_enter_critical();
+        seq = duplex->snd_nxt;
+        seg = DUPLEX_SEG(duplex, seq);
+        if ((rt_uint8_t)(seq - duplex->snd_una) < NRF24_DUPLEX_WINDOW && seg->state == DUPLEX_SEG_FREE){
+            break;
+        }
+        rt_exit_critical();
+
+        if (timeout != RT_WAITING_FOREVER && (rt_int32_t)(rt_tick_get() - start) >= timeout){
+            return -RT_ETIMEOUT;
+        }
+        rt_thread_delay(1);
+    }
+
+    rt_memcpy(seg->data, data, len);
+    seg->len   = len;
+    seg->order = 0;
+    seg->state = DUPLEX_SEG_QUEUED;
+    duplex->snd_nxt = seq + 1;
+    rt_exit_critical();
+
+    nRF24L01_Wakeup(duplex->tx);
+
+    return seq;
+}
+
+
+
+/***
+ * @brief   把一段字节流按 NRF24_DUPLEX_PAYLOAD_SIZE 切成报文依次放入发送窗口
+ * @return  已放入窗口的字节数，第一个报文就失败时返回 nRF24L01_Duplex_Send 的错误码
+ */
+int nRF24L01_Duplex_Write(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, rt_size_t len, rt_int32_t timeout)
+{
+    rt_size_t done = 0;
+    uint8_t chunk;
+    int ret;
+
+    while (done < len)
+    {
+        chunk = (len - done > NRF24_DUPLEX_PAYLOAD_SIZE) ? NRF24_DUPLEX_PAYLOAD_SIZE : (uint8_t)(len - done);
+        ret = nRF24L01_Duplex_Send(duplex, &data[done], chunk, timeout);
+        if (ret < 0){
+            return (done > 0) ? (int)done : ret;
+        }
+        done += chunk;
+    }
+
+    return (int)done;
+}
+
+
+
+/***
+ * @brief   标记一个报文已被确认
+ * @return  该报文最近一次发送的顺序号，报文此前已确认或还未发出时返回 0
+ */
+static rt_uint16_t nRF24L01_Duplex_Ack_Seg(struct nRF24L01_DUPLEX_STRUCT *duplex, struct nRF24L01_DUPLEX_SEG *seg)
+{
+    if ((seg->state != DUPLEX_SEG_INFLIGHT && seg->state != DUPLEX_SEG_QUEUED) || seg->order == 0){
+        return 0;
+    }
+
+    seg->state = DUPLEX_SEG_ACKED;
+    duplex->tx_acked_bytes += seg->len;
+
+    return seg->order;
+}
+
+
+
+/***
+ * @brief   处理对端捎带回来的累计确认和选择确认，释放发送窗口
+ * @return  判定丢失、重新排队的报文数
+ * @note    在 PRX 一片的射频线程中调用，调用者已锁调度器
+ */
+static rt_uint8_t nRF24L01_Duplex_Handle_Ack(struct nRF24L01_DUPLEX_STRUCT *duplex, rt_uint8_t cum, rt_uint8_t sack)
+{
+    rt_uint8_t  outstanding = duplex->snd_nxt - duplex->snd_una;
+    rt_uint16_t order, newest = 0;
+    rt_uint8_t  seq, requeued = 0;
+
+    // 1. 累计确认号必须落在 [snd_una, snd_nxt] 内，否则是过期的确认（反方向的包可能比确认晚到）
+    if ((rt_uint8_t)(cum - duplex->snd_una) > outstanding){
+        return 0;
+    }
+
+    for (seq = duplex->snd_una; seq != cum; seq++){
+        order = nRF24L01_Duplex_Ack_Seg(duplex, DUPLEX_SEG(duplex, seq));
+        if ((rt_int16_t)(order - newest) > 0){
+            newest = order;
+        }
+    }
+
+    // 2. 选择确认
+    for (rt_uint8_t i = 0; i < 8 && (sack >> i); i++)
+    {
+        seq = cum + 1 + i;
+        if (!((sack >> i) & 1) || (rt_uint8_t)(seq - duplex->snd_una) >= outstanding){
+            continue;
+        }
+        order = nRF24L01_Duplex_Ack_Seg(duplex, DUPLEX_SEG(duplex, seq));
+        if ((rt_int16_t)(order - newest) > 0){
+            newest = order;
+        }
+    }
+
+    // 3. 每个方向都是按序的单信道：比本次新确认的报文更早发出却仍未确认的报文已丢失，立即重传
+    if (newest != 0){
+        for (seq = duplex->snd_una; seq != duplex->snd_nxt; seq++)
+        {
+            struct nRF24L01_DUPLEX_SEG *seg = DUPLEX_SEG(duplex, seq);
+            if (seg->state == DUPLEX_SEG_INFLIGHT && (rt_int16_t)(newest - seg->order) > 0){
+                seg->state = DUPLEX_SEG_QUEUED;
+                duplex->retransmits++;
+                requeued++;
+            }
+        }
+    }
+
+    // 4. 滑动窗口，窗口前移说明链路恢复，重传超时回到初值
+    if (cum != duplex->snd_una){
+        duplex->rto = rt_tick_from_millisecond(NRF24_DUPLEX_RTO_MS);
+    }
+    while (duplex->snd_una != duplex->snd_nxt && DUPLEX_SEG(duplex, duplex->snd_una)->state == DUPLEX_SEG_ACKED){
+        DUPLEX_SEG(duplex, duplex->snd_una)->state = DUPLEX_SEG_FREE;
+        duplex->snd_una++;
+    }
+
+    return requeued;
+}
+
+
+
+/***
+ * @brief   接收一个 DATA 报文：乱序报文缓存在接收窗口中，从 rcv_nxt 开始连续的报文依次交付
+ * @note    接收窗口只在 PRX 一片的射频线程中访问，交付时不持锁
+ */
+static void nRF24L01_Duplex_Handle_Data(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len)
+{
+    rt_uint8_t seq = data[1];
+    rt_uint8_t offset = seq - duplex->rcv_nxt;
+    rt_uint8_t slot;
+
+    // 1. 已交付过的报文（序号落后于 rcv_nxt）或已缓存的报文，多半是对端没收到确认而重传
+    if (offset >= 128 || (offset < NRF24_DUPLEX_WINDOW && ((duplex->bitmap >> offset) & 1))){
+        duplex->rx_duplicates++;
+        return;
+    }
+    if (offset >= NRF24_DUPLEX_WINDOW){
+        duplex->rx_out_of_window++;
+        return;
+    }
+
+    // 2. 缓存后按序交付
+    slot = seq & (NRF24_DUPLEX_WINDOW - 1);
+    rt_memcpy(duplex->data[slot], &data[NRF24_DUPLEX_HEADER_SIZE], len - NRF24_DUPLEX_HEADER_SIZE);
+    duplex->len[slot] = len - NRF24_DUPLEX_HEADER_SIZE;
+    duplex->bitmap |= 1UL << offset;
+
+    while (duplex->bitmap & 1)
+    {
+        slot = duplex->rcv_nxt & (NRF24_DUPLEX_WINDOW - 1);
+        duplex->rx_delivered++;
+        duplex->rx_bytes += duplex->len[slot];
+        if (duplex->rx_ind){
+            duplex->rx_ind(duplex, duplex->data[slot], duplex->len[slot]);
+        }
+        duplex->bitmap >>= 1;
+        duplex->rcv_nxt++;
+    }
+}
+
+
+
+/***
+ * @brief   接收方向：处理全双工链路的报文，在 PRX 一片的射频线程中调用
+ * @return  1 : 是全双工报文，已由本层处理   0 : 不是，由调用者按普通数据包处理
+ */
+int nRF24L01_Duplex_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_DUPLEX_STRUCT *duplex = nrf24->duplex;
+    rt_uint8_t type, requeued;
+
+    if (duplex == RT_NULL || duplex->rx != nrf24 || len < NRF24_DUPLEX_HEADER_SIZE
+        || (data[0] & NRF24_DUPLEX_MARK_MASK) != NRF24_DUPLEX_MARK){
+        return 0;
+    }
+    type = data[0] & ~NRF24_DUPLEX_MARK_MASK;
+    if (type != NRF24_DUPLEX_DATA && type != NRF24_DUPLEX_ACK){
+        return 0;
+    }
+
+    // 1. 每个包都带着对端的确认，释放本机的发送窗口
+    rt_enter_critical();
+    requeued = nRF24L01_Duplex_Handle_Ack(duplex, data[2], data[3]);
+    rt_exit_critical();
+
+    // 2. 数据交给接收窗口，再把新的确认交给 PTX 一片捎带回去
+    if (type == NRF24_DUPLEX_DATA && len > NRF24_DUPLEX_HEADER_SIZE)
+    {
+        nRF24L01_Duplex_Handle_Data(duplex, data, len);
+
+        rt_enter_critical();
+        duplex->ack_cum  = duplex->rcv_nxt;
+        duplex->ack_sack = (rt_uint8_t)(duplex->bitmap >> 1);
+        duplex->ack_pending = 1;
+        rt_exit_critical();
+        requeued++;
+    }
+
+    // 3. 有重传或确认要发时唤醒 PTX 一片
+    if (requeued){
+        nRF24L01_Wakeup(duplex->tx);
+    }
+
+    return 1;
+}
+
+
+
+/***
+ * @brief   发送方向的定时处理，在 PTX 一片的 nRF24L01_Run 的每一轮循环中调用
+ * @note    1. 在途报文超过 RTO 仍未确认（这一段的确认全部丢失）时重新排队，RTO 加倍；
+ *          2. 按序号顺序把等待发送 / 重传的报文以 NO_ACK 放入软件发送队列，每包都捎带最新的确认；
+ *          3. 有确认要回而没有数据可捎带时发一个纯 ACK
+ */
+void nRF24L01_Duplex_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_DUPLEX_STRUCT *duplex = nrf24->duplex;
+    struct nRF24L01_DUPLEX_SEG *seg;
+    rt_uint8_t seq, expired = 0, sent = 0;
+    rt_tick_t  now = rt_tick_get();
+    uint8_t    packet[32];
+
+    if (duplex == RT_NULL || duplex->tx != nrf24){
+        return;
+    }
+
+    rt_enter_critical();
+
+    // 1. 超时检查
+    for (seq = duplex->snd_una; seq != duplex->snd_nxt; seq++){
+        seg = DUPLEX_SEG(duplex, seq);
+        if (seg->state == DUPLEX_SEG_INFLIGHT && (rt_int32_t)(now - seg->sent_tick) >= duplex->rto){
+            seg->state = DUPLEX_SEG_QUEUED;
+            expired = 1;
+        }
+    }
+    if (expired){
+        duplex->timeouts++;
+        duplex->rto *= 2;
+        if (duplex->rto > rt_tick_from_millisecond(NRF24_DUPLEX_RTO_MAX_MS)){
+            duplex->rto = rt_tick_from_millisecond(NRF24_DUPLEX_RTO_MAX_MS);
+        }
+    }
+
+    // 2. 发送 / 重传
+    for (seq = duplex->snd_una; seq != duplex->snd_nxt; seq++)
+    {
+        seg = DUPLEX_SEG(duplex, seq);
+        if (seg->state != DUPLEX_SEG_QUEUED){
+            continue;
+        }
+
+        packet[0] = NRF24_DUPLEX_MARK | NRF24_DUPLEX_DATA;
+        packet[1] = seq;
+        packet[2] = duplex->ack_cum;
+        packet[3] = duplex->ack_sack;
+        rt_memcpy(&packet[NRF24_DUPLEX_HEADER_SIZE], seg->data, seg->len);
+        if (nRF24L01_Send_Async(nrf24, packet, seg->len + NRF24_DUPLEX_HEADER_SIZE, nRF24_SEND_NO_ACK) < 0){
+            break;
+        }
+
+        if (seg->order == 0){
+            duplex->tx_segments++;
+        }
+        if (++duplex->order == 0){
+            duplex->order++;
+        }
+        seg->order = duplex->order;
+        seg->sent_tick = now;
+        seg->state = DUPLEX_SEG_INFLIGHT;
+        if (duplex->ack_pending){
+            duplex->ack_pending = 0;
+            duplex->acks_piggybacked++;
+        }
+        sent = 1;
+    }
+
+    // 3. 纯 ACK
+    if (sent == 0 && duplex->ack_pending)
+    {
+        packet[0] = NRF24_DUPLEX_MARK | NRF24_DUPLEX_ACK;
+        packet[1] = duplex->snd_nxt;
+        packet[2] = duplex->ack_cum;
+        packet[3] = duplex->ack_sack;
+        if (nRF24L01_Send_Async(nrf24, packet, NRF24_DUPLEX_HEADER_SIZE, nRF24_SEND_NO_ACK) > 0){
+            duplex->ack_pending = 0;
+            duplex->acks_pure++;
+        }
+    }
+
+    rt_exit_critical();
+}
+
+
+
+/***
+ * @brief   PTX 一片的 nRF24L01_Run 等待 IRQ 信号量的超时时间
+ * @return  有待发报文或待回的确认时为 1，没有在途报文时为 RT_WAITING_FOREVER，否则为距最早一次超时的 tick 数
+ */
+rt_int32_t nRF24L01_Duplex_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_DUPLEX_STRUCT *duplex = nrf24->duplex;
+    struct nRF24L01_DUPLEX_SEG *seg;
+    rt_int32_t wait = RT_WAITING_FOREVER, left;
+    rt_tick_t  now = rt_tick_get();
+
+    if (duplex == RT_NULL || duplex->tx != nrf24){
+        return RT_WAITING_FOREVER;
+    }
+    if (duplex->ack_pending){
+        return 1;
+    }
+
+    rt_enter_critical();
+    for (rt_uint8_t seq = duplex->snd_una; seq != duplex->snd_nxt; seq++)
+    {
+        seg = DUPLEX_SEG(duplex, seq);
+        if (seg->state == DUPLEX_SEG_QUEUED){
+            wait = 1;
+            break;
+        }
+        if (seg->state == DUPLEX_SEG_INFLIGHT){
+            left = duplex->rto - (rt_int32_t)(now - seg->sent_tick);
+            if (left < 1){
+                left = 1;
+            }
+            if (wait == RT_WAITING_FOREVER || left < wait){
+                wait = left;
+            }
+        }
+    }
+    rt_exit_critical();
+
+    return wait;
+}
+
+
+
+/***
+ * @brief msh 命令：全双工链路统计和吞吐测试
+ * @note  nrf24_duplex                  打印统计
+ *        nrf24_duplex bench [seconds]  连续发送满载报文（缺省 10 秒），结束后打印两个方向的有效吞吐；
+ *                                      两块板子同时执行即为双向同时满载
+ *        nrf24_duplex reset            清零统计，复位窗口（链路两端要同时复位）
+ */
+static void nrf24_duplex_cmd(int argc, char **argv)
+{
+    struct nRF24L01_DUPLEX_STRUCT *duplex;
+
+    if (_nrf24 == RT_NULL || _nrf24->duplex == RT_NULL){
+        rt_kprintf("[nrf24] duplex link not initialized.\r\n");
+        return;
+    }
+    duplex = _nrf24->duplex;
+
+    if (argc > 1 && rt_strcmp(argv[1], "bench") == 0)
+    {
+        rt_uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 10;
+        rt_uint32_t tx_bytes = duplex->tx_acked_bytes, rx_bytes = duplex->rx_bytes;
+        rt_uint32_t retransmits = duplex->retransmits, timeouts = duplex->timeouts;
+        rt_uint8_t  buf[NRF24_DUPLEX_PAYLOAD_SIZE];
+        rt_tick_t   start = rt_tick_get(), used;
+        rt_uint32_t i = 0;
+
+        if (seconds == 0){
+            seconds = 1;
+        }
+        while (rt_tick_get() - start < rt_tick_from_millisecond(seconds * 1000))
+        {
+            rt_memset(buf, (rt_uint8_t)i++, sizeof(buf));
+            if (nRF24L01_Duplex_Send(duplex, buf, sizeof(buf), rt_tick_from_millisecond(1000)) < 0){
+                rt_kprintf("[nrf24] duplex send timeout at %d.\r\n", i);
+                break;
+            }
+        }
+        used = rt_tick_get() - start;
+        if (used == 0){
+            used = 1;
+        }
+        tx_bytes = duplex->tx_acked_bytes - tx_bytes;
+        rx_bytes = duplex->rx_bytes - rx_bytes;
+        rt_kprintf("[nrf24] duplex bench %dms: tx goodput %d B/s, rx goodput %d B/s, retransmits %d, timeouts %d\r\n",
+                   used * 1000 / RT_TICK_PER_SECOND,
+                   tx_bytes * RT_TICK_PER_SECOND / used, rx_bytes * RT_TICK_PER_SECOND / used,
+                   duplex->retransmits - retransmits, duplex->timeouts - timeouts);
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        nRF24L01_Duplex_Reset(duplex);
+        rt_exit_critical();
+    }
+
+    rt_kprintf("[nrf24] duplex %s(ch %d) -> %s(ch %d)\r\n",
+               duplex->tx->name, duplex->tx->nrf24_cfg.rf_ch.rf_ch, duplex->rx->name, duplex->rx->nrf24_cfg.rf_ch.rf_ch);
+    rt_kprintf("        tx: segments %d, acked bytes %d, retransmits %d, timeouts %d, window %d/%d, rto %dms\r\n",
+               duplex->tx_segments, duplex->tx_acked_bytes, duplex->retransmits, duplex->timeouts,
+               (rt_uint8_t)(duplex->snd_nxt - duplex->snd_una), NRF24_DUPLEX_WINDOW,
+               duplex->rto * 1000 / RT_TICK_PER_SECOND);
+    rt_kprintf("        rx: delivered %d (%d bytes), duplicates %d, out of window %d\r\n",
+               duplex->rx_delivered, duplex->rx_bytes, duplex->rx_duplicates, duplex->rx_out_of_window);
+    rt_kprintf("        ack: piggybacked %d, pure %d\r\n", duplex->acks_piggybacked, duplex->acks_pure);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_duplex_cmd, nrf24_duplex, full-duplex link stats [bench <seconds> | reset]);
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-15     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_frag.h"
+
+
+
+/***
+ * @brief   初始化分片 / 重组层
+ */
+void nRF24L01_Frag_Init(nrf24_t nrf24)
+{
+    rt_memset(&nrf24->frag, 0, sizeof(struct nRF24L01_FRAG_STRUCT));
+}
+
+
+
+/***
+ * @brief   把一条消息拆成带编号的分片，逐个放入软件发送队列
+ * @param   msg/len   消息内容，1 ~ NRF24_FRAG_MAX_MESSAGE 字节
+ *          ack_mode  nRF24_SEND_NEED_ACK / nRF24_SEND_NO_ACK（PTX 模式）
+ *          timeout   发送队列满时最长等待的 tick 数，RT_WAITING_FOREVER 为一直等待
+ * @return  RT_EOK      全部分片已入队，各分片的发送结果通过 nrf24l01_tx_done 回调上报
+ *          -RT_EINVAL  参数错误
+ *          -RT_ENOSYS  未启用
+ *          -RT_ETIMEOUT 等待发送队列超时，已入队的分片仍会发出，接收端会因跳号丢弃整条消息
+ * @note    队列满时会让出 CPU 等待 nRF24L01_Run 把分片写入芯片，因此不能在 nRF24L01 服务线程中调用
+ */
+int nRF24L01_Frag_Send(nrf24_t nrf24, const uint8_t *msg, rt_uint16_t len, ack_mode_et ack_mode, rt_int32_t timeout)
+{
+    uint8_t     packet[32];
+    rt_uint16_t offset = 0;
+    rt_uint8_t  index = 0, chunk, msg_id;
+    rt_tick_t   start = rt_tick_get();
+    int         result;
+
+    if (!NRF24_USE_FRAG){
+        return -RT_ENOSYS;
+    }
+    if (len == 0 || len > NRF24_FRAG_MAX_MESSAGE){
+        return -RT_EINVAL;
+    }
+
+    msg_id = nrf24->frag.tx_msg_id++ & NRF24_FRAG_ID_MASK;
+
+    while (offset < len)
+    {
+        chunk = (len - offset > NRF24_FRAG_PAYLOAD_SIZE) ? NRF24_FRAG_PAYLOAD_SIZE : (len - offset);
+
+        packet[0] = NRF24_FRAG_MARK | msg_id;
+        if (offset + chunk >= len){
+            packet[0] |= NRF24_FRAG_LAST;
+        }
+        packet[1] = index;
+        rt_memcpy(&packet[NRF24_FRAG_HEADER_SIZE], &msg[offset], chunk);
+
+        for (;;)
+        {
+            result = nRF24L01_Send_Async(nrf24, packet, chunk + NRF24_FRAG_HEADER_SIZE, ack_mode);
+            if (result != -RT_EFULL){
+                break;
+            }
+            if (timeout != RT_WAITING_FOREVER && (rt_int32_t)(rt_tick_get() - start) >= timeout){
+                return -RT_ETIMEOUT;
+            }
+            rt_thread_delay(1);
+        }
+        if (result < 0){
+            return result;
+        }
+
+        offset += chunk;
+        index++;
+    }
+
+    return RT_EOK;
+}
+
+
+
+/***
+ * @brief   接收方向：如果数据包是分片，则放入重组池，收齐后通过 nrf24l01_msg_ind 回调上报整条消息
+ * @return  1 : 数据包是分片，已由本层处理   0 : 不是分片，由调用者按普通数据包处理
+ * @note    同一管道上的分片按顺序到达（芯片自动重发 + PID 去重），因此只接受序号连续的分片：
+ *          重复的分片丢弃，跳号说明有分片丢失，整条消息作废；
+ *          只在 nRF24L01 服务线程中调用，回调返回前重组缓冲区保持有效
+ */
+int nRF24L01_Frag_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_FRAG_STRUCT *frag = &nrf24->frag;
+    struct nRF24L01_REASM_SLOT  *slot = RT_NULL, *oldest = RT_NULL, *s;
+    rt_uint8_t  msg_id, index, chunk;
+    rt_tick_t   now = rt_tick_get();
+    rt_tick_t   timeout = rt_tick_from_millisecond(NRF24_FRAG_TIMEOUT_MS);
+
+    if (!NRF24_USE_FRAG || len < NRF24_FRAG_HEADER_SIZE || (data[0] & NRF24_FRAG_MARK_MASK) != NRF24_FRAG_MARK){
+        return 0;
+    }
+
+    msg_id = data[0] & NRF24_FRAG_ID_MASK;
+    index  = data[1];
+    chunk  = len - NRF24_FRAG_HEADER_SIZE;
+
+    // 1. 回收超时的槽位，同时查找该分片所属的消息
+    for (rt_uint8_t i = 0; i < NRF24_FRAG_POOL_SIZE; i++)
+    {
+        s = &frag->slot[i];
+        if (s->used == 0){
+            continue;
+        }
+        if (now - s->last_tick >= timeout){
+            s->used = 0;
+            frag->timeouts++;
+        }
+        else if (s->pipe == pipe && s->msg_id == msg_id){
+            slot = s;
+        }
+        else if (s->pipe == pipe && index == 0){
+            /* 同一管道开始了新消息，旧消息的剩余分片不会再到达 */
+            s->used = 0;
+            frag->aborts++;
+        }
+    }
+
+    // 2. 第一个分片：分配槽位，重组池已满时淘汰最久未更新的消息
+    if (slot == RT_NULL)
+    {
+        if (index != 0){
+            frag->orphans++;
+            return 1;
+        }
+        for (rt_uint8_t i = 0; i < NRF24_FRAG_POOL_SIZE; i++)
+        {
+            s = &frag->slot[i];
+            if (s->used == 0){
+                slot = s;
+                break;
+            }
+            if (oldest == RT_NULL || (now - s->last_tick) > (now - oldest->last_tick)){
+                oldest = s;
+            }
+        }
+        if (slot == RT_NULL){
+            slot = oldest;
+            frag->evictions++;
+        }
+        slot->used       = 1;
+        slot->pipe       = pipe;
+        slot->msg_id     = msg_id;
+        slot->next_index = 0;
+        slot->length     = 0;
+    }
+
+    // 3. 只接受序号连续的分片
+    if (index < slot->next_index){
+        frag->duplicates++;
+        return 1;
+    }
+    if (index != slot->next_index){
+        slot->used = 0;
+        frag->gaps++;
+        return 1;
+    }
+    if (slot->length + chunk > NRF24_FRAG_MAX_MESSAGE){
+        slot->used = 0;
+        frag->oversize++;
+        return 1;
+    }
+
+    rt_memcpy(&slot->buffer[slot->length], &data[NRF24_FRAG_HEADER_SIZE], chunk);
+    slot->length += chunk;
+    slot->next_index++;
+    slot->last_tick = now;
+
+    // 4. 收到最后一个分片，上报整条消息
+    if (data[0] & NRF24_FRAG_LAST)
+    {
+        slot->used = 0;
+        frag->messages++;
+        if (nrf24->nrf24_cb.nrf24l01_msg_ind){
+            nrf24->nrf24_cb.nrf24l01_msg_ind(nrf24, slot->buffer, slot->length, pipe);
+        }
+    }
+
+    return 1;
+}
+
+
+
+/***
+ * @brief msh 命令：查看分片 / 重组统计，或发送一条测试消息
+ * @note  nrf24_frag              打印统计
+ *        nrf24_frag send <len>   发送 len 字节的递增序列（PTX，需要 ACK）
+ *        nrf24_frag reset        打印后清零统计并清空重组池
+ */
+static void nrf24_frag_cmd(int argc, char **argv)
+{
+    struct nRF24L01_FRAG_STRUCT *frag;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    frag = &_nrf24->frag;
+
+    if (argc > 2 && rt_strcmp(argv[1], "send") == 0)
+    {
+        rt_uint16_t len = atoi(argv[2]);
+        rt_uint8_t *msg;
+        int result;
+
+        if (len == 0 || len > NRF24_FRAG_MAX_MESSAGE){
+            rt_kprintf("Usage: nrf24_frag send <1~%d>\r\n", NRF24_FRAG_MAX_MESSAGE);
+            return;
+        }
+        msg = rt_malloc(len);
+        if (msg == RT_NULL){
+            rt_kprintf("[nrf24] no memory.\r\n");
+            return;
+        }
+        for (rt_uint16_t i = 0; i < len; i++){
+            msg[i] = (rt_uint8_t)i;
+        }
+        result = nRF24L01_Frag_Send(_nrf24, msg, len, nRF24_SEND_NEED_ACK, rt_tick_from_millisecond(1000));
+        rt_free(msg);
+        rt_kprintf("[nrf24] send %d bytes in %d fragments, result = %d\r\n",
+                   len, (len + NRF24_FRAG_PAYLOAD_SIZE - 1) / NRF24_FRAG_PAYLOAD_SIZE, result);
+        return;
+    }
+
+    rt_kprintf("[nrf24] frag: messages %d, timeouts %d, evictions %d, aborts %d\r\n",
+               frag->messages, frag->timeouts, frag->evictions, frag->aborts);
+    rt_kprintf("              orphans %d, duplicates %d, gaps %d, oversize %d\r\n",
+               frag->orphans, frag->duplicates, frag->gaps, frag->oversize);
+
+    if (argc > 1 && rt_strcmp(argv[1], "reset") == 0){
+        rt_enter_critical();
+        nRF24L01_Frag_Init(_nrf24);
+        rt_exit_critical();
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_frag_cmd, nrf24_frag, fragmentation stats [send <len> | reset]);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-15     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_FRAG_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_FRAG_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 分片头（2 字节），其后为最多 30 字节数据
+ * byte0 : bit7~6 = 11 分片标记（协议帧以 0x55 开头，不会与之混淆）
+ *         bit5   = 1  最后一个分片
+ *         bit4~0      消息编号，用于区分同一管道上的前后两条消息
+ * byte1 : 分片序号，从 0 开始
+ */
+#define NRF24_FRAG_HEADER_SIZE      2
+#define NRF24_FRAG_PAYLOAD_SIZE     (32 - NRF24_FRAG_HEADER_SIZE)
+#define NRF24_FRAG_MARK             0xC0
+#define NRF24_FRAG_MARK_MASK        0xC0
+#define NRF24_FRAG_LAST             0x20
+#define NRF24_FRAG_ID_MASK          0x1F
+
+
+/***
+ * 分片 / 重组参数
+ * NRF24_USE_FRAG         : 1 -> 启用分片 / 重组；为 0 时本层不认领 11xxxxxx 的包，按普通数据交给应用
+ * NRF24_FRAG_MAX_MESSAGE : 单条消息最大长度，分片序号为 8 位，最多 256 x 30 字节
+ * NRF24_FRAG_POOL_SIZE   : 重组池槽位数，即可同时重组的消息条数
+ * NRF24_FRAG_TIMEOUT_MS  : 消息两个分片之间的最长间隔，超时未收齐则丢弃
+ */
+#define NRF24_USE_FRAG              1
+#define NRF24_FRAG_MAX_MESSAGE      2048
+#define NRF24_FRAG_POOL_SIZE        2
+#define NRF24_FRAG_TIMEOUT_MS       500
+
+#if (NRF24_FRAG_MAX_MESSAGE > 256 * NRF24_FRAG_PAYLOAD_SIZE)
+#error "NRF24_FRAG_MAX_MESSAGE exceeds 256 fragments"
+#endif
+
+
+/***
+ * 重组池槽位
+ */
+struct nRF24L01_REASM_SLOT
+{
+    rt_uint8_t  used;
+    rt_uint8_t  pipe;
+    rt_uint8_t  msg_id;
+    /* 期望收到的下一个分片序号 */
+    rt_uint8_t  next_index;
+    rt_uint16_t length;
+    /* 最近一次收到分片的时刻 */
+    rt_tick_t   last_tick;
+    rt_uint8_t  buffer[NRF24_FRAG_MAX_MESSAGE];
+};
+
+
+/***
+ * 分片 / 重组层
+ */
+struct nRF24L01_FRAG_STRUCT
+{
+    /* 发送方向的消息编号 */
+    rt_uint8_t  tx_msg_id;
+    struct nRF24L01_REASM_SLOT slot[NRF24_FRAG_POOL_SIZE];
+
+    /* 统计计数 */
+    rt_uint32_t messages;       // 重组完成的消息数
+    rt_uint32_t timeouts;       // 超时丢弃
+    rt_uint32_t evictions;      // 重组池已满，淘汰最久未更新的消息
+    rt_uint32_t aborts;         // 同一管道开始了新消息，旧消息不可能再收齐
+    rt_uint32_t orphans;        // 找不到所属消息的分片
+    rt_uint32_t duplicates;     // 重复的分片
+    rt_uint32_t gaps;           // 分片序号跳号，整条消息作废
+    rt_uint32_t oversize;       // 超过 NRF24_FRAG_MAX_MESSAGE
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_FRAG_H_ */
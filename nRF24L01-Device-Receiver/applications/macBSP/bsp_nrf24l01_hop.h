@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-24     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_HOP_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_HOP_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 跳频
+ * PTX 启用跳频时生成种子，由种子从 NRF24_CHAN_MIN~MAX 的偶数信道中随机挑出 NRF24_HOP_CHANNELS 个，其顺序即跳频序列；
+ * 每个驻留期结束，PTX 停止补充数据、等 TX FIFO 发空，在当前信道发 HOP（带下一跳序号、黑名单和种子），
+ * 以 TX_DS / RX_DR 的 IRQ 时刻为基准双方同时跳到下一信道，下一个驻留期从这一刻开始计时；
+ * PRX 按驻留时间自行外推，漏掉 HOP 时照样跳，连续 LOST 跳收不到 HOP 就回到 NRF24_CHAN_HOME 等 PTX（它一整圈 HOP 失败后也回到这里）；
+ * 每个信道的丢包率滑动平均超过 BLACK_PCT 即拉黑，下一个 HOP 起双方都跳过，PAROLE 跳之后放出来重新试
+ *
+ * NRF24_HOP_ENABLE    : 上电后 PTX 是否直接启用跳频（msh nrf24_hop on/off 可随时切换），PRX 始终跟随 HOP
+ * NRF24_HOP_CHANNELS  : 跳频信道数，不超过 32
+ * NRF24_HOP_DWELL_MS  : 每个信道的驻留时间
+ * NRF24_HOP_LATE_US   : PRX 外推下一跳时在驻留时间之外多等的时间，覆盖 PTX 发空 TX FIFO 和 HOP 的重发
+ * NRF24_HOP_DRAIN_US  : PTX 驻留期结束后最多等 TX FIFO 发空的时间，超过就把 FIFO 中的包退回软件队列、按时发 HOP；
+ *                       被干扰的信道上每包都要重发到 MAX_RT，发空 3 包会超过整个驻留期，对端外推早已跳走
+ * NRF24_HOP_MIN_ACTIVE: 至少保留的可用信道数
+ * NRF24_HOP_BLACK_PCT : 丢包率滑动平均达到该值的信道被拉黑
+ * NRF24_HOP_PAROLE    : 被拉黑的信道多少跳之后重新启用
+ * NRF24_HOP_LOST      : PRX 连续多少跳收不到 HOP 就回到 NRF24_CHAN_HOME 停下
+ * NRF24_HOP_IDLE_MS   : PRX 停下后多久仍收不到 HOP 就回到 NRF24_CHAN_HOME 并退出跳频
+ */
+#define NRF24_HOP_ENABLE            0
+#define NRF24_HOP_CHANNELS          16
+#define NRF24_HOP_DWELL_MS          20
+#define NRF24_HOP_LATE_US           3000
+#define NRF24_HOP_DRAIN_US          1500
+#define NRF24_HOP_MIN_ACTIVE        8
+#define NRF24_HOP_BLACK_PCT         40
+#define NRF24_HOP_PAROLE            256
+#define NRF24_HOP_LOST              3
+#define NRF24_HOP_IDLE_MS           3000
+
+#if NRF24_HOP_CHANNELS > 32 || NRF24_HOP_CHANNELS > (NRF24_CHAN_MAX - NRF24_CHAN_MIN) / 2 + 1
+#error "NRF24_HOP_CHANNELS must not exceed 32 or the even channels within NRF24_CHAN_MIN ~ NRF24_CHAN_MAX"
+#endif
+#if NRF24_HOP_DRAIN_US >= NRF24_HOP_LATE_US
+#error "NRF24_HOP_DRAIN_US must be shorter than NRF24_HOP_LATE_US"
+#endif
+#if NRF24_HOP_MIN_ACTIVE < 2 || NRF24_HOP_MIN_ACTIVE > NRF24_HOP_CHANNELS
+#error "NRF24_HOP_MIN_ACTIVE must be 2 ~ NRF24_HOP_CHANNELS"
+#endif
+
+
+/***
+ * HOP 报文
+ * byte0    : 高 4 位 = 0001 跳频标记（信道为 0010，链路自适应为 0011，切换引擎为 0100，轮换为 0110，TDMA 为 0111，
+ *            可靠传输为 10xxxxxx，分片为 11xxxxxx）  低 4 位 报文类型
+ * byte1    : 下一跳在序列中的位置，0xFF 为 NRF24_CHAN_HOME
+ * byte2~5  : 黑名单位图（小端），bit i 对应序列位置 i
+ * byte6~9  : 种子（小端）
+ */
+#define NRF24_HOP_MARK              0x10
+#define NRF24_HOP_HOP               0x01
+#define NRF24_HOP_SIZE              10
+#define NRF24_HOP_HOME_IDX          0xFF
+
+
+/***
+ * 跳频状态
+ * OFF    : 未跳频，停在固定信道
+ * DATA   : PTX，驻留期内照常发送 / PRX，跟随跳频
+ * DRAIN  : PTX，驻留期已到，等 TX FIFO 发空后发 HOP
+ * HOP_TX : PTX，HOP 在途
+ * PARKED : PRX，失去同步，停在 NRF24_CHAN_HOME 等 HOP
+ */
+typedef enum
+{
+    NRF24_HOP_OFF = 0,
+    NRF24_HOP_DATA,
+    NRF24_HOP_DRAIN,
+    NRF24_HOP_HOP_TX,
+    NRF24_HOP_PARKED,
+}nrf24_hop_state_et;
+
+
+/***
+ * 跳频
+ */
+struct nRF24L01_HOP_STRUCT
+{
+    rt_uint8_t  state;
+    rt_uint32_t seed;
+    /* 跳频序列 */
+    rt_uint8_t  ch[NRF24_HOP_CHANNELS];
+    rt_uint32_t black;
+    /* 当前 / 下一跳在序列中的位置 */
+    rt_uint8_t  idx;
+    rt_uint8_t  next;
+    /* 当前驻留期结束（PTX）/ 下一次外推跳频（PRX）的时刻（DWT 周期计数） */
+    rt_uint32_t deadline_cycles;
+
+    /* PTX：当前驻留期的发送 / 失败数，每个信道的丢包率（%）滑动平均和拉黑以来的跳数 */
+    rt_uint16_t slot_tx;
+    rt_uint16_t slot_fail;
+    rt_uint8_t  loss[NRF24_HOP_CHANNELS];
+    rt_uint16_t black_age[NRF24_HOP_CHANNELS];
+    rt_uint8_t  hop_fail;
+
+    /* PRX：收到 HOP 后等自动应答发完再跳；连续外推的跳数 */
+    rt_uint8_t  peer_pending;
+    rt_uint32_t peer_deadline_cycles;
+    rt_uint8_t  missed;
+    rt_tick_t   last_hop_tick;
+
+    /* msh 请求，由射频线程执行：1 启用  2 停用 */
+    volatile rt_uint8_t req;
+
+    /* 统计 */
+    rt_uint32_t hops;
+    rt_uint32_t hops_failed;
+    rt_uint32_t drain_aborted;
+    rt_uint32_t extrapolated;
+    rt_uint32_t blacklisted;
+    rt_uint32_t paroled;
+    rt_uint32_t rendezvous;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_HOP_H_ */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-19     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_HUB_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_HUB_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 星型网络
+ * NRF24_USE_HUB   : 1 -> 本机作为星型网络的中心（PRX），打开全部 6 个管道并使能自动应答，
+ *                   每个管道的应用数据进入独立的接收队列，解码和 nrf24l01_rx_ind 改由中心线程执行
+ * NRF24_NODE_PIPE : 本机作为节点（PTX）时对准中心的哪个管道，发送地址和管道 0 地址都换成该管道的地址，
+ *                   0 为保持原来的地址
+ *
+ * 中心各管道的地址：管道 0 / 1 为完整的 5 字节地址，管道 2~5 只有最低字节独立，其余 4 字节与管道 1 相同
+ */
+#ifndef NRF24_USE_HUB
+#define NRF24_USE_HUB               0
+#endif
+#define NRF24_NODE_PIPE             0
+
+#if NRF24_NODE_PIPE > 5
+#error "NRF24_NODE_PIPE must be 0 ~ 5"
+#endif
+
+
+/***
+ * 中心的接收队列和调度参数
+ * NRF24_HUB_QUEUE_DEPTH : 每个管道的队列深度，必须为 2 的幂
+ * NRF24_HUB_QUANTUM     : 缺省的 DRR 量子（每轮每个管道可消费的字节数），不小于最大包长 32
+ * NRF24_HUB_THREAD_PRIO : 中心线程优先级，低于射频线程，消费者再慢也不会拖住空口
+ */
+#define NRF24_HUB_QUEUE_DEPTH       8
+#define NRF24_HUB_QUANTUM           32
+#define NRF24_HUB_THREAD_PRIO       10
+#define NRF24_HUB_THREAD_STACK      2048
+
+#if (NRF24_HUB_QUEUE_DEPTH & (NRF24_HUB_QUEUE_DEPTH - 1)) || (NRF24_HUB_QUEUE_DEPTH > 128)
+#error "NRF24_HUB_QUEUE_DEPTH must be a power of 2 not greater than 128"
+#endif
+
+
+/***
+ * 管道消费者，运行在中心线程中
+ * 描述符的所有权随调用交给消费者，用完后调用 nRF24L01_Pkt_Free，或用 nRF24L01_Pkt_Deliver 继续交给应用
+ */
+struct nRF24L01_STRUCT;
+struct nRF24L01_PKT_STRUCT;
+typedef void (*nrf24_hub_consumer_t)(struct nRF24L01_STRUCT *nrf24, struct nRF24L01_PKT_STRUCT *pkt);
+
+
+/***
+ * 单个管道的接收队列，只存数据包描述符的指针，排队时延按描述符中的接收时刻统计
+ * put 只由射频线程推进，get 只由中心线程推进，单生产者单消费者无需加锁
+ */
+struct nRF24L01_HUB_PIPE
+{
+    struct nRF24L01_PKT_STRUCT *pkt[NRF24_HUB_QUEUE_DEPTH];
+    volatile rt_uint8_t put;
+    volatile rt_uint8_t get;
+
+    nrf24_hub_consumer_t consumer;
+    rt_uint16_t quantum;
+    rt_uint16_t deficit;
+
+    /* 统计 */
+    rt_uint32_t enqueued;
+    rt_uint32_t delivered;
+    rt_uint32_t dropped;
+    rt_uint32_t bytes;
+    rt_uint8_t  high_water;
+    rt_uint32_t wait_max_us;
+    rt_uint64_t wait_sum_us;
+};
+
+
+/***
+ * 星型网络中心
+ * 中心线程的控制块和栈随实例静态分配，线程和信号量以 "实例名_hub" 命名，多个实例互不冲突
+ */
+struct nRF24L01_HUB_STRUCT
+{
+    struct nRF24L01_HUB_PIPE pipe[6];
+    struct rt_semaphore sem;
+    /* 中心线程已启动时指向 thread_obj，否则为 RT_NULL */
+    rt_thread_t thread;
+    rt_uint32_t rounds;
+#if NRF24_USE_HUB
+    char        name[RT_NAME_MAX];
+    struct rt_thread thread_obj;
+    ALIGN(RT_ALIGN_SIZE)
+    rt_uint8_t  stack[NRF24_HUB_THREAD_STACK];
+#endif
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_HUB_H_ */
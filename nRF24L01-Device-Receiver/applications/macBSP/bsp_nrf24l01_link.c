@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_link.h"
+
+
+#define LINK_SET_IDLE       0
+#define LINK_SET_QUEUED     1
+#define LINK_SET_INFLIGHT   2
+
+static const char *const link_rate_name[3]   = { "250K", "1M", "2M" };
+static const rt_int8_t   link_power_dbm[4]   = { -18, -12, -6, 0 };
+static const rt_uint32_t link_i_tx_ua[4]     = NRF24_LINK_I_TX_UA;
+/* 带 32 字节 ACK 载荷时各速率的最小 ARD（手册 7.4.2） */
+static const rt_uint16_t link_ard_min_us[3]  = { 1500, 500, 500 };
+static const char *const link_reason_name[]  = { "up", "down", "revert", "tune", "lost", "peer", "idle", "manual" };
+
+
+
+/***
+ * @brief   按阶梯速率序号计算空中时间
+ */
+static rt_uint32_t nRF24L01_Link_Air_Us(nrf24_param_t cfg, rt_uint8_t rate, rt_uint8_t payload_len)
+{
+    struct nRF24L01_PARAMETER_STRUCT tmp = *cfg;
+
+    tmp.rf_setup.rf_dr_low  = (rate == NRF24_LINK_250K);
+    tmp.rf_setup.rf_dr_high = (rate == NRF24_LINK_2M);
+    return nRF24L01_Air_Us(&tmp, payload_len);
+}
+
+
+static rt_uint16_t nRF24L01_Link_Ard_Us(struct nRF24L01_LINK_STRUCT *link)
+{
+    rt_uint32_t us = link_ard_min_us[link->rate] + link->ard_extra * 250;
+    return (us > 4000) ? 4000 : us;
+}
+
+
+/***
+ * @brief   把当前窗口折算为效率：送达字节数 / 消耗电荷(mC)
+ * @note    每次尝试 = PLL 建立 + 32 字节数据包（发射电流）；送达的包再加 PLL 建立 + 空应答（接收电流）；
+ *          每次重发前还要以接收电流等待 ARD
+ */
+static rt_uint32_t nRF24L01_Link_Metric(nrf24_t nrf24)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    nrf24_param_t cfg = &nrf24->nrf24_cfg;
+    rt_uint32_t delivered = link->window_tx - link->window_fail;
+    rt_uint32_t attempts  = link->window_tx + link->window_arc;
+    rt_uint64_t charge;
+
+    charge  = (rt_uint64_t)attempts * (NRF24_TURN_SETTLE_US + nRF24L01_Link_Air_Us(cfg, link->rate, 32)) * link_i_tx_ua[link->power];
+    charge += (rt_uint64_t)delivered * (NRF24_TURN_SETTLE_US + nRF24L01_Link_Air_Us(cfg, link->rate, 0)) * NRF24_LINK_I_RX_UA;
+    charge += (rt_uint64_t)link->window_arc * nRF24L01_Link_Ard_Us(link) * NRF24_LINK_I_RX_UA;
+    if(charge == 0){
+        return 0;
+    }
+
+    /* uA * us = pC，字节 / mC = 字节 * 1e9 / pC */
+    return (rt_uint32_t)((rt_uint64_t)delivered * 32 * 1000000000ULL / charge);
+}
+
+
+static void nRF24L01_Link_Reset_Window(struct nRF24L01_LINK_STRUCT *link)
+{
+    link->window_tx = 0;
+    link->window_fail = 0;
+    link->window_arc = 0;
+}
+
+
+/***
+ * @brief   写入新的速率、功率、ARD、ARC，并记入审计日志
+ */
+static void nRF24L01_Link_Apply(nrf24_t nrf24, rt_uint8_t rate, rt_uint8_t power, rt_uint8_t reason)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    struct nRF24L01_LINK_EVENT *ev = &link->log[link->log_put++ % NRF24_LINK_LOG_SIZE];
+    rt_uint16_t arc_x16 = link->window_tx ? (link->window_arc * 16 / link->window_tx) : 0;
+
+    ev->tick       = rt_tick_get();
+    ev->reason     = reason;
+    ev->from_rate  = link->rate;
+    ev->from_power = link->power;
+    ev->to_rate    = rate;
+    ev->to_power   = power;
+    ev->arc_x16    = arc_x16;
+    ev->fails      = link->window_fail;
+
+    link->rate  = rate;
+    link->power = power;
+    ev->arc     = link->arc;
+    ev->ard_us  = nRF24L01_Link_Ard_Us(link);
+
+    cfg->rf_setup.rf_dr_low  = (rate == NRF24_LINK_250K);
+    cfg->rf_setup.rf_dr_high = (rate == NRF24_LINK_2M);
+    cfg->rf_setup.rf_pwr     = power;
+    cfg->setup_retr.ard      = NRF24_ARD_CODE(ev->ard_us);
+    cfg->setup_retr.arc      = link->arc;
+
+    // 改 RF_SETUP 前退出收发，芯片在 Standby 下换速率
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    link->transitions++;
+    nRF24L01_Link_Reset_Window(link);
+
+    LOG_I("LOG:%d. nrf24 link %s: %s/%ddBm -> %s/%ddBm, ard %dus, arc %d (avg retries %d/16, %d failed).",Record.ulog_cnt++,
+          link_reason_name[reason], link_rate_name[ev->from_rate], link_power_dbm[ev->from_power],
+          link_rate_name[rate], link_power_dbm[power], ev->ard_us, ev->arc, arc_x16, ev->fails);
+}
+
+
+/***
+ * @brief   移动到新的 (速率, 功率)：速率不变直接生效，速率改变先排队发 SET
+ * @return  RT_TRUE : 已生效或已排队
+ */
+static rt_bool_t nRF24L01_Link_Move(nrf24_t nrf24, rt_uint8_t rate, rt_uint8_t power, rt_uint8_t reason)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+
+    if(rate != link->rate)
+    {
+        if(NRF24_LINK_RATE_LOCKED || link->set_state != LINK_SET_IDLE){
+            return RT_FALSE;
+        }
+        link->set_rate   = rate;
+        link->set_power  = power;
+        link->set_reason = reason;
+        link->set_state  = LINK_SET_QUEUED;
+        return RT_TRUE;
+    }
+
+    nRF24L01_Link_Apply(nrf24, rate, power, reason);
+    return RT_TRUE;
+}
+
+
+/***
+ * @brief   阶梯上升一级 / 下降一级
+ * @return  RT_FALSE : 已到顶 / 到底
+ */
+static rt_bool_t nRF24L01_Link_Step(nrf24_t nrf24, rt_bool_t up, rt_uint8_t reason)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    rt_uint8_t rate = link->rate, power = link->power;
+
+    if(up){
+        if(power == RF_POWER_0dBm && rate < NRF24_LINK_2M && !NRF24_LINK_RATE_LOCKED){
+            rate++;
+        }
+        else if(power > RF_POWER_N18dBm){
+            power--;
+        }
+        else{
+            return RT_FALSE;
+        }
+    }
+    else{
+        if(power < RF_POWER_0dBm){
+            power++;
+        }
+        else if(rate > NRF24_LINK_250K && !NRF24_LINK_RATE_LOCKED){
+            rate--;
+            power = RF_POWER_0dBm;
+        }
+        else{
+            return RT_FALSE;
+        }
+    }
+
+    return nRF24L01_Link_Move(nrf24, rate, power, reason);
+}
+
+
+/***
+ * @brief   一个窗口结束：记录效率，决定保持、试探升级、降级或退回
+ */
+static void nRF24L01_Link_Evaluate(nrf24_t nrf24)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    rt_uint32_t avg_x16 = link->window_arc * 16 / link->window_tx;
+    rt_uint32_t metric = nRF24L01_Link_Metric(nrf24);
+    rt_uint32_t *m = &link->metric[link->rate][link->power];
+    rt_uint8_t arc, ard_extra;
+
+    *m = (*m == 0) ? metric : (*m * 3 + metric) / 4;
+
+    // 1. ARC 随重发次数伸缩，ARD 在有失败时加长以错开碰撞，干净时收回
+    arc = 4 + (avg_x16 + 7) / 8;
+    arc = (arc > 15) ? 15 : arc;
+    ard_extra = link->ard_extra;
+    if(link->window_fail > 0 && ard_extra < 4){
+        ard_extra++;
+    }
+    else if(avg_x16 <= NRF24_LINK_ARC_UP_X16 && ard_extra > 0){
+        ard_extra--;
+    }
+
+    // 2. 试探的结果：失败或效率低于原状态的 NRF24_LINK_PROBE_PCT% 就退回，冷却时间加倍
+    if(link->probe_from >= 0)
+    {
+        rt_uint8_t from_rate = link->probe_from / 4, from_power = link->probe_from % 4;
+        rt_uint32_t prev = link->metric[from_rate][from_power];
+
+        link->probe_from = -1;
+        if(link->window_fail > 0 || (rt_uint64_t)metric * 100 < (rt_uint64_t)prev * NRF24_LINK_PROBE_PCT){
+            link->probe_backoff = (link->probe_backoff < 64) ? link->probe_backoff * 2 : 64;
+            link->hold = link->probe_backoff;
+            nRF24L01_Link_Move(nrf24, from_rate, from_power, NRF24_LINK_REVERT);
+            return;
+        }
+        link->probe_backoff = 1;
+    }
+
+    link->arc = arc;
+    link->ard_extra = ard_extra;
+
+    // 3. 变差降级，足够好且冷却结束则试探升级，否则只在 ARD / ARC 变化时重写
+    if(link->window_fail >= NRF24_LINK_FAIL_DOWN || avg_x16 >= NRF24_LINK_ARC_DOWN_X16){
+        link->hold = NRF24_LINK_HOLD;
+        if(nRF24L01_Link_Step(nrf24, RT_FALSE, NRF24_LINK_DOWN)){
+            return;
+        }
+    }
+    else if(link->hold == 0 && avg_x16 <= NRF24_LINK_ARC_UP_X16){
+        rt_int8_t from = link->rate * 4 + link->power;
+        if(nRF24L01_Link_Step(nrf24, RT_TRUE, NRF24_LINK_UP)){
+            link->probe_from = from;
+            return;
+        }
+    }
+    else if(link->hold > 0){
+        link->hold--;
+    }
+
+    if(nrf24->nrf24_cfg.setup_retr.arc != link->arc || nrf24->nrf24_cfg.setup_retr.ard != NRF24_ARD_CODE(nRF24L01_Link_Ard_Us(link))){
+        nRF24L01_Link_Apply(nrf24, link->rate, link->power, NRF24_LINK_TUNE);
+        return;
+    }
+    nRF24L01_Link_Reset_Window(link);
+}
+
+
+
+/***
+ * @brief   初始化链路自适应，当前配置在射频线程第一次运行时从参数结构体读取
+ */
+void nRF24L01_Link_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+
+    rt_memset(link, 0, sizeof(struct nRF24L01_LINK_STRUCT));
+    link->enabled = NRF24_LINK_ADAPT;
+    link->probe_from = -1;
+    link->probe_backoff = 1;
+}
+
+
+/***
+ * @brief   PTX 每次 TX_DS / MAX_RT 时采样 OBSERVE_TX（nRF24L01_Run 已读出）
+ * @note    ARC_CNT 为刚完成的一包的重发次数；PLOS_CNT 累计到 15 就不再增加，读到非零即计入总数并通过重写 RF_CH 清零
+ *          多包的 TX_DS 合并为一次时只采样到最后一包
+ * @return  1 : 事件属于 SET，已处理   0 : 交给后面的层
+ */
+int nRF24L01_Link_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    rt_uint8_t observe = nrf24->nrf24_flags.observe_tx;
+    rt_uint8_t arc_cnt = observe & NRF24BITMASK_ARC_CNT;
+    rt_uint8_t plos = (observe & NRF24BITMASK_PLOS_CNT) >> 4;
+
+    if(plos != 0){
+        link->plos_total += plos;
+        nRF24L01_Clear_Observe_TX(nrf24);
+    }
+
+    // 1. SET 已送达对端才切换；失败则保持原速率，本次试探作废
+    if(link->set_state == LINK_SET_INFLIGHT)
+    {
+        link->set_state = LINK_SET_IDLE;
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+            link->probe_from = -1;
+            LOG_W("LOG:%d. nrf24 link: peer did not ack the switch to %s, staying at %s.",Record.ulog_cnt++,
+                  link_rate_name[link->set_rate], link_rate_name[link->rate]);
+        }
+        else{
+            nRF24L01_Link_Apply(nrf24, link->set_rate, link->set_power, link->set_reason);
+        }
+        return 1;
+    }
+
+    // 2. 累计窗口
+    link->tx_total++;
+    link->window_tx++;
+    link->arc_total += arc_cnt;
+    link->window_arc += arc_cnt;
+    if(irq_flags & NRF24BITMASK_MAX_RT){
+        link->fail_total++;
+        link->window_fail++;
+        link->consecutive_fail++;
+    }
+    else{
+        link->consecutive_fail = 0;
+    }
+
+    // 3. 对端可能没跟上速率切换（SET 的应答丢失），连续失败就回到基准速率，对端空闲超时后也会回来
+    if(link->consecutive_fail >= NRF24_LINK_LOST && link->rate != NRF24_LINK_BASE_RATE){
+        link->probe_from = -1;
+        link->consecutive_fail = 0;
+        nRF24L01_Link_Apply(nrf24, NRF24_LINK_BASE_RATE, RF_POWER_0dBm, NRF24_LINK_LOST_PEER);
+        return 0;
+    }
+
+    if(link->enabled && link->window_tx >= NRF24_LINK_WINDOW){
+        nRF24L01_Link_Evaluate(nrf24);
+    }
+
+    return 0;
+}
+
+
+/***
+ * @brief   处理 SET；PRX 顺带记录最后一次收到数据的时刻
+ * @return  1 : SET，已处理   0 : 其它数据
+ */
+int nRF24L01_Link_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+
+    link->last_rx_tick = rt_tick_get();
+    if(NRF24_LINK_RATE_LOCKED || len != NRF24_LINK_SET_SIZE || data[0] != (NRF24_LINK_MARK | NRF24_LINK_SET) || data[2] > NRF24_LINK_2M){
+        return 0;
+    }
+
+    // 自动应答还没发完，切换速率要等应答（最长带 32 字节 ACK 载荷）离开空口
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX)
+    {
+        link->peer_rate = data[2];
+        link->peer_pending = 1;
+        link->peer_deadline_cycles = nRF24L01_Debug_Get_Cycles() + (NRF24_TURN_SETTLE_US + NRF24_TURN_MARGIN_US
+                                   + nRF24L01_Link_Air_Us(&nrf24->nrf24_cfg, link->rate, 32)) * (SystemCoreClock / 1000000U);
+    }
+
+    return 1;
+}
+
+
+/***
+ * @brief   推进链路自适应，在射频线程中调用
+ */
+void nRF24L01_Link_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+
+    // 1. 从参数结构体取得当前配置
+    if(!link->synced){
+        link->rate  = cfg->rf_setup.rf_dr_low ? NRF24_LINK_250K : (cfg->rf_setup.rf_dr_high ? NRF24_LINK_2M : NRF24_LINK_1M);
+        link->power = cfg->rf_setup.rf_pwr;
+        link->arc   = cfg->setup_retr.arc;
+        link->last_rx_tick = rt_tick_get();
+        link->synced = 1;
+    }
+
+    // 2. msh 手动设置
+    if(link->req_pending){
+        link->req_pending = 0;
+        nRF24L01_Link_Move(nrf24, link->req_rate, link->req_power, NRF24_LINK_MANUAL);
+    }
+
+    // 3. PRX：跟随对端的 SET；非基准速率下长时间收不到包则回到基准速率等对端
+    if(cfg->config.prim_rx == ROLE_PRX)
+    {
+        if(link->peer_pending && (rt_int32_t)(nRF24L01_Debug_Get_Cycles() - link->peer_deadline_cycles) >= 0){
+            link->peer_pending = 0;
+            if(link->peer_rate != link->rate){
+                nRF24L01_Link_Apply(nrf24, link->peer_rate, link->power, NRF24_LINK_PEER);
+            }
+            link->last_rx_tick = rt_tick_get();
+        }
+        if(link->rate != NRF24_LINK_BASE_RATE && rt_tick_get() - link->last_rx_tick >= rt_tick_from_millisecond(NRF24_LINK_IDLE_MS)){
+            nRF24L01_Link_Apply(nrf24, NRF24_LINK_BASE_RATE, link->power, NRF24_LINK_IDLE);
+            link->last_rx_tick = rt_tick_get();
+        }
+        return;
+    }
+
+    // 4. PTX：芯片 TX FIFO 里的数据发完后以旧速率发 SET
+    if(link->set_state == LINK_SET_QUEUED && nrf24->tx_queue.sent == nrf24->tx_queue.done && !nRF24L01_Turn_Busy(nrf24)
+       && !nRF24L01_Chan_Busy(nrf24) && !nRF24L01_Hop_Busy(nrf24))
+    {
+        rt_uint8_t frame[NRF24_LINK_SET_SIZE] = { NRF24_LINK_MARK | NRF24_LINK_SET, ++link->seq, link->set_rate };
+
+        nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, sizeof(frame));
+        link->set_state = LINK_SET_INFLIGHT;
+    }
+}
+
+
+/***
+ * @brief   SET 排队或在途时暂停从软件队列补充数据，SET 前后的数据包都以确定的速率发送
+ */
+rt_bool_t nRF24L01_Link_Tx_Allowed(nrf24_t nrf24)
+{
+    return (nrf24->link.set_state == LINK_SET_IDLE) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   射频线程等待 IRQ 信号量的超时：PRX 等待切换时刻或空闲超时
+ */
+rt_int32_t nRF24L01_Link_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    rt_int32_t left;
+
+    if(link->peer_pending || link->req_pending || link->set_state == LINK_SET_QUEUED){
+        return 1;
+    }
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX && link->rate != NRF24_LINK_BASE_RATE){
+        left = (rt_int32_t)(link->last_rx_tick + rt_tick_from_millisecond(NRF24_LINK_IDLE_MS) - rt_tick_get());
+        return (left > 0) ? left : 1;
+    }
+    return RT_WAITING_FOREVER;
+}
+
+
+
+/***
+ * @brief   手动设置速率和功率，由射频线程执行；速率改变时 PTX 先发 SET 与对端协商
+ * @param   rate   NRF24_LINK_250K / NRF24_LINK_1M / NRF24_LINK_2M
+ *          power  nrf24_power_et
+ * @return  RT_EOK : 已提交   -RT_EINVAL : 参数错误
+ *          -RT_ERROR : PRX 的速率跟随对端，或组网时速率已锁定，只能改功率
+ */
+int nRF24L01_Link_Set(nrf24_t nrf24, rt_uint8_t rate, rt_uint8_t power)
+{
+    struct nRF24L01_LINK_STRUCT *link = &nrf24->link;
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    rt_uint8_t cur = cfg->rf_setup.rf_dr_low ? NRF24_LINK_250K : (cfg->rf_setup.rf_dr_high ? NRF24_LINK_2M : NRF24_LINK_1M);
+
+    if(rate > NRF24_LINK_2M || power > RF_POWER_0dBm){
+        return -RT_EINVAL;
+    }
+    if(rate != cur && (NRF24_LINK_RATE_LOCKED || cfg->config.prim_rx != ROLE_PTX)){
+        return -RT_ERROR;
+    }
+
+    link->req_rate  = rate;
+    link->req_power = power;
+    link->req_pending = 1;
+    nRF24L01_Wakeup(nrf24);
+
+    return RT_EOK;
+}
+
+
+
+/***
+ * @brief msh 命令：链路自适应状态和审计日志
+ * @note  nrf24_link                        打印状态、各状态的效率和最近的状态变化
+ *        nrf24_link on | off               启用 / 停用自适应
+ *        nrf24_link set <kbps> <dBm>       手动设置速率（250/1000/2000）和功率（-18/-12/-6/0）
+ *        nrf24_link reset                  清零统计和效率记录
+ */
+static void nrf24_link_cmd(int argc, char **argv)
+{
+    struct nRF24L01_LINK_STRUCT *link;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    link = &_nrf24->link;
+
+    if (argc > 1 && rt_strcmp(argv[1], "on") == 0)
+    {
+        link->enabled = 1;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "off") == 0)
+    {
+        link->enabled = 0;
+    }
+    else if (argc > 3 && rt_strcmp(argv[1], "set") == 0)
+    {
+        int kbps = atoi(argv[2]), dbm = atoi(argv[3]);
+        rt_uint8_t power;
+
+        for (power = 0; power < 4 && link_power_dbm[power] != dbm; power++);
+        if ((kbps != 250 && kbps != 1000 && kbps != 2000) || power >= 4){
+            rt_kprintf("[nrf24] rate 250/1000/2000, power -18/-12/-6/0.\r\n");
+            return;
+        }
+        if (nRF24L01_Link_Set(_nrf24, (kbps == 250) ? NRF24_LINK_250K : ((kbps == 1000) ? NRF24_LINK_1M : NRF24_LINK_2M), power) != RT_EOK){
+            rt_kprintf("[nrf24] rate follows the peer on PRX or is locked, only power can change.\r\n");
+            return;
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        link->tx_total = link->fail_total = link->arc_total = link->plos_total = 0;
+        link->transitions = 0;
+        link->log_put = 0;
+        rt_memset(link->log, 0, sizeof(link->log));
+        rt_memset(link->metric, 0, sizeof(link->metric));
+        rt_exit_critical();
+    }
+
+    rt_kprintf("[nrf24] link adapt %s%s: %s/%ddBm, ard %dus, arc %d, hold %d, %s\r\n",
+               link->enabled ? "on" : "off", NRF24_LINK_RATE_LOCKED ? " (rate locked)" : "",
+               link_rate_name[link->rate], link_power_dbm[link->power], nRF24L01_Link_Ard_Us(link), link->arc,
+               link->hold, (link->probe_from >= 0) ? "probing" : "steady");
+    rt_kprintf("  %d sent, %d failed, %d retries, %d lost (PLOS), %d transitions\r\n",
+               link->tx_total, link->fail_total, link->arc_total, link->plos_total, link->transitions);
+    rt_kprintf("  B/mC     -18dBm  -12dBm   -6dBm    0dBm\r\n");
+    for (rt_uint8_t r = 0; r < 3; r++)
+    {
+        rt_kprintf("  %-5s %8d%8d%8d%8d\r\n", link_rate_name[r],
+                   link->metric[r][0], link->metric[r][1], link->metric[r][2], link->metric[r][3]);
+    }
+
+    rt_kprintf("  tick       reason  from        to          ard    arc  retries/16  failed\r\n");
+    for (rt_uint8_t i = 0; i < NRF24_LINK_LOG_SIZE; i++)
+    {
+        struct nRF24L01_LINK_EVENT *ev = &link->log[(rt_uint8_t)(link->log_put + i) % NRF24_LINK_LOG_SIZE];
+        if (ev->tick == 0){
+            continue;
+        }
+        rt_kprintf("  %-10d %-7s %4s/%3ddBm %4s/%3ddBm %5dus %3d %8d %8d\r\n", ev->tick, link_reason_name[ev->reason],
+                   link_rate_name[ev->from_rate], link_power_dbm[ev->from_power],
+                   link_rate_name[ev->to_rate], link_power_dbm[ev->to_power],
+                   ev->ard_us, ev->arc, ev->arc_x16, ev->fails);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_link_cmd, nrf24_link, adaptive rate power ard arc [on | off | set <kbps> <dBm> | reset]);
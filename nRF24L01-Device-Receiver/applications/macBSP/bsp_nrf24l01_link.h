@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_LINK_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_LINK_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 链路自适应
+ * PTX 每发完一包读一次 OBSERVE_TX，按窗口统计重发次数和失败数，在 (速率, 功率) 阶梯上移动：
+ *   升一级（更省电）: 0dBm 时先提速 250K -> 1M -> 2M，已是最高速率则降功率
+ *   降一级（更稳健）: 先升功率，已是 0dBm 则降速
+ * 升级是试探：下一个窗口的 "每库仑送达字节数" 比原状态差就退回，并加倍冷却时间
+ * 速率需要双方一致，先以旧速率向对端发 SET，收到自动应答后双方各自切换；功率、ARD、ARC 只影响本机，直接生效
+ *
+ * NRF24_LINK_ADAPT       : 上电时是否启用自适应（msh nrf24_link on/off 可随时切换），对端跟随 SET 不受此开关影响
+ * NRF24_LINK_WINDOW      : 每个评估窗口的发送次数
+ * NRF24_LINK_ARC_UP_X16  : 窗口内平均重发次数（x16）不超过该值才试探升级
+ * NRF24_LINK_ARC_DOWN_X16: 窗口内平均重发次数（x16）达到该值降级
+ * NRF24_LINK_FAIL_DOWN   : 窗口内失败（MAX_RT）达到该值降级
+ * NRF24_LINK_PROBE_PCT   : 试探后的效率不低于原状态的百分比才保留
+ * NRF24_LINK_HOLD        : 降级后至少等待多少个窗口才再试探升级
+ * NRF24_LINK_LOST        : PTX 连续失败多少包后直接回到基准速率
+ * NRF24_LINK_IDLE_MS     : PRX 在非基准速率下多久收不到任何包就回到基准速率，双方以此重新会合
+ */
+#define NRF24_LINK_ADAPT            0
+#define NRF24_LINK_WINDOW           32
+#define NRF24_LINK_ARC_UP_X16       4
+#define NRF24_LINK_ARC_DOWN_X16     48
+#define NRF24_LINK_FAIL_DOWN        2
+#define NRF24_LINK_PROBE_PCT        90
+#define NRF24_LINK_HOLD             4
+#define NRF24_LINK_LOST             3
+#define NRF24_LINK_IDLE_MS          2000
+
+/* 多节点组网时其它节点不会跟着换速率，只调功率、ARD、ARC */
+#define NRF24_LINK_RATE_LOCKED      (NRF24_USE_HUB || NRF24_NODE_PIPE != 0 || NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0 || \
+                                     NRF24_ROTATE_NODES > 0 || NRF24_ROTATE_NODE_ID >= 0)
+
+
+/***
+ * 阶梯上的速率序号（与 RF_SETUP 的编码无关），基准为 1Mbps，与 nRF24L01_Param_Config 一致
+ */
+#define NRF24_LINK_250K             0
+#define NRF24_LINK_1M               1
+#define NRF24_LINK_2M               2
+#define NRF24_LINK_BASE_RATE        NRF24_LINK_1M
+
+
+/***
+ * 估算电荷用的典型电流(uA)，发射电流按 nrf24_power_et 取值
+ */
+#define NRF24_LINK_I_TX_UA          { 7000, 7500, 9000, 11300 }
+#define NRF24_LINK_I_RX_UA          12300
+
+
+/***
+ * SET 报文
+ * byte0 : 高 4 位 = 0011 链路标记（切换引擎为 0100，轮换为 0110，TDMA 为 0111，可靠传输为 10xxxxxx，分片为 11xxxxxx）
+ *         低 4 位        报文类型
+ * byte1 : 序号
+ * byte2 : 新的速率序号
+ */
+#define NRF24_LINK_MARK             0x30
+#define NRF24_LINK_MARK_MASK        0xF0
+#define NRF24_LINK_TYPE_MASK        0x0F
+#define NRF24_LINK_SET              0x01
+#define NRF24_LINK_SET_SIZE         3
+
+
+/***
+ * 状态变化的原因
+ */
+typedef enum
+{
+    NRF24_LINK_UP = 0,      /* 窗口良好，试探升级 */
+    NRF24_LINK_DOWN,        /* 重发多或失败，降级 */
+    NRF24_LINK_REVERT,      /* 试探后效率变差，退回 */
+    NRF24_LINK_TUNE,        /* 只调整 ARD / ARC */
+    NRF24_LINK_LOST_PEER,   /* PTX 连续失败，回到基准速率 */
+    NRF24_LINK_PEER,        /* PRX 跟随对端的 SET */
+    NRF24_LINK_IDLE,        /* PRX 长时间收不到包，回到基准速率 */
+    NRF24_LINK_MANUAL,      /* msh 手动设置 */
+}nrf24_link_reason_et;
+
+
+/***
+ * 审计日志：最近 NRF24_LINK_LOG_SIZE 次状态变化
+ */
+#define NRF24_LINK_LOG_SIZE         16
+
+struct nRF24L01_LINK_EVENT
+{
+    rt_tick_t   tick;
+    rt_uint8_t  reason;
+    rt_uint8_t  from_rate;
+    rt_uint8_t  from_power;
+    rt_uint8_t  to_rate;
+    rt_uint8_t  to_power;
+    rt_uint8_t  arc;
+    rt_uint16_t ard_us;
+    /* 触发时窗口内的平均重发次数(x16)和失败数 */
+    rt_uint16_t arc_x16;
+    rt_uint16_t fails;
+};
+
+
+/***
+ * 链路自适应
+ */
+struct nRF24L01_LINK_STRUCT
+{
+    rt_uint8_t  enabled;
+    /* 0: 尚未从参数结构体取得当前配置 */
+    rt_uint8_t  synced;
+    rt_uint8_t  rate;
+    rt_uint8_t  power;
+    rt_uint8_t  arc;
+    /* ARD 在速率的最小值之上额外增加的 250us 个数 */
+    rt_uint8_t  ard_extra;
+
+    /* 当前评估窗口 */
+    rt_uint16_t window_tx;
+    rt_uint16_t window_fail;
+    rt_uint32_t window_arc;
+    rt_uint8_t  consecutive_fail;
+    rt_uint8_t  hold;
+    rt_uint8_t  probe_backoff;
+    /* 试探升级前的状态 rate * 4 + power，-1 为不在试探中 */
+    rt_int8_t   probe_from;
+    /* 每个 (速率, 功率) 的效率（字节 / mC）滑动平均 */
+    rt_uint32_t metric[3][4];
+
+    /* PTX：待发 / 在途的 SET */
+    rt_uint8_t  set_state;
+    rt_uint8_t  set_rate;
+    rt_uint8_t  set_power;
+    rt_uint8_t  set_reason;
+    rt_uint8_t  seq;
+
+    /* PRX：收到 SET 后等自动应答发完再切换 */
+    rt_uint8_t  peer_pending;
+    rt_uint8_t  peer_rate;
+    rt_uint32_t peer_deadline_cycles;
+    rt_tick_t   last_rx_tick;
+
+    /* msh 手动设置，由射频线程执行 */
+    volatile rt_uint8_t req_pending;
+    rt_uint8_t  req_rate;
+    rt_uint8_t  req_power;
+
+    /* 统计 */
+    rt_uint32_t tx_total;
+    rt_uint32_t fail_total;
+    rt_uint32_t arc_total;
+    rt_uint32_t plos_total;
+    rt_uint32_t transitions;
+    struct nRF24L01_LINK_EVENT log[NRF24_LINK_LOG_SIZE];
+    rt_uint8_t  log_put;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_LINK_H_ */
@@ -23,6 +23,27 @@
 #define CMD_MINI_LENGTH 4
 
 
+/***
+ * CRC16-Modbus 实现选择，在编译期以 flash 换速度，三种实现结果完全一致
+ * NRF24_CRC16_BITWISE : 逐位计算，不占表空间
+ * NRF24_CRC16_TABLE   : 单字节查表，256 项，512B flash
+ * NRF24_CRC16_SLICE4  : slice-by-4 查表，4 x 256 项，2KB flash，适合长帧
+ */
+#define NRF24_CRC16_BITWISE     0
+#define NRF24_CRC16_TABLE       1
+#define NRF24_CRC16_SLICE4      2
+
+#ifndef NRF24_CRC16_IMPL
+#define NRF24_CRC16_IMPL        NRF24_CRC16_TABLE
+#endif
+
+#if (NRF24_CRC16_IMPL == NRF24_CRC16_SLICE4)
+#define NRF24_CRC16_TABLES      4
+#else
+#define NRF24_CRC16_TABLES      1
+#endif
+
+
 /* 解析指令数据的指令类型以及状态宏 */
 //------------------------------------------------------------------------
 #define       FRAME_HEAD1                                        (0x55)      // 帧头1
@@ -55,12 +76,60 @@ typedef enum
     Decode_Step_3,
     Decode_Step_4,
     Decode_Step_5,
-    Decode_Step_6
+    Decode_Step_6,
+    Decode_Step_7
 }DecodeStep_et;
 
 
 
 
+/***
+ * 帧格式：55 AA | LEN | ID_H ID_L TYPE STATE DATA... | CRC_H CRC_L
+ * LEN 为 ID(2) + 帧类型 + 帧状态 + 数据 的长度，CRC 覆盖 LEN 及其后的 LEN 个字节
+ * FRAME_BUFFER_SIZE  : 解码缓冲区大小，存放 LEN 及其后的数据域
+ * FRAME_MAX_LENGTH   : LEN 的最大合法值，保证数据域不会越过解码缓冲区
+ */
+#define FRAME_BUFFER_SIZE   30
+#define FRAME_MAX_LENGTH    (FRAME_BUFFER_SIZE - 1)
+
+
+/***
+ * 解码出一帧完整数据后的回调
+ * frame  : 与 nrf24l01_protocol_operation 的入参一致，frame[0] 为 LEN，之后为数据域
+ * length : frame 的有效字节数（LEN + 1）
+ */
+typedef void (*nrf24_frame_handler_t)(void *parameter, uint8_t *frame, uint8_t length);
+
+
+/***
+ * 可重入的逐字节流式解码器，每个管道 / 对端各用一个实例
+ * 帧可以跨多个无线数据包，一个数据包中也可以包含多帧
+ */
+struct nRF24L01_DECODER_STRUCT
+{
+    /* 当前解码步骤 */
+    uint8_t step;
+    /* 当前帧的 LEN 字段 */
+    uint8_t length;
+    /* CMD_buffer 中已写入的字节数 */
+    uint8_t count;
+    /* 已收到的 CRC 高字节 */
+    uint8_t crc_h;
+    /* LEN + 数据域 */
+    uint8_t CMD_buffer[FRAME_BUFFER_SIZE];
+
+    /* 统计计数 */
+    rt_uint32_t frames;         // 校验通过的帧数
+    rt_uint32_t crc_errors;     // CRC 校验失败
+    rt_uint32_t length_errors;  // LEN 不合法
+    rt_uint32_t id_errors;      // 设备 ID 不匹配
+    rt_uint32_t sync_drops;     // 寻找帧头时丢弃的字节数
+};
+typedef struct nRF24L01_DECODER_STRUCT *nrf24_decoder_t;
+
+
+
+
 /**
   * @brief  枚举类型,指令码
   * @param  None
@@ -75,9 +144,18 @@ typedef enum
 
 
 uint16_t CrcCalc_Crc16Modbus(uint8_t *dat, uint8_t len);
+uint16_t CrcCalc_Crc16Modbus_Bitwise(const uint8_t *dat, uint8_t len);
+#if (NRF24_CRC16_IMPL != NRF24_CRC16_BITWISE)
+uint16_t CrcCalc_Crc16Modbus_Table(const uint8_t *dat, uint8_t len);
+#endif
+#if (NRF24_CRC16_IMPL == NRF24_CRC16_SLICE4)
+uint16_t CrcCalc_Crc16Modbus_Slice4(const uint8_t *dat, uint8_t len);
+#endif
 rt_uint8_t nrf24l01_build_frame(uint8_t cmd_type, uint8_t cmd_status,uint8_t *data, uint8_t data_len,uint8_t *out_frame);
-uint8_t nrf24l01_portocol_get_command(const uint8_t *cmdBuf,const uint16_t cmdLength);
+void nrf24l01_decoder_init(nrf24_decoder_t decoder);
+uint16_t nrf24l01_decoder_feed(nrf24_decoder_t decoder, const uint8_t *data, uint16_t len, nrf24_frame_handler_t handler, void *parameter);
 void nrf24l01_protocol_operation(uint8_t* CmdBuf);
+void nrf24l01_protocol_handler(void *parameter, uint8_t *frame, uint8_t length);
 
 
 
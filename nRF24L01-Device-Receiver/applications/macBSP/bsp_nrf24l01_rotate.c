@@ -0,0 +1,783 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-20     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_rotate.h"
+
+
+/***
+ * 容量模型中每包额外计入的线程调度与 SPI 时间
+ */
+#define NRF24_ROTATE_MODEL_CPU_US   150
+
+
+
+#if NRF24_ROTATE_NODES > 0
+/***
+ * @brief   中心：把当前时隙表装入管道 1 的 ACK 载荷
+ * @param   tag : 触发这次装载的 SYNC 的节点编号和序号，没有时为 RT_NULL
+ */
+static void nRF24L01_Rotate_Load_Beacon(nrf24_t nrf24, const rt_uint8_t *tag)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+    rt_uint8_t beacon[NRF24_ROTATE_BEACON_SIZE];
+    rt_uint32_t elapsed = (rt_tick_get() - rot->slot_tick) * 1000 / RT_TICK_PER_SECOND;
+    rt_uint16_t remaining = (elapsed < NRF24_ROTATE_SLOT_MS) ? (NRF24_ROTATE_SLOT_MS - elapsed) : 0;
+
+    beacon[0] = NRF24_ROTATE_MARK | NRF24_ROTATE_BEACON;
+    beacon[1] = rot->slot & 0xFF;
+    beacon[2] = rot->slot >> 8;
+    beacon[3] = rot->group;
+    beacon[4] = rot->groups;
+    beacon[5] = NRF24_ROTATE_SLOT_MS & 0xFF;
+    beacon[6] = NRF24_ROTATE_SLOT_MS >> 8;
+    beacon[7] = remaining & 0xFF;
+    beacon[8] = remaining >> 8;
+    beacon[9] = tag ? tag[0] : 0xFF;
+    beacon[10] = tag ? tag[1] : 0xFF;
+
+    nRF24L01_Write_Tx_Payload_InAck(nrf24, NRF24_PIPE_1, beacon, sizeof(beacon));
+    rot->beacons++;
+}
+
+
+/***
+ * @brief   中心：切换到下一组节点
+ * @note    只改管道 2~5 的最低字节，经影子比较后最多写 4 个单字节寄存器
+ */
+static void nRF24L01_Rotate_Next_Slot(nrf24_t nrf24)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    rt_uint8_t *lsb[NRF24_ROTATE_GROUP_SIZE] = { &cfg->rx_addr_p2, &cfg->rx_addr_p3, &cfg->rx_addr_p4, &cfg->rx_addr_p5 };
+
+    rot->slot++;
+    rot->group = (rot->group + 1 >= rot->groups) ? 0 : rot->group + 1;
+    rot->slot_tick = rt_tick_get();
+
+    // 1. 先退出接收再改地址，避免按一半新一半旧的地址匹配
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    for(rt_uint8_t i = 0; i < NRF24_ROTATE_GROUP_SIZE; i++){
+        *lsb[i] = NRF24_ROTATE_LSB_BASE + rot->group * NRF24_ROTATE_GROUP_SIZE + i;
+    }
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
+
+    // 2. TX FIFO 中是给上一组节点的 ACK 载荷，不能让新的一组取走
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    nRF24L01_Rotate_Load_Beacon(nrf24, RT_NULL);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    rot->switches++;
+}
+
+
+static void nRF24L01_Rotate_Slot_Timeout(void *parameter)
+{
+    nrf24_t nrf24 = (nrf24_t)parameter;
+
+    nrf24->rotate.slot_due = 1;
+    nRF24L01_Wakeup(nrf24);
+}
+#endif
+
+
+#if NRF24_ROTATE_NODE_ID >= 0
+/***
+ * @brief   节点：发送地址和管道 0 地址在同步地址（管道 1）和本机数据地址之间切换
+ */
+static void nRF24L01_Rotate_Node_Addr(nrf24_t nrf24, rt_bool_t data_addr)
+{
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+
+    rt_memcpy(cfg->txaddr, cfg->rx_addr_p1, 5);
+    if(data_addr){
+        cfg->txaddr[0] = NRF24_ROTATE_LSB_BASE + nrf24->rotate.node_id;
+    }
+    rt_memcpy(cfg->rx_addr_p0, cfg->txaddr, 5);
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
+
+    nrf24->rotate.on_data_addr = data_addr;
+}
+
+
+/***
+ * @brief   节点：当前时刻在轮换周期中的位置（tick），0 为本组时隙的起点
+ */
+static rt_uint32_t nRF24L01_Rotate_Phase(struct nRF24L01_ROTATE_STRUCT *rot, rt_tick_t now)
+{
+    rt_int32_t diff = (rt_int32_t)(now - rot->window_tick);
+    rt_uint32_t phase;
+
+    if(diff < 0){
+        phase = rot->period_ticks - (rt_uint32_t)(-diff) % rot->period_ticks;
+        phase %= rot->period_ticks;
+    }
+    else{
+        phase = (rt_uint32_t)diff % rot->period_ticks;
+    }
+    return phase;
+}
+
+
+/***
+ * @brief   节点：一包数据连同全部自动重发最多占用多少 tick，拉低 CE 后在途的包最晚在此之后完成
+ */
+static rt_uint32_t nRF24L01_Rotate_Retry_Ticks(nrf24_t nrf24)
+{
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    rt_uint32_t attempt_us = (cfg->setup_retr.ard + 1) * 250 + nRF24L01_Air_Us(cfg, 32) + nRF24L01_Air_Us(cfg, 0)
+                           + 2 * NRF24_TURN_SETTLE_US;
+
+    return rt_tick_from_millisecond(((cfg->setup_retr.arc + 1) * attempt_us + 999) / 1000) + 1;
+}
+
+
+/***
+ * @brief   节点：距离本组时隙的发送窗口（去掉两端保护时间）打开还有多少 tick
+ * @return  0 : 窗口已打开
+ */
+static rt_uint32_t nRF24L01_Rotate_Wait(struct nRF24L01_ROTATE_STRUCT *rot, rt_tick_t now)
+{
+    rt_uint32_t guard = rt_tick_from_millisecond(NRF24_ROTATE_GUARD_MS);
+    rt_uint32_t phase = nRF24L01_Rotate_Phase(rot, now);
+
+    if(phase < guard){
+        return guard - phase;
+    }
+    if(phase + guard < rot->slot_ticks){
+        return 0;
+    }
+    return rot->period_ticks - phase + guard;
+}
+#endif
+
+
+
+/***
+ * @brief   初始化地址轮换，按上电时的角色决定本实例是中心还是节点，须在参数初始化和设置角色之后调用
+ * @note    中心启动时隙定时器，第一个时隙在射频线程第一次运行时开始；
+ *          节点先对准管道 1 同步，拿到时隙表后再换成本机的数据地址
+ */
+void nRF24L01_Rotate_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+    rt_memset(rot, 0, sizeof(struct nRF24L01_ROTATE_STRUCT));
+    rot->node_id = -1;
+
+#if NRF24_ROTATE_NODES > 0
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX)
+    {
+        rot->nodes  = NRF24_ROTATE_NODES;
+        rot->groups = (NRF24_ROTATE_NODES + NRF24_ROTATE_GROUP_SIZE - 1) / NRF24_ROTATE_GROUP_SIZE;
+        rot->group  = rot->groups - 1;
+        rot->slot   = 0xFFFF;
+        rot->slot_due = 1;
+        rt_timer_init(&rot->slot_timer, "nrf24_rot", nRF24L01_Rotate_Slot_Timeout, nrf24,
+                      rt_tick_from_millisecond(NRF24_ROTATE_SLOT_MS), RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_SOFT_TIMER);
+        rt_timer_start(&rot->slot_timer);
+        LOG_I("LOG:%d. %s rotating %d nodes in %d groups, %dms per slot.",Record.ulog_cnt++,
+              nrf24->name, rot->nodes, rot->groups, NRF24_ROTATE_SLOT_MS);
+    }
+#endif
+#if NRF24_ROTATE_NODE_ID >= 0
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX)
+    {
+        struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+
+        rot->node_id = NRF24_ROTATE_NODE_ID;
+        rot->rand = NRF24_ROTATE_NODE_ID * 2654435761UL ^ nRF24L01_Debug_Get_Cycles();
+        rot->next_sync_tick = rt_tick_get();
+        rt_memcpy(cfg->txaddr, cfg->rx_addr_p1, 5);
+        rt_memcpy(cfg->rx_addr_p0, cfg->txaddr, 5);
+    }
+#endif
+}
+
+
+/***
+ * @brief   中心：修改参与轮换的节点数，从下一个时隙起按新的组数轮换
+ * @note    已同步的节点按旧的组数推算时隙，要等它们重新同步后才对得上，一般只在部署或测试时修改
+ * @return  -RT_ENOSYS : 本实例不是轮换中心   -RT_EINVAL : nodes 为 0 或超过 NRF24_ROTATE_MAX_NODES
+ */
+int nRF24L01_Rotate_Set_Nodes(nrf24_t nrf24, rt_uint8_t nodes)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+    if(rot->groups == 0){
+        return -RT_ENOSYS;
+    }
+    if(nodes == 0 || nodes > NRF24_ROTATE_MAX_NODES){
+        return -RT_EINVAL;
+    }
+
+    rt_enter_critical();
+    rot->nodes  = nodes;
+    rot->groups = (nodes + NRF24_ROTATE_GROUP_SIZE - 1) / NRF24_ROTATE_GROUP_SIZE;
+    rt_memset(rot->node, 0, sizeof(rot->node));
+    rt_exit_critical();
+
+    LOG_I("LOG:%d. %s rotating %d nodes in %d groups, %dms per slot.",Record.ulog_cnt++,
+          nrf24->name, rot->nodes, rot->groups, NRF24_ROTATE_SLOT_MS);
+    return RT_EOK;
+}
+
+
+/***
+ * @brief   节点：修改本机编号并重新同步，-1 为退出轮换（地址保持不变，发送不再受时隙限制）
+ * @return  -RT_ENOSYS : 未编译节点部分或本实例不是 PTX   -RT_EINVAL : id 超过 NRF24_ROTATE_MAX_NODES
+ */
+int nRF24L01_Rotate_Set_Node(nrf24_t nrf24, rt_int8_t id)
+{
+#if NRF24_ROTATE_NODE_ID >= 0
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+    if(rot->groups != 0 || nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        return -RT_ENOSYS;
+    }
+    if(id >= NRF24_ROTATE_MAX_NODES){
+        return -RT_EINVAL;
+    }
+
+    // 在飞的 SYNC 仍由 Tx_Event 收尾，射频线程醒来后按新编号重新同步
+    rt_enter_critical();
+    rot->node_id = (id < 0) ? -1 : id;
+    rot->rand = (rt_uint32_t)rot->node_id * 2654435761UL ^ nRF24L01_Debug_Get_Cycles();
+    rot->synced = 0;
+    rot->sync_acked = 0;
+    rot->next_sync_tick = rt_tick_get();
+    rt_exit_critical();
+    nRF24L01_Wakeup(nrf24);
+
+    return RT_EOK;
+#else
+    RT_UNUSED(nrf24);
+    RT_UNUSED(id);
+    return -RT_ENOSYS;
+#endif
+}
+
+
+/***
+ * @brief   处理收到的轮换报文；中心顺带统计管道 2~5 上各节点的数据
+ * @return  1 : 轮换报文，已处理   0 : 其它数据，由调用者继续处理
+ */
+int nRF24L01_Rotate_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    rt_uint8_t type;
+
+    if(len == 0 || (data[0] & NRF24_ROTATE_MARK_MASK) != NRF24_ROTATE_MARK)
+    {
+#if NRF24_ROTATE_NODES > 0
+        struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+        rt_uint8_t id = rot->group * NRF24_ROTATE_GROUP_SIZE + pipe - NRF24_PIPE_2;
+        if(pipe >= NRF24_PIPE_2 && pipe <= NRF24_PIPE_5 && id < rot->nodes){
+            struct nRF24L01_ROTATE_NODE *node = &rot->node[id];
+            rt_tick_t now = rt_tick_get();
+            rt_uint32_t gap = (now - node->last_tick) * 1000 / RT_TICK_PER_SECOND;
+
+            if(node->rx_packets != 0 && gap > node->max_gap_ms){
+                node->max_gap_ms = gap;
+            }
+            node->last_tick = now;
+            node->rx_packets++;
+            node->rx_bytes += len;
+        }
+#endif
+        return 0;
+    }
+    type = data[0] & NRF24_ROTATE_TYPE_MASK;
+
+#if NRF24_ROTATE_NODES == 0 && NRF24_ROTATE_NODE_ID < 0
+    // 没有启用轮换，标记范围内的包按普通数据交给应用
+    RT_UNUSED(type);
+    return 0;
+#endif
+
+    // 1. 中心：信标随这个 SYNC 的自动应答发出去了，马上装入新的，下一个 SYNC 取回的就是最新时隙表；
+    //    处理前又收到别的 SYNC 时 TX FIFO 中已有信标，不再装入，保证最多积压一个
+    if(type == NRF24_ROTATE_SYNC)
+    {
+#if NRF24_ROTATE_NODES > 0
+        if(pipe == NRF24_PIPE_1 && nrf24->rotate.groups != 0
+           && (nRF24L01_Read_Reg_Data(nrf24, NRF24REG_FIFO_STATUS) & NRF24BITMASK_TX_EMPTY)){
+            nRF24L01_Rotate_Load_Beacon(nrf24, (len >= NRF24_ROTATE_SYNC_SIZE) ? &data[1] : RT_NULL);
+        }
+#endif
+        return 1;
+    }
+
+    // 2. 节点：只采用本轮第二个及之后的 SYNC 带回的信标，推算本组时隙的起点后切回数据地址
+    if(type == NRF24_ROTATE_BEACON && len >= NRF24_ROTATE_BEACON_SIZE)
+    {
+#if NRF24_ROTATE_NODE_ID >= 0
+        struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+        rt_uint8_t group  = data[3];
+        rt_uint8_t groups = data[4];
+        rt_uint16_t slot_ms   = data[5] | (data[6] << 8);
+        rt_uint16_t remaining = data[7] | (data[8] << 8);
+        rt_uint8_t mine = rot->node_id / NRF24_ROTATE_GROUP_SIZE;
+        rt_tick_t now = rt_tick_get();
+
+        if(rot->node_id < 0 || rot->sync_acked < 2 || groups == 0 || group >= groups || slot_ms <= 2 * NRF24_ROTATE_GUARD_MS){
+            return 1;
+        }
+        // 只有自己上一个 SYNC 触发装载的信标才新鲜，别的是积压的旧信标，由 Service 退避后重新连发
+        if(data[9] != (rt_uint8_t)rot->node_id || data[10] != (rt_uint8_t)(rot->sync_seq - 1)){
+            return 1;
+        }
+        if(mine >= groups){
+            LOG_W("LOG:%d. nrf24 node %d is not in the %d rotating groups.",Record.ulog_cnt++, rot->node_id, groups);
+            rot->sync_acked = 0;
+            rot->next_sync_tick = now + rt_tick_from_millisecond(slot_ms) * groups;
+            return 1;
+        }
+
+        rot->slot_ticks   = rt_tick_from_millisecond(slot_ms);
+        rot->period_ticks = rot->slot_ticks * groups;
+        /* 当前时隙的起点 = now + 剩余 - 时隙长度，本组在其后第 (mine - group) mod groups 个时隙 */
+        rot->window_tick  = now + rt_tick_from_millisecond(remaining) - rot->slot_ticks
+                          + ((mine + groups - group) % groups) * rot->slot_ticks;
+        rot->resync_tick  = now + rot->period_ticks * NRF24_ROTATE_RESYNC;
+        rot->synced = 1;
+        rot->sync_acked = 0;
+        nRF24L01_Rotate_Node_Addr(nrf24, RT_TRUE);
+#endif
+    }
+
+    return 1;
+}
+
+
+/***
+ * @brief   节点：SYNC 的 TX_DS / MAX_RT
+ * @return  1 : 事件属于 SYNC，已处理   0 : 不是，交给软件发送队列
+ */
+int nRF24L01_Rotate_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+    // 窗口关闭后拉低了 CE，在途的数据包到此完成，交给发送队列统计后 Service 再退回其余的包；
+    // 中心已切到下一组时在途的包会 MAX_RT，此时它还在 TX FIFO 中，连同其余的包一起退回，下个窗口重发，不算失败
+    if(rot->closing && rot->sync_inflight == 0 && (irq_flags & NRF24BITMASK_MAX_RT)){
+        nRF24L01_TxQueue_Rewind(nrf24);
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        rot->closing = 0;
+        rot->rewinds++;
+        return 1;
+    }
+    if(rot->closing == 1){
+        rot->closing = 2;
+    }
+    if(rot->sync_inflight == 0){
+        return 0;
+    }
+    rot->sync_inflight = 0;
+
+    // 中心不在或管道 1 收不到时隔一个时隙再试；成功则下一个 tick 再发一个 SYNC 取回新鲜的信标
+    if(irq_flags & NRF24BITMASK_MAX_RT){
+        nRF24L01_Flush_TX_FIFO(nrf24);
+        rot->sync_acked = 0;
+        rot->sync_failed++;
+        rot->next_sync_tick = rt_tick_get() + rt_tick_from_millisecond(NRF24_ROTATE_SLOT_MS);
+    }
+    else{
+        rot->sync_acked++;
+        rot->next_sync_tick = rt_tick_get() + 1;
+    }
+
+    return 1;
+}
+
+
+/***
+ * @brief   推进地址轮换，在射频线程中调用
+ * @note    中心：时隙到期且收到的包已读走后切换到下一组
+ *          节点：发送窗口关闭时把 TX FIFO 中还没发出的包退回软件队列；
+ *          未同步或到了重新同步的时间，等已写入芯片的数据包发完后换到同步地址发 SYNC
+ */
+void nRF24L01_Rotate_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+#if NRF24_ROTATE_NODES > 0
+    // RX FIFO 中是上一组节点的包，按当前组统计，先读空再切换
+    if(rot->slot_due && nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX && !nRF24L01_Turn_Busy(nrf24)
+       && !(nRF24L01_Read_Status_Register(nrf24) & NRF24BITMASK_RX_DR)){
+        rot->slot_due = 0;
+        nRF24L01_Rotate_Next_Slot(nrf24);
+    }
+#endif
+
+#if NRF24_ROTATE_NODE_ID >= 0
+    rt_tick_t now = rt_tick_get();
+    rt_uint8_t sync[NRF24_ROTATE_SYNC_SIZE] = { NRF24_ROTATE_MARK | NRF24_ROTATE_SYNC, (rt_uint8_t)rot->node_id, 0 };
+
+    if(rot->sync_inflight || nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX || nRF24L01_Turn_Busy(nrf24)){
+        return;
+    }
+
+    // 组内几个节点的 TX FIFO 共用空口，窗口关闭时未必发得完，时隙一换中心不再应答，这些包会 MAX_RT 失败；
+    // 拉低 CE 停止发新包，在途的一包完成（或超过一整轮自动重发的时间）后把其余的退回软件队列，到本组下一个时隙再发，
+    // 与 TDMA 时隙结束时一样；在途的包可能已经到了中心，提前退回会被重发成重复包，
+    // 所以挂起的 TX_DS / MAX_RT 先交给发送队列处理，之后的第一个发送事件才是在途那一包的
+    if(rot->closing == 0 && rot->synced && rot->on_data_addr && nrf24->tx_queue.sent != nrf24->tx_queue.done
+       && nRF24L01_Rotate_Wait(rot, now) != 0 && !(nRF24L01_Read_Status_Register(nrf24) & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT))){
+        nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+        rot->closing = 1;
+        rot->close_deadline = now + nRF24L01_Rotate_Retry_Ticks(nrf24);
+    }
+    if(rot->closing == 1 && (rt_int32_t)(now - rot->close_deadline) >= 0){
+        rot->closing = 2;
+    }
+    if(rot->closing == 2 && !(nRF24L01_Read_Status_Register(nrf24) & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT))){
+        nRF24L01_TxQueue_Rewind(nrf24);
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        rot->closing = 0;
+        rot->rewinds++;
+    }
+    if(rot->closing || rot->node_id < 0){
+        return;
+    }
+
+    if(rot->synced && rot->on_data_addr && (rt_int32_t)(now - rot->resync_tick) < 0){
+        return;
+    }
+    if((rt_int32_t)(now - rot->next_sync_tick) < 0 || nrf24->tx_queue.sent != nrf24->tx_queue.done){
+        return;
+    }
+    // 连发的第二个 SYNC 没有带回自己触发装载的信标：别的节点的 SYNC 插在了中间，随机退避后重新连发两个
+    if(rot->sync_acked >= 2){
+        rot->rand = rot->rand * 1103515245 + 12345;
+        rot->sync_acked = 0;
+        rot->sync_stale++;
+        rot->next_sync_tick = now + 1 + (rot->rand >> 8) % (2 * NRF24_ROTATE_MAX_NODES);
+        return;
+    }
+
+    if(rot->on_data_addr){
+        nRF24L01_Rotate_Node_Addr(nrf24, RT_FALSE);
+    }
+    sync[2] = ++rot->sync_seq;
+    nRF24L01_Write_Tx_Payload_Ack(nrf24, sync, sizeof(sync));
+    rot->sync_inflight = 1;
+    rot->syncs++;
+#else
+    RT_UNUSED(rot);
+#endif
+}
+
+
+/***
+ * @brief   节点：现在能否把软件队列中的数据写入芯片
+ * @note    不参与轮换时总是可以；参与时只在已同步、处于数据地址且在本组时隙的发送窗口内
+ */
+rt_bool_t nRF24L01_Rotate_Tx_Allowed(nrf24_t nrf24)
+{
+#if NRF24_ROTATE_NODE_ID >= 0
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+
+    if(rot->closing){
+        return RT_FALSE;
+    }
+    if(rot->node_id < 0){
+        return RT_TRUE;
+    }
+    if(!rot->synced || !rot->on_data_addr || rot->sync_inflight){
+        return RT_FALSE;
+    }
+    return (nRF24L01_Rotate_Wait(rot, rt_tick_get()) == 0) ? RT_TRUE : RT_FALSE;
+#else
+    return RT_TRUE;
+#endif
+}
+
+
+/***
+ * @brief   射频线程等待 IRQ 信号量的超时：中心第一个时隙未开始时立即运行，
+ *          节点在下一次 SYNC、发送窗口打开或重新同步时醒来
+ */
+rt_int32_t nRF24L01_Rotate_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot = &nrf24->rotate;
+    rt_int32_t timeout = RT_WAITING_FOREVER;
+
+#if NRF24_ROTATE_NODES > 0
+    if(rot->slot_due){
+        return 1;
+    }
+#endif
+
+#if NRF24_ROTATE_NODE_ID >= 0
+    rt_tick_t now = rt_tick_get();
+    rt_int32_t left;
+
+    if(rot->closing){
+        left = (rt_int32_t)(rot->close_deadline - now);
+        return (rot->closing == 2 || left <= 0) ? 1 : left;
+    }
+    if(rot->node_id < 0 || rot->sync_inflight){
+        return RT_WAITING_FOREVER;
+    }
+    if(!rot->synced || !rot->on_data_addr){
+        left = (rt_int32_t)(rot->next_sync_tick - now);
+        return (left > 0) ? left : 1;
+    }
+
+    left = (rt_int32_t)(rot->resync_tick - now);
+    timeout = (left > 0) ? left : 1;
+    left = nRF24L01_Rotate_Wait(rot, now);
+    if(left == 0 && nrf24->tx_queue.sent != nrf24->tx_queue.done){
+        // 窗口关闭时要收回 FIFO 中的包
+        left = rot->slot_ticks - rt_tick_from_millisecond(NRF24_ROTATE_GUARD_MS) - nRF24L01_Rotate_Phase(rot, now);
+    }
+    if(left > 0 && left < timeout){
+        timeout = left;
+    }
+#else
+    RT_UNUSED(rot);
+#endif
+
+    return timeout;
+}
+
+
+
+//以下是容量模型---------------------------------------------------------------------------------------------
+
+struct nRF24L01_ROTATE_MODEL_NODE
+{
+    /* 排队中各包的产生时刻(us) */
+    rt_uint32_t gen[NRF24_TXQ_DEPTH];
+    rt_uint8_t  head;
+    rt_uint8_t  count;
+    rt_uint32_t next_us;
+
+    rt_uint32_t offered;
+    rt_uint32_t delivered;
+    rt_uint32_t dropped;
+    rt_uint32_t worst_us;
+    rt_uint64_t sum_us;
+};
+static struct nRF24L01_ROTATE_MODEL_NODE rotate_model[NRF24_ROTATE_MAX_NODES];
+
+
+/***
+ * @brief   把节点在 until 之前产生的数据包放入队列，队列满则丢弃
+ */
+static void nRF24L01_Rotate_Model_Arrive(struct nRF24L01_ROTATE_MODEL_NODE *n, rt_uint32_t until, rt_uint32_t period_us)
+{
+    while(n->next_us <= until)
+    {
+        n->offered++;
+        if(n->count >= NRF24_TXQ_DEPTH){
+            n->dropped++;
+        }
+        else{
+            n->gen[(n->head + n->count) & (NRF24_TXQ_DEPTH - 1)] = n->next_us;
+            n->count++;
+        }
+        n->next_us += period_us;
+    }
+}
+
+
+/***
+ * @brief   地址轮换的容量模型：不访问射频，按时隙表和空中时间推算总吞吐和每个节点的最坏时延
+ * @note    每个节点每 period_ms 产生一包 32 字节数据（初始相位随机），只在本组时隙去掉两端保护时间的窗口内发送；
+ *          组内节点按队首包的产生时间先后串行占用空口，不计碰撞和重发，每包耗时为 PLL 建立 + 数据包 + 收发切换 + 自动应答
+ *          + NRF24_ROTATE_MODEL_CPU_US；每个节点的队列深度为 NRF24_TXQ_DEPTH，满了丢弃新产生的包
+ */
+static void nRF24L01_Rotate_Model(nrf24_param_t cfg, rt_uint32_t nodes, rt_uint32_t slot_ms, rt_uint32_t period_ms, rt_uint32_t seconds)
+{
+    rt_uint32_t pkt_us = 2 * NRF24_TURN_SETTLE_US + nRF24L01_Air_Us(cfg, 32) + nRF24L01_Air_Us(cfg, 0) + NRF24_ROTATE_MODEL_CPU_US;
+    rt_uint32_t groups = (nodes + NRF24_ROTATE_GROUP_SIZE - 1) / NRF24_ROTATE_GROUP_SIZE;
+    rt_uint32_t slot_us = slot_ms * 1000, guard_us = NRF24_ROTATE_GUARD_MS * 1000;
+    rt_uint32_t period_us = period_ms * 1000, end_us = seconds * 1000000;
+    rt_uint32_t seed = 12345, start, group, t, stop, first, last, next, best;
+    rt_uint32_t offered = 0, delivered = 0, dropped = 0, worst = 0, best_worst = 0xFFFFFFFF, worst_node = 0;
+    rt_uint64_t sum = 0;
+    struct nRF24L01_ROTATE_MODEL_NODE *n;
+
+    rt_memset(rotate_model, 0, sizeof(rotate_model));
+    for(rt_uint32_t i = 0; i < nodes; i++){
+        seed = seed * 1103515245 + 12345;
+        rotate_model[i].next_us = (seed >> 8) % period_us;
+    }
+
+    for(start = 0, group = 0; start < end_us; start += slot_us, group = (group + 1) % groups)
+    {
+        t     = start + guard_us;
+        stop  = start + slot_us - guard_us;
+        first = group * NRF24_ROTATE_GROUP_SIZE;
+        last  = (first + NRF24_ROTATE_GROUP_SIZE < nodes) ? first + NRF24_ROTATE_GROUP_SIZE : nodes;
+
+        while(t + pkt_us <= stop)
+        {
+            // 1. 组内队首包最早产生的节点占用空口
+            best = nodes;
+            for(rt_uint32_t i = first; i < last; i++){
+                n = &rotate_model[i];
+                nRF24L01_Rotate_Model_Arrive(n, t, period_us);
+                if(n->count && (best == nodes || n->gen[n->head] < rotate_model[best].gen[rotate_model[best].head])){
+                    best = i;
+                }
+            }
+
+            // 2. 组内都没有数据，空口空闲到下一包产生
+            if(best == nodes){
+                next = 0xFFFFFFFF;
+                for(rt_uint32_t i = first; i < last; i++){
+                    if(rotate_model[i].next_us < next){
+                        next = rotate_model[i].next_us;
+                    }
+                }
+                if(next >= stop){
+                    break;
+                }
+                t = next;
+                continue;
+            }
+
+            // 3. 发完并收到自动应答才算送达，时延从产生算起
+            t += pkt_us;
+            n = &rotate_model[best];
+            next = t - n->gen[n->head];
+            n->head = (n->head + 1) & (NRF24_TXQ_DEPTH - 1);
+            n->count--;
+            n->delivered++;
+            n->sum_us += next;
+            if(next > n->worst_us){
+                n->worst_us = next;
+            }
+        }
+    }
+
+    for(rt_uint32_t i = 0; i < nodes; i++)
+    {
+        n = &rotate_model[i];
+        nRF24L01_Rotate_Model_Arrive(n, end_us, period_us);
+        offered   += n->offered;
+        delivered += n->delivered;
+        dropped   += n->dropped;
+        sum       += n->sum_us;
+        if(n->worst_us > worst){
+            worst = n->worst_us;
+            worst_node = i;
+        }
+        if(n->worst_us < best_worst){
+            best_worst = n->worst_us;
+        }
+    }
+
+    rt_kprintf("  %5d %6d %9d %9d %8d %10d %9d %12d/%d(n%d)\r\n", nodes, groups,
+               offered * 32 / seconds, delivered * 32 / seconds, dropped,
+               delivered ? (rt_uint32_t)(sum / delivered / 1000) : 0,
+               best_worst / 1000, worst / 1000, period_ms, worst_node);
+}
+
+
+
+/***
+ * @brief msh 命令：地址轮换状态和容量模型
+ * @note  nrf24_rotate                                              打印中心各节点 / 节点同步状态
+ *        nrf24_rotate model [nodes] [slot_ms] [period_ms] [seconds] 运行容量模型，nodes 省略或为 0 时从 4 扫描到最大节点数
+ *        nrf24_rotate nodes <n>                                    中心：修改参与轮换的节点数
+ *        nrf24_rotate id <n>                                       节点：修改本机编号并重新同步，-1 为退出轮换
+ *        nrf24_rotate reset                                        清零统计
+ */
+static void nrf24_rotate_cmd(int argc, char **argv)
+{
+    struct nRF24L01_ROTATE_STRUCT *rot;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    rot = &_nrf24->rotate;
+
+    if (argc > 1 && rt_strcmp(argv[1], "model") == 0)
+    {
+        rt_uint32_t nodes   = (argc > 2) ? atoi(argv[2]) : 0;
+        rt_uint32_t slot_ms = (argc > 3) ? atoi(argv[3]) : NRF24_ROTATE_SLOT_MS;
+        rt_uint32_t period  = (argc > 4) ? atoi(argv[4]) : 100;
+        rt_uint32_t seconds = (argc > 5) ? atoi(argv[5]) : 60;
+
+        if (nodes > NRF24_ROTATE_MAX_NODES || slot_ms <= 2 * NRF24_ROTATE_GUARD_MS || period == 0 || seconds == 0 || seconds > 600){
+            rt_kprintf("[nrf24] nodes <= %d, slot_ms > %d, period_ms > 0, seconds 1~600.\r\n",
+                       NRF24_ROTATE_MAX_NODES, 2 * NRF24_ROTATE_GUARD_MS);
+            return;
+        }
+        rt_kprintf("[nrf24] rotation model: %dms slot, %dms guard, one 32B packet per %dms per node, %ds\r\n",
+                   slot_ms, NRF24_ROTATE_GUARD_MS, period, seconds);
+        rt_kprintf("  nodes groups offer(B/s) thru(B/s)  dropped avg lat(ms) best worst(ms)  worst lat(ms)/period\r\n");
+        if (nodes != 0){
+            nRF24L01_Rotate_Model(&_nrf24->nrf24_cfg, nodes, slot_ms, period, seconds);
+            return;
+        }
+        for (nodes = NRF24_ROTATE_GROUP_SIZE; nodes <= NRF24_ROTATE_MAX_NODES; nodes += NRF24_ROTATE_GROUP_SIZE){
+            nRF24L01_Rotate_Model(&_nrf24->nrf24_cfg, nodes, slot_ms, period, seconds);
+        }
+        return;
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "nodes") == 0)
+    {
+        int nodes = atoi(argv[2]);
+
+        if (nodes <= 0 || nodes > NRF24_ROTATE_MAX_NODES || nRF24L01_Rotate_Set_Nodes(_nrf24, nodes) != RT_EOK){
+            rt_kprintf("[nrf24] %s is not a rotating hub, or nodes not 1~%d.\r\n", _nrf24->name, NRF24_ROTATE_MAX_NODES);
+            return;
+        }
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "id") == 0)
+    {
+        int id = atoi(argv[2]);
+
+        if (id < -1 || id >= NRF24_ROTATE_MAX_NODES || nRF24L01_Rotate_Set_Node(_nrf24, id) != RT_EOK){
+            rt_kprintf("[nrf24] %s is not a rotating node, or id not -1~%d.\r\n", _nrf24->name, NRF24_ROTATE_MAX_NODES - 1);
+            return;
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        rt_memset(rot->node, 0, sizeof(rot->node));
+        rot->switches = rot->beacons = 0;
+        rot->syncs = rot->sync_failed = rot->sync_stale = rot->rewinds = 0;
+        rt_exit_critical();
+    }
+
+    if (rot->groups != 0)
+    {
+        rt_kprintf("[nrf24] hub rotating %d nodes: slot %d, group %d/%d, %d switches, %d beacons\r\n",
+                   rot->nodes, rot->slot, rot->group, rot->groups, rot->switches, rot->beacons);
+        rt_kprintf("  node addr  packets    bytes  max gap(ms)\r\n");
+        for (rt_uint8_t i = 0; i < rot->nodes; i++)
+        {
+            struct nRF24L01_ROTATE_NODE *node = &rot->node[i];
+            rt_kprintf("  %4d 0x%02x %8d %8d %12d\r\n", i, NRF24_ROTATE_LSB_BASE + i,
+                       node->rx_packets, node->rx_bytes, node->max_gap_ms);
+        }
+    }
+    else if (rot->node_id >= 0)
+    {
+        rt_kprintf("[nrf24] node %d (group %d, pipe %d): %s, %d syncs, %d failed, %d stale, %d rewound at window close, window %s\r\n",
+                   rot->node_id, rot->node_id / NRF24_ROTATE_GROUP_SIZE,
+                   NRF24_PIPE_2 + rot->node_id % NRF24_ROTATE_GROUP_SIZE,
+                   rot->synced ? "synced" : "unsynced", rot->syncs, rot->sync_failed, rot->sync_stale, rot->rewinds,
+                   nRF24L01_Rotate_Tx_Allowed(_nrf24) ? "open" : "closed");
+    }
+    else
+    {
+        rt_kprintf("[nrf24] address rotation off.\r\n");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_rotate_cmd, nrf24_rotate, address rotation status and capacity model [model [nodes] [slot_ms] [period_ms] [seconds] | nodes <n> | id <n> | reset]);
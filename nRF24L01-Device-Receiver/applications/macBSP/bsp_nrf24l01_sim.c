@@ -0,0 +1,1302 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-17     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_sim.h"
+
+
+#if NRF24_USE_SIMULATOR
+
+/* 虚拟空口以及上面的全部节点，每个驱动实例占用一个节点 */
+static struct nRF24L01_SIM_ETHER nrf24_sim;
+/* 1 个 tick 推进一次模型时间，保证驱动阻塞等待时事件和 IRQ 照常产生 */
+static struct rt_timer nrf24_sim_timer;
+#ifdef RT_USING_HWTIMER
+/* 事件定时器，下一个发射阶段早于下一个 tick 时按 us 推进 */
+static rt_device_t nrf24_sim_hwtimer;
+#endif
+
+/* nrf24_sim node 加入的实例及其射频线程，全部静态分配，节点 0 始终留给 nrf24l01_task.c 的实例 */
+static const struct nRF24L01_HW_CFG sim_hw = { .spi_bus = "sim" };
+static struct nRF24L01_STRUCT sim_radio[NRF24_SIM_NODES - 1];
+static char sim_radio_name[NRF24_SIM_NODES - 1][RT_NAME_MAX];
+static struct rt_thread sim_thread[NRF24_SIM_NODES - 1];
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t sim_thread_stack[NRF24_SIM_NODES - 1][NRF24_SIM_THREAD_STACK];
+static rt_uint8_t sim_radio_count;
+
+static const char * const sim_peer_name[] = { "off", "sink", "echo", "source" };
+
+
+
+//以下是模型的时间和寄存器---------------------------------------------------------------------------------------------
+
+/***
+ * @brief 模型时间（us），由 tick 计数加上 SysTick 当前计数值得到
+ * @note  不依赖 DWT，nRF24L01_Debug_Init 清零 CYCCNT 不会让模型时间跳变
+ */
+static rt_uint64_t nRF24L01_Sim_Now_Us(void)
+{
+    rt_tick_t tick;
+    rt_uint32_t val;
+    rt_uint64_t now;
+
+    do{
+        tick = rt_tick_get();
+        val  = SysTick->VAL;
+    }while(tick != rt_tick_get());
+
+    now = (rt_uint64_t)tick * (1000000U / RT_TICK_PER_SECOND) + (SysTick->LOAD - val) / (SystemCoreClock / 1000000U);
+    if(now < nrf24_sim.now_us){
+        now = nrf24_sim.now_us;
+    }
+
+    return now;
+}
+
+
+/***
+ * @brief 芯片上电复位后的寄存器值
+ */
+static void nRF24L01_Sim_Reset_Chip(struct nRF24L01_SIM_CHIP *chip)
+{
+    rt_memset(chip, 0, sizeof(struct nRF24L01_SIM_CHIP));
+
+    chip->reg[NRF24REG_CONFIG]     = 0x08;
+    chip->reg[NRF24REG_EN_AA]      = 0x3F;
+    chip->reg[NRF24REG_EN_RXADDR]  = 0x03;
+    chip->reg[NRF24REG_SETUP_AW]   = 0x03;
+    chip->reg[NRF24REG_SETUP_RETR] = 0x03;
+    chip->reg[NRF24REG_RF_CH]      = 0x02;
+    chip->reg[NRF24REG_RF_SETUP]   = 0x0E;
+    chip->reg[NRF24REG_RX_ADDR_P2] = 0xC3;
+    chip->reg[NRF24REG_RX_ADDR_P3] = 0xC4;
+    chip->reg[NRF24REG_RX_ADDR_P4] = 0xC5;
+    chip->reg[NRF24REG_RX_ADDR_P5] = 0xC6;
+    rt_memset(chip->rx_addr_p0, 0xE7, 5);
+    rt_memset(chip->rx_addr_p1, 0xC2, 5);
+    rt_memset(chip->tx_addr,    0xE7, 5);
+    rt_memset(chip->last_pid,   0xFF, sizeof(chip->last_pid));
+}
+
+
+/***
+ * @brief 实例所占用的节点
+ * @return RT_NULL 表示该实例还没有启动（nRF24L01_Sim_Init 之前）
+ */
+static struct nRF24L01_SIM_CHIP *nRF24L01_Sim_Chip(nrf24_port_api_t port_api)
+{
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+    {
+        if(nrf24_sim.node[i].owner != RT_NULL && &nrf24_sim.node[i].owner->port_api == port_api){
+            return &nrf24_sim.node[i];
+        }
+    }
+    return RT_NULL;
+}
+
+
+static rt_uint8_t nRF24L01_Sim_Addr_Width(const struct nRF24L01_SIM_CHIP *chip)
+{
+    rt_uint8_t aw = chip->reg[NRF24REG_SETUP_AW] & NRF24BITMASK_AW;
+    return (aw == 0) ? 3 : aw + 2;
+}
+
+
+/***
+ * @brief 合成 STATUS：中断标志 + 顶部数据包管道号（7 为空）+ TX_FULL
+ */
+static rt_uint8_t nRF24L01_Sim_Status(const struct nRF24L01_SIM_CHIP *chip)
+{
+    rt_uint8_t status = chip->reg[NRF24REG_STATUS] & (NRF24BITMASK_RX_DR | NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT);
+
+    status |= ((chip->rx_count > 0) ? chip->rx_fifo[0].pipe : 7) << 1;
+    if(chip->tx_count >= NRF24_SIM_FIFO_DEPTH){
+        status |= NRF24BITMASK_TX_FULL;
+    }
+
+    return status;
+}
+
+
+/***
+ * @brief 信道 ch 上的这一次发射是否被窄带干扰打掉
+ */
+static rt_uint8_t nRF24L01_Sim_Jammed(rt_uint8_t ch)
+{
+    if(nrf24_sim.jam_percent == 0 || ch + nrf24_sim.jam_width < nrf24_sim.jam_ch || ch > nrf24_sim.jam_ch + nrf24_sim.jam_width){
+        return 0;
+    }
+    return ((rt_uint32_t)rand() % 100 < nrf24_sim.jam_percent) ? 1 : 0;
+}
+
+
+static rt_uint8_t nRF24L01_Sim_Read_Reg(const struct nRF24L01_SIM_CHIP *chip, rt_uint8_t reg)
+{
+    rt_uint8_t value = 0;
+
+    switch(reg)
+    {
+    case NRF24REG_STATUS:
+        return nRF24L01_Sim_Status(chip);
+    case NRF24REG_OBSERVE_TX:
+        return (chip->plos_cnt << 4) | (chip->arc_cnt & NRF24BITMASK_ARC_CNT);
+    case NRF24REG_RPD:
+        return chip->rpd | nRF24L01_Sim_Jammed(chip->reg[NRF24REG_RF_CH]);
+    case NRF24REG_FIFO_STATUS:
+        if(chip->tx_reuse)                              value |= NRF24BITMASK_TX_REUSE;
+        if(chip->tx_count >= NRF24_SIM_FIFO_DEPTH)      value |= NRF24BITMASK_TX_FULL2;
+        if(chip->tx_count == 0)                         value |= NRF24BITMASK_TX_EMPTY;
+        if(chip->rx_count >= NRF24_SIM_FIFO_DEPTH)      value |= NRF24BITMASK_RX_RXFULL;
+        if(chip->rx_count == 0)                         value |= NRF24BITMASK_RX_EMPTY;
+        return value;
+    default:
+        return chip->reg[reg & 0x1F];
+    }
+}
+
+
+static void nRF24L01_Sim_Write_Reg(struct nRF24L01_SIM_CHIP *chip, rt_uint8_t reg, const uint8_t *in, rt_uint8_t n)
+{
+    if(n == 0){
+        return;
+    }
+
+    switch(reg)
+    {
+    case NRF24REG_RX_ADDR_P0:
+        rt_memcpy(chip->rx_addr_p0, in, (n > 5) ? 5 : n);
+        break;
+    case NRF24REG_RX_ADDR_P1:
+        rt_memcpy(chip->rx_addr_p1, in, (n > 5) ? 5 : n);
+        break;
+    case NRF24REG_TX_ADDR:
+        rt_memcpy(chip->tx_addr, in, (n > 5) ? 5 : n);
+        break;
+    case NRF24REG_STATUS:
+        /* 中断标志写 1 清零 */
+        chip->reg[NRF24REG_STATUS] &= ~(in[0] & (NRF24BITMASK_RX_DR | NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT));
+        break;
+    case NRF24REG_OBSERVE_TX:
+    case NRF24REG_RPD:
+    case NRF24REG_FIFO_STATUS:
+        /* 只读 */
+        break;
+    case NRF24REG_RF_CH:
+        /* 与芯片一致：写 RF_CH 才会清零 PLOS_CNT */
+        chip->reg[NRF24REG_RF_CH] = in[0] & NRF24BITMASK_RF_CH;
+        chip->plos_cnt = 0;
+        break;
+    case NRF24REG_CONFIG:
+        chip->reg[NRF24REG_CONFIG] = in[0];
+        if((in[0] & NRF24BITMASK_PWR_UP) == 0){
+            chip->tx_state = NRF24_SIM_TX_IDLE;
+        }
+        break;
+    default:
+        chip->reg[reg & 0x1F] = in[0];
+        break;
+    }
+}
+
+
+static void nRF24L01_Sim_Pop(struct nRF24L01_SIM_PACKET *fifo, rt_uint8_t *count, rt_uint8_t index)
+{
+    rt_memmove(&fifo[index], &fifo[index + 1], (*count - index - 1) * sizeof(struct nRF24L01_SIM_PACKET));
+    (*count)--;
+}
+
+
+static void nRF24L01_Sim_Push(struct nRF24L01_SIM_PACKET *fifo, rt_uint8_t *count, const uint8_t *data, rt_uint8_t len, rt_uint8_t pipe, rt_uint8_t no_ack)
+{
+    struct nRF24L01_SIM_PACKET *pkt;
+
+    if(*count >= NRF24_SIM_FIFO_DEPTH){
+        return;
+    }
+
+    pkt = &fifo[(*count)++];
+    pkt->len    = (len > 32) ? 32 : len;
+    pkt->pipe   = pipe;
+    pkt->no_ack = no_ack;
+    rt_memcpy(pkt->data, data, pkt->len);
+}
+
+
+/***
+ * @brief 一次片选内的完整 SPI 事务：mosi[0] 为指令，STATUS 在指令字节期间移出
+ */
+static void nRF24L01_Sim_Transfer(struct nRF24L01_SIM_CHIP *chip, const uint8_t *mosi, uint8_t *miso, rt_uint8_t len)
+{
+    rt_uint8_t cmd = mosi[0];
+    rt_uint8_t n = (len > 33) ? 32 : len - 1;
+    const uint8_t *in = &mosi[1];
+    uint8_t out[32] = { 0 };
+    uint8_t status = nRF24L01_Sim_Status(chip);
+
+    if((cmd & 0xE0) == NRF24CMD_R_REG){
+        rt_uint8_t reg = cmd & 0x1F;
+        if(reg == NRF24REG_RX_ADDR_P0 || reg == NRF24REG_RX_ADDR_P1 || reg == NRF24REG_TX_ADDR){
+            const rt_uint8_t *addr = (reg == NRF24REG_RX_ADDR_P0) ? chip->rx_addr_p0 :
+                                     (reg == NRF24REG_RX_ADDR_P1) ? chip->rx_addr_p1 : chip->tx_addr;
+            rt_memcpy(out, addr, (n > 5) ? 5 : n);
+        }
+        else if(n > 0){
+            out[0] = nRF24L01_Sim_Read_Reg(chip, reg);
+        }
+    }
+    else if((cmd & 0xE0) == NRF24CMD_W_REG){
+        nRF24L01_Sim_Write_Reg(chip, cmd & 0x1F, in, n);
+    }
+    else if((cmd & 0xF8) == NRF24CMD_W_ACK_PAYLOAD){
+        if((cmd & 0x07) <= NRF24_PIPE_5 && n > 0){
+            nRF24L01_Sim_Push(chip->tx_fifo, &chip->tx_count, in, n, cmd & 0x07, 0);
+        }
+    }
+    else{
+        switch(cmd)
+        {
+        case NRF24CMD_R_RX_PL_WID:
+            out[0] = (chip->rx_count > 0) ? chip->rx_fifo[0].len : 0;
+            break;
+        case NRF24CMD_R_RX_PAYLOAD:
+            if(chip->rx_count > 0){
+                rt_memcpy(out, chip->rx_fifo[0].data, (n > chip->rx_fifo[0].len) ? chip->rx_fifo[0].len : n);
+                nRF24L01_Sim_Pop(chip->rx_fifo, &chip->rx_count, 0);
+            }
+            break;
+        case NRF24CMD_W_TX_PLOAD_ACK:
+        case NRF24CMD_W_TX_PLOAD_NACK:
+            if(n > 0){
+                nRF24L01_Sim_Push(chip->tx_fifo, &chip->tx_count, in, n, 0, cmd == NRF24CMD_W_TX_PLOAD_NACK);
+                chip->tx_reuse = 0;
+            }
+            break;
+        case NRF24CMD_FLUSH_TX:
+            chip->tx_count = 0;
+            chip->tx_reuse = 0;
+            chip->tx_state = NRF24_SIM_TX_IDLE;
+            break;
+        case NRF24CMD_FLUSH_RX:
+            chip->rx_count = 0;
+            break;
+        case NRF24CMD_REUSE_TX_PL:
+            chip->tx_reuse = 1;
+            break;
+        default:
+            /* NOP；nRF24L01+ 不需要 ACTIVATE，FEATURE / DYNPD 始终可写 */
+            break;
+        }
+    }
+
+    if(miso != RT_NULL){
+        miso[0] = status;
+        rt_memcpy(&miso[1], out, n);
+    }
+}
+
+
+
+//以下是虚拟空口---------------------------------------------------------------------------------------------
+
+/***
+ * @brief 一包 Enhanced ShockBurst 的空中时间：前导 1 字节 + 地址 + 9 位包控制字段 + 载荷 + CRC
+ */
+static rt_uint32_t nRF24L01_Sim_Air_Us(const struct nRF24L01_SIM_CHIP *chip, rt_uint8_t payload_len)
+{
+    rt_uint8_t crc = 0;
+    rt_uint32_t bits;
+
+    if((chip->reg[NRF24REG_CONFIG] & NRF24BITMASK_EN_CRC) || chip->reg[NRF24REG_EN_AA] != 0){
+        crc = (chip->reg[NRF24REG_CONFIG] & NRF24BITMASK_CRCO) ? 2 : 1;
+    }
+    bits = 8 * (1 + nRF24L01_Sim_Addr_Width(chip) + payload_len + crc) + 9;
+
+    if(chip->reg[NRF24REG_RF_SETUP] & (1 << 5)){
+        return bits * 4;                /* 250Kbps */
+    }
+    if(chip->reg[NRF24REG_RF_SETUP] & NRF24BITMASK_RF_DR){
+        return (bits + 1) / 2;          /* 2Mbps */
+    }
+    return bits;                        /* 1Mbps */
+}
+
+
+static rt_uint32_t nRF24L01_Sim_ARD_Us(const struct nRF24L01_SIM_CHIP *chip)
+{
+    return (((chip->reg[NRF24REG_SETUP_RETR] & NRF24BITMASK_ARD) >> 4) + 1) * 250;
+}
+
+
+static rt_uint8_t nRF24L01_Sim_PTX_Ready(const struct nRF24L01_SIM_CHIP *chip)
+{
+    return (chip->reg[NRF24REG_CONFIG] & (NRF24BITMASK_PWR_UP | NRF24BITMASK_PRIM_RX)) == NRF24BITMASK_PWR_UP &&
+           chip->ce && chip->tx_count > 0 && (chip->reg[NRF24REG_STATUS] & NRF24BITMASK_MAX_RT) == 0;
+}
+
+
+static rt_uint8_t nRF24L01_Sim_PRX_Listening(const struct nRF24L01_SIM_CHIP *chip)
+{
+    return (chip->reg[NRF24REG_CONFIG] & (NRF24BITMASK_PWR_UP | NRF24BITMASK_PRIM_RX)) == (NRF24BITMASK_PWR_UP | NRF24BITMASK_PRIM_RX) &&
+           chip->ce;
+}
+
+
+/***
+ * @brief 目标地址落在哪个已使能的接收管道上，管道 2~5 只有最低字节独立，其余字节与管道 1 共用
+ * @return 管道号，-1 为不匹配
+ */
+static int nRF24L01_Sim_Match_Pipe(const struct nRF24L01_SIM_CHIP *rx, const rt_uint8_t *addr, rt_uint8_t aw)
+{
+    for(rt_uint8_t pipe = 0; pipe <= NRF24_PIPE_5; pipe++)
+    {
+        if((rx->reg[NRF24REG_EN_RXADDR] & (1 << pipe)) == 0){
+            continue;
+        }
+        if(pipe == 0){
+            if(rt_memcmp(rx->rx_addr_p0, addr, aw) == 0) return 0;
+        }
+        else if(rt_memcmp(&rx->rx_addr_p1[1], &addr[1], aw - 1) == 0){
+            rt_uint8_t lsb = (pipe == 1) ? rx->rx_addr_p1[0] : rx->reg[NRF24REG_RX_ADDR_P0 + pipe];
+            if(lsb == addr[0]) return pipe;
+        }
+    }
+
+    return -1;
+}
+
+
+static rt_uint8_t nRF24L01_Sim_Roll_Loss(void)
+{
+    return (nrf24_sim.loss_percent > 0) && ((rt_uint32_t)rand() % 100 < nrf24_sim.loss_percent);
+}
+
+
+/***
+ * @brief 数据包到达空口：寻找接收方、入 RX FIFO、准备应答
+ * @return 1 -> 接收方发出了应答（ACK 载荷放在 tx->ack），0 -> 没有应答
+ */
+static int nRF24L01_Sim_Deliver(struct nRF24L01_SIM_CHIP *tx, const struct nRF24L01_SIM_PACKET *pkt, rt_uint8_t need_ack)
+{
+    struct nRF24L01_SIM_CHIP *rx = RT_NULL;
+    rt_uint8_t aw = nRF24L01_Sim_Addr_Width(tx);
+    rt_uint16_t sum = 0;
+    int pipe = -1;
+
+    if(nRF24L01_Sim_Roll_Loss()){
+        nrf24_sim.data_lost++;
+        return 0;
+    }
+    if(nRF24L01_Sim_Jammed(tx->reg[NRF24REG_RF_CH])){
+        nrf24_sim.jam_lost++;
+        return 0;
+    }
+
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *node = &nrf24_sim.node[i];
+        if(node == tx || !nRF24L01_Sim_PRX_Listening(node) ||
+           node->reg[NRF24REG_RF_CH] != tx->reg[NRF24REG_RF_CH] ||
+           (node->reg[NRF24REG_RF_SETUP] & 0x28) != (tx->reg[NRF24REG_RF_SETUP] & 0x28) ||
+           nRF24L01_Sim_Addr_Width(node) != aw){
+            continue;
+        }
+        pipe = nRF24L01_Sim_Match_Pipe(node, tx->tx_addr, aw);
+        if(pipe >= 0){
+            rx = node;
+            break;
+        }
+    }
+    if(rx == RT_NULL){
+        nrf24_sim.no_receiver++;
+        return 0;
+    }
+    rx->rpd = 1;
+
+    // 1. 接收方没开自动应答，或发送方要求免应答
+    if((rx->reg[NRF24REG_EN_AA] & (1 << pipe)) == 0){
+        need_ack = 0;
+    }
+
+    // 2. 同一 PID 且内容相同视为重发：只应答，不再入 FIFO
+    for(rt_uint8_t i = 0; i < pkt->len; i++){
+        sum = (sum << 1 | sum >> 15) ^ pkt->data[i];
+    }
+    sum ^= pkt->len;
+    if(need_ack && rx->last_pid[pipe] == tx->pid && rx->last_sum[pipe] == sum){
+        nrf24_sim.duplicates++;
+    }
+    else{
+        // 3. RX FIFO 已满时芯片既不接收也不应答
+        if(rx->rx_count >= NRF24_SIM_FIFO_DEPTH){
+            nrf24_sim.rx_full_drops++;
+            return 0;
+        }
+        nRF24L01_Sim_Push(rx->rx_fifo, &rx->rx_count, pkt->data, pkt->len, pipe, 0);
+        rx->reg[NRF24REG_STATUS] |= NRF24BITMASK_RX_DR;
+        rx->last_pid[pipe] = tx->pid;
+        rx->last_sum[pipe] = sum;
+        nrf24_sim.delivered++;
+
+        // 4. 取出该管道的第一个 ACK 载荷随应答发出，并留一份给可能的重发
+        rx->last_ack[pipe].len = 0;
+        if(need_ack && (rx->reg[NRF24REG_FEATURE] & NRF24BITMASK_EN_ACK_PAY)){
+            for(rt_uint8_t i = 0; i < rx->tx_count; i++){
+                if(rx->tx_fifo[i].pipe == pipe){
+                    rx->last_ack[pipe] = rx->tx_fifo[i];
+                    nRF24L01_Sim_Pop(rx->tx_fifo, &rx->tx_count, i);
+                    rx->reg[NRF24REG_STATUS] |= NRF24BITMASK_TX_DS;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(need_ack == 0){
+        return 0;
+    }
+    tx->ack = rx->last_ack[pipe];
+
+    return 1;
+}
+
+
+/***
+ * @brief 开始一次发射（首发或自动重发）
+ */
+static void nRF24L01_Sim_Start_Attempt(struct nRF24L01_SIM_CHIP *chip, rt_uint64_t start)
+{
+    rt_uint32_t air = nRF24L01_Sim_Air_Us(chip, chip->tx_fifo[0].len);
+
+    if(start < nrf24_sim.busy_until_us){
+        start = nrf24_sim.busy_until_us;
+    }
+    chip->attempt_us = start;
+    chip->event_us   = start + air + nrf24_sim.latency_us;
+    chip->tx_state   = NRF24_SIM_TX_DATA;
+    nrf24_sim.busy_until_us = start + air;
+    nrf24_sim.air_us += air;
+    nrf24_sim.attempts++;
+}
+
+
+/***
+ * @brief 处理一个到期的发射阶段
+ */
+static void nRF24L01_Sim_Process(struct nRF24L01_SIM_CHIP *chip)
+{
+    struct nRF24L01_SIM_PACKET *pkt = &chip->tx_fifo[0];
+    rt_uint8_t need_ack = !pkt->no_ack && (chip->reg[NRF24REG_EN_AA] & NRF24BITMASK_PIPE_0);
+    rt_uint8_t is_peer = (chip->owner == RT_NULL);
+
+    // 1. 数据包结束：交给接收方，决定应答能否收到
+    if(chip->tx_state == NRF24_SIM_TX_DATA)
+    {
+        chip->ack_ok = 0;
+        if(nRF24L01_Sim_Deliver(chip, pkt, need_ack)){
+            rt_uint32_t air = nRF24L01_Sim_Air_Us(chip, chip->ack.len);
+            nrf24_sim.air_us += air;
+            nrf24_sim.busy_until_us = chip->event_us + NRF24_SIM_TPLL_US + air;
+            if(nRF24L01_Sim_Roll_Loss()){
+                nrf24_sim.ack_lost++;
+            }
+            else if(nRF24L01_Sim_Jammed(chip->reg[NRF24REG_RF_CH])){
+                nrf24_sim.jam_lost++;
+            }
+            else{
+                chip->ack_ok = 1;
+            }
+        }
+
+        if(need_ack == 0){
+            chip->ack_ok = 1;
+        }
+        else if(chip->ack_ok){
+            chip->event_us += NRF24_SIM_TPLL_US + nRF24L01_Sim_Air_Us(chip, chip->ack.len) + nrf24_sim.latency_us;
+            chip->tx_state = NRF24_SIM_TX_WAIT;
+            return;
+        }
+        else{
+            rt_uint64_t retry = chip->attempt_us + nRF24L01_Sim_Air_Us(chip, pkt->len) + nRF24L01_Sim_ARD_Us(chip);
+            chip->event_us = (retry > chip->event_us) ? retry : chip->event_us;
+            chip->tx_state = NRF24_SIM_TX_WAIT;
+            return;
+        }
+    }
+
+    // 2. 发送成功：出 FIFO（REUSE_TX_PL 时保留），ACK 载荷进 RX FIFO
+    chip->tx_state = NRF24_SIM_TX_IDLE;
+    if(chip->ack_ok)
+    {
+        if(need_ack && chip->ack.len > 0 && chip->rx_count < NRF24_SIM_FIFO_DEPTH){
+            nRF24L01_Sim_Push(chip->rx_fifo, &chip->rx_count, chip->ack.data, chip->ack.len, 0, 0);
+            chip->reg[NRF24REG_STATUS] |= NRF24BITMASK_RX_DR;
+        }
+        if(chip->tx_reuse == 0){
+            nRF24L01_Sim_Pop(chip->tx_fifo, &chip->tx_count, 0);
+        }
+        chip->reg[NRF24REG_STATUS] |= NRF24BITMASK_TX_DS;
+        if(is_peer){
+            nrf24_sim.peer_tx_ok++;
+        }
+        return;
+    }
+
+    // 3. 没有收到应答：重发次数用完则置 MAX_RT 并停发，直到 MAX_RT 被清除
+    if(chip->arc_cnt >= (chip->reg[NRF24REG_SETUP_RETR] & NRF24BITMASK_ARC)){
+        chip->reg[NRF24REG_STATUS] |= NRF24BITMASK_MAX_RT;
+        if(chip->plos_cnt < 15){
+            chip->plos_cnt++;
+        }
+        if(is_peer){
+            nrf24_sim.peer_tx_failed++;
+        }
+        return;
+    }
+    chip->arc_cnt++;
+    nRF24L01_Sim_Start_Attempt(chip, chip->event_us);
+}
+
+
+/***
+ * @brief 空闲且满足发射条件的 PTX 开始发送 FIFO 顶部的新数据包，先经过 PLL 建立时间
+ */
+static void nRF24L01_Sim_Kick(rt_uint64_t t)
+{
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *chip = &nrf24_sim.node[i];
+        if(chip->tx_state == NRF24_SIM_TX_IDLE && nRF24L01_Sim_PTX_Ready(chip)){
+            chip->arc_cnt = 0;
+            chip->pid = (chip->pid + 1) & 0x03;
+            nRF24L01_Sim_Start_Attempt(chip, t + NRF24_SIM_TPLL_US);
+        }
+    }
+}
+
+
+
+//以下是内置的对端节点---------------------------------------------------------------------------------------------
+
+/***
+ * @brief 驱动管道 pipe 的完整地址
+ */
+static void nRF24L01_Sim_Pipe_Addr(const struct nRF24L01_SIM_CHIP *chip, rt_uint8_t pipe, rt_uint8_t *addr)
+{
+    if(pipe == 0){
+        rt_memcpy(addr, chip->rx_addr_p0, 5);
+        return;
+    }
+    rt_memcpy(addr, chip->rx_addr_p1, 5);
+    if(pipe > 1){
+        addr[0] = chip->reg[NRF24REG_RX_ADDR_P0 + pipe];
+    }
+}
+
+
+/***
+ * @brief 内置对端（没有实例占用的节点）的射频参数始终跟随节点 0，角色与节点 0 相反
+ * @note  SINK / ECHO 只用第一个内置对端作 PRX；SOURCE 时节点 i 向节点 0 的管道 (i-1)%6 发送，用于多节点汇聚
+ */
+static void nRF24L01_Sim_Peer_Sync(void)
+{
+    struct nRF24L01_SIM_CHIP *host = &nrf24_sim.node[0];
+    rt_uint8_t crc_bits = host->reg[NRF24REG_CONFIG] & (NRF24BITMASK_EN_CRC | NRF24BITMASK_CRCO);
+    rt_uint8_t host_prx = host->reg[NRF24REG_CONFIG] & NRF24BITMASK_PRIM_RX;
+    rt_uint8_t first = 1;
+
+    for(rt_uint8_t i = 1; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *peer = &nrf24_sim.node[i];
+
+        if(peer->owner != RT_NULL){
+            continue;
+        }
+
+        peer->reg[NRF24REG_EN_AA]      = host->reg[NRF24REG_EN_AA];
+        peer->reg[NRF24REG_SETUP_AW]   = host->reg[NRF24REG_SETUP_AW];
+        peer->reg[NRF24REG_SETUP_RETR] = host->reg[NRF24REG_SETUP_RETR];
+        peer->reg[NRF24REG_RF_CH]      = host->reg[NRF24REG_RF_CH];
+        peer->reg[NRF24REG_RF_SETUP]   = host->reg[NRF24REG_RF_SETUP];
+        peer->reg[NRF24REG_DYNPD]      = host->reg[NRF24REG_DYNPD];
+        peer->reg[NRF24REG_FEATURE]    = host->reg[NRF24REG_FEATURE];
+        peer->reg[NRF24REG_EN_RXADDR]  = NRF24BITMASK_PIPE_0;
+        peer->ce = 1;
+
+        if(!host_prx && first && (nrf24_sim.peer_mode == NRF24_SIM_PEER_SINK || nrf24_sim.peer_mode == NRF24_SIM_PEER_ECHO)){
+            peer->reg[NRF24REG_CONFIG] = crc_bits | NRF24BITMASK_PWR_UP | NRF24BITMASK_PRIM_RX;
+            rt_memcpy(peer->rx_addr_p0, host->tx_addr, 5);
+        }
+        else if(host_prx && nrf24_sim.peer_mode == NRF24_SIM_PEER_SOURCE){
+            peer->reg[NRF24REG_CONFIG] = crc_bits | NRF24BITMASK_PWR_UP;
+            nRF24L01_Sim_Pipe_Addr(host, (i - 1) % 6, peer->tx_addr);
+            rt_memcpy(peer->rx_addr_p0, peer->tx_addr, 5);
+        }
+        else{
+            peer->reg[NRF24REG_CONFIG] = crc_bits;
+        }
+        first = 0;
+    }
+}
+
+
+/***
+ * @brief 对端程序：即时读走收到的数据、回填 ACK 载荷或发送数据，并清除自己的中断标志
+ */
+static void nRF24L01_Sim_Peer_Service(void)
+{
+    nRF24L01_Sim_Peer_Sync();
+
+    for(rt_uint8_t i = 1; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *peer = &nrf24_sim.node[i];
+
+        if(peer->owner != RT_NULL){
+            continue;
+        }
+        if(peer->reg[NRF24REG_STATUS] & NRF24BITMASK_MAX_RT){
+            peer->tx_count = 0;
+        }
+        peer->reg[NRF24REG_STATUS] = 0;
+
+        while(peer->rx_count > 0)
+        {
+            struct nRF24L01_SIM_PACKET *pkt = &peer->rx_fifo[0];
+            nrf24_sim.peer_rx_packets++;
+            nrf24_sim.peer_rx_bytes += pkt->len;
+            if(nrf24_sim.peer_mode == NRF24_SIM_PEER_ECHO){
+                nRF24L01_Sim_Push(peer->tx_fifo, &peer->tx_count, pkt->data, pkt->len, pkt->pipe, 0);
+            }
+            nRF24L01_Sim_Pop(peer->rx_fifo, &peer->rx_count, 0);
+        }
+
+        if(nrf24_sim.peer_mode == NRF24_SIM_PEER_SOURCE && !(peer->reg[NRF24REG_CONFIG] & NRF24BITMASK_PRIM_RX))
+        {
+            while(peer->tx_count < NRF24_SIM_FIFO_DEPTH && nrf24_sim.peer_remaining > 0)
+            {
+                uint8_t buf[32];
+                for(rt_uint8_t k = 0; k < nrf24_sim.peer_len; k++){
+                    buf[k] = (uint8_t)(nrf24_sim.peer_remaining + k);
+                }
+                nRF24L01_Sim_Push(peer->tx_fifo, &peer->tx_count, buf, nrf24_sim.peer_len, 0, 0);
+                nrf24_sim.peer_remaining--;
+            }
+        }
+    }
+}
+
+
+/***
+ * @brief 各实例节点的 IRQ 引脚：未屏蔽的中断标志出现时产生一次“下降沿”，唤醒占用该节点的实例
+ * @note  CONFIG 的 bit6~4 为 MASK_RX_DR / MASK_TX_DS / MASK_MAX_RT，置 1 表示屏蔽
+ */
+static void nRF24L01_Sim_Update_IRQ(void)
+{
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *chip = &nrf24_sim.node[i];
+        rt_uint8_t active = chip->reg[NRF24REG_STATUS] & ~chip->reg[NRF24REG_CONFIG] &
+                            (NRF24BITMASK_RX_DR | NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT);
+
+        if(chip->owner == RT_NULL){
+            continue;
+        }
+        if(active && !chip->irq_line){
+            nRF24L01_Debug_Mark_IRQ(chip->owner);
+            nRF24L01_Wakeup(chip->owner);
+        }
+        chip->irq_line = active ? 1 : 0;
+    }
+}
+
+
+/***
+ * @brief 把模型推进到当前时刻，按时间顺序处理到期的发射阶段
+ * @note  每次 SPI 访问、CE 变化以及定时器都会调用；调用者已锁调度器
+ */
+static void nRF24L01_Sim_Enter(void)
+{
+    rt_uint64_t now;
+
+    rt_enter_critical();
+    now = nRF24L01_Sim_Now_Us();
+
+    for(;;)
+    {
+        struct nRF24L01_SIM_CHIP *next = RT_NULL;
+
+        for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+        {
+            struct nRF24L01_SIM_CHIP *chip = &nrf24_sim.node[i];
+            if(chip->tx_state != NRF24_SIM_TX_IDLE && chip->event_us <= now &&
+               (next == RT_NULL || chip->event_us < next->event_us)){
+                next = chip;
+            }
+        }
+        if(next == RT_NULL){
+            break;
+        }
+
+        nrf24_sim.now_us = next->event_us;
+        nRF24L01_Sim_Process(next);
+        nRF24L01_Sim_Peer_Service();
+        nRF24L01_Sim_Kick(nrf24_sim.now_us);
+    }
+
+    nrf24_sim.now_us = now;
+}
+
+
+/***
+ * @brief 事件定时器对准最早一个未处理的发射阶段
+ * @note  已启动且不晚于该时刻时不重启，提前到期只是多推进一次
+ */
+static void nRF24L01_Sim_Arm_Timer(void)
+{
+#ifdef RT_USING_HWTIMER
+    rt_uint64_t next = 0;
+    rt_uint32_t us;
+    rt_hwtimerval_t tv;
+
+    if(nrf24_sim_hwtimer == RT_NULL){
+        return;
+    }
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++)
+    {
+        struct nRF24L01_SIM_CHIP *chip = &nrf24_sim.node[i];
+        if(chip->tx_state != NRF24_SIM_TX_IDLE && (next == 0 || chip->event_us < next)){
+            next = chip->event_us;
+        }
+    }
+    if(next == 0 || (nrf24_sim.timer_us != 0 && nrf24_sim.timer_us <= next)){
+        return;
+    }
+
+    us = (next > nrf24_sim.now_us) ? (rt_uint32_t)(next - nrf24_sim.now_us) : 1;
+    tv.sec  = us / 1000000;
+    tv.usec = us % 1000000;
+    if(rt_device_write(nrf24_sim_hwtimer, 0, &tv, sizeof(tv)) == sizeof(tv)){
+        nrf24_sim.timer_us = next;
+    }
+#endif
+}
+
+
+static void nRF24L01_Sim_Leave(void)
+{
+    nRF24L01_Sim_Peer_Service();
+    nRF24L01_Sim_Kick(nrf24_sim.now_us);
+    nRF24L01_Sim_Update_IRQ();
+    nRF24L01_Sim_Arm_Timer();
+    rt_exit_critical();
+}
+
+
+static void nRF24L01_Sim_Timeout(void *parameter)
+{
+    nRF24L01_Sim_Enter();
+    nRF24L01_Sim_Leave();
+}
+
+
+#ifdef RT_USING_HWTIMER
+/***
+ * @brief 事件定时器到期，运行在中断上下文
+ */
+static rt_err_t nRF24L01_Sim_Timer_Isr(rt_device_t dev, rt_size_t size)
+{
+    nrf24_sim.timer_us = 0;
+    nRF24L01_Sim_Timeout(RT_NULL);
+    return RT_EOK;
+}
+
+
+/***
+ * @brief 打开事件定时器，没有该设备或被占用时只靠 tick 推进
+ */
+static void nRF24L01_Sim_Timer_Open(void)
+{
+    rt_hwtimer_mode_t mode = HWTIMER_MODE_ONESHOT;
+    rt_uint32_t freq = 1000000;
+
+    nrf24_sim_hwtimer = rt_device_find(NRF24_SIM_TIMER_NAME);
+    if(nrf24_sim_hwtimer == RT_NULL){
+        return;
+    }
+    if(rt_device_open(nrf24_sim_hwtimer, RT_DEVICE_OFLAG_RDWR) != RT_EOK){
+        nrf24_sim_hwtimer = RT_NULL;
+    }
+    else if(rt_device_control(nrf24_sim_hwtimer, HWTIMER_CTRL_FREQ_SET, &freq) != RT_EOK ||
+            rt_device_control(nrf24_sim_hwtimer, HWTIMER_CTRL_MODE_SET, &mode) != RT_EOK){
+        rt_device_close(nrf24_sim_hwtimer);
+        nrf24_sim_hwtimer = RT_NULL;
+    }
+    else{
+        rt_device_set_rx_indicate(nrf24_sim_hwtimer, nRF24L01_Sim_Timer_Isr);
+    }
+}
+#endif
+
+
+
+//以下是替换 SPI 的操作函数---------------------------------------------------------------------------------------------
+
+static int nrf24_sim_send_then_recv(nrf24_port_api_t port_api, const uint8_t *tbuf, uint8_t tlen, uint8_t *rbuf, uint8_t rlen)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+    uint8_t mosi[34], miso[34];
+
+    if(chip == RT_NULL || tlen == 0 || tlen + rlen > sizeof(mosi)){
+        return -RT_EINVAL;
+    }
+    rt_memcpy(mosi, tbuf, tlen);
+    rt_memset(&mosi[tlen], NRF24CMD_NOP, rlen);
+
+    nRF24L01_Sim_Enter();
+    nRF24L01_Sim_Transfer(chip, mosi, miso, tlen + rlen);
+    nRF24L01_Sim_Leave();
+
+    rt_memcpy(rbuf, &miso[tlen], rlen);
+    return RT_EOK;
+}
+
+static int nrf24_sim_send_then_send(nrf24_port_api_t port_api, const uint8_t *tbuf1, uint8_t tlen1, const uint8_t *tbuf2, uint8_t tlen2)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+    uint8_t mosi[34];
+
+    if(chip == RT_NULL || tlen1 == 0 || tlen1 + tlen2 > sizeof(mosi)){
+        return -RT_EINVAL;
+    }
+    rt_memcpy(mosi, tbuf1, tlen1);
+    rt_memcpy(&mosi[tlen1], tbuf2, tlen2);
+
+    nRF24L01_Sim_Enter();
+    nRF24L01_Sim_Transfer(chip, mosi, RT_NULL, tlen1 + tlen2);
+    nRF24L01_Sim_Leave();
+
+    return RT_EOK;
+}
+
+static int nrf24_sim_write(nrf24_port_api_t port_api, const uint8_t *buf, uint8_t len)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+
+    if(chip == RT_NULL){
+        return -RT_ERROR;
+    }
+    if(len == 0){
+        return 0;
+    }
+
+    nRF24L01_Sim_Enter();
+    nRF24L01_Sim_Transfer(chip, buf, RT_NULL, len);
+    nRF24L01_Sim_Leave();
+
+    return len;
+}
+
+static int nrf24_sim_transfer(nrf24_port_api_t port_api, const uint8_t *tbuf, uint8_t *rbuf, uint8_t len)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+
+    if(chip == RT_NULL){
+        return -RT_ERROR;
+    }
+    if(len == 0){
+        return 0;
+    }
+
+    nRF24L01_Sim_Enter();
+    nRF24L01_Sim_Transfer(chip, tbuf, rbuf, len);
+    nRF24L01_Sim_Leave();
+
+    return len;
+}
+
+static int nrf24_sim_set_spi_hz(nrf24_port_api_t port_api, rt_uint32_t hz)
+{
+    port_api->spi_hz = hz;
+    return RT_EOK;
+}
+
+static int nrf24_sim_set_ce(nrf24_port_api_t port_api)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+
+    if(chip == RT_NULL){
+        return -RT_ERROR;
+    }
+    nRF24L01_Sim_Enter();
+    chip->ce = 1;
+    nRF24L01_Sim_Leave();
+    return RT_EOK;
+}
+
+static int nrf24_sim_reset_ce(nrf24_port_api_t port_api)
+{
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+
+    if(chip == RT_NULL){
+        return -RT_ERROR;
+    }
+    nRF24L01_Sim_Enter();
+    chip->ce = 0;
+    nRF24L01_Sim_Leave();
+    return RT_EOK;
+}
+
+
+const struct nRF24L01_FUNC_OPS g_nrf24_sim_ops = {
+    .nrf24_send_then_recv = nrf24_sim_send_then_recv,
+    .nrf24_send_then_send = nrf24_sim_send_then_send,
+    .nrf24_write = nrf24_sim_write,
+    .nrf24_transfer = nrf24_sim_transfer,
+    .nrf24_set_spi_hz = nrf24_sim_set_spi_hz,
+    .nrf24_set_ce = nrf24_sim_set_ce,
+    .nrf24_reset_ce = nrf24_sim_reset_ce,
+};
+
+
+
+/***
+ * @brief 代替 nRF24L01_SPI_Init：实例占用一个空闲节点，它的 IRQ 唤醒该实例的射频线程
+ * @note  第一个实例复位整个空口并启动模型定时器，之后的实例只复位自己的节点，同一实例重新启动时沿用原来的节点；
+ *        默认对端为 ECHO，驱动作为 PTX 时直接有应答和 ACK 载荷；驱动作为 PRX 时用 nrf24_sim source 产生流量
+ * @return -RT_EFULL 表示空口上已经没有空闲节点
+ */
+int nRF24L01_Sim_Init(nrf24_t nrf24)
+{
+    nrf24_port_api_t port_api = &nrf24->port_api;
+    struct nRF24L01_SIM_CHIP *chip = nRF24L01_Sim_Chip(port_api);
+    rt_uint8_t first = 1;
+
+    rt_enter_critical();
+    for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++){
+        if(nrf24_sim.node[i].owner != RT_NULL){
+            first = 0;
+        }
+    }
+
+    // 1. 第一个实例：复位全部节点
+    if(first){
+        rt_memset(&nrf24_sim, 0, sizeof(nrf24_sim));
+        for(rt_uint8_t i = 0; i < NRF24_SIM_NODES; i++){
+            nRF24L01_Sim_Reset_Chip(&nrf24_sim.node[i]);
+        }
+        nrf24_sim.peer_mode = NRF24_SIM_PEER_ECHO;
+        nrf24_sim.peer_len  = 32;
+        nrf24_sim.now_us    = nRF24L01_Sim_Now_Us();
+        nrf24_sim.stat_start_us = nrf24_sim.now_us;
+    }
+
+    // 2. 占用第一个空闲节点（内置对端让出该节点）
+    for(rt_uint8_t i = 0; chip == RT_NULL && i < NRF24_SIM_NODES; i++){
+        if(nrf24_sim.node[i].owner == RT_NULL){
+            chip = &nrf24_sim.node[i];
+        }
+    }
+    if(chip == RT_NULL){
+        rt_exit_critical();
+        LOG_E("LOG:%d. %s: no free node on the virtual ether (NRF24_SIM_NODES = %d).",Record.ulog_cnt++, nrf24->name, NRF24_SIM_NODES);
+        return -RT_EFULL;
+    }
+    nRF24L01_Sim_Reset_Chip(chip);
+    chip->owner = nrf24;
+    rt_exit_critical();
+
+    port_api->spi_dev_nrf24 = RT_NULL;
+    port_api->spi_hz = NRF24_SPI_DEFAULT_HZ;
+
+    if(first){
+        rt_timer_init(&nrf24_sim_timer, "nrf24_sim", nRF24L01_Sim_Timeout, RT_NULL, 1,
+                      RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_SOFT_TIMER);
+        rt_timer_start(&nrf24_sim_timer);
+#ifdef RT_USING_HWTIMER
+        if(nrf24_sim_hwtimer == RT_NULL){
+            nRF24L01_Sim_Timer_Open();
+        }
+        if(nrf24_sim_hwtimer != RT_NULL){
+            LOG_I("LOG:%d. nRF24 simulator events on %s.",Record.ulog_cnt++, NRF24_SIM_TIMER_NAME);
+        }
+#endif
+        LOG_I("LOG:%d. nRF24 simulator started, %d nodes on the virtual ether.",Record.ulog_cnt++, NRF24_SIM_NODES);
+    }
+    LOG_I("LOG:%d. %s on simulator node %d.",Record.ulog_cnt++, nrf24->name, (int)(chip - nrf24_sim.node));
+    return RT_EOK;
+}
+
+
+static void nRF24L01_Sim_Thread_entry(void *parameter)
+{
+    nrf24_t nrf24 = (nrf24_t)parameter;
+
+    if(nRF24L01_Start(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s start false.",Record.ulog_cnt++, nrf24->name);
+        return;
+    }
+    for(;;)
+    {
+        nRF24L01_Run(nrf24);
+        if(nrf24->nrf24_flags.using_irq != RT_TRUE){
+            rt_thread_mdelay(1);
+        }
+    }
+}
+
+
+/***
+ * @brief 在虚拟空口上再加一个跑完整协议栈的 nRF24L01 实例，并启动它的射频线程
+ * @note  实例在射频线程里 nRF24L01_Start 时占用空闲节点，该节点不再由内置对端驱动；
+ *        nrf24_dev <name> 切到它以后，nrf24_xxx 命令就作用在这个实例上；cb 可以为 RT_NULL
+ * @return RT_NULL 表示实例已经用完（最多 NRF24_SIM_NODES - 1 个）或初始化失败
+ */
+nrf24_t nRF24L01_Sim_Add_Node(const char *name, nrf24_role_et role, const struct nrf24_callback *cb)
+{
+    nrf24_t nrf24;
+    rt_uint8_t n;
+
+    rt_enter_critical();
+    n = sim_radio_count;
+    if(n < NRF24_SIM_NODES - 1){
+        sim_radio_count++;
+    }
+    rt_exit_critical();
+    if(n >= NRF24_SIM_NODES - 1){
+        return RT_NULL;
+    }
+
+    nrf24 = &sim_radio[n];
+    rt_strncpy(sim_radio_name[n], name, RT_NAME_MAX - 1);
+    if(nRF24L01_Init(nrf24, sim_radio_name[n], &sim_hw, cb, role) != RT_EOK){
+        return RT_NULL;
+    }
+    rt_thread_init(&sim_thread[n], sim_radio_name[n], nRF24L01_Sim_Thread_entry, nrf24,
+                   sim_thread_stack[n], NRF24_SIM_THREAD_STACK, NRF24_SIM_THREAD_PRIORITY, 50);
+    rt_thread_startup(&sim_thread[n]);
+
+    return nrf24;
+}
+
+
+
+/***
+ * @brief 对端实例收到的字节数（全部管道，含各层的控制报文）
+ */
+static rt_uint32_t nRF24L01_Sim_Rx_Bytes(nrf24_t nrf24)
+{
+    rt_uint32_t bytes = 0;
+
+    for (rt_uint8_t i = 0; i < NRF24_STAT_PIPES; i++){
+        bytes += nrf24->stat.rx_bytes[i];
+    }
+    return bytes;
+}
+
+
+/***
+ * @brief 跳频基准测试：100% 占空的窄带干扰落在正在使用的信道上，按干扰宽度比较固定信道和跳频的吞吐
+ * @note  驱动须为 PTX；对端是虚拟空口上另一个跑完整协议栈的 PRX 实例（缺省为 nrf_hop，不存在时自动加入），
+ *        它的信道只由收到的 HOP 报文和自身的外推决定，所以测的是干扰、拉黑过程、HOP 开销以及对端失步对吞吐的影响；
+ *        固定信道时干扰以 NRF24_CHAN_HOME 为中心，跳频时以跳频序列的第一个信道为中心；
+ *        测试期间内置对端关闭，避免和对端实例抢同一个地址
+ */
+static void nRF24L01_Sim_Hop_Bench(rt_uint32_t seconds, rt_uint8_t len, const char *peer_name)
+{
+    static const rt_int8_t widths[] = { -1, 0, 1, 2, 4 };
+    rt_uint8_t peer_mode = nrf24_sim.peer_mode;
+    nrf24_t peer;
+    uint8_t buf[32];
+
+    if (_nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        rt_kprintf("[nrf24] hop bench needs the driver as PTX.\r\n");
+        return;
+    }
+    peer = nRF24L01_Find(peer_name);
+    if (peer == RT_NULL){
+        peer = nRF24L01_Sim_Add_Node(peer_name, ROLE_PRX, RT_NULL);
+        rt_thread_mdelay(100);
+    }
+    if (peer == RT_NULL || peer == _nrf24 || peer->nrf24_cfg.config.prim_rx != ROLE_PRX){
+        rt_kprintf("[nrf24] hop bench needs a PRX peer instance %s.\r\n", peer_name);
+        return;
+    }
+    nrf24_sim.peer_mode = NRF24_SIM_PEER_OFF;
+    for (rt_uint8_t k = 0; k < len; k++){
+        buf[k] = k;
+    }
+
+    rt_kprintf("  jammer        fixed B/s     hop B/s   blacklisted  peer extrapolated\r\n");
+    for (rt_uint8_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+    {
+        rt_uint32_t result[2] = { 0, 0 }, blacklisted = 0, extrapolated = 0;
+
+        for (rt_uint8_t mode = 0; mode < 2; mode++)
+        {
+            rt_uint32_t hops, bytes, extra;
+            rt_uint64_t start_us;
+            rt_tick_t end;
+
+            // 1. 固定信道 / 跳频：先撤掉干扰，双方都停用跳频回到 NRF24_CHAN_HOME，每次重新启用都会换种子、清空黑名单
+            nrf24_sim.jam_percent = 0;
+            nRF24L01_Hop_Enable(_nrf24, RT_FALSE);
+            nRF24L01_Hop_Enable(peer, RT_FALSE);
+            rt_thread_mdelay(NRF24_HOP_DWELL_MS * 2);
+            if (mode == 1){
+                nRF24L01_Hop_Enable(_nrf24, RT_TRUE);
+                rt_thread_mdelay(NRF24_HOP_DWELL_MS * 2);
+            }
+
+            rt_enter_critical();
+            nrf24_sim.jam_ch      = (mode == 1) ? _nrf24->hop.ch[0] : NRF24_CHAN_HOME;
+            nrf24_sim.jam_width   = (widths[w] < 0) ? 0 : widths[w];
+            nrf24_sim.jam_percent = (widths[w] < 0) ? 0 : 100;
+            start_us = nrf24_sim.now_us;
+            bytes = nRF24L01_Sim_Rx_Bytes(peer);
+            hops  = _nrf24->hop.hops - _nrf24->hop.hops_failed;
+            extra = peer->hop.extrapolated;
+            rt_exit_critical();
+
+            // 2. 持续填满软件发送队列
+            end = rt_tick_get() + rt_tick_from_millisecond(seconds * 1000);
+            while ((rt_int32_t)(rt_tick_get() - end) < 0)
+            {
+                if (nRF24L01_Send_Async(_nrf24, buf, len, nRF24_SEND_NEED_ACK) < 0){
+                    rt_thread_mdelay(1);
+                }
+            }
+
+            // 3. 对端实际收到的字节扣掉 HOP 报文，只算有效载荷
+            rt_enter_critical();
+            hops  = _nrf24->hop.hops - _nrf24->hop.hops_failed - hops;
+            bytes = nRF24L01_Sim_Rx_Bytes(peer) - bytes - hops * NRF24_HOP_SIZE;
+            result[mode] = (rt_uint32_t)((rt_uint64_t)bytes * 1000000 / (nrf24_sim.now_us - start_us + 1));
+            rt_exit_critical();
+            if (mode == 1){
+                blacklisted  = _nrf24->hop.blacklisted;
+                extrapolated = peer->hop.extrapolated - extra;
+            }
+        }
+
+        if (widths[w] < 0){
+            rt_kprintf("  none       %12d%12d%12d%12d\r\n", result[0], result[1], blacklisted, extrapolated);
+        }
+        else{
+            rt_kprintf("  %2d MHz     %12d%12d%12d%12d\r\n", widths[w] * 2 + 1, result[0], result[1], blacklisted, extrapolated);
+        }
+    }
+
+    nRF24L01_Hop_Enable(_nrf24, RT_FALSE);
+    nRF24L01_Hop_Enable(peer, RT_FALSE);
+    nrf24_sim.jam_percent = 0;
+    nrf24_sim.peer_mode = peer_mode;
+}
+
+
+/***
+ * @brief msh 命令：虚拟空口的参数和统计
+ * @note  nrf24_sim                      打印统计
+ *        nrf24_sim loss <pct>           数据包 / 应答包各自的丢包率
+ *        nrf24_sim latency <us>         每个方向额外的传播延时
+ *        nrf24_sim jam <ch> [w] [pct]   在信道 ch ± w 上加窄带干扰，jam off 关闭
+ *        nrf24_sim hopbench [s] [len] [peer]  固定信道与跳频在不同干扰宽度下到对端实例的吞吐
+ *        nrf24_sim off|sink|echo        对端行为
+ *        nrf24_sim source <n> [len]     对端向驱动发送 n 包，每包 len 字节
+ *        nrf24_sim node <name> [ptx|prx] 再加一个跑完整协议栈的实例，缺省角色与当前实例相反
+ *        nrf24_sim reset                清零统计
+ */
+static void nrf24_sim_cmd(int argc, char **argv)
+{
+    rt_uint64_t elapsed;
+    rt_uint32_t busy;
+
+    if (argc > 2 && rt_strcmp(argv[1], "loss") == 0){
+        rt_uint32_t loss = atoi(argv[2]);
+        nrf24_sim.loss_percent = (loss > 100) ? 100 : loss;
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "latency") == 0){
+        nrf24_sim.latency_us = atoi(argv[2]);
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "jam") == 0){
+        if (rt_strcmp(argv[2], "off") == 0){
+            nrf24_sim.jam_percent = 0;
+        }
+        else{
+            rt_uint32_t pct = (argc > 4) ? atoi(argv[4]) : 100;
+            nrf24_sim.jam_ch      = atoi(argv[2]);
+            nrf24_sim.jam_width   = (argc > 3) ? atoi(argv[3]) : 0;
+            nrf24_sim.jam_percent = (pct > 100) ? 100 : pct;
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "hopbench") == 0){
+        rt_uint32_t seconds = (argc > 2) ? atoi(argv[2]) : 5;
+        rt_uint32_t len = (argc > 3) ? atoi(argv[3]) : 32;
+        nRF24L01_Sim_Hop_Bench(seconds ? seconds : 5, (len == 0 || len > 32) ? 32 : len, (argc > 4) ? argv[4] : "nrf_hop");
+        return;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "off") == 0){
+        nrf24_sim.peer_mode = NRF24_SIM_PEER_OFF;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "sink") == 0){
+        nrf24_sim.peer_mode = NRF24_SIM_PEER_SINK;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "echo") == 0){
+        nrf24_sim.peer_mode = NRF24_SIM_PEER_ECHO;
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "source") == 0){
+        rt_uint32_t len = (argc > 3) ? atoi(argv[3]) : 32;
+        rt_enter_critical();
+        nrf24_sim.peer_len = (len == 0 || len > 32) ? 32 : len;
+        nrf24_sim.peer_remaining = atoi(argv[2]);
+        nrf24_sim.peer_mode = NRF24_SIM_PEER_SOURCE;
+        rt_exit_critical();
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "node") == 0){
+        nrf24_role_et role = (_nrf24 != RT_NULL && _nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX) ? ROLE_PTX : ROLE_PRX;
+        if (argc > 3){
+            role = (rt_strcmp(argv[3], "prx") == 0) ? ROLE_PRX : ROLE_PTX;
+        }
+        if (nRF24L01_Find(argv[2]) != RT_NULL || nRF24L01_Sim_Add_Node(argv[2], role, RT_NULL) == RT_NULL){
+            rt_kprintf("[nrf24] can not add node %s.\r\n", argv[2]);
+        }
+        else{
+            rt_kprintf("[nrf24] node %s added as %s.\r\n", argv[2], (role == ROLE_PRX) ? "PRX" : "PTX");
+        }
+        return;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0){
+        rt_enter_critical();
+        nrf24_sim.attempts = nrf24_sim.data_lost = nrf24_sim.ack_lost = nrf24_sim.jam_lost = 0;
+        nrf24_sim.no_receiver = nrf24_sim.rx_full_drops = nrf24_sim.duplicates = nrf24_sim.delivered = 0;
+        nrf24_sim.peer_rx_packets = nrf24_sim.peer_rx_bytes = nrf24_sim.peer_tx_ok = nrf24_sim.peer_tx_failed = 0;
+        nrf24_sim.air_us = 0;
+        nrf24_sim.stat_start_us = nrf24_sim.now_us;
+        rt_exit_critical();
+    }
+
+    // 已排队但还没发完的发射在开始时就计入 air_us，统计窗口很短时会超出 elapsed
+    elapsed = nrf24_sim.now_us - nrf24_sim.stat_start_us;
+    busy = elapsed ? (rt_uint32_t)(nrf24_sim.air_us * 100 / elapsed) : 0;
+    rt_kprintf("[nrf24] sim %dms, air busy %d%%, loss %d%%, latency %dus\r\n",
+               (rt_uint32_t)(elapsed / 1000), (busy > 100) ? 100 : busy,
+               nrf24_sim.loss_percent, nrf24_sim.latency_us);
+    rt_kprintf("        attempts %d, delivered %d, duplicates %d, lost data %d / ack %d, no receiver %d, rx full %d\r\n",
+               nrf24_sim.attempts, nrf24_sim.delivered, nrf24_sim.duplicates, nrf24_sim.data_lost,
+               nrf24_sim.ack_lost, nrf24_sim.no_receiver, nrf24_sim.rx_full_drops);
+    if (nrf24_sim.jam_percent > 0){
+        rt_kprintf("        jammer %d~%d at %d%%, %d packets lost to it\r\n", nrf24_sim.jam_ch - nrf24_sim.jam_width,
+                   nrf24_sim.jam_ch + nrf24_sim.jam_width, nrf24_sim.jam_percent, nrf24_sim.jam_lost);
+    }
+    rt_kprintf("        peer %s: rx %d packets %d bytes, tx ok %d failed %d, remaining %d\r\n",
+               sim_peer_name[nrf24_sim.peer_mode], nrf24_sim.peer_rx_packets, nrf24_sim.peer_rx_bytes,
+               nrf24_sim.peer_tx_ok, nrf24_sim.peer_tx_failed, nrf24_sim.peer_remaining);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_sim_cmd, nrf24_sim, nrf24 simulator [loss <pct> | latency <us> | jam <ch> [w] [pct] | hopbench [s] [len] [peer] | off | sink | echo | source <n> [len] | node <name> [ptx|prx] | reset]);
+
+#endif
@@ -17,28 +17,63 @@
 #if USE_CUSTOMER_NRF24L01
 
 
-/* 片选引脚 -- CS */
-#define     nRF24_CS_PORT     nRF24L01_CE_GPIO_Port
-#define     nRF24_CS_PIN      nRF24L01_CE_Pin
-
-#define     nRF24_CS_SET(bit) if(bit) \
-                              HAL_GPIO_WritePin ( nRF24_CS_PORT, nRF24_CS_PIN , GPIO_PIN_SET );\
-                              else \
-                              HAL_GPIO_WritePin ( nRF24_CS_PORT, nRF24_CS_PIN , GPIO_PIN_RESET );
-
+/***
+ * 双射频
+ * NRF24_USE_DUAL_RADIO : 1 -> 在 SPI1 上再挂一片 nRF24L01（radio1），与 SPI2 上的 radio0 各有一个射频线程，
+ *                        两片的 CE / CSN / IRQ 引脚、SPI 设备和信号量互不相干，可以同时收发；
+ *                        radio1 的角色与 radio0 相反，一片常驻接收、一片常驻发送，组成全双工链路；
+ *                        需要在 board.h 中打开 BSP_USING_SPI1
+ */
+#define NRF24_USE_DUAL_RADIO        0
 
-/* SPI引脚 -- NSS */
-#define     nRF24_NSS_PORT     nRF24L01_CSN_GPIO_Port
-#define     nRF24_NSS_PIN      nRF24L01_CSN_Pin
+#if NRF24_USE_DUAL_RADIO && !defined(BSP_USING_SPI1)
+#error "NRF24_USE_DUAL_RADIO needs BSP_USING_SPI1 in board.h"
+#endif
 
 
-#define     nRF24_NSS_SET(bit) if(bit) \
-                               HAL_GPIO_WritePin ( nRF24_NSS_PORT, nRF24_NSS_PIN , GPIO_PIN_SET );\
-                               else \
-                               HAL_GPIO_WritePin ( nRF24_NSS_PORT, nRF24_NSS_PIN , GPIO_PIN_RESET );
+/***
+ * 一片 nRF24L01 的硬件连接
+ * spi_bus / spi_name : 挂载的 SPI 总线和挂载后的设备名
+ * csn_port / csn_pin : 片选 CSN，由 drv_spi 在传输时控制
+ * ce_port / ce_pin   : 使能 CE，收发切换时直接写 GPIO，可在中断中调用
+ * irq_pin            : IRQ 的 RT-Thread 引脚编号（GET_PIN）
+ * apb2               : SPI 挂在 APB2 上（SPI1），协商 SPI 时钟时按 PCLK2 分频，否则按 PCLK1
+ */
+struct nRF24L01_HW_CFG
+{
+    const char   *spi_bus;
+    const char   *spi_name;
+    GPIO_TypeDef *csn_port;
+    rt_uint16_t   csn_pin;
+    GPIO_TypeDef *ce_port;
+    rt_uint16_t   ce_pin;
+    rt_base_t     irq_pin;
+    rt_uint8_t    apb2;
+};
+
+
+/* 使能引脚 -- CE */
+#define     nRF24_CE_SET(hw, bit) HAL_GPIO_WritePin((hw)->ce_port, (hw)->ce_pin, (bit) ? GPIO_PIN_SET : GPIO_PIN_RESET)
+
+
+/***
+ * SPI 时钟协商参数
+ * NRF24_SPI_DEFAULT_HZ    : 协商前 / 协商失败时使用的保守速率
+ * NRF24_SPI_MAX_HZ        : nRF24L01 手册规定的 SPI 最高速率
+ * NRF24_SPI_CHECK_ROUNDS  : 每一档速率连续通过回环写读的次数
+ * NRF24_SPI_MARGIN_STEPS  : 在出现失败的速率档之下再回退的分频档数（安全余量）
+ */
+#define     NRF24_SPI_DEFAULT_HZ      (1*1000*1000)
+#define     NRF24_SPI_MAX_HZ          (10*1000*1000)
+#define     NRF24_SPI_CHECK_ROUNDS    8
+#define     NRF24_SPI_MARGIN_STEPS    1
 
 
 extern const struct nRF24L01_FUNC_OPS g_nrf24_func_ops;
+extern const struct nRF24L01_HW_CFG g_nrf24_hw_radio0;
+#if NRF24_USE_DUAL_RADIO
+extern const struct nRF24L01_HW_CFG g_nrf24_hw_radio1;
+#endif
 
 
 
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-25     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_stat.h"
+
+
+
+/***
+ * @brief   初始化链路统计
+ */
+void nRF24L01_Stat_Init(nrf24_t nrf24)
+{
+    rt_memset(&nrf24->stat, 0, sizeof(struct nRF24L01_STAT_STRUCT));
+    nrf24->stat.reset_tick = rt_tick_get();
+}
+
+
+/***
+ * @brief   清零链路统计、各管道解码器的计数和 IRQ 延时直方图
+ * @note    解码器只清计数，不打断正在解码的帧
+ */
+void nRF24L01_Stat_Reset(nrf24_t nrf24)
+{
+    nrf24_decoder_t dec;
+
+    rt_enter_critical();
+    nRF24L01_Stat_Init(nrf24);
+    for(rt_uint8_t i = 0; i < NRF24_STAT_PIPES; i++){
+        dec = &nrf24->decoder[i];
+        dec->frames = dec->crc_errors = dec->length_errors = dec->id_errors = dec->sync_drops = 0;
+    }
+    rt_exit_critical();
+
+    nRF24L01_Debug_Reset_Latency(nrf24);
+}
+
+
+/***
+ * @brief   取一份统计快照
+ * @param   snap  输出，格式见 struct nrf24_stat_snapshot
+ * @note    可在任意线程中调用；计数器只由射频线程修改，拷贝期间锁调度器，得到的是同一时刻的一组值
+ */
+void nRF24L01_Stat_Snapshot(nrf24_t nrf24, struct nrf24_stat_snapshot *snap)
+{
+    struct nRF24L01_STAT_STRUCT *stat = &nrf24->stat;
+    nrf24_decoder_t dec;
+
+    rt_memset(snap, 0, sizeof(struct nrf24_stat_snapshot));
+    snap->magic   = NRF24_STAT_MAGIC;
+    snap->version = NRF24_STAT_VERSION;
+    snap->size    = sizeof(struct nrf24_stat_snapshot);
+
+    rt_enter_critical();
+    snap->role  = nrf24->nrf24_cfg.config.prim_rx;
+    snap->rf_ch = nrf24->nrf24_cfg.rf_ch.rf_ch;
+    snap->uptime_ms = (rt_uint32_t)((rt_uint64_t)(rt_tick_get() - stat->reset_tick) * 1000 / RT_TICK_PER_SECOND);
+
+    rt_memcpy(snap->tx_packets, stat->tx_packets, sizeof(snap->tx_packets));
+    rt_memcpy(snap->tx_bytes, stat->tx_bytes, sizeof(snap->tx_bytes));
+    rt_memcpy(snap->rx_packets, stat->rx_packets, sizeof(snap->rx_packets));
+    rt_memcpy(snap->rx_bytes, stat->rx_bytes, sizeof(snap->rx_bytes));
+    snap->tx_ds  = stat->tx_ds;
+    snap->max_rt = stat->max_rt;
+    rt_memcpy(snap->arc_hist, stat->arc_hist, sizeof(snap->arc_hist));
+    snap->rx_fifo_full = stat->rx_fifo_full;
+    snap->rx_corrupt   = stat->rx_corrupt;
+
+    for(rt_uint8_t i = 0; i < NRF24_STAT_PIPES; i++){
+        dec = &nrf24->decoder[i];
+        snap->frames[i]        = dec->frames;
+        snap->crc_errors[i]    = dec->crc_errors;
+        snap->length_errors[i] = dec->length_errors;
+        snap->id_errors[i]     = dec->id_errors;
+        snap->sync_drops[i]    = dec->sync_drops;
+    }
+
+    snap->irq_samples = nrf24->latency.count;
+    if(nrf24->latency.count != 0){
+        snap->irq_min_us = nrf24->latency.min_us;
+        snap->irq_avg_us = (rt_uint32_t)(nrf24->latency.sum_us / nrf24->latency.count);
+        snap->irq_max_us = nrf24->latency.max_us;
+    }
+    rt_exit_critical();
+}
+
+
+
+/***
+ * @brief   每秒的字节数，uptime_ms 为 0 时返回 0
+ */
+static rt_uint32_t nRF24L01_Stat_Rate(rt_uint32_t bytes, rt_uint32_t uptime_ms)
+{
+    if(uptime_ms == 0){
+        return 0;
+    }
+    return (rt_uint32_t)((rt_uint64_t)bytes * 1000 / uptime_ms);
+}
+
+
+/***
+ * @brief msh 命令：链路统计
+ * @note  nrf24_stat          打印各管道收发量、重发直方图、RX FIFO 溢出、解码错误和 IRQ 延时
+ *        nrf24_stat bin      以十六进制输出二进制快照（struct nrf24_stat_snapshot），供上位机轮询解析
+ *        nrf24_stat reset    打印后清零
+ */
+static void nrf24_stat_cmd(int argc, char **argv)
+{
+    struct nrf24_stat_snapshot snap;
+    rt_uint32_t tx_bytes = 0, rx_bytes = 0, arc_sum = 0;
+    rt_uint8_t *raw = (rt_uint8_t *)&snap;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+
+    nRF24L01_Stat_Snapshot(_nrf24, &snap);
+
+    if (argc > 1 && rt_strcmp(argv[1], "bin") == 0)
+    {
+        for (rt_uint16_t i = 0; i < sizeof(snap); i++){
+            rt_kprintf("%02X%s", raw[i], ((i & 31) == 31 || i == sizeof(snap) - 1) ? "\r\n" : "");
+        }
+        return;
+    }
+
+    rt_kprintf("[nrf24] %s, channel %d, %d.%03ds since reset\r\n", snap.role ? "PRX" : "PTX", snap.rf_ch,
+               snap.uptime_ms / 1000, snap.uptime_ms % 1000);
+    rt_kprintf("pipe  tx_pkts  tx_bytes   rx_pkts  rx_bytes    frames   crc_err   len_err    id_err\r\n");
+    for (rt_uint8_t i = 0; i < NRF24_STAT_PIPES; i++)
+    {
+        rt_kprintf("p%d  %8d  %8d  %8d  %8d  %8d  %8d  %8d  %8d\r\n", i,
+                   snap.tx_packets[i], snap.tx_bytes[i], snap.rx_packets[i], snap.rx_bytes[i],
+                   snap.frames[i], snap.crc_errors[i], snap.length_errors[i], snap.id_errors[i]);
+        tx_bytes += snap.tx_bytes[i];
+        rx_bytes += snap.rx_bytes[i];
+    }
+    rt_kprintf("throughput: tx %d B/s, rx %d B/s\r\n",
+               nRF24L01_Stat_Rate(tx_bytes, snap.uptime_ms), nRF24L01_Stat_Rate(rx_bytes, snap.uptime_ms));
+
+    for (rt_uint8_t i = 0; i < NRF24_STAT_ARC_BUCKETS; i++){
+        arc_sum += snap.arc_hist[i] * i;
+    }
+    rt_kprintf("tx_ds %d, max_rt %d, avg retries %d.%02d\r\n", snap.tx_ds, snap.max_rt,
+               snap.tx_ds ? arc_sum / snap.tx_ds : 0, snap.tx_ds ? (arc_sum * 100 / snap.tx_ds) % 100 : 0);
+    rt_kprintf("arc_cnt:");
+    for (rt_uint8_t i = 0; i < NRF24_STAT_ARC_BUCKETS; i++){
+        if (snap.arc_hist[i] != 0){
+            rt_kprintf(" %d:%d", i, snap.arc_hist[i]);
+        }
+    }
+    rt_kprintf("\r\n");
+
+    rt_kprintf("rx_fifo_full %d, rx_corrupt %d\r\n", snap.rx_fifo_full, snap.rx_corrupt);
+    rt_kprintf("irq->service latency: %d samples, min %dus, avg %dus, max %dus\r\n",
+               snap.irq_samples, snap.irq_min_us, snap.irq_avg_us, snap.irq_max_us);
+
+    if (argc > 1 && rt_strcmp(argv[1], "reset") == 0){
+        nRF24L01_Stat_Reset(_nrf24);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_stat_cmd, nrf24_stat, per pipe link statistics [bin | reset]);
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-25     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_STAT_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_STAT_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 链路统计
+ * 热路径上每个事件只做一两次计数器自增，不额外读寄存器：
+ * TX      : 发送完成时计数：PTX 的发送队列 / 同步接口数据包在 TX_DS 时记在管道 0，PRX 的 ACK 载荷随应答发出时记在对应管道；
+ *           重新写入、FIFO 探测包、被清空的数据包不计入
+ * TX_DS   : 发送成功的中断次数，ARC_CNT 直方图取自同一次中断读出的 OBSERVE_TX（与链路自适应共用一次读取）；
+ *           多包的 TX_DS 合并为一次时只计一次
+ * MAX_RT  : 达到最大重发次数的次数
+ * RX      : 从 RX FIFO 读出的包数和字节数，按管道统计
+ * rx_fifo_full : 一次读空 RX FIFO 时读出 3 包及以上的次数，即 RX FIFO 曾经写满，之后到达的包会被芯片丢弃
+ * rx_corrupt   : R_RX_PL_WID 读出的长度不合法、清空 RX FIFO 的次数
+ * CRC / 长度 / 设备 ID 错误直接取自各管道的帧解码器，IRQ -> 服务延时取自实例的 latency，读出时汇总
+ */
+#define NRF24_STAT_PIPES            6
+#define NRF24_STAT_ARC_BUCKETS      16
+
+
+struct nRF24L01_STAT_STRUCT
+{
+    rt_uint32_t tx_packets[NRF24_STAT_PIPES];
+    rt_uint32_t tx_bytes[NRF24_STAT_PIPES];
+    rt_uint32_t rx_packets[NRF24_STAT_PIPES];
+    rt_uint32_t rx_bytes[NRF24_STAT_PIPES];
+
+    rt_uint32_t tx_ds;
+    rt_uint32_t max_rt;
+    /* 发送成功的包按 ARC_CNT（重发次数）分桶 */
+    rt_uint32_t arc_hist[NRF24_STAT_ARC_BUCKETS];
+
+    rt_uint32_t rx_fifo_full;
+    rt_uint32_t rx_corrupt;
+
+    /* 上次清零的时刻 */
+    rt_tick_t   reset_tick;
+};
+
+
+/***
+ * 二进制快照，供上位机轮询
+ * 小端，8 字节头之后全部为 32 位计数，没有填充；新增字段只追加在末尾并增加 version，
+ * 上位机按 size 截取自己认识的部分即可
+ */
+#define NRF24_STAT_MAGIC            0x5453      /* "ST" */
+#define NRF24_STAT_VERSION          1
+
+struct nrf24_stat_snapshot
+{
+    rt_uint16_t magic;
+    rt_uint8_t  version;
+    /* 0: PTX  1: PRX */
+    rt_uint8_t  role;
+    rt_uint16_t size;
+    rt_uint8_t  rf_ch;
+    rt_uint8_t  reserved;
+
+    /* 上次清零以来的毫秒数 */
+    rt_uint32_t uptime_ms;
+
+    rt_uint32_t tx_packets[NRF24_STAT_PIPES];
+    rt_uint32_t tx_bytes[NRF24_STAT_PIPES];
+    rt_uint32_t rx_packets[NRF24_STAT_PIPES];
+    rt_uint32_t rx_bytes[NRF24_STAT_PIPES];
+    rt_uint32_t tx_ds;
+    rt_uint32_t max_rt;
+    rt_uint32_t arc_hist[NRF24_STAT_ARC_BUCKETS];
+    rt_uint32_t rx_fifo_full;
+    rt_uint32_t rx_corrupt;
+
+    /* 各管道帧解码器 */
+    rt_uint32_t frames[NRF24_STAT_PIPES];
+    rt_uint32_t crc_errors[NRF24_STAT_PIPES];
+    rt_uint32_t length_errors[NRF24_STAT_PIPES];
+    rt_uint32_t id_errors[NRF24_STAT_PIPES];
+    rt_uint32_t sync_drops[NRF24_STAT_PIPES];
+
+    /* IRQ -> 服务延时 */
+    rt_uint32_t irq_samples;
+    rt_uint32_t irq_min_us;
+    rt_uint32_t irq_avg_us;
+    rt_uint32_t irq_max_us;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_STAT_H_ */
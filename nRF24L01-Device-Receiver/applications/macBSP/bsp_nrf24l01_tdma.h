@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-21     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_TDMA_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_TDMA_H_
+#include "bsp_sys.h"
+
+
+/***
+ * TDMA 超帧
+ *
+ *   | 信标 | BEACON_US | 时隙 0 | 时隙 1 | ... | 时隙 SLOTS-1 | 竞争时隙 JOIN_US |
+ *
+ * 中心以 PTX 向管道 1 的地址广播信标（NO_ACK），随后回到 PRX；节点平时以 PRX 监听管道 1，
+ * 以收到信标的 IRQ 时刻为基准推算各时隙，只在自己的时隙内切换为 PTX 向中心的管道 0 发送，时隙结束后回到监听；
+ * 还没有时隙的节点在竞争时隙内随机退避后发 JOIN，中心在下一个信标中分配时隙
+ *
+ * NRF24_TDMA_HUB      : 1 -> 本机作为 TDMA 中心
+ * NRF24_TDMA_NODE_ID  : 节点编号 1~254，0 为不参与 TDMA
+ * NRF24_TDMA_SLOTS    : 每个超帧的数据时隙数，不超过信标能容纳的 25 个
+ * NRF24_TDMA_SLOT_US  : 数据时隙长度
+ * NRF24_TDMA_BEACON_US: 信标结束到时隙 0 开始的间隔，中心在这段时间里切回 PRX
+ * NRF24_TDMA_JOIN_US  : 竞争时隙长度
+ * NRF24_TDMA_GUARD_US : 时隙两端的保护时间
+ * NRF24_TDMA_EXPIRE   : 中心连续多少个超帧收不到某时隙的数据就收回该时隙
+ */
+#define NRF24_TDMA_HUB              0
+#define NRF24_TDMA_NODE_ID          0
+#define NRF24_TDMA_SLOTS            8
+#define NRF24_TDMA_SLOT_US          2000
+#define NRF24_TDMA_BEACON_US        500
+#define NRF24_TDMA_JOIN_US          2000
+#define NRF24_TDMA_GUARD_US         50
+#define NRF24_TDMA_EXPIRE           16
+
+#define NRF24_TDMA_SUPERFRAME_US    (NRF24_TDMA_BEACON_US + NRF24_TDMA_SLOTS * NRF24_TDMA_SLOT_US + NRF24_TDMA_JOIN_US)
+
+#if NRF24_TDMA_SLOTS < 1 || NRF24_TDMA_SLOTS > 25
+#error "NRF24_TDMA_SLOTS must be 1 ~ 25"
+#endif
+#if NRF24_TDMA_NODE_ID > 254 || (NRF24_TDMA_HUB && NRF24_TDMA_NODE_ID != 0)
+#error "NRF24_TDMA_NODE_ID must be 1 ~ 254 on a node and 0 on the hub"
+#endif
+#if (NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0) && (NRF24_ROTATE_NODES > 0 || NRF24_ROTATE_NODE_ID >= 0)
+#error "TDMA and address rotation both use pipe 1, enable only one"
+#endif
+
+
+/***
+ * 定时器
+ * NRF24_TDMA_TIMER_NAME : 时隙定时用的硬件定时器，不能与切换引擎共用；
+ *                         未开启 RT_USING_HWTIMER 时退化为 rt_timer，时隙边界只有 tick 精度，需相应加大 SLOT_US 和 GUARD_US
+ */
+#define NRF24_TDMA_TIMER_NAME       "timer4"
+#define NRF24_TDMA_TIMER_HZ         1000000
+
+
+/***
+ * TDMA 报文
+ * byte0 : 高 4 位 = 0111 TDMA 标记（轮换为 0110，切换引擎为 0100，可靠传输为 10xxxxxx，分片为 11xxxxxx，协议帧以 0x55 开头）
+ *         低 4 位        报文类型
+ *
+ * BEACON : 中心 -> 管道 1 广播   byte1 超帧序号   byte2 时隙数   byte3~4 时隙长度(us)   byte5~6 竞争时隙长度(us)
+ *                               byte7 起每个时隙的节点编号，0 为空闲
+ * JOIN   : 节点 -> 中心，竞争时隙内发送   byte1 节点编号
+ * KEEP   : 节点 -> 中心，时隙开始时软件队列为空则发一包保活，中心不会收回时隙   byte1 节点编号
+ */
+#define NRF24_TDMA_MARK             0x70
+#define NRF24_TDMA_MARK_MASK        0xF0
+#define NRF24_TDMA_TYPE_MASK        0x0F
+#define NRF24_TDMA_BEACON           0x01
+#define NRF24_TDMA_JOIN             0x02
+#define NRF24_TDMA_KEEP             0x03
+#define NRF24_TDMA_BEACON_HEADER    7
+
+
+/***
+ * TDMA 状态
+ * IDLE      : 中心以 PRX 接收 / 节点尚未开始
+ * BEACON_TX : 中心，信标已写入，等待 TX_DS
+ * LISTEN    : 节点，PRX 监听信标
+ * WAIT_SLOT : 节点，已切换为 PTX、CE 低，软件队列写入 TX FIFO，等待时隙开始
+ * IN_SLOT   : 节点，CE 高，芯片连续发送 TX FIFO
+ * DRAIN     : 节点，CE 已拉低，等待最后一包发完
+ * JOIN_WAIT : 节点，JOIN 已写入，等待竞争时隙中的退避时刻
+ * JOIN_TX   : 节点，JOIN 已开始发送，等待 TX_DS / MAX_RT
+ */
+typedef enum
+{
+    NRF24_TDMA_IDLE = 0,
+    NRF24_TDMA_BEACON_TX,
+    NRF24_TDMA_LISTEN,
+    NRF24_TDMA_WAIT_SLOT,
+    NRF24_TDMA_IN_SLOT,
+    NRF24_TDMA_DRAIN,
+    NRF24_TDMA_JOIN_WAIT,
+    NRF24_TDMA_JOIN_TX,
+}nrf24_tdma_state_et;
+
+
+/***
+ * 定时器到期后在中断里要做的事
+ * BEACON     : 中心，置位 due 并唤醒射频线程发信标（周期定时）
+ * SLOT_START : 节点，拉高 CE，并定时到 CE_LOW
+ * CE_LOW     : 节点，拉低 CE，留出最后一包发完的时间，并定时到 FINISH
+ * FINISH     : 节点，置位 due 并唤醒射频线程回到监听
+ * JOIN       : 节点，拉高 CE 发出 JOIN
+ */
+typedef enum
+{
+    NRF24_TDMA_TIMER_BEACON = 0,
+    NRF24_TDMA_TIMER_SLOT_START,
+    NRF24_TDMA_TIMER_CE_LOW,
+    NRF24_TDMA_TIMER_FINISH,
+    NRF24_TDMA_TIMER_JOIN,
+}nrf24_tdma_timer_et;
+
+
+/***
+ * TDMA 超帧调度
+ */
+struct nRF24L01_TDMA_STRUCT
+{
+    /* 硬件定时器，RT_NULL 时使用 rt_timer */
+    rt_device_t timer;
+    struct rt_timer soft_timer;
+    volatile rt_uint8_t timer_action;
+    volatile rt_uint8_t due;
+    /* 节点：CE_LOW / FINISH 的时刻（DWT 周期计数），由中断接力定时 */
+    rt_uint32_t ce_low_cycles;
+    rt_uint32_t finish_cycles;
+    /* 定时精度：每次到期比目标时刻晚多少 DWT 周期（负数为提前），中心的信标按相邻两次的间隔计 */
+    rt_uint32_t timer_at_cycles;
+    rt_uint32_t edges;
+    rt_int32_t  late_min;
+    rt_int32_t  late_max;
+    rt_int64_t  late_sum;
+
+    rt_uint8_t  state;
+    rt_uint8_t  seq;
+    /* 每个时隙的节点编号 */
+    rt_uint8_t  owner[NRF24_TDMA_SLOTS];
+    /* 最近一个信标的时刻：中心为 TX_DS，节点为 RX_DR 的 IRQ 时刻 */
+    rt_uint32_t beacon_cycles;
+
+    /* 中心 */
+    rt_uint32_t superframes;
+    rt_uint32_t seen[NRF24_TDMA_SLOTS];
+    rt_uint32_t slot_rx[NRF24_TDMA_SLOTS];
+    rt_uint32_t outside;
+    rt_uint32_t joins;
+    rt_uint32_t expired;
+
+    /* 节点 */
+    rt_int8_t   my_slot;
+    rt_uint8_t  keep_inflight;
+    rt_uint32_t rand;
+    rt_uint32_t beacons;
+    rt_uint32_t beacons_lost;
+    rt_uint32_t slots_used;
+    rt_uint32_t join_sent;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_TDMA_H_ */
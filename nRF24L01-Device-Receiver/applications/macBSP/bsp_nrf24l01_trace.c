@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-26     Administrator       the first version
+ */
+#include <stdarg.h>
+#include "bsp_sys.h"
+#include "bsp_nrf24l01_trace.h"
+
+#if NRF24_TRACE_BINARY
+
+/* 跟踪环形缓冲和统计 */
+struct nRF24L01_TRACE_STRUCT nrf24_trace;
+
+
+
+/***
+ * @brief   把一条完整的记录放入环形缓冲，空间不足时整条丢弃
+ * @note    任意线程中可调用；关中断只覆盖下标检查和不超过 45 字节的拷贝
+ */
+static void nRF24L01_Trace_Put(const rt_uint8_t *rec, rt_uint32_t len)
+{
+    rt_uint32_t used, pos, first;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    used = nrf24_trace.head - nrf24_trace.tail;
+    if(used + len > NRF24_TRACE_RING_SIZE){
+        nrf24_trace.drops++;
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    pos = nrf24_trace.head & (NRF24_TRACE_RING_SIZE - 1);
+    first = NRF24_TRACE_RING_SIZE - pos;
+    if(first >= len){
+        rt_memcpy(&nrf24_trace.ring[pos], rec, len);
+    }
+    else{
+        rt_memcpy(&nrf24_trace.ring[pos], rec, first);
+        rt_memcpy(nrf24_trace.ring, rec + first, len - first);
+    }
+    nrf24_trace.head += len;
+    nrf24_trace.records++;
+    nrf24_trace.bytes += len;
+    if(used + len > nrf24_trace.high_water){
+        nrf24_trace.high_water = used + len;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+
+/***
+ * @brief   填写帧头，返回帧头长度
+ */
+static rt_uint32_t nRF24L01_Trace_Header(rt_uint8_t *rec, rt_uint8_t level, rt_uint8_t type, rt_uint16_t id)
+{
+    rt_uint32_t now = DWT->CYCCNT;
+
+    rec[0] = NRF24_TRACE_SYNC;
+    rec[1] = (level << 4) | type;
+    rec[2] = id & 0xFF;
+    rec[3] = id >> 8;
+    rec[4] = now & 0xFF;
+    rec[5] = (now >> 8) & 0xFF;
+    rec[6] = (now >> 16) & 0xFF;
+    rec[7] = now >> 24;
+    return NRF24_TRACE_HEADER_SIZE;
+}
+
+
+/***
+ * @brief   追加从 byte1 起的累加和，返回整条记录的长度
+ */
+static rt_uint32_t nRF24L01_Trace_Seal(rt_uint8_t *rec, rt_uint32_t len)
+{
+    rt_uint8_t sum = 0;
+
+    for(rt_uint32_t i = 1; i < len; i++){
+        sum += rec[i];
+    }
+    rec[len] = sum;
+    return len + 1;
+}
+
+
+/***
+ * @brief   写一条跟踪记录，由 NRF24_TRACE / LOG_x 宏调用
+ * @param   fmt    .nrf24_trace 段中的格式串，只取地址作为编号，不在 MCU 上解析
+ *          nargs  参数个数，每个参数按 32 位读取
+ */
+void nRF24L01_Trace_Write(rt_uint8_t level, const char *fmt, rt_uint8_t nargs, ...)
+{
+    rt_uint8_t rec[NRF24_TRACE_HEADER_SIZE + NRF24_TRACE_MAX_ARGS * 4 + 1];
+    rt_uint32_t len, arg;
+    va_list ap;
+
+    if(level > nrf24_trace.level){
+        return;
+    }
+    if(nargs > NRF24_TRACE_MAX_ARGS){
+        nargs = NRF24_TRACE_MAX_ARGS;
+    }
+
+    len = nRF24L01_Trace_Header(rec, level, nargs, (rt_uint16_t)(rt_uint32_t)fmt);
+    va_start(ap, nargs);
+    for(rt_uint8_t i = 0; i < nargs; i++){
+        arg = va_arg(ap, rt_uint32_t);
+        rec[len++] = arg & 0xFF;
+        rec[len++] = (arg >> 8) & 0xFF;
+        rec[len++] = (arg >> 16) & 0xFF;
+        rec[len++] = arg >> 24;
+    }
+    va_end(ap);
+
+    nRF24L01_Trace_Put(rec, nRF24L01_Trace_Seal(rec, len));
+}
+
+
+/***
+ * @brief   写一条十六进制数据记录，由 LOG_HEX 宏调用
+ * @param   name  名称，应为 Flash 中的常量字符串，解码时按地址从 ELF 中读取
+ */
+void nRF24L01_Trace_Hex(const char *name, const rt_uint8_t *buf, rt_uint8_t len)
+{
+    rt_uint8_t rec[NRF24_TRACE_HEADER_SIZE + 5 + 32 + 1];
+    rt_uint32_t n, addr = (rt_uint32_t)name;
+
+    if(NRF24_TRACE_LVL_D > nrf24_trace.level){
+        return;
+    }
+    if(len > 32){
+        len = 32;
+    }
+
+    n = nRF24L01_Trace_Header(rec, NRF24_TRACE_LVL_D, NRF24_TRACE_HEX, 0);
+    rec[n++] = addr & 0xFF;
+    rec[n++] = (addr >> 8) & 0xFF;
+    rec[n++] = (addr >> 16) & 0xFF;
+    rec[n++] = addr >> 24;
+    rec[n++] = len;
+    rt_memcpy(&rec[n], buf, len);
+    n += len;
+
+    nRF24L01_Trace_Put(rec, nRF24L01_Trace_Seal(rec, n));
+}
+
+
+/***
+ * @brief   跟踪输出线程：定时把环形缓冲中的记录整块写到输出设备
+ * @note    丢弃的记录数以一条编号为 0 的记录报告；控制台以流模式打开时串口驱动会在 0x0A 前插入 0x0D，
+ *          解码工具按 --stream 把它去掉
+ */
+static void nRF24L01_Trace_Thread_Entry(void *parameter)
+{
+    rt_device_t dev = (rt_device_t)parameter;
+    rt_uint8_t rec[NRF24_TRACE_HEADER_SIZE + 4 + 1];
+    rt_uint32_t drops, tail, pos, chunk, n;
+
+    for(;;)
+    {
+        rt_thread_mdelay(NRF24_TRACE_FLUSH_MS);
+
+        drops = nrf24_trace.drops;
+        if(drops != nrf24_trace.drops_reported && nrf24_trace.head - nrf24_trace.tail <= NRF24_TRACE_RING_SIZE / 2){
+            n = nRF24L01_Trace_Header(rec, NRF24_TRACE_LVL_W, 1, NRF24_TRACE_ID_DROP);
+            rec[n++] = (drops - nrf24_trace.drops_reported) & 0xFF;
+            rec[n++] = ((drops - nrf24_trace.drops_reported) >> 8) & 0xFF;
+            rec[n++] = ((drops - nrf24_trace.drops_reported) >> 16) & 0xFF;
+            rec[n++] = (drops - nrf24_trace.drops_reported) >> 24;
+            nRF24L01_Trace_Put(rec, nRF24L01_Trace_Seal(rec, n));
+            nrf24_trace.drops_reported = drops;
+        }
+
+        // 只有本线程移动 tail，生产者只移动 head
+        tail = nrf24_trace.tail;
+        while(tail != nrf24_trace.head)
+        {
+            pos = tail & (NRF24_TRACE_RING_SIZE - 1);
+            chunk = nrf24_trace.head - tail;
+            if(chunk > NRF24_TRACE_RING_SIZE - pos){
+                chunk = NRF24_TRACE_RING_SIZE - pos;
+            }
+            rt_device_write(dev, 0, &nrf24_trace.ring[pos], chunk);
+            tail += chunk;
+            nrf24_trace.tail = tail;
+        }
+    }
+}
+
+
+/***
+ * @brief   初始化二进制跟踪并启动输出线程
+ */
+static int nRF24L01_Trace_Init(void)
+{
+    rt_device_t dev;
+    rt_thread_t thread;
+
+    nrf24_trace.level = NRF24_TRACE_LVL_D;
+
+    dev = rt_device_find(NRF24_TRACE_DEVICE);
+    if(dev == RT_NULL){
+        rt_kprintf("[nrf24] trace device %s not found.\r\n", NRF24_TRACE_DEVICE);
+        return -RT_ERROR;
+    }
+    if((dev->open_flag & RT_DEVICE_OFLAG_OPEN) == 0 && rt_device_open(dev, RT_DEVICE_OFLAG_WRONLY) != RT_EOK){
+        rt_kprintf("[nrf24] trace device %s open failed.\r\n", NRF24_TRACE_DEVICE);
+        return -RT_ERROR;
+    }
+
+    thread = rt_thread_create("nrf24_trace", nRF24L01_Trace_Thread_Entry, dev, 512, NRF24_TRACE_THREAD_PRIORITY, 10);
+    if(thread == RT_NULL){
+        rt_kprintf("[nrf24] trace thread create failed.\r\n");
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(thread);
+
+    return RT_EOK;
+}
+INIT_COMPONENT_EXPORT(nRF24L01_Trace_Init);
+
+
+
+/***
+ * @brief msh 命令：二进制跟踪统计
+ * @note  nrf24_trace                打印记录数、字节数、丢弃数和缓冲区高水位
+ *        nrf24_trace level <0~7>    运行时级别，高于该级别的记录不写入（3 E  4 W  6 I  7 D）
+ *        nrf24_trace bench [次数]   对比同一条日志文本格式化（ulog）与二进制记录的耗时和字节数
+ *        nrf24_trace reset          清零统计
+ */
+static void nrf24_trace_cmd(int argc, char **argv)
+{
+    if (argc > 2 && rt_strcmp(argv[1], "level") == 0)
+    {
+        nrf24_trace.level = atoi(argv[2]);
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "bench") == 0)
+    {
+        rt_uint32_t loops = (argc > 2) ? atoi(argv[2]) : 100;
+        rt_uint32_t start, text_cycles = 0, bin_cycles = 0, text_bytes, bin_bytes;
+        char line[ULOG_LINE_BUF_SIZE];
+
+        if (loops == 0 || loops > 1000){
+            rt_kprintf("Usage: nrf24_trace bench [1~1000]\r\n");
+            return;
+        }
+
+        // 文本：ulog 的格式化和拷贝（异步输出，不含串口时间）；字节数按 ulog 的行前缀 + 正文 + 换行估算
+        for (rt_uint32_t i = 0; i < loops; i++){
+            start = nRF24L01_Debug_Get_Cycles();
+            ulog_output(LOG_LVL_INFO, "nrf24", RT_TRUE, "LOG:%d. nrf24 link: tx %d, fail %d, arc %d.", i, 1000 + i, i & 7, i & 15);
+            text_cycles += nRF24L01_Debug_Get_Cycles() - start;
+            rt_thread_mdelay(1);
+        }
+        text_bytes = rt_snprintf(line, sizeof(line), "[%d] I/nrf24: LOG:%d. nrf24 link: tx %d, fail %d, arc %d.\r\n",
+                                 rt_tick_get(), loops, 1000 + loops, loops & 7, loops & 15);
+
+        for (rt_uint32_t i = 0; i < loops; i++){
+            start = nRF24L01_Debug_Get_Cycles();
+            NRF24_TRACE(NRF24_TRACE_LVL_I, "LOG:%d. nrf24 link: tx %d, fail %d, arc %d.", i, 1000 + i, i & 7, i & 15);
+            bin_cycles += nRF24L01_Debug_Get_Cycles() - start;
+            rt_thread_mdelay(1);
+        }
+        bin_bytes = NRF24_TRACE_HEADER_SIZE + 4 * 4 + 1;
+
+        rt_kprintf("[nrf24] one log line with 4 arguments, %d loops\r\n", loops);
+        rt_kprintf("text   (ulog) : %d cycles, %d bytes\r\n", text_cycles / loops, text_bytes);
+        rt_kprintf("binary (trace): %d cycles, %d bytes\r\n", bin_cycles / loops, bin_bytes);
+        return;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        nrf24_trace.records = nrf24_trace.bytes = nrf24_trace.high_water = 0;
+        nrf24_trace.drops_reported = nrf24_trace.drops = 0;
+    }
+
+    rt_kprintf("[nrf24] trace level %d, %d records, %d bytes, %d dropped, ring %d / %d bytes (high water %d)\r\n",
+               nrf24_trace.level, nrf24_trace.records, nrf24_trace.bytes, nrf24_trace.drops,
+               nrf24_trace.head - nrf24_trace.tail, NRF24_TRACE_RING_SIZE, nrf24_trace.high_water);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_trace_cmd, nrf24_trace, binary trace stats [level <0~7> | bench [loops] | reset]);
+
+#endif /* NRF24_TRACE_BINARY */
@@ -267,6 +267,7 @@ static rt_err_t stm32_spi_init(struct stm32_spi *spi_drv, struct rt_spi_configur
 static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *message)
 {
     HAL_StatusTypeDef state;
+    rt_bool_t use_dma;
     rt_size_t message_length, already_send_length;
     rt_uint16_t send_length;
     rt_uint8_t *recv_buf;
@@ -314,38 +315,49 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         send_buf = (rt_uint8_t *)message->send_buf + already_send_length;
         recv_buf = (rt_uint8_t *)message->recv_buf + already_send_length;
         
+        /* short transfers are cheaper in polling mode */
+        use_dma = (send_length >= SPI_DMA_MIN_LENGTH);
+        if (use_dma)
+        {
+            rt_completion_init(&spi_drv->cpt);
+        }
+
         /* start once data exchange in DMA mode */
         if (message->send_buf && message->recv_buf)
         {
-            if ((spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
+            if (use_dma && (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
             {
                 state = HAL_SPI_TransmitReceive_DMA(spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, send_length);
             }
             else
             {
+                use_dma = RT_FALSE;
                 state = HAL_SPI_TransmitReceive(spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, send_length, 1000);
             }
         }
         else if (message->send_buf)
         {
-            if (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG)
+            if (use_dma && (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG))
             {
                 state = HAL_SPI_Transmit_DMA(spi_handle, (uint8_t *)send_buf, send_length);
             }
             else
             {
+                use_dma = RT_FALSE;
                 state = HAL_SPI_Transmit(spi_handle, (uint8_t *)send_buf, send_length, 1000);
             }
         }
         else
         {
             memset((uint8_t *)recv_buf, 0xff, send_length);
-            if (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG)
+            /* in full duplex master mode the HAL receives by transmitting recv_buf itself, so both channels are needed */
+            if (use_dma && (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
             {
                 state = HAL_SPI_Receive_DMA(spi_handle, (uint8_t *)recv_buf, send_length);
             }
             else
             {
+                use_dma = RT_FALSE;
                 state = HAL_SPI_Receive(spi_handle, (uint8_t *)recv_buf, send_length, 1000);
             }
         }
@@ -356,14 +368,24 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
             message->length = 0;
             spi_handle->State = HAL_SPI_STATE_READY;
         }
+        else if (use_dma)
+        {
+            /* sleep until the DMA transfer complete interrupt, the CPU is free for other threads meanwhile */
+            if (rt_completion_wait(&spi_drv->cpt, rt_tick_from_millisecond(1000)) != RT_EOK)
+            {
+                LOG_I("spi dma transfer timeout");
+                HAL_SPI_Abort(spi_handle);
+                message->length = 0;
+                spi_handle->State = HAL_SPI_STATE_READY;
+            }
+            LOG_D("%s transfer done", spi_drv->config->bus_name);
+        }
         else
         {
             LOG_D("%s transfer done", spi_drv->config->bus_name);
         }
 
-        /* For simplicity reasons, this example is just waiting till the end of the
-           transfer, but application may perform other tasks while transfer operation
-           is ongoing. */
+        /* polling transfers are complete when the HAL call returns */
         while (HAL_SPI_GetState(spi_handle) != HAL_SPI_STATE_READY);
     }
 
@@ -401,6 +423,7 @@ static int rt_hw_spi_bus_init(void)
         spi_bus_obj[i].config = &spi_config[i];
         spi_bus_obj[i].spi_bus.parent.user_data = &spi_config[i];
         spi_bus_obj[i].handle.Instance = spi_config[i].Instance;
+        rt_completion_init(&spi_bus_obj[i].cpt);
 
         if (spi_bus_obj[i].spi_dma_flag & SPI_USING_RX_DMA_FLAG)
         {
@@ -810,6 +833,34 @@ void SPI6_DMA_TX_IRQHandler(void)
 }
 #endif /* defined(BSP_USING_SPI6) && defined(BSP_SPI_USING_DMA) */
 
+static void stm32_spi_dma_done(SPI_HandleTypeDef *hspi)
+{
+    struct stm32_spi *spi_drv = rt_container_of(hspi, struct stm32_spi, handle);
+
+    rt_completion_done(&spi_drv->cpt);
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    stm32_spi_dma_done(hspi);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    stm32_spi_dma_done(hspi);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    stm32_spi_dma_done(hspi);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    LOG_I("spi dma transfer error : 0x%x", hspi->ErrorCode);
+    stm32_spi_dma_done(hspi);
+}
+
 static void stm32_get_dma_info(void)
 {
 #ifdef BSP_SPI1_RX_USING_DMA
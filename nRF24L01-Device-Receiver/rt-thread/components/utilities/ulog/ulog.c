@@ -93,6 +93,9 @@ struct rt_ulog
     struct rt_ringbuffer *async_rb;
     rt_thread_t async_th;
     struct rt_semaphore async_notice;
+    /* logs dropped because the buffer was full, and how many of them were reported */
+    rt_uint32_t async_drops;
+    rt_uint32_t async_drops_reported;
 #endif
 
 #ifdef ULOG_USING_FILTER
@@ -504,13 +507,9 @@ static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, cons
         }
         else
         {
-            static rt_bool_t already_output = RT_FALSE;
-            if (already_output == RT_FALSE)
-            {
-                rt_kprintf("Warning: There is no enough buffer for saving async log,"
-                        " please increase the ULOG_ASYNC_OUTPUT_BUF_SIZE option.\n");
-                already_output = RT_TRUE;
-            }
+            /* never block or print here, the caller may be a time critical thread.
+             * the async output thread reports the dropped count after the buffer drains */
+            ulog.async_drops++;
         }
     }
     else if (ulog.async_rb)
@@ -1402,6 +1401,25 @@ void ulog_async_output(void)
             rt_free(log);
         }
     }
+    /* report the logs dropped since last time */
+    if (ulog.async_drops != ulog.async_drops_reported)
+    {
+        char drop_log[96];
+        rt_uint32_t drops = ulog.async_drops;
+        rt_size_t len = rt_snprintf(drop_log, sizeof(drop_log), "Warning: %d async logs dropped,"
+                " please increase the ULOG_ASYNC_OUTPUT_BUF_SIZE option." ULOG_NEWLINE_SIGN,
+                drops - ulog.async_drops_reported);
+        ulog.async_drops_reported = drops;
+        ulog_output_to_all_backend(LOG_LVL_WARNING, RT_NULL, RT_TRUE, drop_log, len);
+    }
+}
+
+/**
+ * get the total number of logs dropped because the async output buffer was full
+ */
+rt_uint32_t ulog_async_drops(void)
+{
+    return ulog.async_drops;
 }
 
 /**
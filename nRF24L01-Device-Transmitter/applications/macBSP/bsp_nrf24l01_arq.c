@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-16     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_arq.h"
+
+
+#define ARQ_SEG(arq, seq)   (&(arq)->seg[(seq) & (NRF24_ARQ_WINDOW - 1)])
+
+
+
+/***
+ * @brief   初始化可靠传输层
+ */
+void nRF24L01_ARQ_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_ARQ_STRUCT *arq = &nrf24->arq;
+
+    rt_memset(arq, 0, sizeof(struct nRF24L01_ARQ_STRUCT));
+    arq->rto = rt_tick_from_millisecond(NRF24_ARQ_RTO_INIT_MS);
+}
+
+
+
+/***
+ * @brief   把一条报文放入发送窗口，由 nRF24L01_Run 负责发送、重传
+ * @param   data/len  报文内容，1 ~ NRF24_ARQ_PAYLOAD_SIZE 字节
+ *          timeout   窗口已满时最长等待的 tick 数，RT_WAITING_FOREVER 为一直等待
+ * @return  >=0 : 报文序号   -RT_EINVAL : 参数错误   -RT_ETIMEOUT : 等待窗口超时   -RT_ENOSYS : 未启用
+ * @note    只用于 PTX；窗口满时会让出 CPU 等待确认，因此不能在 nRF24L01 服务线程中调用
+ */
+int nRF24L01_ARQ_Send(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_int32_t timeout)
+{
+    struct nRF24L01_ARQ_STRUCT *arq = &nrf24->arq;
+    struct nRF24L01_ARQ_SEG *seg;
+    rt_tick_t start = rt_tick_get();
+    rt_uint8_t seq;
+    rt_base_t level;
+
+    if (!NRF24_USE_ARQ){
+        return -RT_ENOSYS;
+    }
+    if (len == 0 || len > NRF24_ARQ_PAYLOAD_SIZE){
+        return -RT_EINVAL;
+    }
+
+    for (;;)
+    {
+        level = rt_hw_interrupt_disable();
+        seq = arq->snd_nxt;
+        seg = ARQ_SEG(arq, seq);
+        if ((rt_uint8_t)(seq - arq->snd_una) < NRF24_ARQ_WINDOW && seg->state == ARQ_SEG_FREE){
+            break;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (timeout != RT_WAITING_FOREVER && (rt_int32_t)(rt_tick_get() - start) >= timeout){
+            return -RT_ETIMEOUT;
+        }
+        rt_thread_delay(1);
+    }
+
+    rt_memcpy(seg->data, data, len);
+    seg->len   = len;
+    seg->xmits = 0;
+    seg->state = ARQ_SEG_QUEUED;
+    arq->snd_nxt = seq + 1;
+    rt_hw_interrupt_enable(level);
+
+    nRF24L01_Wakeup(nrf24);
+
+    return seq;
+}
+
+
+
+/***
+ * @brief   用一次 RTT 采样更新重传超时（RFC 6298）
+ */
+static void nRF24L01_ARQ_Update_RTO(struct nRF24L01_ARQ_STRUCT *arq, rt_tick_t rtt)
+{
+    rt_int32_t r8 = (rt_int32_t)rtt << 3;
+    rt_int32_t delta;
+    rt_int32_t rto_min = rt_tick_from_millisecond(NRF24_ARQ_RTO_MIN_MS);
+    rt_int32_t rto_max = rt_tick_from_millisecond(NRF24_ARQ_RTO_MAX_MS);
+
+    if (arq->srtt == 0){
+        arq->srtt   = r8;
+        arq->rttvar = r8 / 2;
+    }
+    else{
+        delta = r8 - arq->srtt;
+        arq->srtt += delta / 8;
+        if (delta < 0){
+            delta = -delta;
+        }
+        arq->rttvar += (delta - arq->rttvar) / 4;
+    }
+
+    arq->rto = (arq->srtt + ((4 * arq->rttvar > 8) ? 4 * arq->rttvar : 8)) >> 3;
+    if (arq->rto < rto_min){
+        arq->rto = rto_min;
+    }
+    if (arq->rto > rto_max){
+        arq->rto = rto_max;
+    }
+}
+
+
+
+/***
+ * @brief   标记一个报文已被确认
+ * @return  该报文最近一次发送的顺序号，报文此前已确认时返回 0
+ */
+static rt_uint16_t nRF24L01_ARQ_Ack_Seg(struct nRF24L01_ARQ_STRUCT *arq, struct nRF24L01_ARQ_SEG *seg, rt_tick_t now)
+{
+    if (seg->state != ARQ_SEG_INFLIGHT && seg->state != ARQ_SEG_QUEUED){
+        return 0;
+    }
+    if (seg->xmits == 0){
+        return 0;
+    }
+
+    if (seg->xmits == 1 && seg->state == ARQ_SEG_INFLIGHT){
+        nRF24L01_ARQ_Update_RTO(arq, now - seg->sent_tick);
+    }
+    seg->state = ARQ_SEG_ACKED;
+    arq->acked++;
+
+    return seg->order;
+}
+
+
+
+/***
+ * @brief   PTX 处理 ACK 载荷中的累计确认和选择确认
+ */
+static void nRF24L01_ARQ_Handle_Ack(struct nRF24L01_ARQ_STRUCT *arq, const uint8_t *data)
+{
+    rt_uint8_t  cum = data[1];
+    rt_uint32_t bitmap = data[2] | (data[3] << 8) | (data[4] << 16) | ((rt_uint32_t)data[5] << 24);
+    rt_uint8_t  outstanding = arq->snd_nxt - arq->snd_una;
+    rt_uint16_t order, newest = 0;
+    rt_tick_t   now = rt_tick_get();
+    rt_uint8_t  seq;
+
+    // 1. 累计确认号必须落在 [snd_una, snd_nxt] 内，否则是过期或错误的确认
+    if ((rt_uint8_t)(cum - arq->snd_una) > outstanding){
+        return;
+    }
+
+    for (seq = arq->snd_una; seq != cum; seq++){
+        order = nRF24L01_ARQ_Ack_Seg(arq, ARQ_SEG(arq, seq), now);
+        if ((rt_int16_t)(order - newest) > 0){
+            newest = order;
+        }
+    }
+
+    // 2. 选择确认
+    for (rt_uint8_t i = 1; i < 32 && bitmap >> i; i++)
+    {
+        seq = cum + i;
+        if (!((bitmap >> i) & 1) || (rt_uint8_t)(seq - arq->snd_una) >= outstanding){
+            continue;
+        }
+        order = nRF24L01_ARQ_Ack_Seg(arq, ARQ_SEG(arq, seq), now);
+        if ((rt_int16_t)(order - newest) > 0){
+            newest = order;
+        }
+    }
+
+    // 3. 链路按序传输：比本次新确认的报文更早发出却仍未确认的报文已丢失，立即重传；
+    //    没有确认任何新报文的重复确认不算 POLL 的回应，否则丢在窗口尾部的报文会被 POLL 无限追问而永不超时重传
+    if (newest != 0){
+        arq->poll_pending = 0;
+        for (seq = arq->snd_una; seq != arq->snd_nxt; seq++)
+        {
+            struct nRF24L01_ARQ_SEG *seg = ARQ_SEG(arq, seq);
+            if (seg->state == ARQ_SEG_INFLIGHT && (rt_int16_t)(newest - seg->order) > 0){
+                seg->state = ARQ_SEG_QUEUED;
+                arq->retransmits++;
+            }
+        }
+    }
+
+    // 4. 滑动窗口
+    while (arq->snd_una != arq->snd_nxt && ARQ_SEG(arq, arq->snd_una)->state == ARQ_SEG_ACKED){
+        ARQ_SEG(arq, arq->snd_una)->state = ARQ_SEG_FREE;
+        arq->snd_una++;
+    }
+}
+
+
+
+/***
+ * @brief   PRX 把当前接收状态写入该管道的 ACK 载荷，随下一次应答回传给 PTX
+ * @note    TX FIFO 由各管道的 ACK 载荷、轮换信标和应用数据共用，不能清空；每个管道最多只有一个确认在芯片中，
+ *          上一个确认还没随应答发出时只记下 ack_dirty，由它发出后的 nRF24L01_ARQ_Service 写入最新的确认
+ */
+static void nRF24L01_ARQ_Load_Ack(nrf24_t nrf24, rt_uint8_t pipe)
+{
+    struct nRF24L01_ARQ_RX *rx = &nrf24->arq.rx[pipe];
+    uint8_t ack[NRF24_ARQ_ACK_SIZE];
+
+    rx->ack_dirty = 1;
+    if ((rt_uint8_t)(rx->ack_pos - nrf24->ack_pipe[pipe].get - 1) < nRF24L01_Ack_Pending(nrf24, pipe)){
+        return;
+    }
+
+    ack[0] = NRF24_ARQ_MARK | NRF24_ARQ_ACK;
+    ack[1] = rx->rcv_nxt;
+    ack[2] = rx->bitmap;
+    ack[3] = rx->bitmap >> 8;
+    ack[4] = rx->bitmap >> 16;
+    ack[5] = rx->bitmap >> 24;
+
+    if (nRF24L01_Write_Tx_Payload_InAck(nrf24, pipe, ack, sizeof(ack)) == RT_EOK){
+        rx->ack_pos   = nrf24->ack_pipe[pipe].put;
+        rx->ack_dirty = 0;
+    }
+}
+
+
+
+/***
+ * @brief   PRX 接收一个 DATA 报文：按序交付，乱序报文缓存在接收窗口中
+ */
+static void nRF24L01_ARQ_Handle_Data(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_ARQ_STRUCT *arq = &nrf24->arq;
+    struct nRF24L01_ARQ_RX *rx = &arq->rx[pipe];
+    rt_uint8_t seq = data[1];
+    rt_uint8_t offset = seq - rx->rcv_nxt;
+    rt_uint8_t slot;
+
+    if (arq->loss_percent != 0 && (rand() % 100) < arq->loss_percent){
+        arq->rx_injected_loss++;
+        return;
+    }
+
+    // 1. 已交付过的报文（序号落后于 rcv_nxt）或已缓存的报文
+    if (offset >= 128 || (offset < NRF24_ARQ_WINDOW && ((rx->bitmap >> offset) & 1))){
+        arq->rx_duplicates++;
+        return;
+    }
+    if (offset >= NRF24_ARQ_WINDOW){
+        arq->rx_out_of_window++;
+        return;
+    }
+
+    // 2. 缓存后把从 rcv_nxt 开始连续的报文依次交付
+    slot = seq & (NRF24_ARQ_WINDOW - 1);
+    rt_memcpy(rx->data[slot], &data[NRF24_ARQ_HEADER_SIZE], len - NRF24_ARQ_HEADER_SIZE);
+    rx->len[slot] = len - NRF24_ARQ_HEADER_SIZE;
+    rx->bitmap |= 1UL << offset;
+
+    while (rx->bitmap & 1)
+    {
+        slot = rx->rcv_nxt & (NRF24_ARQ_WINDOW - 1);
+        arq->rx_delivered++;
+        if (nrf24->nrf24_cb.nrf24l01_msg_ind){
+            nrf24->nrf24_cb.nrf24l01_msg_ind(nrf24, rx->data[slot], rx->len[slot], pipe);
+        }
+        rx->bitmap >>= 1;
+        rx->rcv_nxt++;
+    }
+}
+
+
+
+/***
+ * @brief   接收方向：处理可靠传输层的报文
+ * @return  1 : 是可靠传输报文，已由本层处理   0 : 不是，由调用者按普通数据包处理
+ */
+int nRF24L01_ARQ_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    if (!NRF24_USE_ARQ || len < NRF24_ARQ_HEADER_SIZE || (data[0] & NRF24_ARQ_MARK_MASK) != NRF24_ARQ_MARK){
+        return 0;
+    }
+
+    switch (data[0] & NRF24_ARQ_TYPE_MASK)
+    {
+        case NRF24_ARQ_ACK:
+        {
+            if (len >= NRF24_ARQ_ACK_SIZE && nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX){
+                nRF24L01_ARQ_Handle_Ack(&nrf24->arq, data);
+            }
+        }break;
+
+        case NRF24_ARQ_DATA:
+        {
+            if (len > NRF24_ARQ_HEADER_SIZE && nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX){
+                nRF24L01_ARQ_Handle_Data(nrf24, data, len, pipe);
+                nRF24L01_ARQ_Load_Ack(nrf24, pipe);
+            }
+        }break;
+
+        case NRF24_ARQ_POLL:
+        {
+            if (nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX){
+                nRF24L01_ARQ_Load_Ack(nrf24, pipe);
+            }
+        }break;
+
+        default: break;
+    }
+
+    return 1;
+}
+
+
+
+/***
+ * @brief   发送方向的定时处理，在 nRF24L01_Run 的每一轮循环中调用
+ * @note    1. 最早发出的在途报文超过 RTO 仍未确认时，先发一个 POLL 取回 PRX 最新的确认
+ *             （ACK 载荷总是比数据晚一包，窗口尾部的报文只能靠 POLL 取回确认）；
+ *          2. POLL 之后再过一个 RTO 仍无确认，重传全部超时报文并把 RTO 加倍；
+ *          3. 按序号顺序把等待发送 / 重传的报文放入软件发送队列
+ *          PRX 只补写之前因上一个确认未发出而推迟的确认
+ */
+void nRF24L01_ARQ_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_ARQ_STRUCT *arq = &nrf24->arq;
+    struct nRF24L01_ARQ_SEG *seg;
+    rt_uint8_t snd_nxt = arq->snd_nxt;
+    rt_uint8_t seq, expired = 0;
+    rt_tick_t  now = rt_tick_get();
+    uint8_t    packet[32];
+
+    if (nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        for (rt_uint8_t pipe = 0; pipe < 6; pipe++){
+            if (arq->rx[pipe].ack_dirty){
+                nRF24L01_ARQ_Load_Ack(nrf24, pipe);
+            }
+        }
+        return;
+    }
+
+    // 1. 超时检查
+    for (seq = arq->snd_una; seq != snd_nxt; seq++){
+        seg = ARQ_SEG(arq, seq);
+        if (seg->state == ARQ_SEG_INFLIGHT && (rt_int32_t)(now - seg->sent_tick) >= arq->rto){
+            expired = 1;
+            break;
+        }
+    }
+    if (expired)
+    {
+        if (arq->poll_pending == 0){
+            packet[0] = NRF24_ARQ_MARK | NRF24_ARQ_POLL;
+            packet[1] = arq->snd_nxt;
+            if (nRF24L01_Send_Async(nrf24, packet, NRF24_ARQ_HEADER_SIZE, nRF24_SEND_NEED_ACK) > 0){
+                arq->poll_pending = 1;
+                arq->poll_tick = now;
+                arq->polls++;
+            }
+        }
+        else if ((rt_int32_t)(now - arq->poll_tick) >= arq->rto){
+            for (seq = arq->snd_una; seq != snd_nxt; seq++){
+                seg = ARQ_SEG(arq, seq);
+                if (seg->state == ARQ_SEG_INFLIGHT && (rt_int32_t)(now - seg->sent_tick) >= arq->rto){
+                    seg->state = ARQ_SEG_QUEUED;
+                }
+            }
+            arq->timeouts++;
+            arq->poll_pending = 0;
+            arq->rto *= 2;
+            if (arq->rto > rt_tick_from_millisecond(NRF24_ARQ_RTO_MAX_MS)){
+                arq->rto = rt_tick_from_millisecond(NRF24_ARQ_RTO_MAX_MS);
+            }
+        }
+    }
+
+    // 2. 发送 / 重传
+    for (seq = arq->snd_una; seq != snd_nxt; seq++)
+    {
+        seg = ARQ_SEG(arq, seq);
+        if (seg->state != ARQ_SEG_QUEUED){
+            continue;
+        }
+
+        packet[0] = NRF24_ARQ_MARK | NRF24_ARQ_DATA;
+        packet[1] = seq;
+        rt_memcpy(&packet[NRF24_ARQ_HEADER_SIZE], seg->data, seg->len);
+        if (nRF24L01_Send_Async(nrf24, packet, seg->len + NRF24_ARQ_HEADER_SIZE, nRF24_SEND_NEED_ACK) < 0){
+            break;
+        }
+
+        if (seg->xmits == 0){
+            arq->tx_segments++;
+        }
+        if (seg->xmits < 0xFF){
+            seg->xmits++;
+        }
+        if (++arq->order == 0){
+            arq->order++;
+        }
+        seg->order = arq->order;
+        seg->sent_tick = now;
+        seg->state = ARQ_SEG_INFLIGHT;
+    }
+}
+
+
+
+/***
+ * @brief   nRF24L01_Run 等待 IRQ 信号量的超时时间
+ * @return  没有在途报文时为 RT_WAITING_FOREVER，否则为距最近一次超时检查的 tick 数
+ */
+rt_int32_t nRF24L01_ARQ_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_ARQ_STRUCT *arq = &nrf24->arq;
+    struct nRF24L01_ARQ_SEG *seg;
+    rt_uint8_t snd_nxt = arq->snd_nxt;
+    rt_int32_t wait = RT_WAITING_FOREVER, left;
+    rt_tick_t  now = rt_tick_get();
+
+    if (nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        return RT_WAITING_FOREVER;
+    }
+
+    for (rt_uint8_t seq = arq->snd_una; seq != snd_nxt; seq++)
+    {
+        seg = ARQ_SEG(arq, seq);
+        if (seg->state == ARQ_SEG_QUEUED){
+            return 1;
+        }
+        if (seg->state == ARQ_SEG_INFLIGHT){
+            left = arq->rto - (rt_int32_t)(now - (arq->poll_pending ? arq->poll_tick : seg->sent_tick));
+            if (left < 1){
+                left = 1;
+            }
+            if (wait == RT_WAITING_FOREVER || left < wait){
+                wait = left;
+            }
+        }
+    }
+
+    return wait;
+}
+
+
+
+/***
+ * @brief msh 命令：可靠传输层统计、吞吐测试和丢包注入
+ * @note  nrf24_arq                 打印统计
+ *        nrf24_arq send <n>        PTX 连续发送 n 个 30 字节报文，等待全部确认后打印有效吞吐
+ *        nrf24_arq loss <0~99>     PRX 按百分比人为丢弃收到的 DATA，配合 send 扫描丢包率
+ *        nrf24_arq reset           清零统计，复位窗口
+ */
+static void nrf24_arq_cmd(int argc, char **argv)
+{
+    struct nRF24L01_ARQ_STRUCT *arq;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    arq = &_nrf24->arq;
+
+    if (argc > 2 && rt_strcmp(argv[1], "send") == 0)
+    {
+        rt_uint32_t n = atoi(argv[2]);
+        rt_uint8_t  buf[NRF24_ARQ_PAYLOAD_SIZE];
+        rt_tick_t   start = rt_tick_get(), used;
+
+        for (rt_uint32_t i = 0; i < n; i++){
+            rt_memset(buf, (rt_uint8_t)i, sizeof(buf));
+            if (nRF24L01_ARQ_Send(_nrf24, buf, sizeof(buf), rt_tick_from_millisecond(5000)) < 0){
+                rt_kprintf("[nrf24] arq send timeout at %d.\r\n", i);
+                return;
+            }
+        }
+        while (arq->snd_una != arq->snd_nxt){
+            if (rt_tick_get() - start > rt_tick_from_millisecond(30000)){
+                rt_kprintf("[nrf24] arq wait ack timeout.\r\n");
+                return;
+            }
+            rt_thread_delay(1);
+        }
+        used = rt_tick_get() - start;
+        if (used == 0){
+            used = 1;
+        }
+        rt_kprintf("[nrf24] arq %d segments in %dms, goodput %d B/s\r\n",
+                   n, used * 1000 / RT_TICK_PER_SECOND, n * NRF24_ARQ_PAYLOAD_SIZE * RT_TICK_PER_SECOND / used);
+    }
+    else if (argc > 2 && rt_strcmp(argv[1], "loss") == 0)
+    {
+        rt_uint32_t loss = atoi(argv[2]);
+        arq->loss_percent = (loss > 99) ? 99 : loss;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        nRF24L01_ARQ_Init(_nrf24);
+        rt_exit_critical();
+    }
+
+    rt_kprintf("[nrf24] arq tx: segments %d, acked %d, retransmits %d, timeouts %d, polls %d\r\n",
+               arq->tx_segments, arq->acked, arq->retransmits, arq->timeouts, arq->polls);
+    rt_kprintf("            window %d/%d, srtt %dms, rto %dms\r\n",
+               (rt_uint8_t)(arq->snd_nxt - arq->snd_una), NRF24_ARQ_WINDOW,
+               (arq->srtt >> 3) * 1000 / RT_TICK_PER_SECOND, arq->rto * 1000 / RT_TICK_PER_SECOND);
+    rt_kprintf("        rx: delivered %d, duplicates %d, out of window %d, injected loss %d (%d%%)\r\n",
+               arq->rx_delivered, arq->rx_duplicates, arq->rx_out_of_window, arq->rx_injected_loss, arq->loss_percent);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_arq_cmd, nrf24_arq, reliable transport stats [send <n> | loss <pct> | reset]);
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-16     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_ARQ_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_ARQ_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 可靠传输层报文头（2 字节）
+ * byte0 : bit7~6 = 10 可靠传输标记（分片为 11，协议帧以 0x55 开头）
+ *         bit5~0      报文类型
+ * byte1 : DATA/POLL 为序号，ACK 为累计确认号（接收端期望的下一个序号）
+ *
+ * DATA : PTX -> PRX，头 + 最多 30 字节数据
+ * POLL : PTX -> PRX，只有报文头，用于取回 PRX 最新的确认
+ * ACK  : PRX -> PTX，通过 ACK 载荷回传，头 + 4 字节选择确认位图（小端），
+ *        bit i 置位表示序号 (累计确认号 + i) 已收到
+ */
+#define NRF24_ARQ_MARK              0x80
+#define NRF24_ARQ_MARK_MASK         0xC0
+#define NRF24_ARQ_TYPE_MASK         0x3F
+#define NRF24_ARQ_DATA              0x00
+#define NRF24_ARQ_POLL              0x01
+#define NRF24_ARQ_ACK               0x02
+#define NRF24_ARQ_HEADER_SIZE       2
+#define NRF24_ARQ_PAYLOAD_SIZE      (32 - NRF24_ARQ_HEADER_SIZE)
+#define NRF24_ARQ_ACK_SIZE          (NRF24_ARQ_HEADER_SIZE + 4)
+
+
+/***
+ * 可靠传输参数
+ * NRF24_USE_ARQ         : 1 -> 启用可靠传输层；为 0 时本层不认领 10xxxxxx 的包，按普通数据交给应用
+ * NRF24_ARQ_WINDOW      : 发送窗口（同时在途的报文数），2 的幂且不超过 32（选择确认位图宽度）
+ * NRF24_ARQ_RTO_INIT_MS : 初始重传超时
+ * NRF24_ARQ_RTO_MIN_MS  : 重传超时下限
+ * NRF24_ARQ_RTO_MAX_MS  : 重传超时上限，超时退避到此为止
+ */
+#define NRF24_USE_ARQ               1
+#define NRF24_ARQ_WINDOW            8
+#define NRF24_ARQ_RTO_INIT_MS       50
+#define NRF24_ARQ_RTO_MIN_MS        5
+#define NRF24_ARQ_RTO_MAX_MS        1000
+
+#if (NRF24_ARQ_WINDOW > 32) || (NRF24_ARQ_WINDOW & (NRF24_ARQ_WINDOW - 1))
+#error "NRF24_ARQ_WINDOW must be a power of 2 not greater than 32"
+#endif
+
+
+/***
+ * 发送窗口中报文的状态
+ */
+typedef enum
+{
+    ARQ_SEG_FREE = 0,
+    ARQ_SEG_QUEUED,         // 等待发送 / 重传
+    ARQ_SEG_INFLIGHT,       // 已发送，等待确认
+    ARQ_SEG_ACKED,          // 已确认，等待窗口滑过
+}arq_seg_state_et;
+
+
+struct nRF24L01_ARQ_SEG
+{
+    rt_uint8_t  state;
+    rt_uint8_t  len;
+    /* 发送次数，大于 1 的报文不参与 RTT 采样（Karn 算法） */
+    rt_uint8_t  xmits;
+    /* 最近一次发送的顺序号，确认中出现更晚发出的报文时，更早发出且未确认的报文即判定丢失 */
+    rt_uint16_t order;
+    rt_tick_t   sent_tick;
+    rt_uint8_t  data[NRF24_ARQ_PAYLOAD_SIZE];
+};
+
+
+/***
+ * 接收方向，每个管道一个
+ */
+struct nRF24L01_ARQ_RX
+{
+    /* 期望的下一个序号 */
+    rt_uint8_t  rcv_nxt;
+    /* bit i 置位表示序号 rcv_nxt + i 已缓存 */
+    rt_uint32_t bitmap;
+    rt_uint8_t  len[NRF24_ARQ_WINDOW];
+    rt_uint8_t  data[NRF24_ARQ_WINDOW][NRF24_ARQ_PAYLOAD_SIZE];
+    /* 本管道最近写入的确认之后的 ack_pipe 入队位置，它落在 (get, put] 内说明确认仍在芯片中 */
+    rt_uint8_t  ack_pos;
+    /* 接收状态已变化、新的确认还没写入：上一个确认仍在芯片中时等它发出后再写 */
+    rt_uint8_t  ack_dirty;
+};
+
+
+/***
+ * 滑动窗口可靠传输层
+ */
+struct nRF24L01_ARQ_STRUCT
+{
+    /* 发送方向 */
+    struct nRF24L01_ARQ_SEG seg[NRF24_ARQ_WINDOW];
+    rt_uint8_t  snd_una;            // 最早未确认的序号
+    volatile rt_uint8_t snd_nxt;    // 下一个分配的序号
+    rt_uint16_t order;
+    rt_uint8_t  poll_pending;
+    rt_tick_t   poll_tick;
+    /* RTT 估计（RFC 6298），srtt / rttvar 以 1/8 tick 为单位 */
+    rt_int32_t  srtt;
+    rt_int32_t  rttvar;
+    rt_int32_t  rto;
+
+    /* 接收方向 */
+    struct nRF24L01_ARQ_RX rx[6];
+    /* 接收端人为丢弃 DATA 的百分比，用于在实际链路上扫描丢包率 */
+    rt_uint8_t  loss_percent;
+
+    /* 统计计数 */
+    rt_uint32_t tx_segments;        // 首次发送的报文
+    rt_uint32_t retransmits;        // 由选择确认判定丢失后的重传
+    rt_uint32_t timeouts;           // 重传超时
+    rt_uint32_t polls;              // 发出的 POLL
+    rt_uint32_t acked;              // 已确认的报文
+    rt_uint32_t rx_delivered;       // 按序交付的报文
+    rt_uint32_t rx_duplicates;      // 重复的报文
+    rt_uint32_t rx_out_of_window;   // 超出接收窗口的报文
+    rt_uint32_t rx_injected_loss;   // 人为丢弃的报文
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_ARQ_H_ */
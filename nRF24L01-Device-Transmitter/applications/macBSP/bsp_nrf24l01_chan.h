@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-23     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_CHAN_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_CHAN_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 信道勘测与切换
+ * 勘测时临时切到 PRX，逐个信道拉高 CE 停留 DWELL_US 后读 RPD（>-64dBm 的信号持续 40us 以上即置位），
+ * 每一轮扫完全部信道就回到原信道和原角色，轮与轮之间照常收发，PASSES 轮后得到每个信道的占用次数；
+ * 信道的得分为它及两侧各 1 个（2Mbps 时 2 个）信道的占用次数之和，取得分最低的信道
+ * PTX 勘测完以当前信道向对端发 SWITCH，收到自动应答后双方各自切换；PRX 的勘测只用于查看
+ *
+ * NRF24_CHAN_HOME     : 上电信道，也是失联后双方重新会合的信道
+ * NRF24_CHAN_MIN / MAX: 可选信道范围；2400~2483.5MHz 以外（84 以上）在部分地区不允许使用，按当地法规收窄
+ * NRF24_CHAN_PASSES   : 勘测轮数，即每个信道的采样次数；每轮约 126 * (DWELL_US + SPI) = 30ms
+ * NRF24_CHAN_DWELL_US : 每个信道的停留时间，不小于 PLL 建立 130us + RPD 检测 40us
+ * NRF24_CHAN_HYST     : 当前信道的得分不比最佳信道多出该值就不切换
+ * NRF24_CHAN_AUTO_S   : PTX 每隔多少秒自动勘测一次，0 为只由 msh 发起
+ * NRF24_CHAN_LOST     : PTX 在非上电信道连续失败多少包后回到上电信道
+ * NRF24_CHAN_IDLE_MS  : PRX 在非上电信道多久收不到任何包就回到上电信道
+ */
+#define NRF24_CHAN_HOME             100
+#define NRF24_CHAN_MIN              0
+#define NRF24_CHAN_MAX              125
+#define NRF24_CHAN_PASSES           32
+#define NRF24_CHAN_DWELL_US         200
+#define NRF24_CHAN_HYST             2
+#define NRF24_CHAN_AUTO_S           0
+#define NRF24_CHAN_LOST             3
+#define NRF24_CHAN_IDLE_MS          3000
+
+#define NRF24_CHAN_COUNT            126
+
+#if NRF24_CHAN_MIN > NRF24_CHAN_MAX - 4 || NRF24_CHAN_MAX >= NRF24_CHAN_COUNT
+#error "NRF24_CHAN_MIN / NRF24_CHAN_MAX must cover at least 5 channels within 0 ~ 125"
+#endif
+#if NRF24_CHAN_HOME < NRF24_CHAN_MIN || NRF24_CHAN_HOME > NRF24_CHAN_MAX
+#error "NRF24_CHAN_HOME must be within NRF24_CHAN_MIN ~ NRF24_CHAN_MAX"
+#endif
+
+/* 多节点组网时其它节点不会跟着换信道，只允许勘测 */
+#define NRF24_CHAN_LOCKED           NRF24_LINK_RATE_LOCKED
+
+
+/***
+ * SWITCH 报文
+ * byte0 : 高 4 位 = 0010 信道标记（链路自适应为 0011，切换引擎为 0100，轮换为 0110，TDMA 为 0111，可靠传输为 10xxxxxx，分片为 11xxxxxx）
+ *         低 4 位        报文类型
+ * byte1 : 序号
+ * byte2 : 新信道
+ */
+#define NRF24_CHAN_MARK             0x20
+#define NRF24_CHAN_SWITCH           0x01
+#define NRF24_CHAN_SWITCH_SIZE      3
+
+
+/***
+ * 信道勘测与切换
+ */
+struct nRF24L01_CHAN_STRUCT
+{
+    /* 每个信道 RPD 置位的次数，以及已完成的轮数 */
+    rt_uint16_t hits[NRF24_CHAN_COUNT];
+    rt_uint16_t passes;
+    /* 勘测中：剩余轮数 */
+    rt_uint16_t survey_left;
+    rt_uint8_t  best;
+    rt_uint32_t best_score;
+    rt_uint32_t cur_score;
+    rt_tick_t   next_auto_tick;
+
+    /* PTX：待发 / 在途的 SWITCH */
+    rt_uint8_t  switch_state;
+    rt_uint8_t  switch_ch;
+    rt_uint8_t  seq;
+    rt_uint8_t  consecutive_fail;
+
+    /* PRX：收到 SWITCH 后等自动应答发完再切换 */
+    rt_uint8_t  peer_pending;
+    rt_uint8_t  peer_ch;
+    rt_uint32_t peer_deadline_cycles;
+    rt_tick_t   last_rx_tick;
+
+    /* msh 请求，由射频线程执行：1 勘测  2 切换到 req_ch */
+    volatile rt_uint8_t req;
+    rt_uint8_t  req_ch;
+
+    /* 统计 */
+    rt_uint32_t surveys;
+    rt_uint32_t switches;
+    rt_uint32_t fallbacks;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_CHAN_H_ */
@@ -7,25 +7,582 @@
  * Date           Author       Notes
  * 2025-09-10     Administrator       the first version
  */
+#include "bsp_nrf24l01_driver.h"
 #include "bsp_nrf24l01_debug.h"
 
 
+/* 各分桶的上限(us)，最后一个分桶收纳其余所有样本 */
+static const rt_uint32_t latency_bucket_us[NRF24_LATENCY_BUCKETS - 1] = { 50, 100, 200, 500, 1000, 2000, 5000 };
 
 
 
+/***
+ * @brief 使能 DWT 周期计数器，作为微秒级时间戳来源
+ * @note  Cortex-M3 的 CYCCNT 以内核时钟计数，72MHz 下约 59s 回绕一次，只用于测量短时间差
+ */
+void nRF24L01_Debug_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/***
+ * @brief 读取当前的 DWT 周期计数
+ */
+rt_uint32_t nRF24L01_Debug_Get_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
 
+/***
+ * @brief 把 DWT 周期数换算为微秒
+ */
+rt_uint32_t nRF24L01_Debug_Cycles_To_Us(rt_uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
 
 
+/***
+ * @brief 在实例的 IRQ 引脚中断里记录时间戳
+ * @note  一次唤醒内只保留第一个下降沿的时刻，后续中断在线程处理前不覆盖
+ */
+void nRF24L01_Debug_Mark_IRQ(nrf24_t nrf24)
+{
+    struct nRF24L01_LATENCY_STRUCT *lat = &nrf24->latency;
+
+    if(lat->irq_pending == 0){
+        lat->irq_cycles  = DWT->CYCCNT;
+        lat->irq_pending = 1;
+    }
+}
+
+
+/***
+ * @brief 在第一次回调分发之前调用，把 IRQ -> 回调 的延时记入直方图
+ */
+void nRF24L01_Debug_Record_Latency(nrf24_t nrf24)
+{
+    struct nRF24L01_LATENCY_STRUCT *lat = &nrf24->latency;
+    rt_uint32_t us;
+    rt_uint8_t  i;
 
+    if(lat->irq_pending == 0){
+        return;
+    }
 
+    us = nRF24L01_Debug_Cycles_To_Us(DWT->CYCCNT - lat->irq_cycles);
+    lat->irq_pending = 0;
+
+    for(i = 0; i < NRF24_LATENCY_BUCKETS - 1; i++){
+        if(us < latency_bucket_us[i]){
+            break;
+        }
+    }
+    lat->bucket[i]++;
+
+    if(us < lat->min_us){
+        lat->min_us = us;
+    }
+    if(us > lat->max_us){
+        lat->max_us = us;
+    }
+    lat->sum_us += us;
+    lat->count++;
+}
+
+
+/***
+ * @brief 清空实例的延时直方图
+ */
+void nRF24L01_Debug_Reset_Latency(nrf24_t nrf24)
+{
+    struct nRF24L01_LATENCY_STRUCT *lat = &nrf24->latency;
+    rt_base_t level = rt_hw_interrupt_disable();
+
+    rt_memset(lat->bucket, 0, sizeof(lat->bucket));
+    lat->count  = 0;
+    lat->min_us = 0xFFFFFFFF;
+    lat->max_us = 0;
+    lat->sum_us = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+
+
+/***
+ * @brief msh 命令：打印当前实例 IRQ -> 回调 的延时直方图
+ * @note  nrf24_latency        打印
+ *        nrf24_latency reset  打印后清零
+ */
+static void nrf24_latency_cmd(int argc, char **argv)
+{
+    struct nRF24L01_LATENCY_STRUCT *lat;
+    rt_uint32_t lower = 0;
 
+    if(_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    lat = &_nrf24->latency;
 
+    rt_kprintf("----------------------------------\r\n");
+    rt_kprintf("[nrf24] %s irq->callback latency, samples = %d\r\n", _nrf24->name, lat->count);
+    if(lat->count != 0){
+        rt_kprintf("min = %dus, avg = %dus, max = %dus\r\n",
+                   lat->min_us,
+                   (rt_uint32_t)(lat->sum_us / lat->count),
+                   lat->max_us);
+    }
+    for(rt_uint8_t i = 0; i < NRF24_LATENCY_BUCKETS - 1; i++){
+        rt_kprintf("%5d ~ %5dus : %d\r\n", lower, latency_bucket_us[i], lat->bucket[i]);
+        lower = latency_bucket_us[i];
+    }
+    rt_kprintf("%5d ~   ...  : %d\r\n", lower, lat->bucket[NRF24_LATENCY_BUCKETS - 1]);
 
+    if(argc > 1 && rt_strcmp(argv[1], "reset") == 0){
+        nRF24L01_Debug_Reset_Latency(_nrf24);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_latency_cmd, nrf24_latency, nrf24 irq to callback latency histogram [reset]);
 
 
 
+/* CPU 空闲率统计：调度器钩子里累加空闲线程占用的 DWT 周期 */
+static rt_uint32_t idle_enter_cycles;
+static rt_uint64_t idle_total_cycles;
 
+static void nRF24L01_Debug_Scheduler_Hook(rt_thread_t from, rt_thread_t to)
+{
+    rt_thread_t idle = rt_thread_idle_gethandler();
+
+    if(to == idle){
+        idle_enter_cycles = DWT->CYCCNT;
+    }
+    else if(from == idle){
+        idle_total_cycles += DWT->CYCCNT - idle_enter_cycles;
+    }
+}
+
+
+/***
+ * @brief msh 命令：统计一段时间内的 CPU 空闲率
+ * @note  nrf24_cpu [ms]，默认 1000ms，最长 30000ms（CYCCNT 72MHz 下约 59s 回绕）
+ *        在持续收发时分别运行使能/关闭 DMA 的固件，即可对比 SPI 传输占用的 CPU
+ */
+static void nrf24_cpu_cmd(int argc, char **argv)
+{
+    rt_uint32_t ms = 1000;
+    rt_uint32_t start, total;
+    rt_uint64_t idle;
+
+    if(argc > 1){
+        ms = atoi(argv[1]);
+    }
+    if(ms == 0 || ms > 30000){
+        rt_kprintf("Usage: nrf24_cpu [1~30000 ms]\r\n");
+        return;
+    }
+
+    idle_total_cycles = 0;
+    rt_scheduler_sethook(nRF24L01_Debug_Scheduler_Hook);
+    start = DWT->CYCCNT;
+
+    rt_thread_mdelay(ms);
+
+    total = DWT->CYCCNT - start;
+    rt_scheduler_sethook(RT_NULL);
+    idle = idle_total_cycles;
+
+    rt_kprintf("[nrf24] cpu idle = %d.%02d%% over %dms\r\n",
+               (rt_uint32_t)(idle * 100 / total),
+               (rt_uint32_t)(idle * 10000 / total % 100),
+               ms);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_cpu_cmd, nrf24_cpu, measure cpu idle percentage [ms]);
+
+
+/***
+ * @brief msh 命令：对比 RX 服务路径逐寄存器访问与合并片选两种实现的 SPI 耗时
+ * @note  nrf24_spi_bench [次数]，默认 100 次，读取 32 字节数据包
+ *        旧路径：读 STATUS、清 STATUS、读 FIFO_STATUS、读长度、读数据，共 5 次片选（其中 3 次为两段传输）
+ *        新路径：R_RX_PL_WID 带回 STATUS 和长度、R_RX_PAYLOAD 带回 STATUS 和数据，共 2 次片选
+ *        RX FIFO 为空时读数据不会改变芯片状态，建议在链路空闲时运行
+ */
+static void nrf24_spi_bench_cmd(int argc, char **argv)
+{
+    rt_uint32_t loops = 100;
+    rt_uint32_t start, legacy = 0, fused = 0;
+    rt_uint8_t  cmd, status, width;
+    rt_uint8_t  buf[33];
+    rt_uint8_t  clear[2] = { NRF24CMD_W_REG | NRF24REG_STATUS, 0 };
+
+    if(_nrf24 == RT_NULL || _nrf24->nrf24_ops.nrf24_transfer == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    if(argc > 1){
+        loops = atoi(argv[1]);
+    }
+    if(loops == 0 || loops > 10000){
+        rt_kprintf("Usage: nrf24_spi_bench [1~10000]\r\n");
+        return;
+    }
+
+    for(rt_uint32_t i = 0; i < loops; i++)
+    {
+        start = DWT->CYCCNT;
+        cmd = NRF24CMD_R_REG | NRF24REG_STATUS;
+        _nrf24->nrf24_ops.nrf24_send_then_recv(&_nrf24->port_api, &cmd, 1, &status, 1);
+        _nrf24->nrf24_ops.nrf24_write(&_nrf24->port_api, clear, 2);
+        cmd = NRF24CMD_R_REG | NRF24REG_FIFO_STATUS;
+        _nrf24->nrf24_ops.nrf24_send_then_recv(&_nrf24->port_api, &cmd, 1, &status, 1);
+        cmd = NRF24CMD_R_RX_PL_WID;
+        _nrf24->nrf24_ops.nrf24_send_then_recv(&_nrf24->port_api, &cmd, 1, &width, 1);
+        cmd = NRF24CMD_R_RX_PAYLOAD;
+        _nrf24->nrf24_ops.nrf24_send_then_recv(&_nrf24->port_api, &cmd, 1, buf, 32);
+        legacy += DWT->CYCCNT - start;
+
+        start = DWT->CYCCNT;
+        width = nRF24L01_Read_Top_RXFIFO_Width_Status(_nrf24, &status);
+        nRF24L01_Read_Rx_Frame(_nrf24, buf, 32);
+        fused += DWT->CYCCNT - start;
+    }
+
+    rt_kprintf("[nrf24] rx service spi cost, %d loops, 32 bytes payload\r\n", loops);
+    rt_kprintf("legacy (5 cs) : %d cycles, %dus\r\n", legacy / loops, nRF24L01_Debug_Cycles_To_Us(legacy / loops));
+    rt_kprintf("fused  (2 cs) : %d cycles, %dus\r\n", fused / loops, nRF24L01_Debug_Cycles_To_Us(fused / loops));
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_spi_bench_cmd, nrf24_spi_bench, compare legacy and fused rx spi path [loops]);
+
+
+
+#if defined(ULOG_USING_ASYNC_OUTPUT) && defined(ULOG_USING_FILTER)
+/***
+ * @brief 一包数据在 RX 服务路径上的日志：与 nRF24L01_Drain_RX_FIFO 和 nrf24l01_tx_done 中的调试日志相同
+ * @param mode 0: 同步 rt_kprintf（启用 ulog 之前 rtdbg 的输出方式）  1: ulog
+ */
+static void nrf24_log_bench_packet(rt_uint8_t mode, rt_uint32_t i)
+{
+    if(mode == 0){
+        rt_kprintf("[D/nrf24] Data pipe number(p%d).\r\n", 0);
+        rt_kprintf("[D/nrf24] Receive length = %d.\r\n", 32);
+        rt_kprintf("[D/nrf24] Protocol parse succeed.\r\n");
+        rt_kprintf("[D/nrf24] tx_done ok, id = %d\r\n", i);
+    }
+    else{
+        LOG_D("Data pipe number(p%d).", 0);
+        LOG_D("Receive length = %d.", 32);
+        LOG_D("Protocol parse succeed.");
+        LOG_D("tx_done ok, id = %d", i);
+    }
+}
 
 
+/***
+ * @brief msh 命令：对比每包调试日志在射频线程中占用的时间
+ * @note  nrf24_log_bench [包数]，默认 20 包，每包 4 行日志，包间隔 2ms（按 1kHz 的包速率）
+ *        sync     : 同步 rt_kprintf，格式化和串口发送都在调用线程中完成
+ *        async    : ulog 异步输出，调用线程只格式化并拷入环形块缓冲，由 ulog_async 线程在空闲时发送；
+ *                   缓冲区满时丢弃并计数，不阻塞
+ *        filtered : ulog 运行时过滤掉 DEBUG 级别（ulog_lvl 6），只剩一次比较
+ *        把 ULOG_OUTPUT_LVL 设为 Information 时这些日志在编译期就被去掉，开销为 0
+ */
+static void nrf24_log_bench_cmd(int argc, char **argv)
+{
+    static const char *const mode_name[] = { "sync", "async", "filtered" };
+    rt_uint32_t packets = 20;
+    rt_uint32_t start, cycles, sum[3] = {0}, max[3] = {0}, drops[3] = {0};
+    rt_uint32_t level = ulog_global_filter_lvl_get();
+
+    if(argc > 1){
+        packets = atoi(argv[1]);
+    }
+    if(packets == 0 || packets > 1000){
+        rt_kprintf("Usage: nrf24_log_bench [1~1000]\r\n");
+        return;
+    }
+
+    for(rt_uint8_t mode = 0; mode < 3; mode++)
+    {
+        ulog_global_filter_lvl_set(mode == 2 ? LOG_LVL_INFO : level);
+        ulog_flush();
+        drops[mode] = ulog_async_drops();
+
+        for(rt_uint32_t i = 0; i < packets; i++)
+        {
+            start = DWT->CYCCNT;
+            nrf24_log_bench_packet(mode == 0 ? 0 : 1, i);
+            cycles = DWT->CYCCNT - start;
+            sum[mode] += cycles;
+            if(cycles > max[mode]){
+                max[mode] = cycles;
+            }
+            rt_thread_mdelay(2);
+        }
+        drops[mode] = ulog_async_drops() - drops[mode];
+    }
+    ulog_global_filter_lvl_set(level);
+    ulog_flush();
+
+    rt_kprintf("[nrf24] per packet log cost in the calling thread, %d packets x 4 lines\r\n", packets);
+    rt_kprintf("mode        avg(us)   max(us)   dropped\r\n");
+    for(rt_uint8_t mode = 0; mode < 3; mode++){
+        rt_kprintf("%-9s  %8d  %8d  %8d\r\n", mode_name[mode],
+                   nRF24L01_Debug_Cycles_To_Us(sum[mode] / packets), nRF24L01_Debug_Cycles_To_Us(max[mode]), drops[mode]);
+    }
+    rt_kprintf("ulog async drops since boot: %d\r\n", ulog_async_drops());
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_log_bench_cmd, nrf24_log_bench, compare sync and async log cost per packet [packets]);
+#endif /* ULOG_USING_ASYNC_OUTPUT && ULOG_USING_FILTER */
+
+
+
+/* CRC 自检 / 基准使用的伪随机数（xorshift32），不依赖 libc 的 rand */
+static rt_uint32_t crc_test_seed = 0x2545F491;
+
+static rt_uint32_t nRF24L01_Debug_Random(void)
+{
+    crc_test_seed ^= crc_test_seed << 13;
+    crc_test_seed ^= crc_test_seed >> 17;
+    crc_test_seed ^= crc_test_seed << 5;
+    return crc_test_seed;
+}
+
+
+/***
+ * @brief msh 命令：把编译进来的 CRC16-Modbus 实现与逐位计算的参考实现做交叉校验，并统计耗时
+ * @note  nrf24_crc [次数]，默认 1000 组随机缓冲区，长度 0~255 随机
+ *        耗时分别按 32 字节（单包最大载荷）和 255 字节统计平均周期数
+ */
+static void nrf24_crc_cmd(int argc, char **argv)
+{
+    rt_uint32_t loops = 1000, errors = 0;
+    rt_uint8_t  buf[255];
+    rt_uint8_t  len;
+    rt_uint16_t ref;
+    rt_uint32_t start;
+    static const rt_uint8_t bench_len[2] = { 32, 255 };
+
+    if(argc > 1){
+        loops = atoi(argv[1]);
+    }
+    if(loops == 0 || loops > 100000){
+        rt_kprintf("Usage: nrf24_crc [1~100000]\r\n");
+        return;
+    }
+
+    // 1. 交叉校验
+    for(rt_uint32_t n = 0; n < loops; n++)
+    {
+        len = nRF24L01_Debug_Random() & 0xFF;
+        for(rt_uint8_t i = 0; i < len; i++){
+            buf[i] = nRF24L01_Debug_Random();
+        }
+        ref = CrcCalc_Crc16Modbus_Bitwise(buf, len);
+#if (NRF24_CRC16_IMPL != NRF24_CRC16_BITWISE)
+        if(CrcCalc_Crc16Modbus_Table(buf, len) != ref){
+            errors++;
+        }
+#endif
+#if (NRF24_CRC16_IMPL == NRF24_CRC16_SLICE4)
+        if(CrcCalc_Crc16Modbus_Slice4(buf, len) != ref){
+            errors++;
+        }
+#endif
+        if(CrcCalc_Crc16Modbus(buf, len) != ref){
+            errors++;
+        }
+    }
+    rt_kprintf("[nrf24] crc16 impl = %d, %d buffers, %d mismatch\r\n", NRF24_CRC16_IMPL, loops, errors);
+
+    // 2. 耗时统计
+    for(rt_uint8_t k = 0; k < 2; k++)
+    {
+        rt_uint32_t bitwise, table = 0, slice4 = 0;
+
+        start = DWT->CYCCNT;
+        CrcCalc_Crc16Modbus_Bitwise(buf, bench_len[k]);
+        bitwise = DWT->CYCCNT - start;
+#if (NRF24_CRC16_IMPL != NRF24_CRC16_BITWISE)
+        start = DWT->CYCCNT;
+        CrcCalc_Crc16Modbus_Table(buf, bench_len[k]);
+        table = DWT->CYCCNT - start;
+#endif
+#if (NRF24_CRC16_IMPL == NRF24_CRC16_SLICE4)
+        start = DWT->CYCCNT;
+        CrcCalc_Crc16Modbus_Slice4(buf, bench_len[k]);
+        slice4 = DWT->CYCCNT - start;
+#endif
+        rt_kprintf("%3d bytes : bitwise %d, table %d, slice4 %d cycles\r\n", bench_len[k], bitwise, table, slice4);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_crc_cmd, nrf24_crc, cross check and benchmark crc16 modbus [loops]);
+
+
+
+/***
+ * @brief msh 命令：打印各管道帧解码器的统计计数
+ * @note  nrf24_decoder        打印
+ *        nrf24_decoder reset  打印后复位解码器
+ */
+static void nrf24_decoder_cmd(int argc, char **argv)
+{
+    if(_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+
+    rt_kprintf("pipe   frames   crc_err   len_err    id_err  sync_drop\r\n");
+    for(rt_uint8_t i = 0; i < 6; i++){
+        nrf24_decoder_t dec = &_nrf24->decoder[i];
+        rt_kprintf("p%d   %8d  %8d  %8d  %8d   %8d\r\n", i,
+                   dec->frames, dec->crc_errors, dec->length_errors, dec->id_errors, dec->sync_drops);
+    }
+
+    if(argc > 1 && rt_strcmp(argv[1], "reset") == 0){
+        for(rt_uint8_t i = 0; i < 6; i++){
+            nrf24l01_decoder_init(&_nrf24->decoder[i]);
+        }
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_decoder_cmd, nrf24_decoder, show frame decoder counters [reset]);
+
+
+
+/***
+ * @brief msh 命令：解码器自检，用独立的解码器实例处理随机数据
+ * @note  nrf24_decoder_fuzz [次数]，默认 10000 组
+ *        1. 随机字节流（帧头、合法/非法长度字节加权出现），每次送入后检查解码状态不越界
+ *        2. 合法帧夹杂噪声后按随机长度切片送入，检查解出的帧数与发送的帧数一致
+ */
+static rt_uint16_t fuzz_frames;
+
+static void nrf24_decoder_fuzz_handler(void *parameter, uint8_t *frame, uint8_t length)
+{
+    fuzz_frames++;
+}
+
+static void nrf24_decoder_fuzz_cmd(int argc, char **argv)
+{
+    struct nRF24L01_DECODER_STRUCT dec;
+    rt_uint32_t loops = 10000, overrun = 0, lost = 0;
+    rt_uint8_t  buf[64], data[FRAME_MAX_LENGTH];
+    rt_uint8_t  len, sent, pos, chunk;
+
+    if(argc > 1){
+        loops = atoi(argv[1]);
+    }
+    if(loops == 0 || loops > 1000000){
+        rt_kprintf("Usage: nrf24_decoder_fuzz [1~1000000]\r\n");
+        return;
+    }
+
+    // 1. 随机字节流
+    nrf24l01_decoder_init(&dec);
+    for(rt_uint32_t n = 0; n < loops; n++)
+    {
+        len = nRF24L01_Debug_Random() % sizeof(buf);
+        for(rt_uint8_t i = 0; i < len; i++){
+            rt_uint32_t r = nRF24L01_Debug_Random();
+            switch(r & 0x07){
+                case 0:  buf[i] = FRAME_HEAD1;                            break;
+                case 1:  buf[i] = FRAME_HEAD2;                            break;
+                case 2:  buf[i] = (r >> 8) % (FRAME_BUFFER_SIZE + 8);     break;
+                default: buf[i] = r >> 8;                                 break;
+            }
+        }
+        nrf24l01_decoder_feed(&dec, buf, len, RT_NULL, RT_NULL);
+        if(dec.count > FRAME_BUFFER_SIZE || dec.step > Decode_Step_7){
+            overrun++;
+        }
+    }
+
+    // 2. 合法帧 + 噪声，随机切片
+    nrf24l01_decoder_init(&dec);
+    for(rt_uint32_t n = 0; n < loops; n++)
+    {
+        len = nRF24L01_Debug_Random() % (FRAME_MAX_LENGTH - CMD_MINI_LENGTH + 1);
+        for(rt_uint8_t i = 0; i < len; i++){
+            data[i] = nRF24L01_Debug_Random();
+        }
+        pos = nRF24L01_Debug_Random() % 4;
+        for(rt_uint8_t i = 0; i < pos; i++){
+            buf[i] = nRF24L01_Debug_Random() & 0x3F;   // 噪声取 0~0x3F，不会与帧头 0x55 混淆
+        }
+        sent = pos + nrf24l01_build_frame(FRAME_TYPE_ACT, FRAME_STATE_ASK, data, len, &buf[pos]);
+
+        fuzz_frames = 0;
+        for(pos = 0; pos < sent; pos += chunk){
+            chunk = 1 + nRF24L01_Debug_Random() % 32;
+            if(chunk > sent - pos){
+                chunk = sent - pos;
+            }
+            nrf24l01_decoder_feed(&dec, &buf[pos], chunk, nrf24_decoder_fuzz_handler, RT_NULL);
+        }
+        if(fuzz_frames != 1){
+            lost++;
+        }
+    }
+
+    rt_kprintf("[nrf24] decoder fuzz %d loops: overrun %d, lost %d\r\n", loops, overrun, lost);
+    rt_kprintf("frames %d, crc_err %d, len_err %d, id_err %d, sync_drop %d\r\n",
+               dec.frames, dec.crc_errors, dec.length_errors, dec.id_errors, dec.sync_drops);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_decoder_fuzz_cmd, nrf24_decoder_fuzz, frame decoder self test [loops]);
+
+
+
+
+
+/***
+ * @brief msh 命令：打印寄存器影子和省掉的 SPI 访问次数
+ * @note  nrf24_reg          打印影子（* 为脏，? 为无效）
+ *        nrf24_reg verify   逐个读回有效且不脏的寄存器，与影子对比（读回会刷新影子）
+ */
+static void nrf24_reg_cmd(int argc, char **argv)
+{
+    struct nRF24L01_SHADOW_STRUCT *shadow;
+    rt_uint8_t mismatch = 0;
+
+    if(_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    shadow = &_nrf24->shadow;
 
+    if(argc > 1 && rt_strcmp(argv[1], "verify") == 0){
+        for(rt_uint8_t reg = 0; reg < NRF24_SHADOW_REG_NUM; reg++){
+            rt_uint32_t bit = 1UL << reg;
+            rt_uint8_t cached = shadow->reg[reg];
+            if(((NRF24_SHADOW_VOLATILE | NRF24_SHADOW_ADDR_REGS) & bit) || (shadow->valid & bit) == 0 || (shadow->dirty & bit)){
+                continue;
+            }
+            if(nRF24L01_Read_Reg_Data(_nrf24, reg) != cached){
+                rt_kprintf("reg 0x%02x: shadow 0x%02x, chip 0x%02x\r\n", reg, cached, shadow->reg[reg]);
+                mismatch++;
+            }
+        }
+        rt_kprintf("[nrf24] shadow verify: %d mismatch.\r\n", mismatch);
+    }
 
+    for(rt_uint8_t reg = 0; reg < NRF24_SHADOW_REG_NUM; reg++){
+        rt_uint32_t bit = 1UL << reg;
+        if((NRF24_SHADOW_VOLATILE | NRF24_SHADOW_ADDR_REGS) & bit){
+            rt_kprintf(" 0x%02x: --  ", reg);
+        }
+        else{
+            rt_kprintf(" 0x%02x: %02x%c ", reg, shadow->reg[reg],
+                       (shadow->dirty & bit) ? '*' : ((shadow->valid & bit) ? ' ' : '?'));
+        }
+        if((reg & 0x07) == 0x07){
+            rt_kprintf("\r\n");
+        }
+    }
+    rt_kprintf("\r\n[nrf24] shadow writes %d, skipped %d, reads saved %d, dirty 0x%08x\r\n",
+               shadow->writes, shadow->skipped, shadow->reads_saved, shadow->dirty);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_reg_cmd, nrf24_reg, show register shadow [verify]);
@@ -12,12 +12,41 @@
 #include "bsp_sys.h"
 
 
+/***
+ * IRQ -> 回调 延时直方图的分桶数量
+ * 分桶上限(us)：50 / 100 / 200 / 500 / 1000 / 2000 / 5000 / 其余
+ */
+#define NRF24_LATENCY_BUCKETS   8
 
 
-
-
-
-
+/***
+ * nRF24L01 中断服务延时统计结构体，内嵌在 nRF24L01 实例中
+ * IRQ 时刻由该实例的 IRQ 中断写入，TDMA、跳频用它作为 IRQ 到达的时间基准
+ */
+struct nRF24L01_LATENCY_STRUCT
+{
+    /* IRQ 引脚下降沿时刻的 DWT 周期计数 */
+    volatile rt_uint32_t irq_cycles;
+    /* 1: 已记录 IRQ 时刻，等待线程处理 */
+    volatile rt_uint8_t  irq_pending;
+
+    rt_uint32_t bucket[NRF24_LATENCY_BUCKETS];
+    rt_uint32_t count;
+    rt_uint32_t min_us;
+    rt_uint32_t max_us;
+    rt_uint64_t sum_us;
+};
+
+struct nRF24L01_STRUCT;
+
+
+// 函数声明 -------------------------------------------------------------------
+void nRF24L01_Debug_Init(void);
+rt_uint32_t nRF24L01_Debug_Get_Cycles(void);
+rt_uint32_t nRF24L01_Debug_Cycles_To_Us(rt_uint32_t cycles);
+void nRF24L01_Debug_Mark_IRQ(struct nRF24L01_STRUCT *nrf24);
+void nRF24L01_Debug_Record_Latency(struct nRF24L01_STRUCT *nrf24);
+void nRF24L01_Debug_Reset_Latency(struct nRF24L01_STRUCT *nrf24);
 
 
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-10-02     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_DEV_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_DEV_H_
+#include "bsp_sys.h"
+
+
+/***
+ * RT-Thread 设备接口
+ * 每个 nRF24L01 实例注册一个与实例同名的字符设备（"nrf0"、"nrf1"），应用用 rt_device_find / open / read / write / control 访问，
+ * 不再直接碰 _nrf24 和驱动内部；多个线程可以同时打开同一个设备
+ * RX : 打开后，交给应用的包中以 NRF24_DEV_MARK 开头的设备数据，去掉类型字节后再放进一个 rt_rbb 环形块缓冲，
+ *      读线程用 NRF24_CTRL_BLK_GET 直接拿到块在环形缓冲中的指针，处理完 NRF24_CTRL_BLK_FREE 归还，读出时不再拷贝；
+ *      rt_device_read 是拷贝版本，每次读出一包；缓冲满时丢弃新包
+ * TX : rt_device_write 把数据按 NRF24_DEV_PAYLOAD_SIZE 字节切包、加上类型字节放入软件发送队列（需要应答），只用于 PTX
+ *
+ * NRF24_USE_DEVICE    : 1 -> 注册设备
+ * NRF24_DEV_RBB_SIZE  : 环形块缓冲的字节数
+ * NRF24_DEV_RBB_BLKS  : 环形块缓冲最多同时容纳的包数
+ */
+#define NRF24_USE_DEVICE            1
+#define NRF24_DEV_RBB_SIZE          1024
+#define NRF24_DEV_RBB_BLKS          32
+
+
+/***
+ * 设备数据的类型字节
+ * 空口上的控制报文按首字节区分：0x1x 跳频、0x2x 信道、0x3x 链路自适应、0x4x 切换引擎、0x5x 全双工、0x6x 轮换、0x7x TDMA、
+ * 10xxxxxx 可靠传输、11xxxxxx 分片，协议帧以 0x55 开头；0x0x 不属于任何层，留给应用数据
+ * 设备收发的每一包以 NRF24_DEV_MARK 开头，其后为 1 ~ NRF24_DEV_PAYLOAD_SIZE 字节数据，不会被任何层当作控制报文
+ */
+#define NRF24_DEV_MARK              0x00
+#define NRF24_DEV_PAYLOAD_SIZE      31
+
+
+/***
+ * 环形块缓冲中每一块的格式：[管道号][描述符标志][载荷 1~31 字节]
+ */
+#define NRF24_DEV_BLK_HEADER        2
+
+
+/***
+ * rt_device_control 命令，arg 均为指针
+ * SET/GET_CHANNEL : rt_uint8_t，信道；设置只用于 PTX，与对端协商后切换
+ * SET/GET_RATE    : rt_uint8_t，NRF24_LINK_250K / NRF24_LINK_1M / NRF24_LINK_2M；设置只用于 PTX，与对端协商后切换
+ * SET/GET_POWER   : rt_uint8_t，nrf24_power_et
+ * SET/GET_ROLE    : rt_uint8_t，nrf24_role_et；PTX 要等芯片 TX FIFO 中的数据发完才切换
+ * BLK_GET         : struct nrf24_dev_rx，取出最早的一包，最多等待 timeout 个 tick
+ * BLK_FREE        : struct nrf24_dev_rx，归还 BLK_GET 取出的一包
+ * 设置命令由射频线程异步执行，返回 RT_EOK 只表示请求已提交
+ */
+#define NRF24_CTRL_SET_CHANNEL      0x30
+#define NRF24_CTRL_GET_CHANNEL      0x31
+#define NRF24_CTRL_SET_RATE         0x32
+#define NRF24_CTRL_GET_RATE         0x33
+#define NRF24_CTRL_SET_POWER        0x34
+#define NRF24_CTRL_GET_POWER        0x35
+#define NRF24_CTRL_SET_ROLE         0x36
+#define NRF24_CTRL_GET_ROLE         0x37
+#define NRF24_CTRL_BLK_GET          0x38
+#define NRF24_CTRL_BLK_FREE         0x39
+
+
+/***
+ * NRF24_CTRL_BLK_GET / NRF24_CTRL_BLK_FREE 的参数
+ * timeout 由调用者填写，其余由 BLK_GET 填写；data 指向环形缓冲内部，BLK_FREE 之前一直有效
+ */
+struct nrf24_dev_rx
+{
+    rt_int32_t   timeout;
+    rt_rbb_blk_t blk;
+    rt_uint8_t  *data;
+    rt_uint8_t   len;
+    rt_uint8_t   pipe;
+    rt_uint8_t   flags;
+};
+
+
+/***
+ * 设备对象，内嵌在 nRF24L01 实例中
+ * 环形块缓冲由交付数据包的线程写入（射频线程，星型中心模式下还有中心线程），读写双方都靠 rt_rbb 内部的关中断互斥；
+ * rx_sem 的计数等于缓冲中已放入、尚未取出的包数
+ */
+struct nRF24L01_DEV_STRUCT
+{
+    struct rt_device parent;
+    struct nRF24L01_STRUCT *nrf24;
+
+    struct rt_rbb rbb;
+    struct rt_rbb_blk blk_set[NRF24_DEV_RBB_BLKS];
+    rt_uint8_t  buf[NRF24_DEV_RBB_SIZE];
+    struct rt_semaphore rx_sem;
+
+    /* 角色切换请求，由射频线程执行：0 无请求，否则为 nrf24_role_et + 1 */
+    volatile rt_uint8_t role_req;
+
+    /* 统计 */
+    rt_uint32_t rx_packets;
+    rt_uint32_t rx_dropped;
+    rt_uint32_t tx_packets;
+    rt_uint32_t tx_dropped;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_DEV_H_ */
@@ -51,10 +51,10 @@ int nRF24L01_Param_Config(nrf24_param_t param)
 
     /* SET_RETR */
     param->setup_retr.arc = 15;
-    param->setup_retr.ard = ADR_2Mbps;
+    param->setup_retr.ard = NRF24_ARD_CODE(500);
 
     /* RF_CH */
-    param->rf_ch.rf_ch = 100; /*! 无线频道设为 100（2.500 GHz） */
+    param->rf_ch.rf_ch = NRF24_CHAN_HOME; /*! 无线频道设为 100（2.500 GHz） */
 
     /* RF_SETUP */
     param->rf_setup.rf_pwr      = RF_POWER_0dBm;
@@ -87,6 +87,21 @@ int nRF24L01_Param_Config(nrf24_param_t param)
     param->rx_addr_p4 = 4;
     param->rx_addr_p5 = 5;
 
+#if NRF24_USE_HUB
+    /* 星型中心：打开全部 6 个管道并使能自动应答 */
+    param->en_aa.p2 = param->en_aa.p3 = param->en_aa.p4 = param->en_aa.p5 = 1;
+    param->en_rxaddr.p2 = param->en_rxaddr.p3 = param->en_rxaddr.p4 = param->en_rxaddr.p5 = RT_TRUE;
+#endif
+#if NRF24_TDMA_HUB
+    /* TDMA 中心：信标以 NO_ACK 广播给监听管道 1 的节点 */
+    rt_memcpy(param->txaddr, param->rx_addr_p1, 5);
+#endif
+#if NRF24_NODE_PIPE != 0
+    /* 节点：发送地址换成中心对应管道的地址，管道 0 与之相同才能收到自动应答 */
+    nRF24L01_Hub_Pipe_Addr(param, NRF24_NODE_PIPE, param->txaddr);
+    rt_memcpy(param->rx_addr_p0, param->txaddr, 5);
+#endif
+
     return RT_EOK;
 
 }
@@ -95,134 +110,283 @@ int nRF24L01_Param_Config(nrf24_param_t param)
 
 
 
+/* 回环写读使用的测试图样：递增、全 0、全 1、交替位、walking-one，覆盖高低电平保持和相邻位翻转 */
+static const uint8_t spi_check_pattern[][5] = {
+    { 0x01, 0x02, 0x03, 0x04, 0x05 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+    { 0x55, 0xAA, 0x55, 0xAA, 0x55 },
+    { 0xAA, 0x55, 0xAA, 0x55, 0xAA },
+    { 0x01, 0x02, 0x04, 0x08, 0x80 },
+};
+
+
 /**
  *  @brief  在不依赖任何上层状态的前提下，用最简短的 SPI 读写回路验证“MCU ↔ NRF24L01”硬件连接是否正常
- *  @note   检测思路（经典“回环写读”）
+ *  @note   检测思路（经典“回环写读”），依次写读多组测试图样，任意一组不一致即判定失败；
+ *          SPI 时钟协商也复用本函数判断每一档速率是否可靠
  */
 int nRF24L01_Check_SPI_Community(nrf24_t port_ops)
 {
     /***
-     * 1. 创建两个数组缓冲区，一个用来备份当前默认地址数据，一个用于存储测试数据
-     *    test_addr[5]  用于存储测试数据
+     * 1. 创建两个数组缓冲区，一个用来备份当前默认地址数据，一个用于读回测试数据
+     *    test_addr[5]  用于读回测试数据
      *    backup_addr[5]用于存储原始数据，测试完后用于恢复现场
-     *    send_empty    用于触发连续读取或者写入的变量
      *
      * 2. 读取 NRF24REG_RX_ADDR_P1 寄存器指令中的地址数据，存入backup_addr
      *
-     * 3. 写入 NRF24REG_RX_ADDR_P1 寄存器指定的地址数据
-     *
-     * 4. 清空 test_addr[5] 为读回刚刚写入的数据做准备
+     * 3. 对每一组测试图样：写入 NRF24REG_RX_ADDR_P1，清空 test_addr[5] 后读回并对比，如果出错代表SPI读写有误
      *
-     * 5. 读取 NRF24REG_RX_ADDR_P1 寄存器指令中的地址数据，存入test_addr
-     *
-     * 6. 和 backup_addr[5]中的原始地址数据进行数据对比，如果出错代表SPI写入有误
-     *
-     * 7. 恢复现场
+     * 4. 恢复现场（测试失败时同样恢复）
      */
 
     RT_ASSERT(port_ops != RT_NULL);
 
     // 1. 创建变量缓冲区
-    uint8_t test_addr[5]    = { 1,2,3,4,5 };
+    uint8_t test_addr[5]    = { 0 };
     uint8_t backup_addr[5]  = { 0 };
     uint8_t send_cmd;
+    int result = RT_EOK;
 
     // 2. 读取 rx_addr_p1[5] 的地址数据
     send_cmd = NRF24CMD_R_REG | NRF24REG_RX_ADDR_P1;
     port_ops->nrf24_ops.nrf24_send_then_recv(&port_ops->port_api, &send_cmd, 1, backup_addr, 5);
 
-    // 3. 写入测试
-    send_cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P1;
-    port_ops->nrf24_ops.nrf24_send_then_send(&port_ops->port_api, &send_cmd, 1, test_addr, 5);
-
-    // 4. 清零 test_addr[5] , 用于读回刚刚写入的数据
-    rt_memset(test_addr, 0, sizeof(test_addr));
+    // 3. 逐组写入测试图样并读回对比
+    for (int n = 0; n < sizeof(spi_check_pattern) / sizeof(spi_check_pattern[0]); n++)
+    {
+        send_cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P1;
+        port_ops->nrf24_ops.nrf24_send_then_send(&port_ops->port_api, &send_cmd, 1, spi_check_pattern[n], 5);
 
-    // 5. 重复一遍步骤2.
-    send_cmd = NRF24CMD_R_REG | NRF24REG_RX_ADDR_P1;
-    port_ops->nrf24_ops.nrf24_send_then_recv(&port_ops->port_api, &send_cmd, 1, test_addr, 5);
+        rt_memset(test_addr, 0, sizeof(test_addr));
+        send_cmd = NRF24CMD_R_REG | NRF24REG_RX_ADDR_P1;
+        port_ops->nrf24_ops.nrf24_send_then_recv(&port_ops->port_api, &send_cmd, 1, test_addr, 5);
 
-    // 6. 和 backup_addr[5]中的原始地址数据进行数据对比，如果出错代表SPI写入有误
-    for (int i = 0; i < 5; i++)
-    {
-        if (test_addr[i] != i+1){
-            return RT_ERROR;
+        if (rt_memcmp(test_addr, spi_check_pattern[n], 5) != 0){
+            result = RT_ERROR;
+            break;
         }
     }
 
-    // 7. 恢复现场
+    // 4. 恢复现场
     send_cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P1;
     port_ops->nrf24_ops.nrf24_send_then_send(&port_ops->port_api, &send_cmd, 1, backup_addr, 5);
 
-    return RT_EOK;
+    return result;
 }
 
 
 
 
 
-/**
- *  @brief 把参数更新到芯片的寄存器当中
- *  @note
+/***
+ * 参数结构体中与寄存器一一对应的字段，按写入芯片的顺序排列
+ * CONFIG 放在最后，PWR_UP / PRIM_RX 在其余参数就绪后才生效
  */
-int nRF24L01_Update_Parameter(nrf24_t nrf24)
+static const struct
 {
-    uint8_t cmd;
+    uint8_t reg;
+    uint8_t len;
+    const char *name;
+} nrf24_param_regs[] = {
+    { NRF24REG_EN_AA,       1, "en_aa"      },
+    { NRF24REG_EN_RXADDR,   1, "en_rxaddr"  },
+    { NRF24REG_SETUP_AW,    1, "setup_aw"   },
+    { NRF24REG_SETUP_RETR,  1, "setup_retr" },
+    { NRF24REG_RF_CH,       1, "rf_ch"      },
+    { NRF24REG_RF_SETUP,    1, "rf_setup"   },
+    { NRF24REG_DYNPD,       1, "dynpd"      },
+    { NRF24REG_FEATURE,     1, "feature"    },
+    { NRF24REG_TX_ADDR,     5, "txaddr"     },
+    { NRF24REG_RX_ADDR_P0,  5, "rx_addr_p0" },
+    { NRF24REG_RX_ADDR_P1,  5, "rx_addr_p1" },
+    { NRF24REG_RX_ADDR_P2,  1, "rx_addr_p2" },
+    { NRF24REG_RX_ADDR_P3,  1, "rx_addr_p3" },
+    { NRF24REG_RX_ADDR_P4,  1, "rx_addr_p4" },
+    { NRF24REG_RX_ADDR_P5,  1, "rx_addr_p5" },
+    { NRF24REG_CONFIG,      1, "config"     },
+};
 
-    rt_kprintf("----------------------------------\r\n");
 
+/***
+ * @brief  寄存器在参数结构体中对应的字段
+ * @return RT_NULL 表示该寄存器没有对应的参数
+ */
+static uint8_t *nRF24L01_Param_Reg_Ptr(nrf24_param_t param, uint8_t reg_addr)
+{
+    switch(reg_addr)
+    {
+    case NRF24REG_CONFIG:       return (uint8_t *)&param->config;
+    case NRF24REG_EN_AA:        return (uint8_t *)&param->en_aa;
+    case NRF24REG_EN_RXADDR:    return (uint8_t *)&param->en_rxaddr;
+    case NRF24REG_SETUP_AW:     return (uint8_t *)&param->setup_aw;
+    case NRF24REG_SETUP_RETR:   return (uint8_t *)&param->setup_retr;
+    case NRF24REG_RF_CH:        return (uint8_t *)&param->rf_ch;
+    case NRF24REG_RF_SETUP:     return (uint8_t *)&param->rf_setup;
+    case NRF24REG_DYNPD:        return (uint8_t *)&param->dynpd;
+    case NRF24REG_FEATURE:      return (uint8_t *)&param->feature;
+    case NRF24REG_TX_ADDR:      return param->txaddr;
+    case NRF24REG_RX_ADDR_P0:   return param->rx_addr_p0;
+    case NRF24REG_RX_ADDR_P1:   return param->rx_addr_p1;
+    case NRF24REG_RX_ADDR_P2:   return &param->rx_addr_p2;
+    case NRF24REG_RX_ADDR_P3:   return &param->rx_addr_p3;
+    case NRF24REG_RX_ADDR_P4:   return &param->rx_addr_p4;
+    case NRF24REG_RX_ADDR_P5:   return &param->rx_addr_p5;
+    default:                    return RT_NULL;
+    }
+}
+
+
+/***
+ * @brief  寄存器在影子中的存放位置
+ */
+static uint8_t *nRF24L01_Shadow_Reg_Ptr(struct nRF24L01_SHADOW_STRUCT *shadow, uint8_t reg_addr)
+{
+    switch(reg_addr)
+    {
+    case NRF24REG_TX_ADDR:      return shadow->tx_addr;
+    case NRF24REG_RX_ADDR_P0:   return shadow->rx_addr_p0;
+    case NRF24REG_RX_ADDR_P1:   return shadow->rx_addr_p1;
+    default:                    return &shadow->reg[reg_addr];
+    }
+}
+
+
+/***
+ * @brief  单字节寄存器能否由影子代替芯片
+ */
+static rt_bool_t nRF24L01_Shadow_Cacheable(uint8_t reg_addr)
+{
+    return (reg_addr < NRF24_SHADOW_REG_NUM) &&
+           ((NRF24_SHADOW_VOLATILE | NRF24_SHADOW_ADDR_REGS) & (1UL << reg_addr)) == 0;
+}
+
+
+/***
+ * @brief  作废全部影子，下一次位更新会重新从芯片读回
+ * @note   初始化时、以及怀疑芯片被复位（掉电、SPI 异常）后调用
+ */
+void nRF24L01_Shadow_Invalidate(nrf24_t nrf24)
+{
+    rt_memset(&nrf24->shadow, 0, sizeof(struct nRF24L01_SHADOW_STRUCT));
+}
+
+
+/***
+ * @brief  只修改影子和参数结构体，不访问 SPI，由 nRF24L01_Shadow_Flush 统一写入
+ * @note   值与芯片一致且没有待写入的修改时不会标记为脏；多次修改同一寄存器只写入最后一次
+ */
+void nRF24L01_Shadow_Set(nrf24_t nrf24, uint8_t reg_addr, uint8_t data)
+{
+    struct nRF24L01_SHADOW_STRUCT *shadow = &nrf24->shadow;
+    rt_uint32_t bit = 1UL << reg_addr;
+    uint8_t *param;
+
+    if(!nRF24L01_Shadow_Cacheable(reg_addr)){
+        nRF24L01_Write_Reg_Data(nrf24, reg_addr, data);
+        return;
+    }
+
+    param = nRF24L01_Param_Reg_Ptr(&nrf24->nrf24_cfg, reg_addr);
+    if(param != RT_NULL){
+        *param = data;
+    }
+    /* 已是脏的寄存器影子里存的是待写入的值而不是芯片的值，不能据此清除脏位 */
+    if((shadow->valid & bit) && !(shadow->dirty & bit) && shadow->reg[reg_addr] == data){
+        return;
+    }
+    shadow->reg[reg_addr] = data;
+    shadow->dirty |= bit;
+}
+
+
+/***
+ * @brief  把参数结构体装入影子，与芯片不一致（或影子无效）的寄存器标记为脏
+ */
+void nRF24L01_Shadow_Stage(nrf24_t nrf24)
+{
+    struct nRF24L01_SHADOW_STRUCT *shadow = &nrf24->shadow;
+
+    for(rt_uint8_t i = 0; i < sizeof(nrf24_param_regs) / sizeof(nrf24_param_regs[0]); i++)
+    {
+        uint8_t reg = nrf24_param_regs[i].reg;
+        uint8_t len = nrf24_param_regs[i].len;
+        uint8_t *src = nRF24L01_Param_Reg_Ptr(&nrf24->nrf24_cfg, reg);
+        uint8_t *dst = nRF24L01_Shadow_Reg_Ptr(shadow, reg);
+
+        if((shadow->valid & (1UL << reg)) == 0 || rt_memcmp(dst, src, len) != 0){
+            rt_memcpy(dst, src, len);
+            shadow->dirty |= 1UL << reg;
+        }
+    }
+}
 
-    // 3. 写EN_AA寄存器
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_EN_AA,           *((uint8_t *)&nrf24->nrf24_cfg.en_aa));
-    rt_kprintf("[WRITE]ccfg->en_aa           = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.en_aa));
 
-    // 4. 设置可用的接收信道
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_EN_RXADDR,       *((uint8_t *)&nrf24->nrf24_cfg.en_rxaddr));
-    rt_kprintf("[WRITE]ccfg->en_rxaddr       = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.en_rxaddr));
+/***
+ * @brief  把脏寄存器按 nrf24_param_regs 的顺序写入芯片，每个寄存器一次片选
+ * @return 写入的寄存器个数
+ */
+int nRF24L01_Shadow_Flush(nrf24_t nrf24)
+{
+    struct nRF24L01_SHADOW_STRUCT *shadow = &nrf24->shadow;
+    uint8_t frame[6];
+    int count = 0;
+
+    for(rt_uint8_t i = 0; i < sizeof(nrf24_param_regs) / sizeof(nrf24_param_regs[0]) && shadow->dirty != 0; i++)
+    {
+        uint8_t reg = nrf24_param_regs[i].reg;
+        uint8_t len = nrf24_param_regs[i].len;
+        rt_uint32_t bit = 1UL << reg;
 
-    // 5. 设置地址宽度，这个指令针对所有信道
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_SETUP_AW,        *((uint8_t *)&nrf24->nrf24_cfg.setup_aw));
-    rt_kprintf("[WRITE]ccfg->setup_aw        = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.setup_aw));
+        if((shadow->dirty & bit) == 0){
+            continue;
+        }
+        frame[0] = NRF24CMD_W_REG | reg;
+        rt_memcpy(&frame[1], nRF24L01_Shadow_Reg_Ptr(shadow, reg), len);
+        nrf24->nrf24_ops.nrf24_write(&nrf24->port_api, frame, len + 1);
+
+        shadow->valid |= bit;
+        shadow->dirty &= ~bit;
+        shadow->writes++;
+        count++;
+    }
 
-    // 6. 设置建立自动重发机制
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_SETUP_RETR,      *((uint8_t *)&nrf24->nrf24_cfg.setup_retr));
-    rt_kprintf("[WRITE]ccfg->setup_retr      = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.setup_retr));
+    return count;
+}
 
-    // 7. RF频段通道设置
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH,           *((uint8_t *)&nrf24->nrf24_cfg.rf_ch));
-    rt_kprintf("[WRITE]ccfg->rf_ch           = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.rf_ch));
 
-    // 8. 设置RF射频速率等
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_SETUP,        *((uint8_t *)&nrf24->nrf24_cfg.rf_setup));
-    rt_kprintf("[WRITE]ccfg->rf_setup        = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.rf_setup));
+/**
+ *  @brief 把参数更新到芯片的寄存器当中
+ *  @note  参数结构体先装入影子，只写入与芯片不一致的寄存器；第一次调用时影子无效，全部写入
+ */
+int nRF24L01_Update_Parameter(nrf24_t nrf24)
+{
+    rt_uint32_t dirty;
 
-    // 9. 设置不同信道数据动态长度使能
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_DYNPD,           *((uint8_t *)&nrf24->nrf24_cfg.dynpd));
-    rt_kprintf("[WRITE]ccfg->dynpd           = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.dynpd));
+    rt_kprintf("----------------------------------\r\n");
 
-    // 10. 设置扩展功能
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_FEATURE,         *((uint8_t *)&nrf24->nrf24_cfg.feature));
-    rt_kprintf("[WRITE]ccfg->feature         = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.feature));
+    // 1. 参数结构体 -> 影子
+    nRF24L01_Shadow_Stage(nrf24);
+    dirty = nrf24->shadow.dirty;
 
-    // 11. 设置CRC等基础配置项
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_CONFIG,          *((uint8_t *)&nrf24->nrf24_cfg.config));
-    rt_kprintf("[WRITE]ccfg->config          = 0x%02x.\r\n", *((uint8_t *)&nrf24->nrf24_cfg.config));
+    // 2. 只写入脏寄存器
+    nRF24L01_Shadow_Flush(nrf24);
 
+    for(rt_uint8_t i = 0; i < sizeof(nrf24_param_regs) / sizeof(nrf24_param_regs[0]); i++)
+    {
+        uint8_t *src = nRF24L01_Param_Reg_Ptr(&nrf24->nrf24_cfg, nrf24_param_regs[i].reg);
 
-    cmd = NRF24CMD_W_REG | NRF24REG_TX_ADDR;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, nrf24->nrf24_cfg.txaddr, 5);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P0;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, nrf24->nrf24_cfg.rx_addr_p0, 5);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P1;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, nrf24->nrf24_cfg.rx_addr_p1, 5);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P2;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &nrf24->nrf24_cfg.rx_addr_p2, 1);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P3;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &nrf24->nrf24_cfg.rx_addr_p3, 1);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P4;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &nrf24->nrf24_cfg.rx_addr_p4, 1);
-    cmd = NRF24CMD_W_REG | NRF24REG_RX_ADDR_P5;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &nrf24->nrf24_cfg.rx_addr_p5, 1);
+        if((dirty & (1UL << nrf24_param_regs[i].reg)) == 0){
+            continue;
+        }
+        if(nrf24_param_regs[i].len == 5){
+            LOG_I("[WRITE]ccfg->%-14s= %02x %02x %02x %02x %02x.",
+                  nrf24_param_regs[i].name, src[0], src[1], src[2], src[3], src[4]);
+        }
+        else{
+            LOG_I("[WRITE]ccfg->%-14s= 0x%02x.", nrf24_param_regs[i].name, src[0]);
+        }
+    }
 
 
     return RT_EOK;
@@ -240,31 +404,31 @@ int nRF24L01_Read_Onchip_Parameter(nrf24_t nrf24)
     rt_kprintf("----------------------------------\r\n");
 
     *((uint8_t *)&real_cfg.en_aa)           =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_EN_AA);
-    rt_kprintf("[READ]real_cfg.en_aa        = 0x%02x.\r\n", *((uint8_t *)&real_cfg.en_aa));
+    LOG_I("[READ]real_cfg.en_aa        = 0x%02x.", *((uint8_t *)&real_cfg.en_aa));
 
     *((uint8_t *)&real_cfg.en_rxaddr)       =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_EN_RXADDR);
-    rt_kprintf("[READ]real_cfg.en_rxaddr    = 0x%02x.\r\n", *((uint8_t *)&real_cfg.en_rxaddr));
+    LOG_I("[READ]real_cfg.en_rxaddr    = 0x%02x.", *((uint8_t *)&real_cfg.en_rxaddr));
 
     *((uint8_t *)&real_cfg.setup_aw)        =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_SETUP_AW);
-    rt_kprintf("[READ]real_cfg.setup_aw     = 0x%02x.\r\n", *((uint8_t *)&real_cfg.setup_aw));
+    LOG_I("[READ]real_cfg.setup_aw     = 0x%02x.", *((uint8_t *)&real_cfg.setup_aw));
 
     *((uint8_t *)&real_cfg.setup_retr)      =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_SETUP_RETR);
-    rt_kprintf("[READ]real_cfg.setup_retr   = 0x%02x.\r\n", *((uint8_t *)&real_cfg.setup_retr));
+    LOG_I("[READ]real_cfg.setup_retr   = 0x%02x.", *((uint8_t *)&real_cfg.setup_retr));
 
     *((uint8_t *)&real_cfg.rf_ch)           =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_RF_CH);
-    rt_kprintf("[READ]real_cfg.rf_ch        = 0x%02x.\r\n", *((uint8_t *)&real_cfg.rf_ch));
+    LOG_I("[READ]real_cfg.rf_ch        = 0x%02x.", *((uint8_t *)&real_cfg.rf_ch));
 
     *((uint8_t *)&real_cfg.rf_setup)        =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_RF_SETUP);
-    rt_kprintf("[READ]real_cfg.rf_setup     = 0x%02x.\r\n", *((uint8_t *)&real_cfg.rf_setup));
+    LOG_I("[READ]real_cfg.rf_setup     = 0x%02x.", *((uint8_t *)&real_cfg.rf_setup));
 
     *((uint8_t *)&real_cfg.dynpd)           =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_DYNPD);
-    rt_kprintf("[READ]real_cfg.dynpd        = 0x%02x.\r\n", *((uint8_t *)&real_cfg.dynpd));
+    LOG_I("[READ]real_cfg.dynpd        = 0x%02x.", *((uint8_t *)&real_cfg.dynpd));
 
     *((uint8_t *)&real_cfg.feature)         =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_FEATURE);
-    rt_kprintf("[READ]real_cfg.feature      = 0x%02x.\r\n", *((uint8_t *)&real_cfg.feature));
+    LOG_I("[READ]real_cfg.feature      = 0x%02x.", *((uint8_t *)&real_cfg.feature));
 
     *((uint8_t *)&real_cfg.config)          =  nRF24L01_Read_Reg_Data(nrf24, NRF24REG_CONFIG);
-    rt_kprintf("[READ]real_cfg.config       = 0x%02x.\r\n", *((uint8_t *)&real_cfg.config));
+    LOG_I("[READ]real_cfg.config       = 0x%02x.", *((uint8_t *)&real_cfg.config));
 
     tmp = NRF24CMD_R_REG | NRF24REG_TX_ADDR;
     nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &tmp, 1, (uint8_t *)&real_cfg.txaddr, 5);
@@ -298,24 +462,47 @@ int nRF24L01_Read_Onchip_Parameter(nrf24_t nrf24)
  */
 uint8_t nRF24L01_Read_Reg_Data(nrf24_t nrf24, uint8_t reg_addr)
 {
+    uint8_t tx_buf[2] = { NRF24CMD_R_REG | reg_addr, NRF24CMD_NOP };
+    uint8_t rx_buf[2] = { 0 };
+    rt_uint32_t bit = 1UL << reg_addr;
 
-    uint8_t cmd, rx_empty = 0;
+    nrf24->nrf24_ops.nrf24_transfer(&nrf24->port_api, tx_buf, rx_buf, 2);
 
-    cmd = NRF24CMD_R_REG | reg_addr;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &rx_empty, 1);
+    // 读回的值顺便刷新影子，尚未写入的脏值以影子为准
+    if(nRF24L01_Shadow_Cacheable(reg_addr) && (nrf24->shadow.dirty & bit) == 0){
+        nrf24->shadow.reg[reg_addr] = rx_buf[1];
+        nrf24->shadow.valid |= bit;
+    }
 
-    return rx_empty;
+    return rx_buf[1];
 }
 
 
-/****
- * @param  reg_addr: 要写的寄存器地址
- *         data    : 要写的数据
- * @return NULL
+/***
+ * @brief  写寄存器并同步影子；参数结构体只同步 param_mask 覆盖的位
+ * @note   位更新时寄存器其余位可能来自芯片读回，不能覆盖参数结构体中尚未写入的配置
  */
-void nRF24L01_Write_Reg_Data(nrf24_t nrf24, uint8_t reg_addr, uint8_t data)
+static void nRF24L01_Write_Reg_Masked(nrf24_t nrf24, uint8_t reg_addr, uint8_t data, uint8_t param_mask)
 {
+    struct nRF24L01_SHADOW_STRUCT *shadow = &nrf24->shadow;
+    rt_uint32_t bit = 1UL << reg_addr;
     uint8_t empty_buf[2];
+    uint8_t *param;
+
+    if(nRF24L01_Shadow_Cacheable(reg_addr)){
+        param = nRF24L01_Param_Reg_Ptr(&nrf24->nrf24_cfg, reg_addr);
+        if(param != RT_NULL){
+            *param = (*param & ~param_mask) | (data & param_mask);
+        }
+        if(reg_addr != NRF24REG_RF_CH && (shadow->valid & bit) && (shadow->dirty & bit) == 0 && shadow->reg[reg_addr] == data){
+            shadow->skipped++;
+            return;
+        }
+        shadow->reg[reg_addr] = data;
+        shadow->valid |= bit;
+        shadow->dirty &= ~bit;
+    }
+    shadow->writes++;
 
     empty_buf[0] = NRF24CMD_W_REG | reg_addr;
     empty_buf[1] = data;
@@ -323,8 +510,22 @@ void nRF24L01_Write_Reg_Data(nrf24_t nrf24, uint8_t reg_addr, uint8_t data)
 }
 
 
+/****
+ * @param  reg_addr: 要写的寄存器地址
+ *         data    : 要写的数据
+ * @note   可缓存的寄存器同步更新影子和参数结构体，值与芯片一致时不发 SPI；
+ *         RF_CH 的写入会清零 PLOS_CNT，即使值不变也照常写入
+ * @return NULL
+ */
+void nRF24L01_Write_Reg_Data(nrf24_t nrf24, uint8_t reg_addr, uint8_t data)
+{
+    nRF24L01_Write_Reg_Masked(nrf24, reg_addr, data, 0xFF);
+}
+
+
 /**
  * @brief   Treat the specified continuous bit as a whole and then set its value
+ * @note    影子有效时直接基于影子计算，整个位更新只需一次 SPI 写，值不变时一次都不需要
  */
 void nRF24L01_Write_Reg_Bits(nrf24_t nrf24, uint8_t reg_addr, uint8_t mask, uint8_t value)
 {
@@ -335,18 +536,30 @@ void nRF24L01_Write_Reg_Bits(nrf24_t nrf24, uint8_t reg_addr, uint8_t mask, uint
         if (mask & (1 << tidx))
             break;
     }
-    tmp = ~mask & nRF24L01_Read_Reg_Data(nrf24, reg_addr);
+    if (nRF24L01_Shadow_Cacheable(reg_addr) && (nrf24->shadow.valid & (1UL << reg_addr))){
+        tmp = nrf24->shadow.reg[reg_addr];
+        nrf24->shadow.reads_saved++;
+    }
+    else{
+        tmp = nRF24L01_Read_Reg_Data(nrf24, reg_addr);
+    }
+    tmp &= ~mask;
     tmp |= mask & (value << tidx);
-    nRF24L01_Write_Reg_Data(nrf24, reg_addr, tmp);
+    nRF24L01_Write_Reg_Masked(nrf24, reg_addr, tmp, mask);
 }
 
 /***
  * @brief  用来查看芯片当前状态
+ * @note   芯片在每条指令的第一个字节期间都会移出 STATUS，发送 1 字节 NOP 即可读到
  * @return status
  */
 uint8_t nRF24L01_Read_Status_Register(nrf24_t nrf24)
 {
-    return nRF24L01_Read_Reg_Data(nrf24, NRF24REG_STATUS);
+    uint8_t cmd = NRF24CMD_NOP, status = 0;
+
+    nrf24->nrf24_ops.nrf24_transfer(&nrf24->port_api, &cmd, &status, 1);
+
+    return status;
 }
 
 /***
@@ -380,12 +593,13 @@ rt_uint8_t nRF24L01_Read_IRQ_Status(nrf24_t nrf24)
 
 
 /***
- * @brief   把 OBSERVE_TX 里的丢包计数和重发计数清零
+ * @brief   把 OBSERVE_TX 里的丢包计数清零
+ * @note    OBSERVE_TX 是只读寄存器，PLOS_CNT 只有写 RF_CH 时才清零（原值写回即可）；ARC_CNT 在下一包开始发送时自动清零
  * @return  NULL
  */
 void nRF24L01_Clear_Observe_TX(nrf24_t nrf24)
 {
-    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_OBSERVE_TX, 0);
+    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH, nrf24->nrf24_cfg.rf_ch.rf_ch);
 }
 
 
@@ -395,11 +609,26 @@ void nRF24L01_Clear_Observe_TX(nrf24_t nrf24)
  */
 uint8_t nRF24L01_Read_Top_RXFIFO_Width(nrf24_t nrf24)
 {
-    uint8_t cmd = NRF24CMD_R_RX_PL_WID;
-    uint8_t width_data = 0;
-    nrf24->nrf24_ops.nrf24_send_then_recv(&nrf24->port_api, &cmd, 1, &width_data, 1);
+    return nRF24L01_Read_Top_RXFIFO_Width_Status(nrf24, RT_NULL);
+}
+
+
+/***
+ * @brief   读取 RX FIFO 顶部数据包长度，同时带回指令字节期间移出的 STATUS
+ * @note    STATUS 中的 RX_P_NO 给出顶部数据包的管道号，为 7 时说明 RX FIFO 为空，
+ *          一次片选即可同时得到“是否有数据、哪个管道、多长”
+ */
+uint8_t nRF24L01_Read_Top_RXFIFO_Width_Status(nrf24_t nrf24, uint8_t *status)
+{
+    uint8_t tx_buf[2] = { NRF24CMD_R_RX_PL_WID, NRF24CMD_NOP };
+    uint8_t rx_buf[2] = { 0 };
+
+    nrf24->nrf24_ops.nrf24_transfer(&nrf24->port_api, tx_buf, rx_buf, 2);
+    if(status != RT_NULL){
+        *status = rx_buf[0];
+    }
 
-    return width_data;
+    return rx_buf[1];
 }
 
 
@@ -438,12 +667,12 @@ void nRF24L01_Standby_Set(nrf24_t nrf24, nrf24_standby_et mode)
     if(mode == Standby_one)
     {
         nRF24L01_Enter_Power_Up_Mode(nrf24);
-        nrf24->nrf24_ops.nrf24_reset_ce();
+        nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
     }
     else if(mode == Standby_two)
     {
         nRF24L01_Enter_Power_Up_Mode(nrf24);
-        nrf24->nrf24_ops.nrf24_set_ce();
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
     }
     else if(mode == PowerDown)
     {
@@ -454,14 +683,42 @@ void nRF24L01_Standby_Set(nrf24_t nrf24, nrf24_standby_et mode)
 
 
 
+/***
+ * @brief 把指令字节和数据拼成一帧，一次片选、一次 SPI 传输写入芯片
+ * @note  只用于同步接口和各层自己组的控制报文，拷贝 32 字节的开销远小于 send_then_send 的第二次 HAL 传输；
+ *        发送队列中的描述符由 nRF24L01_Write_Pkt 原地写出，不经过这次拷贝
+ */
+static void nRF24L01_Write_Payload_Cmd(nrf24_t nrf24, uint8_t cmd, const uint8_t *buf, uint8_t len)
+{
+    uint8_t frame[33];
+
+    if (len > 32){
+        len = 32;
+    }
+
+    frame[0] = cmd;
+    rt_memcpy(&frame[1], buf, len);
+    nrf24->nrf24_ops.nrf24_write(&nrf24->port_api, frame, len + 1);
+}
+
+
+/***
+ * @brief 把描述符原地写入芯片 TX FIFO：指令字节放进紧挨在 data 之前的 status，从 status 开始一次 SPI 传输 len + 1 字节
+ * @note  发送描述符的 status 没有别的用途，DMA 直接从描述符取数，不需要栈上的拼帧缓冲
+ */
+static void nRF24L01_Write_Pkt(nrf24_t nrf24, uint8_t cmd, nrf24_pkt_t pkt)
+{
+    pkt->status = cmd;
+    nrf24->nrf24_ops.nrf24_write(&nrf24->port_api, &pkt->status, pkt->len + 1);
+}
+
+
 /***
  * @brief 发送一包数据，若未收到 ACK，会重发（最多 RETR 次）
  */
 void nRF24L01_Write_Tx_Payload_Ack(nrf24_t nrf24, const uint8_t *buf, uint8_t len)
 {
-
-    uint8_t cmd = NRF24CMD_W_TX_PLOAD_ACK;
-    nrf24->nrf24_ops.nrf24_send_then_send(&nrf24->port_api, &cmd, 1, buf, len);
+    nRF24L01_Write_Payload_Cmd(nrf24, NRF24CMD_W_TX_PLOAD_ACK, buf, len);
 }
 
 /***
@@ -469,26 +726,81 @@ void nRF24L01_Write_Tx_Payload_Ack(nrf24_t nrf24, const uint8_t *buf, uint8_t le
  */
 void nRF24L01_Write_Tx_Payload_NoAck(nrf24_t nrf24, const uint8_t *buf, uint8_t len)
 {
-    uint8_t cmd = NRF24CMD_W_TX_PLOAD_NACK;
-    nrf24->nrf24_ops.nrf24_send_then_send(&nrf24->port_api, &cmd, 1, buf, len);
+    nRF24L01_Write_Payload_Cmd(nrf24, NRF24CMD_W_TX_PLOAD_NACK, buf, len);
 }
 
 
 
 /***
- * @brief   把 buf 里的 len 字节写入指定管道 pipe 的 ACK Payload 缓冲区，使芯片在下次收到该管道的数据后，能够随 ACK 帧自动把这段数据回传给发送端
- * @note    ACK Payload 是 NRF24L01的 “带数据应答” 功能，接收端收到数据后，不必切换到发送模式，就能把最多 32 B 的数据随 ACK 帧一起送回发送端
+ * @brief   写入 ACK 载荷并入队记账，tag 为 0 或 NRF24_ACK_FROM_SEND
  */
-void nRF24L01_Write_Tx_Payload_InAck(nrf24_t nrf24, uint8_t pipe, const uint8_t *buf, uint8_t len)
+static int nRF24L01_Write_Ack_Payload(nrf24_t nrf24, uint8_t pipe, const uint8_t *buf, uint8_t len, rt_uint8_t tag)
 {
+    struct nRF24L01_ACK_PIPE *ack;
+    rt_uint8_t pending = 0;
     uint8_t cmd;
 
-    if (pipe > 5){
-        return;
+    if (pipe > 5 || len > 32){
+        return -RT_EINVAL;
+    }
+    for (rt_uint8_t i = 0; i < 6; i++){
+        pending += nRF24L01_Ack_Pending(nrf24, i);
+    }
+    if (pending >= NRF24_HW_TX_FIFO_DEPTH){
+        return -RT_EFULL;
     }
 
     cmd = NRF24CMD_W_ACK_PAYLOAD | pipe;
-    nrf24->nrf24_ops.nrf24_send_then_send(&nrf24->port_api, &cmd, 1, buf, len);
+    nRF24L01_Write_Payload_Cmd(nrf24, cmd, buf, len);
+
+    ack = &nrf24->ack_pipe[pipe];
+    ack->len[ack->put % NRF24_HW_TX_FIFO_DEPTH] = len | tag;
+    ack->put++;
+
+    return RT_EOK;
+}
+
+
+/***
+ * @brief   把 buf 里的 len 字节写入指定管道 pipe 的 ACK Payload 缓冲区，使芯片在下次收到该管道的数据后，能够随 ACK 帧自动把这段数据回传给发送端
+ * @note    ACK Payload 是 NRF24L01的 “带数据应答” 功能，接收端收到数据后，不必切换到发送模式，就能把最多 32 B 的数据随 ACK 帧一起送回发送端；
+ *          芯片 TX FIFO 已被各管道的 ACK 载荷占满时不写入，避免芯片静默丢弃
+ * @return  RT_EOK，或 -RT_EFULL / -RT_EINVAL
+ */
+int nRF24L01_Write_Tx_Payload_InAck(nrf24_t nrf24, uint8_t pipe, const uint8_t *buf, uint8_t len)
+{
+    return nRF24L01_Write_Ack_Payload(nrf24, pipe, buf, len, 0);
+}
+
+
+/***
+ * @brief   管道 pipe 已写入、尚未随应答发出的 ACK 载荷数量
+ */
+rt_uint8_t nRF24L01_Ack_Pending(nrf24_t nrf24, uint8_t pipe)
+{
+    return (rt_uint8_t)(nrf24->ack_pipe[pipe].put - nrf24->ack_pipe[pipe].get);
+}
+
+
+/***
+ * @brief   PRX 在管道 pipe 收到一包，该管道最早写入的 ACK 载荷已随应答发出，出队并计入发送统计
+ * @return  出队的长度字节（最高位为 NRF24_ACK_FROM_SEND），没有待发载荷时返回 0
+ */
+static rt_uint8_t nRF24L01_Ack_Sent(nrf24_t nrf24, uint8_t pipe)
+{
+    struct nRF24L01_ACK_PIPE *ack = &nrf24->ack_pipe[pipe];
+    rt_uint8_t len;
+
+    if (ack->put == ack->get){
+        return 0;
+    }
+    len = ack->len[ack->get % NRF24_HW_TX_FIFO_DEPTH];
+    ack->get++;
+
+    nrf24->stat.tx_packets[pipe]++;
+    nrf24->stat.tx_bytes[pipe] += len & ~NRF24_ACK_FROM_SEND;
+
+    return len;
 }
 
 
@@ -509,6 +821,24 @@ void nRF24L01_Read_Rx_Payload(nrf24_t nrf24, uint8_t *buf, uint8_t len)
 }
 
 
+/***
+ * @brief   一次片选读出 RX FIFO 顶部数据包，供中断服务的快速路径使用
+ * @param   frame 至少 len + 1 字节：frame[0] 为指令字节期间移出的 STATUS，frame[1] 起为数据
+ */
+void nRF24L01_Read_Rx_Frame(nrf24_t nrf24, uint8_t *frame, uint8_t len)
+{
+    uint8_t tx_buf[33];
+
+    if ((len > 32) || (len == 0)){
+        return;
+    }
+
+    rt_memset(tx_buf, NRF24CMD_NOP, len + 1);
+    tx_buf[0] = NRF24CMD_R_RX_PAYLOAD;
+    nrf24->nrf24_ops.nrf24_transfer(&nrf24->port_api, tx_buf, frame, len + 1);
+}
+
+
 /***
  * @brief   立即清空 NRF24L01的 TX FIFO，把里面所有待发数据包全部丢弃
  * @note    TX FIFO 最多可缓存 3 包待发数据
@@ -517,6 +847,10 @@ void nRF24L01_Flush_TX_FIFO(nrf24_t nrf24)
 {
     uint8_t cmd = NRF24CMD_FLUSH_TX;
     nrf24->nrf24_ops.nrf24_write(&nrf24->port_api, &cmd, 1);
+
+    for (rt_uint8_t i = 0; i < 6; i++){
+        nrf24->ack_pipe[i].get = nrf24->ack_pipe[i].put;
+    }
 }
 
 /***
@@ -535,18 +869,18 @@ void nRF24L01_Flush_RX_FIFO(nrf24_t nrf24)
 
 /***
  * @brief 设置nRF24L01的发送地址
- * @note
+ * @note  经由影子写入，地址未变化时不访问 SPI
  */
 void NRF24L01_Set_TxAddr(nrf24_t nrf24, rt_uint8_t *addr_buf, rt_uint8_t length)
 {
     length = ( length > 5 ) ? 5 : length;
 
-    for(rt_uint8_t i = 0; i < 5; i++){
+    for(rt_uint8_t i = 0; i < length; i++){
         nrf24->nrf24_cfg.txaddr[i] = *(addr_buf + i);
     }
 
-    uint8_t tmp = NRF24CMD_R_REG | NRF24REG_TX_ADDR;
-    nrf24->nrf24_ops.nrf24_send_then_send(&nrf24->port_api, &tmp, 1, (uint8_t *)&nrf24->nrf24_cfg.txaddr, 5);
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
 }
 
 
@@ -565,20 +899,304 @@ int nRF24L01_Send_Packet(nrf24_t nrf24, uint8_t *data, uint8_t len, uint8_t pipe
    // 如果是发送端（PTX）
     if (nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX && ack_mode == nRF24_SEND_NEED_ACK){
         nRF24L01_Write_Tx_Payload_Ack(nrf24, data, len);
+        nrf24->tx_queue.sync_len = len;
     }
     else if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX && ack_mode == nRF24_SEND_NO_ACK){
         nRF24L01_Write_Tx_Payload_NoAck(nrf24, data, len);
+        nrf24->tx_queue.sync_len = len;
     }
     // 如果是接收端（PRX）
     else if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX && ack_mode == nRF24_RECE_IN_ACK){
-        nRF24L01_Write_Tx_Payload_InAck(nrf24, pipe, data, len);
-        rt_sem_release(nrf24_send_sem);
+        if (nRF24L01_Write_Ack_Payload(nrf24, pipe, data, len, NRF24_ACK_FROM_SEND) != RT_EOK){
+            return RT_EFULL;
+        }
+        rt_sem_release(&nrf24->send_sem);
     }
 
     return RT_EOK;
 }
 
 
+/***
+ * @brief   初始化软件发送队列
+ */
+void nRF24L01_TxQueue_Init(nrf24_t nrf24)
+{
+    rt_memset(&nrf24->tx_queue, 0, sizeof(struct nRF24L01_TX_QUEUE));
+    rt_memset(nrf24->ack_pipe, 0, sizeof(nrf24->ack_pipe));
+}
+
+
+/***
+ * @brief   队首数据包已完成（成功或失败），让出槽位并把描述符还回池中
+ * @return  该数据包的编号
+ */
+static rt_uint16_t nRF24L01_TxQueue_Retire(struct nRF24L01_TX_QUEUE *q)
+{
+    struct nRF24L01_TX_SLOT *slot = &q->slot[q->done & (NRF24_TXQ_DEPTH - 1)];
+    rt_uint16_t id = slot->id;
+
+    nRF24L01_Pkt_Free(slot->pkt);
+    slot->pkt = RT_NULL;
+    q->done++;
+
+    return id;
+}
+
+
+/***
+ * @brief   非阻塞零拷贝发送：把调用者填好的描述符放入软件发送队列后立即返回，由 nRF24L01_Run 负责写入芯片 TX FIFO
+ * @param   pkt      由 nRF24L01_Pkt_Alloc 取得，data / len 已填好；无论成功与否，调用后描述符都归驱动所有
+ *          ack_mode 仅支持 nRF24_SEND_NEED_ACK / nRF24_SEND_NO_ACK（PTX 模式）
+ * @return  >0 : 数据包编号，发送结果通过 nrf24l01_tx_done 回调按编号上报，之后描述符还回池中
+ *          -RT_EFULL : 软件队列已满
+ *          -RT_EINVAL: 参数错误
+ * @note    可在任意线程中调用；与同步接口 nRF24L01_Send_Packet 混用时，同步数据包的完成事件无法区分编号
+ */
+int nRF24L01_Send_Pkt(nrf24_t nrf24, nrf24_pkt_t pkt, ack_mode_et ack_mode)
+{
+    struct nRF24L01_TX_QUEUE *q = &nrf24->tx_queue;
+    struct nRF24L01_TX_SLOT *slot;
+    rt_uint16_t id;
+    rt_base_t level;
+
+    if (pkt == RT_NULL){
+        return -RT_EINVAL;
+    }
+    if (pkt->len == 0 || pkt->len > 32 || ack_mode == nRF24_RECE_IN_ACK){
+        nRF24L01_Pkt_Free(pkt);
+        return -RT_EINVAL;
+    }
+    pkt->pipe   = NRF24_PIPE_0;
+    pkt->cycles = nRF24L01_Debug_Get_Cycles();
+
+    level = rt_hw_interrupt_disable();
+    if ((rt_uint8_t)(q->put - q->done) >= NRF24_TXQ_DEPTH){
+        rt_hw_interrupt_enable(level);
+        nRF24L01_Pkt_Free(pkt);
+        return -RT_EFULL;
+    }
+
+    if (++q->next_id == NRF24_PACKET_ID_NONE){
+        q->next_id++;
+    }
+    id = q->next_id;
+
+    slot = &q->slot[q->put & (NRF24_TXQ_DEPTH - 1)];
+    slot->id       = id;
+    slot->ack_mode = ack_mode;
+    slot->pkt      = pkt;
+    q->put++;
+    rt_hw_interrupt_enable(level);
+
+    // 唤醒射频线程，把新数据补充到芯片 TX FIFO
+    nRF24L01_Wakeup(nrf24);
+
+    return id;
+}
+
+
+/***
+ * @brief   非阻塞发送：把数据拷贝进一个描述符后交给 nRF24L01_Send_Pkt
+ * @return  同 nRF24L01_Send_Pkt；描述符池耗尽时返回 -RT_EFULL
+ */
+int nRF24L01_Send_Async(nrf24_t nrf24, const uint8_t *data, uint8_t len, ack_mode_et ack_mode)
+{
+    nrf24_pkt_t pkt;
+
+    if (len == 0 || len > 32 || ack_mode == nRF24_RECE_IN_ACK){
+        return -RT_EINVAL;
+    }
+
+    pkt = nRF24L01_Pkt_Alloc(nrf24);
+    if (pkt == RT_NULL){
+        return -RT_EFULL;
+    }
+    pkt->len = len;
+    rt_memcpy(pkt->data, data, len);
+
+    return nRF24L01_Send_Pkt(nrf24, pkt, ack_mode);
+}
+
+
+/***
+ * @brief   把软件队列中的数据包写入芯片 TX FIFO，直到 3 个槽位全部占满
+ * @note    只在射频线程中调用
+ */
+static void nRF24L01_TxQueue_Refill(nrf24_t nrf24)
+{
+    struct nRF24L01_TX_QUEUE *q = &nrf24->tx_queue;
+    struct nRF24L01_TX_SLOT *slot;
+
+    if (nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX || nRF24L01_Turn_Busy(nrf24) || !nRF24L01_Rotate_Tx_Allowed(nrf24) || !nRF24L01_Tdma_Tx_Allowed(nrf24)
+        || !nRF24L01_Link_Tx_Allowed(nrf24) || !nRF24L01_Chan_Tx_Allowed(nrf24)
+        || !nRF24L01_Hop_Tx_Allowed(nrf24)){
+        return;
+    }
+
+    while ((rt_uint8_t)(q->sent - q->done) < NRF24_HW_TX_FIFO_DEPTH && q->sent != q->put)
+    {
+        slot = &q->slot[q->sent & (NRF24_TXQ_DEPTH - 1)];
+        nRF24L01_Write_Pkt(nrf24, (slot->ack_mode == nRF24_SEND_NO_ACK) ? NRF24CMD_W_TX_PLOAD_NACK : NRF24CMD_W_TX_PLOAD_ACK, slot->pkt);
+        q->sent++;
+    }
+}
+
+
+/***
+ * @brief   芯片停发时 TX FIFO 中数据包的准确数量
+ * @note    FIFO_STATUS 只能区分 空 / 满 / 1~2 包，1~2 包时再写入一个探测包，看 FIFO 是否因此变满；
+ *          只在芯片不会再发送时调用（MAX_RT 尚未清除，或 CE 已拉低且当前数据包已完成），调用后必须清空 TX FIFO
+ */
+static rt_uint8_t nRF24L01_TxQueue_Fifo_Count(nrf24_t nrf24)
+{
+    static const uint8_t probe = 0;
+    rt_uint8_t fifo_status = nRF24L01_Read_Reg_Data(nrf24, NRF24REG_FIFO_STATUS);
+
+    if (fifo_status & NRF24BITMASK_TX_EMPTY){
+        return 0;
+    }
+    if (fifo_status & NRF24BITMASK_TX_FULL2){
+        return NRF24_HW_TX_FIFO_DEPTH;
+    }
+    nRF24L01_Write_Payload_Cmd(nrf24, NRF24CMD_W_TX_PLOAD_NACK, &probe, 1);
+    fifo_status = nRF24L01_Read_Reg_Data(nrf24, NRF24REG_FIFO_STATUS);
+
+    return (fifo_status & NRF24BITMASK_TX_FULL2) ? 2 : 1;
+}
+
+
+/***
+ * @brief   按写入顺序上报 count 个发送成功的数据包，发送统计在此时计入，重新写入的数据包不会重复计数
+ */
+static void nRF24L01_TxQueue_Report(nrf24_t nrf24, rt_uint8_t count, rt_uint8_t pipe)
+{
+    struct nRF24L01_TX_QUEUE *q = &nrf24->tx_queue;
+    rt_uint16_t id;
+
+    while (count-- > 0)
+    {
+        nrf24->stat.tx_packets[NRF24_PIPE_0]++;
+        nrf24->stat.tx_bytes[NRF24_PIPE_0] += q->slot[q->done & (NRF24_TXQ_DEPTH - 1)].pkt->len;
+        id = nRF24L01_TxQueue_Retire(q);
+        if (nrf24->nrf24_cb.nrf24l01_tx_done){
+            nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, pipe, id);
+        }
+    }
+}
+
+
+/***
+ * @brief   根据 TX_DS / MAX_RT 标志和 TX FIFO 的剩余量，按顺序上报已完成的数据包
+ * @note    多个数据包的 TX_DS 可能在一次读取 STATUS 前合并为一个标志，只能用 FIFO 剩余量反推完成数量；
+ *          TX_DS : 芯片仍在发送，FIFO 剩 1~2 包时无法区分，按 2 包计，只上报一定已完成的数据包，
+ *                  少报的在之后的 TX_DS、MAX_RT 或 nRF24L01_TxQueue_Rewind 时补上
+ *          MAX_RT: 调用时 MAX_RT 尚未清除，芯片停发，FIFO 中的数据包数准确可得：
+ *                  之前的数据包全部成功，FIFO 队首的数据包失败，其后的数据包清空后由 nRF24L01_TxQueue_Refill 重新写入
+ */
+static void nRF24L01_TxQueue_Complete(nrf24_t nrf24, rt_uint8_t irq_flags, rt_uint8_t pipe)
+{
+    struct nRF24L01_TX_QUEUE *q = &nrf24->tx_queue;
+    rt_uint8_t inflight = (rt_uint8_t)(q->sent - q->done);
+    rt_uint8_t remaining, fifo_status;
+    rt_uint16_t id;
+
+    // 1. 同步接口写入的数据包，没有编号
+    if (inflight == 0){
+        if (irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+            if (nrf24->nrf24_cb.nrf24l01_tx_done){
+                nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, NRF24_PIPE_NONE, NRF24_PACKET_ID_NONE);
+            }
+        }
+        else{
+            nrf24->stat.tx_packets[NRF24_PIPE_0]++;
+            nrf24->stat.tx_bytes[NRF24_PIPE_0] += q->sync_len;
+            if (nrf24->nrf24_cb.nrf24l01_tx_done){
+                nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, pipe, NRF24_PACKET_ID_NONE);
+            }
+        }
+        return;
+    }
+
+    // 2. 达到最大重发次数：FIFO 中剩余的数据包里只有队首真正发过，之前写入的全部成功
+    if (irq_flags & NRF24BITMASK_MAX_RT){
+        remaining = nRF24L01_TxQueue_Fifo_Count(nrf24);
+        nRF24L01_Flush_TX_FIFO(nrf24);
+        if (remaining > inflight){
+            remaining = inflight;
+        }
+        nRF24L01_TxQueue_Report(nrf24, inflight - remaining, pipe);
+
+        id = NRF24_PACKET_ID_NONE;
+        if (remaining > 0){
+            id = nRF24L01_TxQueue_Retire(q);
+        }
+        q->sent = q->done;
+        if (nrf24->nrf24_cb.nrf24l01_tx_done){
+            nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, NRF24_PIPE_NONE, id);
+        }
+        return;
+    }
+
+    // 3. 发送成功：由 FIFO_STATUS 得到仍留在芯片 TX FIFO 中的数据包数量的上限
+    fifo_status = nRF24L01_Read_Reg_Data(nrf24, NRF24REG_FIFO_STATUS);
+    if (fifo_status & NRF24BITMASK_TX_EMPTY){
+        remaining = 0;
+    }
+    else if (fifo_status & NRF24BITMASK_TX_FULL2){
+        remaining = NRF24_HW_TX_FIFO_DEPTH;
+    }
+    else{
+        remaining = 2;
+    }
+    if (remaining > inflight){
+        remaining = inflight;
+    }
+    nRF24L01_TxQueue_Report(nrf24, inflight - remaining, pipe);
+}
+
+
+/***
+ * @brief   放弃已写入芯片 TX FIFO 但还没有发送的数据包，它们留在软件队列中，由 nRF24L01_TxQueue_Refill 重新写入
+ * @note    只在射频线程中调用，调用前应已处理完挂起的 TX_DS / MAX_RT，并且 CE 已拉低、当前数据包已完成；
+ *          已离开 FIFO 但还没上报的数据包先按成功上报，不会被重发
+ */
+void nRF24L01_TxQueue_Rewind(nrf24_t nrf24)
+{
+    struct nRF24L01_TX_QUEUE *q = &nrf24->tx_queue;
+    rt_uint8_t inflight = (rt_uint8_t)(q->sent - q->done);
+    rt_uint8_t remaining;
+
+    if (inflight > 0){
+        remaining = nRF24L01_TxQueue_Fifo_Count(nrf24);
+        if (remaining < inflight){
+            nRF24L01_TxQueue_Report(nrf24, inflight - remaining, NRF24_PIPE_0);
+        }
+    }
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    q->sent = q->done;
+}
+
+
+/***
+ * @brief   一包 Enhanced ShockBurst 的空中时间(us)：前导 1 字节 + 地址 + 9 位包控制字段 + 载荷 + CRC
+ */
+rt_uint32_t nRF24L01_Air_Us(nrf24_param_t cfg, rt_uint8_t payload_len)
+{
+    rt_uint32_t bits = 8 * (1 + (cfg->setup_aw.aw + 2) + payload_len + (cfg->config.crco + 1)) + 9;
+
+    if(cfg->rf_setup.rf_dr_low){
+        return bits * 4;
+    }
+    if(cfg->rf_setup.rf_dr_high){
+        return (bits + 1) / 2;
+    }
+    return bits;
+}
+
+
+
 
 /**
  * @brief  把用户数据写到 TX FIFO（PTX 模式）或 ACK Payload 缓冲区（PRX 模式），并立即触发发送或等待对方读取
@@ -636,84 +1254,420 @@ void nRF24L01_Ensure_RWW_Features_Activated(nrf24_t nrf24)
 
 
 /***
- * @brief
- * @note
+ * @brief   读出 RX FIFO 中的全部数据包，直到 STATUS.RX_P_NO 为 7（RX FIFO 为空）
+ * @note    RX FIFO 最多缓存 3 包，一次 RX_DR 中断可能对应多包数据，只读一包会让其余数据滞留直至溢出丢包
+ *          每包只需两次片选：R_RX_PL_WID 同时带回 STATUS（管道号/是否为空）和长度，R_RX_PAYLOAD 读出数据
+ *          数据直接读进描述符池中的描述符，之后只传递指针；池耗尽时读进栈上的备用描述符，
+ *          控制报文照常交给各层，应用数据丢弃并计入池的 exhausted
+ * @return  本次读出的数据包数量
+ */
+static int nRF24L01_Drain_RX_FIFO(nrf24_t nrf24)
+{
+    int count = 0;
+    uint8_t status, pipe, length, flags = 0;
+    rt_bool_t layered;
+    rt_uint8_t ack_sent;
+    nrf24_pkt_t pkt;
+    struct nRF24L01_PKT_STRUCT spare;
+
+#if NRF24_PKT_READ_RPD
+    // RPD 在每包收完时更新，读空前读一次，这一批包都按其中最近收到的一包标记
+    if(nRF24L01_Read_Reg_Data(nrf24, NRF24REG_RPD) & 0x01){
+        flags = NRF24_PKT_FLAG_RPD;
+    }
+#endif
+
+    for(;;)
+    {
+        // 1. 每读出一包，STATUS 中的 RX_P_NO 都会更新为下一包所属的管道，为 7 时 RX FIFO 已空
+        length = nRF24L01_Read_Top_RXFIFO_Width_Status(nrf24, &status);
+        pipe = (status & NRF24BITMASK_RX_P_NO) >> 1;
+        if(pipe > NRF24_PIPE_5){
+            break;
+        }
+
+        // 2. 长度大于 32 说明数据包已损坏，按手册要求清空 RX FIFO
+        if(length == 0 || length > 32){
+            nRF24L01_Flush_RX_FIFO(nrf24);
+            nrf24->stat.rx_corrupt++;
+            break;
+        }
+
+        // 3. SPI 移出的 STATUS 落在 pkt->status，载荷直接落在 pkt->data
+        pkt = nRF24L01_Pkt_Alloc(nrf24);
+        if(pkt == RT_NULL){
+            pkt = &spare;
+        }
+        nRF24L01_Read_Rx_Frame(nrf24, &pkt->status, length);
+        pkt->len    = length;
+        pkt->pipe   = pipe;
+        pkt->flags  = flags;
+        pkt->cycles = nRF24L01_Debug_Get_Cycles();
+        nrf24->stat.rx_packets[pipe]++;
+        nrf24->stat.rx_bytes[pipe] += length;
+
+        // PRX 的应答在这包收到时已经发出，该管道最早写入的 ACK 载荷随它离开芯片，先出队，各层据此写入新的 ACK 载荷
+        ack_sent = (nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX) ? nRF24L01_Ack_Sent(nrf24, pipe) : 0;
+
+        // 4. 切换引擎报文、全双工报文、可靠传输报文、分片分别交给对应的层
+        layered = nRF24L01_Link_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Chan_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Hop_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Tdma_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Rotate_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Turn_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Duplex_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_ARQ_Input(nrf24, pkt->data, length, pipe) != 0 ||
+                  nRF24L01_Frag_Input(nrf24, pkt->data, length, pipe) != 0;
+        count++;
+
+        // 5. 被某一层消费的报文到此为止，描述符直接归还；
+        //    星型中心模式下其余数据连同描述符进入该管道的接收队列，解码和交付由中心线程按 DRR 调度执行；
+        //    否则送入该管道的解码器，PTX 收到的 ACK 载荷同样按帧解析，再把描述符交给应用
+        if(pkt != &spare)
+        {
+            if(layered != 0){
+                nRF24L01_Pkt_Free(pkt);
+            }else if(nRF24L01_Hub_Input(nrf24, pkt) == 0){
+                nrf24l01_decoder_feed(&nrf24->decoder[pipe], pkt->data, length, nrf24l01_protocol_handler, nrf24);
+                nRF24L01_Pkt_Deliver(nrf24, pkt);
+            }
+        }
+
+        // 6. 随本包的应答发出的 ACK 载荷是同步接口写入的，上报发送完成
+        if((ack_sent & NRF24_ACK_FROM_SEND) && rt_sem_trytake(&nrf24->send_sem) ==  RT_EOK){
+            if(nrf24->nrf24_cb.nrf24l01_tx_done){
+                nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, pipe, NRF24_PACKET_ID_NONE);
+            }
+        }
+    }
+
+    // 一次读出的包数达到 RX FIFO 深度，说明读取前 RX FIFO 已满，期间到达的包被芯片丢弃
+    if(count >= NRF24_HW_RX_FIFO_DEPTH){
+        nrf24->stat.rx_fifo_full++;
+    }
+
+    return count;
+}
+
+
+
+/***
+ * @brief   取两个等待超时中较短的一个，RT_WAITING_FOREVER 表示不需要超时
+ */
+static rt_int32_t nRF24L01_Min_Timeout(rt_int32_t a, rt_int32_t b)
+{
+    if(a == RT_WAITING_FOREVER){
+        return b;
+    }
+    if(b == RT_WAITING_FOREVER){
+        return a;
+    }
+    return (a < b) ? a : b;
+}
+
+
+/***
+ * @brief   nRF24L01 的事件服务函数，由 IRQ 信号量驱动
+ * @note    每次唤醒都会循环处理，直到 STATUS 中不再有 RX_DR/TX_DS/MAX_RT 挂起且 RX FIFO 已读空，
+ *          IRQ 引脚为下降沿触发，只要还有标志位未清除，引脚就保持低电平而不会产生新的下降沿
+ * @return  1->发送完成  2->接收完成  -1->达到最大重发次数
  */
 int nRF24L01_Run(nrf24_t nrf24)
 {
-    /* ret_flag: 1->发送完成  2->接收完成 */
+    /* ret_flag: 1->发送完成  2->接收完成  4->发送失败 */
     rt_uint8_t ret_flag = 0;
+    rt_uint8_t irq_flags;
 
     // 1. 如果使用IRQ中断，则获取信号量等待释放
     if(nrf24->nrf24_flags.using_irq == RT_TRUE){
-        rt_sem_take(nrf24_irq_sem, RT_WAITING_FOREVER);
-    }
-
-    // 2. 读取status状态标志，并清除中断触发标志位
-     nrf24->nrf24_flags.status = nRF24L01_Read_Status_Register(nrf24);
-     nRF24L01_Clear_Status_Register(nrf24, NRF24BITMASK_RX_DR | NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT);
-
-     // 3. 分析哪条信道接收的数据
-     uint8_t pipe = (nrf24->nrf24_flags.status & NRF24BITMASK_RX_P_NO) >> 1;
-
-     // 4. 角色 = 发送端（PTX）
-     if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX)
-     {
-         // 4.1 读取status寄存器的 NRF24BITMASK_MAX_RT位，如果为1，说明达到最大重发次数，发送失败
-         if(nrf24->nrf24_flags.status & NRF24BITMASK_MAX_RT){
-             nRF24L01_Flush_TX_FIFO(nrf24);
-             nRF24L01_Clear_Status_Register(nrf24, NRF24BITMASK_MAX_RT);
-             if(nrf24->nrf24_cb.nrf24l01_tx_done){
-                 nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, NRF24_PIPE_NONE);
-             }
-             return -1;
-         }
-
-         /* 4.2 收到 ACK 带载荷（PTX 也能收） */
-         if(nrf24->nrf24_flags.status & NRF24BITMASK_RX_DR){
-             uint8_t rec_data[32];
-             uint8_t len = nRF24L01_Read_Top_RXFIFO_Width(nrf24);
-             nRF24L01_Read_Rx_Payload(nrf24, rec_data, len);
-             if(nrf24->nrf24_cb.nrf24l01_rx_ind){
-                 nrf24->nrf24_cb.nrf24l01_rx_ind(nrf24, rec_data, len, pipe);
-             }
-             ret_flag |= 2;
-         }
-
-
-         /* 4.3 发送完成 */
-         if(nrf24->nrf24_flags.status & NRF24BITMASK_TX_DS){
-             if(nrf24->nrf24_cb.nrf24l01_tx_done){
-                 nrf24->nrf24_cb.nrf24l01_tx_done(nrf24, pipe);
-             }
-             ret_flag |= 1;
-         }
-     }
-
-
-     // 5. 角色 = 接收端（PRX）
-     if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX)
-     {
-         if(pipe < 5){
-             uint8_t data_buf[32];
-             uint8_t length = nRF24L01_Read_Top_RXFIFO_Width(nrf24);
-             nRF24L01_Read_Rx_Payload(nrf24, data_buf, length);
-             if(nrf24->nrf24_cb.nrf24l01_rx_ind){
-                 nrf24->nrf24_cb.nrf24l01_rx_ind(nrf24, data_buf, length, pipe);
-             }
-             ret_flag |= 2;
-
-             if(rt_sem_trytake(nrf24_send_sem) ==  RT_EOK){
-                 if(nrf24->nrf24_cb.nrf24l01_tx_done){
-                     nrf24->nrf24_cb.nrf24l01_tx_done(nrf24,pipe);
-                 }
-                 ret_flag |= 1;
-             }
-         }
-     }
-     return ret_flag;
+        /* 可靠传输层 / 全双工链路有在途报文、切换引擎没有硬件定时器而在等待应答、轮换 / TDMA 节点在等下一次同步、或链路自适应 / 信道切换 / 跳频在等切换时刻时带超时等待，超时后进入循环检查 */
+        rt_int32_t timeout = nRF24L01_Min_Timeout(nRF24L01_ARQ_Next_Timeout(nrf24), nRF24L01_Turn_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Rotate_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Tdma_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Link_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Chan_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Hop_Next_Timeout(nrf24));
+        timeout = nRF24L01_Min_Timeout(timeout, nRF24L01_Duplex_Next_Timeout(nrf24));
+        rt_sem_take(&nrf24->irq_sem, timeout);
+    }
+
+    for(;;)
+    {
+        // 2. 推进收发切换引擎、地址轮换、TDMA、链路自适应、信道勘测和跳频；全双工链路和可靠传输层的发送 / 重传放入软件发送队列，再把软件发送队列中的数据补充到芯片 TX FIFO
+        nRF24L01_Turn_Service(nrf24);
+        nRF24L01_Rotate_Service(nrf24);
+        nRF24L01_Tdma_Service(nrf24);
+        nRF24L01_Link_Service(nrf24);
+        nRF24L01_Chan_Service(nrf24);
+        nRF24L01_Hop_Service(nrf24);
+        nRF24L01_Dev_Service(nrf24);
+        nRF24L01_Duplex_Service(nrf24);
+        nRF24L01_ARQ_Service(nrf24);
+        nRF24L01_TxQueue_Refill(nrf24);
+
+        // 3. 读取status状态标志，没有挂起的中断标志则本次唤醒处理完毕
+        nrf24->nrf24_flags.status = nRF24L01_Read_Status_Register(nrf24);
+        irq_flags = nrf24->nrf24_flags.status & (NRF24BITMASK_RX_DR | NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT);
+        if(irq_flags == 0){
+            break;
+        }
+
+        // 4. 只清除本次读到的标志位，处理期间新产生的事件留到下一轮循环
+        //    MAX_RT 留到发送事件处理完再清除：清除前芯片停发，TX FIFO 不变，发送队列据此准确计数
+        nRF24L01_Clear_Status_Register(nrf24, irq_flags & ~NRF24BITMASK_MAX_RT);
+        nRF24L01_Debug_Record_Latency(nrf24);
+
+        // 5. 角色 = 发送端（PTX）：TX_DS 为发送完成，MAX_RT 为达到最大重发次数、发送失败
+        if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX)
+        {
+            // 同一次中断只读一次 OBSERVE_TX，ARC_CNT 为刚完成的一包的重发次数
+            if(irq_flags & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT)){
+                nrf24->nrf24_flags.observe_tx = nRF24L01_Read_Reg_Data(nrf24, NRF24REG_OBSERVE_TX);
+                if(irq_flags & NRF24BITMASK_MAX_RT){
+                    nrf24->stat.max_rt++;
+                }
+                else{
+                    nrf24->stat.arc_hist[nrf24->nrf24_flags.observe_tx & NRF24BITMASK_ARC_CNT]++;
+                }
+                if(irq_flags & NRF24BITMASK_TX_DS){
+                    nrf24->stat.tx_ds++;
+                }
+            }
+            if((irq_flags & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT)) 
+               && nRF24L01_Link_Tx_Event(nrf24, irq_flags) == 0 && nRF24L01_Chan_Tx_Event(nrf24, irq_flags) == 0
+               && nRF24L01_Hop_Tx_Event(nrf24, irq_flags) == 0
+               && nRF24L01_Turn_Tx_Event(nrf24, irq_flags) == 0 && nRF24L01_Rotate_Tx_Event(nrf24, irq_flags) == 0
+               && nRF24L01_Tdma_Tx_Event(nrf24, irq_flags) == 0){
+                nRF24L01_TxQueue_Complete(nrf24, irq_flags, (nrf24->nrf24_flags.status & NRF24BITMASK_RX_P_NO) >> 1);
+            }
+            if(irq_flags & NRF24BITMASK_MAX_RT){
+                ret_flag |= 4;
+            }
+            if(irq_flags & NRF24BITMASK_TX_DS){
+                ret_flag |= 1;
+            }
+        }
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Clear_Status_Register(nrf24, NRF24BITMASK_MAX_RT);
+        }
+
+        // 6. 收到数据（PRX 的数据包，或 PTX 收到的 ACK 带载荷），把 RX FIFO 读空
+        if(irq_flags & NRF24BITMASK_RX_DR){
+            if(nRF24L01_Drain_RX_FIFO(nrf24) > 0){
+                ret_flag |= 2;
+            }
+        }
+    }
+
+    if(ret_flag & 4){
+        return -1;
+    }
+    return ret_flag;
 }
 
 
 
+/* 已初始化的实例链表，以及 msh 命令操作的实例 */
+static nrf24_t nrf24_list = RT_NULL;
+nrf24_t _nrf24 = RT_NULL;
+
+/***
+ * @brief   初始化一个 nRF24L01 实例（静态分配，不访问硬件）
+ * @param   nrf24 调用者提供的实例内存，通常是静态变量
+ *          name  实例名，同时作为两个信号量的名字
+ *          hw    这片 nRF24L01 的 SPI 总线和 CE / CSN / IRQ 引脚
+ *          cb    事件回调，内容会被拷贝
+ *          role  上电后的角色
+ * @note    只做软件初始化：信号量、描述符池、发送队列、解码器和各协议层；硬件由 nRF24L01_Start 在射频线程中启动
+ */
+int nRF24L01_Init(nrf24_t nrf24, const char *name, const struct nRF24L01_HW_CFG *hw,
+                  const struct nrf24_callback *cb, nrf24_role_et role)
+{
+    rt_base_t level;
+
+    RT_ASSERT(nrf24 != RT_NULL && name != RT_NULL && hw != RT_NULL);
+
+    /* 第一个实例打开 DWT，之后不能再清零周期计数 */
+    if(nrf24_list == RT_NULL){
+        nRF24L01_Debug_Init();
+    }
+
+    rt_memset(nrf24, 0, sizeof(struct nRF24L01_STRUCT));
+    nrf24->name = name;
+    nrf24->port_api.hw = hw;
+    rt_sem_init(&nrf24->irq_sem, name, 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&nrf24->send_sem, name, 0, RT_IPC_FLAG_FIFO);
+    nrf24->nrf24_flags.using_irq = RT_TRUE;
+
+#if NRF24_USE_SIMULATOR
+    nrf24->nrf24_ops = g_nrf24_sim_ops;
+#else
+    nrf24->nrf24_ops = g_nrf24_func_ops;
+#endif
+    if(cb != RT_NULL){
+        nrf24->nrf24_cb = *cb;
+    }
+    nRF24L01_Shadow_Invalidate(nrf24);
+    nRF24L01_Pkt_Init(nrf24);
+    nRF24L01_TxQueue_Init(nrf24);
+    for(rt_uint8_t i = 0; i < 6; i++){
+        nrf24l01_decoder_init(&nrf24->decoder[i]);
+    }
+    nRF24L01_Frag_Init(nrf24);
+    nRF24L01_ARQ_Init(nrf24);
+    nRF24L01_Turn_Init(nrf24);
+    nRF24L01_Hub_Init(nrf24);
+    nRF24L01_Tdma_Init(nrf24);
+    nRF24L01_Link_Init(nrf24);
+    nRF24L01_Chan_Init(nrf24);
+    nRF24L01_Hop_Init(nrf24);
+    nRF24L01_Stat_Init(nrf24);
+    nRF24L01_Debug_Reset_Latency(nrf24);
+
+    if(nRF24L01_Param_Config(&nrf24->nrf24_cfg) != RT_EOK){
+        LOG_E("LOG:%d. %s parameter config error.",Record.ulog_cnt++, name);
+        return RT_ERROR;
+    }
+    nrf24->nrf24_cfg.config.prim_rx = role;
+    /* 地址轮换按角色决定是中心还是节点，节点还要改发送地址，放在参数初始化之后 */
+    nRF24L01_Rotate_Init(nrf24);
+
+    /* 挂到实例链表尾，第一个实例同时作为 msh 命令的缺省实例 */
+    level = rt_hw_interrupt_disable();
+    if(nrf24_list == RT_NULL){
+        nrf24_list = nrf24;
+        _nrf24 = nrf24;
+    }
+    else{
+        nrf24_t last = nrf24_list;
+        while(last->next != RT_NULL){
+            last = last->next;
+        }
+        last->next = nrf24;
+    }
+    rt_hw_interrupt_enable(level);
 
+    if(nRF24L01_Dev_Register(nrf24) != RT_EOK){
+        LOG_W("LOG:%d. %s device register failed.",Record.ulog_cnt++, name);
+    }
+
+    LOG_I("LOG:%d. %s initialized on %s.",Record.ulog_cnt++, name, hw->spi_bus);
+    return RT_EOK;
+}
+
+
+/***
+ * @brief   启动 nRF24L01 硬件：挂载 SPI、配置 IRQ、协商 SPI 时钟、写入全部寄存器并上电，最后拉高 CE
+ * @note    需要 SPI 收发，只能在线程中调用，一般作为该实例射频线程的第一步
+ */
+int nRF24L01_Start(nrf24_t nrf24)
+{
+    int result = RT_EOK;
+
+    // 1. 初始化SPI（使用软件模型时初始化虚拟空口），配置中断引脚
+#if NRF24_USE_SIMULATOR
+    if(nRF24L01_Sim_Init(nrf24) != RT_EOK){
+        return RT_ERROR;
+    }
+#else
+    if(nRF24L01_SPI_Init(&nrf24->port_api) != RT_EOK){
+        return RT_ERROR;
+    }
+    if(nRF24L01_IQR_GPIO_Config(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s irq config error.",Record.ulog_cnt++, nrf24->name);
+    }
+#endif
+
+    // 2. 通过回环通信，检测SPI硬件链路是否有误，并协商可靠的最高SPI时钟
+    if(nRF24L01_SPI_Negotiate_Speed(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s check spi hardware false.",Record.ulog_cnt++, nrf24->name);
+        result = RT_ERROR;
+    }
+
+    // 3. 拉低CE，先进入掉电模式，解锁高级扩展功能
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Enter_Power_Down_Mode(nrf24);
+    nRF24L01_Ensure_RWW_Features_Activated(nrf24);
+
+    // 4. 更新寄存器参数并设置角色，再读回
+    if(nRF24L01_Update_Parameter(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s update_onchip_config false.",Record.ulog_cnt++, nrf24->name);
+        result = RT_ERROR;
+    }
+    else{
+        nRF24L01_Set_Role_Mode(nrf24, (nrf24_role_et)nrf24->nrf24_cfg.config.prim_rx);
+    }
+    if(nRF24L01_Read_Onchip_Parameter(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s read parameter false.",Record.ulog_cnt++, nrf24->name);
+        result = RT_ERROR;
+    }
+
+    // 5. 清空"发送/接收"队列、中断标志、重发计数和丢包计数
+    nRF24L01_Flush_RX_FIFO(nrf24);
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    nRF24L01_Clear_IRQ_Flags(nrf24);
+    nRF24L01_Clear_Observe_TX(nrf24);
+
+    // 6. 配置完成，进入上电模式，拉高CE引脚
+    nRF24L01_Enter_Power_Up_Mode(nrf24);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    LOG_I("LOG:%d. %s started as %s.",Record.ulog_cnt++, nrf24->name,
+          (nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX) ? "PTX" : "PRX");
+    return result;
+}
+
+
+/***
+ * @brief   按名字查找已初始化的实例
+ * @return  RT_NULL 表示没有这个实例
+ */
+nrf24_t nRF24L01_Find(const char *name)
+{
+    for(nrf24_t nrf24 = nrf24_list; nrf24 != RT_NULL; nrf24 = nrf24->next){
+        if(rt_strcmp(nrf24->name, name) == 0){
+            return nrf24;
+        }
+    }
+    return RT_NULL;
+}
+
+
+/***
+ * @brief   唤醒实例的射频线程，让它处理 IRQ、定时器到期或各层的请求
+ * @note    可在任意线程或中断中调用
+ */
+void nRF24L01_Wakeup(nrf24_t nrf24)
+{
+    rt_sem_release(&nrf24->irq_sem);
+}
+
+
+
+/***
+ * @brief msh 命令：列出 nRF24L01 实例，或选择其它 nrf24_xxx 命令操作的实例
+ * @note  nrf24_dev         列出全部实例，* 为当前实例
+ *        nrf24_dev <name>  切换当前实例
+ */
+static void nrf24_dev_cmd(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        nrf24_t nrf24 = nRF24L01_Find(argv[1]);
+        if (nrf24 == RT_NULL){
+            rt_kprintf("[nrf24] no instance named %s.\r\n", argv[1]);
+            return;
+        }
+        _nrf24 = nrf24;
+    }
+
+    rt_kprintf("  name      role  spi        clock(Hz)  irq pin\r\n");
+    for (nrf24_t nrf24 = nrf24_list; nrf24 != RT_NULL; nrf24 = nrf24->next)
+    {
+        rt_kprintf("%c %-8s  %s   %-9s  %-9d  %d\r\n", (nrf24 == _nrf24) ? '*' : ' ', nrf24->name,
+                   (nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX) ? "PTX" : "PRX",
+                   nrf24->port_api.hw->spi_bus, nrf24->port_api.spi_hz, nrf24->port_api.hw->irq_pin);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_dev_cmd, nrf24_dev, list nrf24 instances or select one [name]);
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-29     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_DUPLEX_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_DUPLEX_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 双射频全双工链路
+ * 每块板子两片 nRF24L01：一片固定为 PTX 只发，一片固定为 PRX 只收，两个方向各占一个信道，同时收发，没有收发切换；
+ * 空口上的包全部以 NO_ACK 发出，PTX 发完一包不再等自动应答，省掉每包的收发切换和 ACK 时间；
+ * 可靠性由本层负责：每个方向一个滑动窗口，本方向的确认捎带在反方向的数据包头里，反方向没有数据时才发纯 ACK
+ *
+ * NRF24_USE_DUPLEX        : 1 -> 双射频时两片组成全双工链路（需要 NRF24_USE_DUAL_RADIO）
+ * NRF24_DUPLEX_CH_A / B   : 两个方向的信道，两片射频在同一块板上，相隔越远越不容易互相阻塞
+ * NRF24_DUPLEX_SIDE       : 0 -> 本机在 A 上发、B 上收；1 -> 反之，链路两端必须相反
+ * NRF24_DUPLEX_WINDOW     : 发送 / 接收窗口，2 的幂且不超过 16
+ * NRF24_DUPLEX_RTO_MS     : 重传超时，超时后加倍，收到新的确认后恢复
+ * NRF24_DUPLEX_RTO_MAX_MS : 重传超时上限
+ */
+#define NRF24_USE_DUPLEX            0
+#define NRF24_DUPLEX_CH_A           20
+#define NRF24_DUPLEX_CH_B           100
+#define NRF24_DUPLEX_SIDE           0
+#define NRF24_DUPLEX_WINDOW         16
+#define NRF24_DUPLEX_RTO_MS         20
+#define NRF24_DUPLEX_RTO_MAX_MS     500
+
+#if (NRF24_DUPLEX_WINDOW > 16) || (NRF24_DUPLEX_WINDOW & (NRF24_DUPLEX_WINDOW - 1))
+#error "NRF24_DUPLEX_WINDOW must be a power of 2 not greater than 16"
+#endif
+
+
+/***
+ * 全双工报文头（4 字节）
+ * byte0 : 高 4 位 = 0101 全双工标记（协议帧的 0x55 类型号不合法，不会被当作本层报文）  低 4 位 报文类型
+ * byte1 : DATA 为序号，ACK 无意义
+ * byte2 : 捎带的累计确认号（本机期望收到的下一个序号）
+ * byte3 : 选择确认位图，bit i 置位表示序号 (累计确认号 + 1 + i) 已收到
+ *
+ * DATA : 头 + 1 ~ 28 字节数据
+ * ACK  : 只有报文头，反方向没有数据可捎带时发出
+ */
+#define NRF24_DUPLEX_MARK           0x50
+#define NRF24_DUPLEX_MARK_MASK      0xF0
+#define NRF24_DUPLEX_DATA           0x00
+#define NRF24_DUPLEX_ACK            0x01
+#define NRF24_DUPLEX_HEADER_SIZE    4
+#define NRF24_DUPLEX_PAYLOAD_SIZE   (32 - NRF24_DUPLEX_HEADER_SIZE)
+
+
+/***
+ * 发送窗口中报文的状态
+ */
+typedef enum
+{
+    DUPLEX_SEG_FREE = 0,
+    DUPLEX_SEG_QUEUED,          // 等待发送 / 重传
+    DUPLEX_SEG_INFLIGHT,        // 已发送，等待确认
+    DUPLEX_SEG_ACKED,           // 已被选择确认，等待窗口滑过
+}duplex_seg_state_et;
+
+
+struct nRF24L01_DUPLEX_SEG
+{
+    rt_uint8_t  state;
+    rt_uint8_t  len;
+    /* 最近一次发送的顺序号，确认中出现更晚发出的报文时，更早发出且未确认的报文即判定丢失 */
+    rt_uint16_t order;
+    rt_tick_t   sent_tick;
+    rt_uint8_t  data[NRF24_DUPLEX_PAYLOAD_SIZE];
+};
+
+
+/***
+ * 收到的按序数据，运行在 PRX 一片的射频线程中，返回后数据即失效
+ */
+struct nRF24L01_DUPLEX_STRUCT;
+typedef void (*nrf24_duplex_rx_t)(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len);
+
+
+/***
+ * 全双工链路，由两个 nRF24L01 实例共用
+ * 发送窗口由 PTX 一片的射频线程发送 / 重传，由 PRX 一片的射频线程按捎带的确认释放；
+ * 接收窗口只由 PRX 一片的射频线程更新，要捎带的确认（ack_cum / ack_sack）在锁内整体更新，PTX 一片整体读出
+ */
+struct nRF24L01_DUPLEX_STRUCT
+{
+    struct nRF24L01_STRUCT *tx;
+    struct nRF24L01_STRUCT *rx;
+    nrf24_duplex_rx_t rx_ind;
+
+    /* 发送方向 */
+    struct nRF24L01_DUPLEX_SEG seg[NRF24_DUPLEX_WINDOW];
+    rt_uint8_t  snd_una;            // 最早未确认的序号
+    volatile rt_uint8_t snd_nxt;    // 下一个分配的序号
+    rt_uint16_t order;
+    rt_int32_t  rto;
+
+    /* 接收方向 */
+    rt_uint8_t  rcv_nxt;
+    /* bit i 置位表示序号 rcv_nxt + i 已缓存 */
+    rt_uint32_t bitmap;
+    rt_uint8_t  len[NRF24_DUPLEX_WINDOW];
+    rt_uint8_t  data[NRF24_DUPLEX_WINDOW][NRF24_DUPLEX_PAYLOAD_SIZE];
+    rt_uint8_t  ack_cum;
+    rt_uint8_t  ack_sack;
+    volatile rt_uint8_t ack_pending;
+
+    /* 统计计数 */
+    rt_uint32_t tx_segments;        // 首次发送的报文
+    rt_uint32_t tx_acked_bytes;     // 已确认的数据字节
+    rt_uint32_t retransmits;        // 由选择确认判定丢失后的重传
+    rt_uint32_t timeouts;           // 重传超时
+    rt_uint32_t acks_piggybacked;   // 捎带在 DATA 中的确认
+    rt_uint32_t acks_pure;          // 纯 ACK
+    rt_uint32_t rx_delivered;       // 按序交付的报文
+    rt_uint32_t rx_bytes;           // 按序交付的字节
+    rt_uint32_t rx_duplicates;      // 重复的报文
+    rt_uint32_t rx_out_of_window;   // 超出接收窗口的报文
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_DUPLEX_H_ */
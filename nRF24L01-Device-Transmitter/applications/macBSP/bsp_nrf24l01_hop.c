@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-24     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_hop.h"
+
+
+#define HOP_REQ_ON      1
+#define HOP_REQ_OFF     2
+
+static const char *const hop_state_name[] = { "off", "data", "drain", "hop", "parked" };
+
+
+
+static rt_uint32_t nRF24L01_Hop_Us_To_Cycles(rt_uint32_t us)
+{
+    return us * (SystemCoreClock / 1000000U);
+}
+
+
+/***
+ * @brief   由种子生成跳频序列：从可选范围内的偶数信道中不重复地随机挑出 NRF24_HOP_CHANNELS 个
+ * @note    xorshift32，双方用同一个种子得到同一个序列
+ */
+static void nRF24L01_Hop_Build(struct nRF24L01_HOP_STRUCT *hop, rt_uint32_t seed)
+{
+    rt_uint8_t pool[(NRF24_CHAN_MAX - NRF24_CHAN_MIN) / 2 + 1];
+    rt_uint8_t count = 0;
+    rt_uint32_t x = seed ? seed : 1;
+
+    for(rt_uint8_t ch = (NRF24_CHAN_MIN + 1) & ~1; ch <= NRF24_CHAN_MAX; ch += 2){
+        pool[count++] = ch;
+    }
+    for(rt_uint8_t i = 0; i < NRF24_HOP_CHANNELS; i++)
+    {
+        rt_uint8_t j, tmp;
+
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        j = i + x % (count - i);
+        tmp = pool[i];
+        pool[i] = pool[j];
+        pool[j] = tmp;
+        hop->ch[i] = pool[i];
+    }
+    hop->seed = seed;
+}
+
+
+static rt_uint8_t nRF24L01_Hop_Channel(struct nRF24L01_HOP_STRUCT *hop, rt_uint8_t idx)
+{
+    return (idx == NRF24_HOP_HOME_IDX) ? NRF24_CHAN_HOME : hop->ch[idx];
+}
+
+
+/***
+ * @brief   序列中 idx 之后第一个不在黑名单里的位置
+ */
+static rt_uint8_t nRF24L01_Hop_Next_Idx(struct nRF24L01_HOP_STRUCT *hop, rt_uint8_t idx)
+{
+    rt_uint8_t start = (idx == NRF24_HOP_HOME_IDX) ? NRF24_HOP_CHANNELS - 1 : idx;
+
+    for(rt_uint8_t k = 1; k <= NRF24_HOP_CHANNELS; k++)
+    {
+        rt_uint8_t i = (start + k) % NRF24_HOP_CHANNELS;
+        if((hop->black & (1UL << i)) == 0){
+            return i;
+        }
+    }
+    return (start + 1) % NRF24_HOP_CHANNELS;
+}
+
+
+static rt_uint8_t nRF24L01_Hop_Active_Count(struct nRF24L01_HOP_STRUCT *hop)
+{
+    rt_uint8_t count = 0;
+
+    for(rt_uint8_t i = 0; i < NRF24_HOP_CHANNELS; i++){
+        count += (hop->black & (1UL << i)) ? 0 : 1;
+    }
+    return count;
+}
+
+
+static void nRF24L01_Hop_Set_Channel(nrf24_t nrf24, rt_uint8_t ch)
+{
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Write_Reg_Data(nrf24, NRF24REG_RF_CH, ch);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+}
+
+
+/***
+ * @brief   PTX：驻留期结束，更新该信道的丢包率，拉黑 / 放出信道
+ */
+static void nRF24L01_Hop_Slot_End(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+
+    if(hop->idx != NRF24_HOP_HOME_IDX && hop->slot_tx > 0)
+    {
+        rt_uint8_t pct = hop->slot_fail * 100 / hop->slot_tx;
+
+        hop->loss[hop->idx] = (hop->loss[hop->idx] * 3 + pct) / 4;
+        if(hop->loss[hop->idx] >= NRF24_HOP_BLACK_PCT && (hop->black & (1UL << hop->idx)) == 0
+           && nRF24L01_Hop_Active_Count(hop) > NRF24_HOP_MIN_ACTIVE)
+        {
+            hop->black |= 1UL << hop->idx;
+            hop->black_age[hop->idx] = 0;
+            hop->blacklisted++;
+            LOG_W("LOG:%d. nrf24 hop: channel %d blacklisted, loss %d%%.",Record.ulog_cnt++, hop->ch[hop->idx], hop->loss[hop->idx]);
+        }
+    }
+    hop->slot_tx = 0;
+    hop->slot_fail = 0;
+
+    for(rt_uint8_t i = 0; i < NRF24_HOP_CHANNELS; i++)
+    {
+        if((hop->black & (1UL << i)) && ++hop->black_age[i] >= NRF24_HOP_PAROLE){
+            hop->black &= ~(1UL << i);
+            hop->loss[i] = 0;
+            hop->paroled++;
+            LOG_I("LOG:%d. nrf24 hop: channel %d back on parole.",Record.ulog_cnt++, hop->ch[i]);
+        }
+    }
+}
+
+
+/***
+ * @brief   PTX：在当前信道发出 HOP，带下一跳位置、黑名单和种子
+ */
+static void nRF24L01_Hop_Send(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+    rt_uint8_t frame[NRF24_HOP_SIZE];
+
+    nRF24L01_Hop_Slot_End(nrf24);
+    hop->next = nRF24L01_Hop_Next_Idx(hop, hop->idx);
+
+    frame[0] = NRF24_HOP_MARK | NRF24_HOP_HOP;
+    frame[1] = hop->next;
+    for(rt_uint8_t i = 0; i < 4; i++){
+        frame[2 + i] = (rt_uint8_t)(hop->black >> (8 * i));
+        frame[6 + i] = (rt_uint8_t)(hop->seed  >> (8 * i));
+    }
+    nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, sizeof(frame));
+    hop->state = NRF24_HOP_HOP_TX;
+}
+
+
+static rt_int32_t nRF24L01_Hop_Ticks_Until(rt_uint32_t deadline_cycles)
+{
+    rt_int32_t left = (rt_int32_t)(deadline_cycles - nRF24L01_Debug_Get_Cycles());
+
+    if(left <= 0){
+        return 1;
+    }
+    return rt_tick_from_millisecond((nRF24L01_Debug_Cycles_To_Us(left) + 999) / 1000);
+}
+
+
+
+/***
+ * @brief   初始化跳频
+ */
+void nRF24L01_Hop_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+
+    rt_memset(hop, 0, sizeof(struct nRF24L01_HOP_STRUCT));
+    hop->idx = NRF24_HOP_HOME_IDX;
+    hop->req = NRF24_HOP_ENABLE ? HOP_REQ_ON : 0;
+}
+
+
+/***
+ * @brief   启用 / 停用跳频（PTX），可在任意线程中调用
+ */
+void nRF24L01_Hop_Enable(nrf24_t nrf24, rt_bool_t on)
+{
+    nrf24->hop.req = on ? HOP_REQ_ON : HOP_REQ_OFF;
+    nRF24L01_Wakeup(nrf24);
+}
+
+
+/***
+ * @brief   PTX 的 TX_DS / MAX_RT
+ * @note    HOP 的 TX_DS 时刻即下一个驻留期的起点；HOP 失败也照常跳，对端会按驻留时间外推跟上，
+ *          此时下一个驻留期接着上一个的截止时刻算，而不是从 MAX_RT 算起：被干扰的信道上发空 TX FIFO 再加 HOP 的重发
+ *          可能远超 NRF24_HOP_LATE_US，从失败时刻起算会让 PTX 每跳都比对端的外推晚一截，几跳之后对端就失步停下；
+ *          连续一整圈 HOP 都失败说明对端已失去同步，回到 NRF24_CHAN_HOME 重新会合
+ * @return  1 : 事件属于 HOP，已处理   0 : 交给后面的层
+ */
+int nRF24L01_Hop_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+
+    if(hop->state == NRF24_HOP_OFF){
+        return 0;
+    }
+    if(hop->state != NRF24_HOP_HOP_TX){
+        hop->slot_tx++;
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            hop->slot_fail++;
+        }
+        return 0;
+    }
+
+    if(irq_flags & NRF24BITMASK_MAX_RT){
+        nRF24L01_Flush_TX_FIFO(nrf24);
+        hop->hops_failed++;
+        hop->hop_fail++;
+    }
+    else{
+        hop->hop_fail = 0;
+    }
+
+    if(hop->hop_fail > nRF24L01_Hop_Active_Count(hop)){
+        hop->hop_fail = 0;
+        hop->rendezvous++;
+        hop->idx = NRF24_HOP_HOME_IDX;
+        LOG_W("LOG:%d. nrf24 hop: peer lost, rendezvous at channel %d.",Record.ulog_cnt++, NRF24_CHAN_HOME);
+    }
+    else{
+        hop->idx = hop->next;
+    }
+    nRF24L01_Hop_Set_Channel(nrf24, nRF24L01_Hop_Channel(hop, hop->idx));
+    if(irq_flags & NRF24BITMASK_MAX_RT){
+        hop->deadline_cycles += nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DWELL_MS * 1000);
+    }
+    else{
+        hop->deadline_cycles = nrf24->latency.irq_cycles + nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DWELL_MS * 1000);
+    }
+    hop->state = NRF24_HOP_DATA;
+    hop->hops++;
+
+    return 1;
+}
+
+
+/***
+ * @brief   PRX 处理 HOP
+ * @return  1 : HOP，已处理   0 : 其它数据
+ */
+int nRF24L01_Hop_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+    rt_uint32_t black = 0, seed = 0;
+
+    if(NRF24_CHAN_LOCKED || len != NRF24_HOP_SIZE || data[0] != (NRF24_HOP_MARK | NRF24_HOP_HOP)
+       || (data[1] >= NRF24_HOP_CHANNELS && data[1] != NRF24_HOP_HOME_IDX)){
+        return 0;
+    }
+    if(nrf24->nrf24_cfg.config.prim_rx != ROLE_PRX){
+        return 1;
+    }
+
+    for(rt_uint8_t i = 0; i < 4; i++){
+        black |= (rt_uint32_t)data[2 + i] << (8 * i);
+        seed  |= (rt_uint32_t)data[6 + i] << (8 * i);
+    }
+    if(seed != hop->seed || hop->state == NRF24_HOP_OFF){
+        nRF24L01_Hop_Build(hop, seed);
+    }
+    hop->black = black;
+    hop->next = data[1];
+    hop->last_hop_tick = rt_tick_get();
+
+    // 自动应答还没发完，跳频要等应答（最长带 32 字节 ACK 载荷）离开空口
+    hop->peer_pending = 1;
+    hop->peer_deadline_cycles = nrf24->latency.irq_cycles + nRF24L01_Hop_Us_To_Cycles(NRF24_TURN_SETTLE_US + NRF24_TURN_MARGIN_US
+                              + nRF24L01_Air_Us(&nrf24->nrf24_cfg, 32));
+
+    return 1;
+}
+
+
+/***
+ * @brief   推进跳频，在射频线程中调用
+ */
+void nRF24L01_Hop_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+    rt_uint32_t now = nRF24L01_Debug_Get_Cycles();
+
+    // 1. msh 请求：PTX 启用时生成新的种子，先在 NRF24_CHAN_HOME 驻留一期，用第一个 HOP 把对端带进序列
+    if(hop->req == HOP_REQ_ON){
+        hop->req = 0;
+        if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX && !NRF24_CHAN_LOCKED && hop->state == NRF24_HOP_OFF){
+            rt_uint8_t *addr = nrf24->nrf24_cfg.txaddr;
+            nRF24L01_Hop_Build(hop, now ^ (rt_tick_get() << 16) ^ (addr[0] << 8) ^ addr[1]);
+            hop->black = 0;
+            rt_memset(hop->loss, 0, sizeof(hop->loss));
+            hop->idx = NRF24_HOP_HOME_IDX;
+            hop->slot_tx = hop->slot_fail = 0;
+            hop->hop_fail = 0;
+            nRF24L01_Hop_Set_Channel(nrf24, NRF24_CHAN_HOME);
+            hop->deadline_cycles = now + nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DWELL_MS * 1000);
+            hop->state = NRF24_HOP_DATA;
+            LOG_I("LOG:%d. nrf24 hop: on, seed 0x%08x, %d channels, %d ms dwell.",Record.ulog_cnt++, hop->seed, NRF24_HOP_CHANNELS, NRF24_HOP_DWELL_MS);
+        }
+    }
+    else if(hop->req == HOP_REQ_OFF){
+        hop->req = 0;
+        if(hop->state != NRF24_HOP_OFF && hop->state != NRF24_HOP_HOP_TX){
+            hop->state = NRF24_HOP_OFF;
+            hop->idx = NRF24_HOP_HOME_IDX;
+            nRF24L01_Hop_Set_Channel(nrf24, NRF24_CHAN_HOME);
+            LOG_I("LOG:%d. nrf24 hop: off, back to channel %d.",Record.ulog_cnt++, NRF24_CHAN_HOME);
+        }
+    }
+
+    // 2. PTX：驻留期到了停止补充数据，TX FIFO 发空后发 HOP；超过 NRF24_HOP_DRAIN_US 还没发空就放弃 FIFO 中的包，
+    //    它们留在软件队列里到下一信道再发（与 TDMA 时隙结束时一样），挂起的 TX_DS / MAX_RT 先交给发送队列处理
+    if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX)
+    {
+        if(hop->state == NRF24_HOP_DATA && (rt_int32_t)(now - hop->deadline_cycles) >= 0){
+            hop->state = NRF24_HOP_DRAIN;
+        }
+        if(hop->state == NRF24_HOP_DRAIN && nrf24->tx_queue.sent != nrf24->tx_queue.done
+           && (rt_int32_t)(now - hop->deadline_cycles) >= (rt_int32_t)nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DRAIN_US)
+           && !(nRF24L01_Read_Status_Register(nrf24) & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT))){
+            nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+            nRF24L01_TxQueue_Rewind(nrf24);
+            nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+            hop->drain_aborted++;
+        }
+        if(hop->state == NRF24_HOP_DRAIN && nrf24->tx_queue.sent == nrf24->tx_queue.done && !nRF24L01_Turn_Busy(nrf24)
+           && nRF24L01_Link_Tx_Allowed(nrf24) && !nRF24L01_Chan_Busy(nrf24)){
+            nRF24L01_Hop_Send(nrf24);
+        }
+        return;
+    }
+
+    // 3. PRX：HOP 的自动应答发完后跳到下一信道
+    if(hop->peer_pending && (rt_int32_t)(now - hop->peer_deadline_cycles) >= 0)
+    {
+        hop->peer_pending = 0;
+        hop->idx = hop->next;
+        hop->missed = 0;
+        hop->hops++;
+        nRF24L01_Hop_Set_Channel(nrf24, nRF24L01_Hop_Channel(hop, hop->idx));
+        hop->deadline_cycles = hop->peer_deadline_cycles + nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DWELL_MS * 1000 + NRF24_HOP_LATE_US);
+        hop->state = NRF24_HOP_DATA;
+    }
+
+    // 4. PRX：漏掉 HOP 时按驻留时间外推，连续漏掉 NRF24_HOP_LOST 次就回到 NRF24_CHAN_HOME 等 PTX 会合；
+    //    不停在当前信道：连续漏掉多半是这几个信道被干扰了，PTX 一整圈 HOP 失败后也会回到 NRF24_CHAN_HOME
+    if(hop->state == NRF24_HOP_DATA && (rt_int32_t)(now - hop->deadline_cycles) >= 0)
+    {
+        if(++hop->missed >= NRF24_HOP_LOST){
+            hop->state = NRF24_HOP_PARKED;
+            hop->idx = NRF24_HOP_HOME_IDX;
+            nRF24L01_Hop_Set_Channel(nrf24, NRF24_CHAN_HOME);
+            LOG_W("LOG:%d. nrf24 hop: lost sync, parked at channel %d.",Record.ulog_cnt++, NRF24_CHAN_HOME);
+        }
+        else{
+            hop->idx = nRF24L01_Hop_Next_Idx(hop, hop->idx);
+            hop->extrapolated++;
+            nRF24L01_Hop_Set_Channel(nrf24, nRF24L01_Hop_Channel(hop, hop->idx));
+            hop->deadline_cycles += nRF24L01_Hop_Us_To_Cycles(NRF24_HOP_DWELL_MS * 1000);
+        }
+    }
+    if(hop->state == NRF24_HOP_PARKED && rt_tick_get() - hop->last_hop_tick >= rt_tick_from_millisecond(NRF24_HOP_IDLE_MS)){
+        hop->state = NRF24_HOP_OFF;
+        hop->idx = NRF24_HOP_HOME_IDX;
+        nRF24L01_Hop_Set_Channel(nrf24, NRF24_CHAN_HOME);
+        LOG_W("LOG:%d. nrf24 hop: no hop from peer, back to channel %d.",Record.ulog_cnt++, NRF24_CHAN_HOME);
+    }
+}
+
+
+/***
+ * @brief   PTX 只在驻留期内从软件队列补充数据
+ */
+rt_bool_t nRF24L01_Hop_Tx_Allowed(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+
+    if(hop->state == NRF24_HOP_OFF || nrf24->nrf24_cfg.config.prim_rx != ROLE_PTX){
+        return RT_TRUE;
+    }
+    return (hop->state == NRF24_HOP_DATA && (rt_int32_t)(nRF24L01_Debug_Get_Cycles() - hop->deadline_cycles) < 0) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   正在跳频，固定信道的切换和失联回退让给跳频处理
+ */
+rt_bool_t nRF24L01_Hop_Active(nrf24_t nrf24)
+{
+    return (nrf24->hop.state != NRF24_HOP_OFF) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   HOP 在途，其它层不能再往芯片 TX FIFO 写入
+ */
+rt_bool_t nRF24L01_Hop_Busy(nrf24_t nrf24)
+{
+    return (nrf24->hop.state == NRF24_HOP_HOP_TX) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   射频线程等待 IRQ 信号量的超时：驻留期结束、PRX 的跳频时刻或停下后的空闲超时
+ */
+rt_int32_t nRF24L01_Hop_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_HOP_STRUCT *hop = &nrf24->hop;
+    rt_int32_t left;
+
+    if(hop->req || hop->peer_pending || hop->state == NRF24_HOP_DRAIN){
+        return 1;
+    }
+    if(hop->state == NRF24_HOP_DATA){
+        return nRF24L01_Hop_Ticks_Until(hop->deadline_cycles);
+    }
+    if(hop->state == NRF24_HOP_PARKED){
+        left = (rt_int32_t)(hop->last_hop_tick + rt_tick_from_millisecond(NRF24_HOP_IDLE_MS) - rt_tick_get());
+        return (left > 0) ? left : 1;
+    }
+    return RT_WAITING_FOREVER;
+}
+
+
+
+/***
+ * @brief msh 命令：跳频序列、各信道丢包率和黑名单
+ * @note  nrf24_hop                 打印状态
+ *        nrf24_hop on | off        PTX 启用 / 停用跳频
+ *        nrf24_hop reset           清零统计
+ */
+static void nrf24_hop_cmd(int argc, char **argv)
+{
+    struct nRF24L01_HOP_STRUCT *hop;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    hop = &_nrf24->hop;
+
+    if (argc > 1 && rt_strcmp(argv[1], "on") == 0)
+    {
+        nRF24L01_Hop_Enable(_nrf24, RT_TRUE);
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "off") == 0)
+    {
+        nRF24L01_Hop_Enable(_nrf24, RT_FALSE);
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        hop->hops = hop->hops_failed = hop->drain_aborted = hop->extrapolated = 0;
+        hop->blacklisted = hop->paroled = hop->rendezvous = 0;
+    }
+
+    rt_kprintf("[nrf24] hop %s%s: channel %d, seed 0x%08x, %d of %d channels active\r\n",
+               hop_state_name[hop->state], NRF24_CHAN_LOCKED ? " (locked)" : "", _nrf24->nrf24_cfg.rf_ch.rf_ch,
+               hop->seed, nRF24L01_Hop_Active_Count(hop), NRF24_HOP_CHANNELS);
+    rt_kprintf("  %d hops, %d hop frames failed, %d drains cut short, %d extrapolated, %d blacklisted, %d paroled, %d rendezvous\r\n",
+               hop->hops, hop->hops_failed, hop->drain_aborted, hop->extrapolated, hop->blacklisted, hop->paroled, hop->rendezvous);
+    if (hop->seed == 0){
+        return;
+    }
+
+    rt_kprintf("  pos  ch   loss\r\n");
+    for (rt_uint8_t i = 0; i < NRF24_HOP_CHANNELS; i++)
+    {
+        rt_kprintf("  %c%2d  %3d  %3d%%%s\r\n", (i == hop->idx) ? '>' : ' ', i, hop->ch[i], hop->loss[i],
+                   (hop->black & (1UL << i)) ? "  blacklisted" : "");
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_hop_cmd, nrf24_hop, frequency hopping sequence and blacklist [on | off | reset]);
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-19     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_hub.h"
+
+
+#define HUB_PKT(p, i)   ((p)->pkt[(i) & (NRF24_HUB_QUEUE_DEPTH - 1)])
+
+
+
+/***
+ * @brief   中心管道的完整地址
+ * @note    管道 2~5 的最低字节取自 rx_addr_pN，其余 4 字节与管道 1 相同
+ */
+void nRF24L01_Hub_Pipe_Addr(nrf24_param_t param, rt_uint8_t pipe, rt_uint8_t *addr)
+{
+    const rt_uint8_t lsb[6] = { 0, 0, param->rx_addr_p2, param->rx_addr_p3, param->rx_addr_p4, param->rx_addr_p5 };
+
+    if(pipe == NRF24_PIPE_0){
+        rt_memcpy(addr, param->rx_addr_p0, 5);
+        return;
+    }
+    rt_memcpy(addr, param->rx_addr_p1, 5);
+    if(pipe > NRF24_PIPE_1 && pipe <= NRF24_PIPE_5){
+        addr[0] = lsb[pipe];
+    }
+}
+
+
+/***
+ * @brief   缺省的管道消费者：送入该管道的帧解码器，再交给 nrf24l01_rx_ind
+ */
+static void nRF24L01_Hub_Default_Consumer(nrf24_t nrf24, nrf24_pkt_t pkt)
+{
+    nrf24l01_decoder_feed(&nrf24->decoder[pkt->pipe], pkt->data, pkt->len, nrf24l01_protocol_handler, nrf24);
+    nRF24L01_Pkt_Deliver(nrf24, pkt);
+}
+
+
+#if NRF24_USE_HUB
+/***
+ * @brief   一轮 DRR 调度
+ * @note    每个非空管道的赤字加一个量子，队首包长不超过赤字就出队交给消费者；队列空时赤字清零，
+ *          空闲的管道不能攒下额度。一个管道每轮最多消费 quantum 字节，发得再多的节点也只是在自己的队列里排队
+ * @return  本轮消费的数据包数量
+ */
+static int nRF24L01_Hub_Round(nrf24_t nrf24)
+{
+    struct nRF24L01_HUB_STRUCT *hub = &nrf24->hub;
+    struct nRF24L01_HUB_PIPE *p;
+    nrf24_pkt_t pkt;
+    rt_uint32_t wait;
+    int served = 0;
+
+    for(rt_uint8_t i = 0; i < 6; i++)
+    {
+        p = &hub->pipe[i];
+        if(p->get == p->put){
+            p->deficit = 0;
+            continue;
+        }
+
+        p->deficit += p->quantum;
+        while(p->get != p->put)
+        {
+            pkt = HUB_PKT(p, p->get);
+            if(pkt->len > p->deficit){
+                break;
+            }
+            p->deficit -= pkt->len;
+
+            wait = nRF24L01_Debug_Cycles_To_Us(nRF24L01_Debug_Get_Cycles() - pkt->cycles);
+            if(wait > p->wait_max_us){
+                p->wait_max_us = wait;
+            }
+            p->wait_sum_us += wait;
+
+            /* 槽位里只有指针，描述符交给消费者之前就可以让出槽位 */
+            p->get++;
+            p->delivered++;
+            p->bytes += pkt->len;
+            served++;
+            p->consumer(nrf24, pkt);
+        }
+        if(p->get == p->put){
+            p->deficit = 0;
+        }
+    }
+    hub->rounds++;
+
+    return served;
+}
+
+
+static void nRF24L01_Hub_Thread_Entry(void *parameter)
+{
+    nrf24_t nrf24 = (nrf24_t)parameter;
+
+    for(;;)
+    {
+        rt_sem_take(&nrf24->hub.sem, RT_WAITING_FOREVER);
+        while(nRF24L01_Hub_Round(nrf24) > 0);
+    }
+}
+#endif
+
+
+
+/***
+ * @brief   初始化星型网络中心，NRF24_USE_HUB 为 1 时启动中心线程
+ */
+void nRF24L01_Hub_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_HUB_STRUCT *hub = &nrf24->hub;
+
+    rt_memset(hub, 0, sizeof(struct nRF24L01_HUB_STRUCT));
+    for(rt_uint8_t i = 0; i < 6; i++){
+        hub->pipe[i].consumer = nRF24L01_Hub_Default_Consumer;
+        hub->pipe[i].quantum  = NRF24_HUB_QUANTUM;
+    }
+
+#if NRF24_USE_HUB
+    rt_snprintf(hub->name, sizeof(hub->name), "%s_hub", nrf24->name);
+    rt_sem_init(&hub->sem, hub->name, 0, RT_IPC_FLAG_FIFO);
+    if(rt_thread_init(&hub->thread_obj, hub->name, nRF24L01_Hub_Thread_Entry, nrf24,
+                      hub->stack, sizeof(hub->stack), NRF24_HUB_THREAD_PRIO, 10) != RT_EOK){
+        LOG_E("LOG:%d. %s thread init failed.",Record.ulog_cnt++, hub->name);
+        return;
+    }
+    hub->thread = &hub->thread_obj;
+    rt_thread_startup(hub->thread);
+    LOG_I("LOG:%d. %s running on 6 pipes.",Record.ulog_cnt++, hub->name);
+#endif
+}
+
+
+/***
+ * @brief   设置管道的消费者和 DRR 量子
+ * @param   consumer 为 RT_NULL 时恢复缺省消费者（解码 + nrf24l01_rx_ind）
+ *          quantum  每轮可消费的字节数，按比例分配各管道的带宽，小于 32 时按 32 处理
+ */
+int nRF24L01_Hub_Set_Consumer(nrf24_t nrf24, rt_uint8_t pipe, nrf24_hub_consumer_t consumer, rt_uint16_t quantum)
+{
+    struct nRF24L01_HUB_PIPE *p;
+
+    if(pipe > NRF24_PIPE_5){
+        return -RT_EINVAL;
+    }
+    p = &nrf24->hub.pipe[pipe];
+
+    rt_enter_critical();
+    p->consumer = (consumer != RT_NULL) ? consumer : nRF24L01_Hub_Default_Consumer;
+    p->quantum  = (quantum < 32) ? 32 : quantum;
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+
+/***
+ * @brief   射频线程把一包应用数据放入管道的接收队列
+ * @return  1 : 已入队或因队列满而丢弃，描述符归中心所有   0 : 未开启中心模式，由调用者按原来的方式处理
+ */
+int nRF24L01_Hub_Input(nrf24_t nrf24, nrf24_pkt_t pkt)
+{
+#if NRF24_USE_HUB
+    struct nRF24L01_HUB_STRUCT *hub = &nrf24->hub;
+    struct nRF24L01_HUB_PIPE *p;
+    rt_uint8_t depth;
+
+    if(hub->thread == RT_NULL || pkt->pipe > NRF24_PIPE_5){
+        return 0;
+    }
+    p = &hub->pipe[pkt->pipe];
+
+    // 1. 队列满则丢弃新包，只影响这个管道
+    depth = (rt_uint8_t)(p->put - p->get);
+    if(depth >= NRF24_HUB_QUEUE_DEPTH){
+        p->dropped++;
+        nRF24L01_Pkt_Free(pkt);
+        return 1;
+    }
+
+    // 2. 先写指针再推进 put，中心线程看到 put 变化时槽位已完整
+    HUB_PKT(p, p->put) = pkt;
+    p->put++;
+
+    p->enqueued++;
+    if(depth + 1 > p->high_water){
+        p->high_water = depth + 1;
+    }
+    rt_sem_release(&hub->sem);
+
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+
+
+/***
+ * @brief msh 命令：星型网络中心各管道的队列统计
+ * @note  nrf24_hub                          打印统计
+ *        nrf24_hub quantum <pipe> <bytes>   设置管道的 DRR 量子
+ *        nrf24_hub reset                    清零统计
+ */
+static void nrf24_hub_cmd(int argc, char **argv)
+{
+    struct nRF24L01_HUB_STRUCT *hub;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    hub = &_nrf24->hub;
+
+    if (argc > 3 && rt_strcmp(argv[1], "quantum") == 0)
+    {
+        rt_uint8_t pipe = atoi(argv[2]);
+        if (pipe <= NRF24_PIPE_5){
+            nRF24L01_Hub_Set_Consumer(_nrf24, pipe, hub->pipe[pipe].consumer, atoi(argv[3]));
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        for (rt_uint8_t i = 0; i < 6; i++)
+        {
+            struct nRF24L01_HUB_PIPE *p = &hub->pipe[i];
+            p->enqueued = p->delivered = p->dropped = p->bytes = 0;
+            p->high_water = 0;
+            p->wait_max_us = 0;
+            p->wait_sum_us = 0;
+        }
+        hub->rounds = 0;
+        rt_exit_critical();
+    }
+
+    rt_kprintf("[nrf24] hub %s, %d rounds\r\n", (hub->thread != RT_NULL) ? "running" : "off", hub->rounds);
+    rt_kprintf("  pipe quantum   queued  delivered  dropped    bytes  hwm  wait avg/max(us)\r\n");
+    for (rt_uint8_t i = 0; i < 6; i++)
+    {
+        struct nRF24L01_HUB_PIPE *p = &hub->pipe[i];
+        rt_kprintf("  p%d   %7d %8d %10d %8d %8d  %d/%d  %d/%d\r\n", i, p->quantum,
+                   p->enqueued, p->delivered, p->dropped, p->bytes,
+                   p->high_water, NRF24_HUB_QUEUE_DEPTH,
+                   p->delivered ? (rt_uint32_t)(p->wait_sum_us / p->delivered) : 0, p->wait_max_us);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_hub_cmd, nrf24_hub, star hub per pipe queue stats [quantum <pipe> <bytes> | reset]);
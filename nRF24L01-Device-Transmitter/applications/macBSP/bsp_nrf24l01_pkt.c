@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-27     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_pkt.h"
+
+
+
+/***
+ * @brief   初始化数据包描述符池
+ */
+void nRF24L01_Pkt_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_PKT_POOL *pool = &nrf24->pkt_pool;
+
+    rt_memset(pool, 0, sizeof(struct nRF24L01_PKT_POOL));
+    rt_mp_init(&pool->mp, "nrf24_pkt", pool->pool, sizeof(pool->pool), sizeof(struct nRF24L01_PKT_STRUCT));
+    pool->low_water = pool->mp.block_total_count;
+}
+
+
+/***
+ * @brief   取一个描述符
+ * @return  RT_NULL 表示池已耗尽，已计入 exhausted
+ * @note    不等待，可在任意线程或中断中调用
+ */
+nrf24_pkt_t nRF24L01_Pkt_Alloc(nrf24_t nrf24)
+{
+    struct nRF24L01_PKT_POOL *pool = &nrf24->pkt_pool;
+    nrf24_pkt_t pkt;
+
+    pkt = (nrf24_pkt_t)rt_mp_alloc(&pool->mp, 0);
+    if(pkt == RT_NULL){
+        pool->exhausted++;
+        return RT_NULL;
+    }
+    pool->allocs++;
+    if(pool->mp.block_free_count < pool->low_water){
+        pool->low_water = pool->mp.block_free_count;
+    }
+
+    pkt->flags = 0;
+    return pkt;
+}
+
+
+/***
+ * @brief   把描述符还回所属的池
+ * @note    rt_mempool 的块头记着所属的池，不需要知道是哪个 nRF24L01 分配的；可在任意线程或中断中调用
+ */
+void nRF24L01_Pkt_Free(nrf24_pkt_t pkt)
+{
+    if(pkt != RT_NULL){
+        rt_mp_free(pkt);
+    }
+}
+
+
+/***
+ * @brief   把一包应用数据交给应用，并转移描述符的所有权
+ * @note    设备已打开时先放进设备的接收缓冲；设置了 nrf24l01_rx_pkt 时描述符交给它，由应用在用完后调用 nRF24L01_Pkt_Free；
+ *          否则调用 nrf24l01_rx_ind，回调返回后在这里释放
+ */
+void nRF24L01_Pkt_Deliver(nrf24_t nrf24, nrf24_pkt_t pkt)
+{
+    nRF24L01_Dev_Input(nrf24, pkt);
+    if(nrf24->nrf24_cb.nrf24l01_rx_pkt){
+        nrf24->nrf24_cb.nrf24l01_rx_pkt(nrf24, pkt);
+        return;
+    }
+    if(nrf24->nrf24_cb.nrf24l01_rx_ind){
+        nrf24->nrf24_cb.nrf24l01_rx_ind(nrf24, pkt->data, pkt->len, pkt->pipe);
+    }
+    nRF24L01_Pkt_Free(pkt);
+}
+
+
+
+/***
+ * @brief msh 命令：数据包描述符池
+ * @note  nrf24_pkt              打印池的使用情况
+ *        nrf24_pkt bench [次数]  对比一次 alloc + free 与一次 32 字节拷贝的耗时
+ *        nrf24_pkt reset        清零统计
+ */
+static void nrf24_pkt_cmd(int argc, char **argv)
+{
+    struct nRF24L01_PKT_POOL *pool;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    pool = &_nrf24->pkt_pool;
+
+    if (argc > 1 && rt_strcmp(argv[1], "bench") == 0)
+    {
+        rt_uint32_t loops = (argc > 2) ? atoi(argv[2]) : 1000;
+        rt_uint32_t start, pool_cycles = 0, copy_cycles = 0;
+        rt_uint8_t src[32], dst[32];
+        nrf24_pkt_t pkt;
+
+        if (loops == 0 || loops > 100000){
+            rt_kprintf("Usage: nrf24_pkt bench [1~100000]\r\n");
+            return;
+        }
+        rt_memset(src, 0x5A, sizeof(src));
+
+        for (rt_uint32_t i = 0; i < loops; i++){
+            start = nRF24L01_Debug_Get_Cycles();
+            pkt = nRF24L01_Pkt_Alloc(_nrf24);
+            nRF24L01_Pkt_Free(pkt);
+            pool_cycles += nRF24L01_Debug_Get_Cycles() - start;
+
+            start = nRF24L01_Debug_Get_Cycles();
+            rt_memcpy(dst, src, sizeof(src));
+            copy_cycles += nRF24L01_Debug_Get_Cycles() - start;
+            src[0] = dst[31];
+        }
+
+        rt_kprintf("[nrf24] %d loops\r\n", loops);
+        rt_kprintf("alloc + free : %d cycles\r\n", pool_cycles / loops);
+        rt_kprintf("32 byte copy : %d cycles\r\n", copy_cycles / loops);
+        return;
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        pool->allocs = pool->exhausted = 0;
+        pool->low_water = pool->mp.block_free_count;
+        rt_exit_critical();
+    }
+
+    rt_kprintf("[nrf24] packet pool: %d / %d free (low water %d), block %d bytes, %d allocs, %d exhausted\r\n",
+               pool->mp.block_free_count, pool->mp.block_total_count, pool->low_water,
+               pool->mp.block_size, pool->allocs, pool->exhausted);
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_pkt_cmd, nrf24_pkt, packet descriptor pool [bench [loops] | reset]);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-27     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_PKT_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_PKT_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 数据包描述符池
+ * 收发路径上的每一包数据都放在一个描述符里，描述符取自 rt_mempool 管理的静态内存，分配和释放都是 O(1)，运行时不用堆：
+ * RX : R_RX_PAYLOAD 直接读进描述符，之后各层、星型中心的接收队列和应用都只传递描述符的指针，不再拷贝数据
+ * TX : 软件发送队列的槽位只存描述符指针，nRF24L01_Send_Pkt 提交调用者填好的描述符，不拷贝，
+ *      写入 TX FIFO 时指令字节放在 status 上，从 status 起一次 SPI 传输直接写出；
+ *      nRF24L01_Send_Async 仍接受数据指针，拷贝一次进描述符
+ * 池耗尽时不阻塞也不断言：RX 包仍交给控制报文各层处理，只是不再交给应用；TX 返回 -RT_EFULL，均记入 exhausted
+ *
+ * NRF24_PKT_POOL_SIZE : 描述符个数，应不小于 NRF24_TXQ_DEPTH + RX FIFO 深度 + 应用同时持有的包数；
+ *                       星型中心模式下各管道队列中的包也占用描述符
+ * NRF24_PKT_READ_RPD  : 1 -> 每次读空 RX FIFO 前多读一次 RPD 寄存器，填入描述符的 NRF24_PKT_FLAG_RPD
+ */
+#if NRF24_USE_HUB
+#define NRF24_PKT_POOL_SIZE         32
+#else
+#define NRF24_PKT_POOL_SIZE         16
+#endif
+#define NRF24_PKT_READ_RPD          1
+
+
+/* 描述符标志 */
+#define NRF24_PKT_FLAG_RPD          0x01    /* 收到该包时 RPD 为 1（接收功率高于 -64dBm） */
+
+
+/***
+ * 数据包描述符
+ * status 紧挨在 data 之前：R_RX_PAYLOAD 时 SPI 同时移出的 STATUS 字节落在 status 上，载荷直接落在 data 中；
+ * 发送时 status 存放 W_TX_PAYLOAD 指令字节，[status][data] 就是要写给芯片的一整帧
+ */
+struct nRF24L01_PKT_STRUCT
+{
+    /* 收到时的 DWT 周期计数，发送时为提交时刻 */
+    rt_uint32_t cycles;
+    rt_uint8_t  len;
+    rt_uint8_t  pipe;
+    rt_uint8_t  flags;
+    rt_uint8_t  status;
+    rt_uint8_t  data[32];
+};
+typedef struct nRF24L01_PKT_STRUCT *nrf24_pkt_t;
+
+
+/* rt_mempool 每块前有一个指针大小的块头，块大小按 RT_ALIGN_SIZE 对齐 */
+#define NRF24_PKT_BLOCK_SIZE        (RT_ALIGN(sizeof(struct nRF24L01_PKT_STRUCT), RT_ALIGN_SIZE) + sizeof(rt_uint8_t *))
+
+struct nRF24L01_PKT_POOL
+{
+    struct rt_mempool mp;
+    rt_uint32_t pool[(NRF24_PKT_POOL_SIZE * NRF24_PKT_BLOCK_SIZE + 3) / 4];
+
+    /* 统计 */
+    rt_uint32_t allocs;
+    rt_uint32_t exhausted;
+    rt_uint16_t low_water;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_PKT_H_ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-20     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_ROTATE_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_ROTATE_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 地址轮换：中心超过 6 个节点
+ * 节点按编号每 4 个分为一组，第 n 个节点的地址最低字节为 NRF24_ROTATE_LSB_BASE + n，其余 4 字节与管道 1 相同，
+ * 对准中心的管道 2 + n % 4；中心每个时隙把管道 2~5 的最低字节换成下一组节点的地址，
+ * 不在当前组的节点地址不匹配，发出的包中心根本不会应答，因此节点只在本组的时隙内发送
+ *
+ * 管道 1 不参与轮换，作为同步通道：节点向管道 1 发 SYNC，中心在管道 1 的 ACK 载荷中放好信标（时隙表）
+ *
+ * NRF24_ROTATE_NODES    : 中心：参与轮换的节点数，0 为关闭，需要 NRF24_USE_HUB；运行时可用 nrf24_rotate nodes 修改
+ * NRF24_ROTATE_NODE_ID  : 节点：本机编号，-1 为不参与轮换；运行时可用 nrf24_rotate id 修改，同一份固件可烧到所有节点
+ * 两者都不为关闭时同一份代码既能做中心也能做节点，按实例上电时的角色区分（PRX 为中心，PTX 为节点），主机测试就这样在一个进程里
+ * 跑一个中心和多个节点
+ * NRF24_ROTATE_SLOT_MS  : 每组节点占用的时隙长度
+ * NRF24_ROTATE_GUARD_MS : 时隙两端的保护时间，节点在其中不再写入新数据，吸收信标的时延误差、时钟漂移和 FIFO 中剩余包的重发
+ * NRF24_ROTATE_RESYNC   : 节点每经过多少个轮换周期重新同步一次
+ */
+#ifndef NRF24_ROTATE_NODES
+#define NRF24_ROTATE_NODES          0
+#endif
+#ifndef NRF24_ROTATE_NODE_ID
+#define NRF24_ROTATE_NODE_ID        (-1)
+#endif
+#define NRF24_ROTATE_MAX_NODES      32
+#define NRF24_ROTATE_GROUP_SIZE     4
+#define NRF24_ROTATE_SLOT_MS        50
+#define NRF24_ROTATE_GUARD_MS       3
+#define NRF24_ROTATE_LSB_BASE       0x10
+#define NRF24_ROTATE_RESYNC         64
+
+#if NRF24_ROTATE_NODES > NRF24_ROTATE_MAX_NODES || NRF24_ROTATE_NODE_ID >= NRF24_ROTATE_MAX_NODES
+#error "NRF24_ROTATE_NODES / NRF24_ROTATE_NODE_ID exceed NRF24_ROTATE_MAX_NODES"
+#endif
+#if NRF24_ROTATE_NODES > 0 && !NRF24_USE_HUB
+#error "NRF24_ROTATE_NODES needs NRF24_USE_HUB"
+#endif
+#if NRF24_ROTATE_GUARD_MS * 2 >= NRF24_ROTATE_SLOT_MS
+#error "NRF24_ROTATE_GUARD_MS leaves no room in the slot"
+#endif
+
+
+/***
+ * 轮换报文（管道 1）
+ * byte0 : 高 4 位 = 0110 轮换标记（切换引擎为 0100，可靠传输为 10xxxxxx，分片为 11xxxxxx，协议帧以 0x55 开头）
+ *         低 4 位        报文类型
+ *
+ * SYNC   : 节点 -> 中心，用来取走 ACK 载荷中的信标
+ *          byte1 节点编号   byte2 节点的 SYNC 序号
+ * BEACON : 中心 -> 节点（管道 1 的 ACK 载荷）
+ *          byte1~2 当前时隙序号   byte3 当前组   byte4 组数   byte5~6 时隙长度(ms)
+ *          byte7~8 装载信标时本时隙的剩余时间(ms)
+ *          byte9~10 触发这次装载的 SYNC 的 byte1~2，切换时隙时装载的为 0xFF，多字节均为小端
+ *
+ * 信标在装载后要等下一个 SYNC 才被取走，第一个 SYNC 取回的信标可能已经过时；中心每收到一个 SYNC 就重新装载，
+ * 所以节点连发两个 SYNC，只采用第二个 SYNC 带回的、由自己第一个 SYNC 触发装载的信标，误差不超过两个 SYNC 的间隔。
+ * 多个节点同时同步时，别的节点的 SYNC 会插在两个 SYNC 之间取走信标，第二个 SYNC 取回的是别人触发装载的信标
+ * 或者没有信标，按 byte9~10 丢弃，随机退避后重新连发两个；
+ * 中心的 TX FIFO 不空（已有信标或别的 ACK 载荷，切换时隙时清空）时不再装入，信标最多积压一个
+ */
+#define NRF24_ROTATE_MARK           0x60
+#define NRF24_ROTATE_MARK_MASK      0xF0
+#define NRF24_ROTATE_TYPE_MASK      0x0F
+#define NRF24_ROTATE_SYNC           0x01
+#define NRF24_ROTATE_BEACON         0x02
+#define NRF24_ROTATE_SYNC_SIZE      3
+#define NRF24_ROTATE_BEACON_SIZE    11
+
+
+/***
+ * 中心看到的单个节点
+ * max_gap_ms : 同一节点相邻两包的最大间隔，周期上报的节点减去上报周期即为最坏排队时延
+ */
+struct nRF24L01_ROTATE_NODE
+{
+    rt_uint32_t rx_packets;
+    rt_uint32_t rx_bytes;
+    rt_tick_t   last_tick;
+    rt_uint32_t max_gap_ms;
+};
+
+
+/***
+ * 地址轮换
+ */
+struct nRF24L01_ROTATE_STRUCT
+{
+    /* 中心：时隙定时器只置标志并唤醒射频线程，换地址在射频线程中完成 */
+    struct rt_timer slot_timer;
+    volatile rt_uint8_t slot_due;
+    /* 参与轮换的节点数，不是中心时为 0 */
+    rt_uint8_t  nodes;
+    rt_uint8_t  groups;
+    rt_uint8_t  group;
+    rt_uint16_t slot;
+    rt_tick_t   slot_tick;
+    rt_uint32_t switches;
+    rt_uint32_t beacons;
+    struct nRF24L01_ROTATE_NODE node[NRF24_ROTATE_MAX_NODES];
+
+    /* 节点：本机编号，不是节点时为 -1；本组时隙 = [window_tick + k * period_ticks, + slot_ticks) */
+    rt_int8_t   node_id;
+    rt_uint8_t  synced;
+    rt_uint8_t  sync_inflight;
+    /* 本轮已成功发出的 SYNC 数量，最近一个 SYNC 的序号，退避用的伪随机数 */
+    rt_uint8_t  sync_acked;
+    rt_uint8_t  sync_seq;
+    rt_uint32_t rand;
+    rt_uint8_t  on_data_addr;
+    rt_tick_t   next_sync_tick;
+    rt_tick_t   resync_tick;
+    rt_tick_t   window_tick;
+    rt_uint32_t slot_ticks;
+    rt_uint32_t period_ticks;
+    /* 窗口关闭时 TX FIFO 中还有包：1 = 已拉低 CE，等在途的包完成   2 = 已完成，退回其余的包 */
+    rt_uint8_t  closing;
+    rt_tick_t   close_deadline;
+    rt_uint32_t syncs;
+    rt_uint32_t sync_failed;
+    /* 连发两个 SYNC 没有取回自己触发装载的信标、退避重来的次数 */
+    rt_uint32_t sync_stale;
+    /* 窗口关闭时 TX FIFO 中还有包、退回软件队列的次数 */
+    rt_uint32_t rewinds;
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_ROTATE_H_ */
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-17     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_SIM_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_SIM_H_
+#include "bsp_sys.h"
+
+
+/***
+ * nRF24L01 寄存器级软件模型
+ * NRF24_USE_SIMULATOR  : 1 -> 驱动的 nRF24L01_FUNC_OPS 换成软件模型，不再访问 SPI 和 IRQ 引脚，
+ *                        没有射频模块的板子也可以跑完整的驱动 / 协议栈并测吞吐和延时
+ * NRF24_SIM_NODES      : 虚拟空口上的节点数，每个 nRF24L01 实例启动时占用一个空闲节点（第一个实例为节点 0），
+ *                        没有实例的节点由内置的对端程序驱动
+ * NRF24_SIM_FIFO_DEPTH : TX / RX FIFO 深度，与芯片一致
+ * NRF24_SIM_TPLL_US    : 待机 -> 收发的 PLL 建立时间，同时作为收发切换时间
+ * NRF24_SIM_THREAD_STACK / NRF24_SIM_THREAD_PRIORITY : nrf24_sim node 加入的实例的射频线程，与 nrf24l01_task.c 一致
+ * NRF24_SIM_TIMER_NAME : 模型的事件定时器（hwtimer），按下一个发射阶段的时刻单次定时，IRQ 精确到 us；
+ *                        找不到该设备时模型只在 SPI 访问和每个 tick 推进，IRQ 落在 tick 边界
+ */
+#ifndef NRF24_USE_SIMULATOR
+#define NRF24_USE_SIMULATOR         0
+#endif
+#ifndef NRF24_SIM_NODES
+#define NRF24_SIM_NODES             2
+#endif
+#define NRF24_SIM_FIFO_DEPTH        3
+#define NRF24_SIM_TPLL_US           130
+#define NRF24_SIM_THREAD_STACK      4096
+#define NRF24_SIM_THREAD_PRIORITY   9
+#define NRF24_SIM_TIMER_NAME        "timer2"
+
+#if NRF24_SIM_NODES < 2
+#error "NRF24_SIM_NODES must be at least 2"
+#endif
+
+
+/***
+ * 对端节点的行为
+ * OFF    : 对端掉电，空口上没有应答
+ * SINK   : 对端为 PRX，收到即读走
+ * ECHO   : 对端为 PRX，把收到的数据原样装入 ACK 载荷回给驱动
+ * SOURCE : 对端为 PTX，按设定的包数和长度向驱动连续发送
+ */
+typedef enum
+{
+    NRF24_SIM_PEER_OFF = 0,
+    NRF24_SIM_PEER_SINK,
+    NRF24_SIM_PEER_ECHO,
+    NRF24_SIM_PEER_SOURCE,
+}nrf24_sim_peer_et;
+
+
+/***
+ * PTX 发射的阶段
+ * IDLE : 空闲，或 MAX_RT 未清除而停发
+ * DATA : 数据包在空中
+ * WAIT : 等待应答（ack_ok 表示应答能否收到）或等待自动重发延时
+ */
+typedef enum
+{
+    NRF24_SIM_TX_IDLE = 0,
+    NRF24_SIM_TX_DATA,
+    NRF24_SIM_TX_WAIT,
+}nrf24_sim_tx_state_et;
+
+
+/***
+ * FIFO 中的数据包
+ * PTX 的 TX FIFO 用 no_ack 区分 W_TX_PAYLOAD / W_TX_PAYLOAD_NOACK，
+ * PRX 的 TX FIFO 存放 ACK 载荷，pipe 为 W_ACK_PAYLOAD 指定的管道
+ */
+struct nRF24L01_SIM_PACKET
+{
+    rt_uint8_t len;
+    rt_uint8_t pipe;
+    rt_uint8_t no_ack;
+    rt_uint8_t data[32];
+};
+
+
+/***
+ * 单个芯片的模型
+ */
+struct nRF24L01_SIM_CHIP
+{
+    /* 单字节寄存器，STATUS / FIFO_STATUS / OBSERVE_TX 读出时由内部状态合成 */
+    rt_uint8_t reg[0x20];
+    rt_uint8_t rx_addr_p0[5];
+    rt_uint8_t rx_addr_p1[5];
+    rt_uint8_t tx_addr[5];
+    rt_uint8_t ce;
+
+    struct nRF24L01_SIM_PACKET tx_fifo[NRF24_SIM_FIFO_DEPTH];
+    rt_uint8_t tx_count;
+    rt_uint8_t tx_reuse;
+    struct nRF24L01_SIM_PACKET rx_fifo[NRF24_SIM_FIFO_DEPTH];
+    rt_uint8_t rx_count;
+
+    /* PTX 状态机：tx_state 非空闲时，event_us 为当前阶段结束的时刻 */
+    rt_uint8_t  tx_state;
+    rt_uint8_t  ack_ok;
+    rt_uint8_t  arc_cnt;
+    rt_uint8_t  plos_cnt;
+    rt_uint8_t  pid;
+    rt_uint64_t attempt_us;
+    rt_uint64_t event_us;
+    struct nRF24L01_SIM_PACKET ack;
+
+    /* PRX 按管道记录上一包的 PID 和校验，重发的同一包只应答不入 FIFO，并重发上一次的 ACK 载荷 */
+    rt_uint8_t  last_pid[6];
+    rt_uint16_t last_sum[6];
+    struct nRF24L01_SIM_PACKET last_ack[6];
+
+    rt_uint8_t  rpd;
+    rt_uint8_t  irq_line;
+
+    /* 占用该节点的驱动实例，RT_NULL 为内置的对端 */
+    struct nRF24L01_STRUCT *owner;
+};
+
+
+/***
+ * 虚拟空口
+ * 所有发射按先来先服务串行占用空口，不模拟碰撞；
+ * 丢包按百分比独立作用于数据包和应答包，latency_us 叠加在每个方向的传播上；
+ * 窄带干扰占据 jam_ch ± jam_width 个信道，这些信道上的数据包和应答包再按 jam_percent 丢失，RPD 也按同样的概率置位
+ */
+struct nRF24L01_SIM_ETHER
+{
+    struct nRF24L01_SIM_CHIP node[NRF24_SIM_NODES];
+
+    rt_uint8_t  loss_percent;
+    rt_uint32_t latency_us;
+    rt_uint8_t  jam_ch;
+    rt_uint8_t  jam_width;
+    rt_uint8_t  jam_percent;
+    rt_uint64_t now_us;
+    rt_uint64_t busy_until_us;
+    rt_uint64_t stat_start_us;
+    rt_uint64_t timer_us;           // 事件定时器到期的模型时间，0 表示未启动
+
+    rt_uint8_t  peer_mode;
+    rt_uint8_t  peer_len;
+    rt_uint32_t peer_remaining;
+
+    /* 统计 */
+    rt_uint32_t attempts;
+    rt_uint32_t data_lost;
+    rt_uint32_t ack_lost;
+    rt_uint32_t jam_lost;
+    rt_uint32_t no_receiver;
+    rt_uint32_t rx_full_drops;
+    rt_uint32_t duplicates;
+    rt_uint32_t delivered;
+    rt_uint64_t air_us;
+    rt_uint32_t peer_rx_packets;
+    rt_uint32_t peer_rx_bytes;
+    rt_uint32_t peer_tx_ok;
+    rt_uint32_t peer_tx_failed;
+};
+
+
+extern const struct nRF24L01_FUNC_OPS g_nrf24_sim_ops;
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_SIM_H_ */
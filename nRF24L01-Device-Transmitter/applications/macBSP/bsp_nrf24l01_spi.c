@@ -15,27 +15,59 @@
 
 //以下是SPI以及nRF24L01引脚配置相关的函数---------------------------------------------------------------------------------------------
 
-/* 宏定义SPI名称 */
-#define     nRF24_SPI_NAME    "nrf24_spi2"
-/* 宏定义SPI总线 */
-#define     nRF24_SPI_BUS     "spi2"
+/* radio0：SPI2（PB13/PB14/PB15），引脚与 CubeMX 工程一致 */
+const struct nRF24L01_HW_CFG g_nrf24_hw_radio0 = {
+    .spi_bus  = "spi2",
+    .spi_name = "nrf24_spi2",
+    .csn_port = nRF24L01_CSN_GPIO_Port,
+    .csn_pin  = nRF24L01_CSN_Pin,
+    .ce_port  = nRF24L01_CE_GPIO_Port,
+    .ce_pin   = nRF24L01_CE_Pin,
+    .irq_pin  = GET_PIN(C, 7),
+    .apb2     = 0,
+};
+
+#if NRF24_USE_DUAL_RADIO
+/* radio1：SPI1（PA5/PA6/PA7），CSN PA4，CE PC4，IRQ PC5 */
+const struct nRF24L01_HW_CFG g_nrf24_hw_radio1 = {
+    .spi_bus  = "spi1",
+    .spi_name = "nrf24_spi1",
+    .csn_port = GPIOA,
+    .csn_pin  = GPIO_PIN_4,
+    .ce_port  = GPIOC,
+    .ce_pin   = GPIO_PIN_4,
+    .irq_pin  = GET_PIN(C, 5),
+    .apb2     = 1,
+};
+#endif
 
 
 
 
 int nRF24L01_SPI_Init(nrf24_port_api_t port_api)
 {
+    const struct nRF24L01_HW_CFG *hw = port_api->hw;
+    GPIO_InitTypeDef gpio = {0};
+
     //--------------------------------------------------------------------------------------
+    /* CE 推挽输出并拉低；radio0 的 CE 已由 CubeMX 配置，这里对每个实例统一再配一次 */
+    HAL_GPIO_WritePin(hw->ce_port, hw->ce_pin, GPIO_PIN_RESET);
+    gpio.Pin   = hw->ce_pin;
+    gpio.Mode  = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull  = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(hw->ce_port, &gpio);
+
     /* 将SPI设备名挂载到总线 */
-    rt_hw_spi_device_attach(nRF24_SPI_BUS, nRF24_SPI_NAME, nRF24_NSS_PORT, nRF24_NSS_PIN);
+    rt_hw_spi_device_attach(hw->spi_bus, hw->spi_name, hw->csn_port, hw->csn_pin);
     /* 查找SPI设备 */
-    port_api->spi_dev_nrf24 = (struct rt_spi_device *)rt_device_find(nRF24_SPI_NAME);
+    port_api->spi_dev_nrf24 = (struct rt_spi_device *)rt_device_find(hw->spi_name);
     if(port_api->spi_dev_nrf24 == NULL){
-        LOG_E("LOG:%d. nRF24 spi device is not found!",Record.ulog_cnt++);
+        LOG_E("LOG:%d. nRF24 spi device %s is not found!",Record.ulog_cnt++, hw->spi_name);
         return RT_ERROR;
     }
     else{
-        LOG_I("LOG:%d. nRF24 spi device is successfully!",Record.ulog_cnt++);
+        LOG_I("LOG:%d. nRF24 spi device %s is successfully!",Record.ulog_cnt++, hw->spi_name);
     }
 
     /***
@@ -49,9 +81,10 @@ int nRF24L01_SPI_Init(nrf24_port_api_t port_api)
     struct rt_spi_configuration nrf24_spi_cfg;
 
     nrf24_spi_cfg.data_width = 8;
-    nrf24_spi_cfg.max_hz = 1*1000*1000; /* 10M,SPI max 10MHz,lora 4-wire spi */
+    nrf24_spi_cfg.max_hz = NRF24_SPI_DEFAULT_HZ; /* 先用保守速率，SPI max 10MHz 由 nRF24L01_SPI_Negotiate_Speed 协商 */
     nrf24_spi_cfg.mode = RT_SPI_MASTER | RT_SPI_MODE_0 | RT_SPI_MSB;
     rt_spi_configure(port_api->spi_dev_nrf24, &nrf24_spi_cfg); /* 使能参数 */
+    port_api->spi_hz = NRF24_SPI_DEFAULT_HZ;
 
     //--------------------------------------------------------------------------------------
 
@@ -60,16 +93,99 @@ int nRF24L01_SPI_Init(nrf24_port_api_t port_api)
 
 
 
+/**
+  * @brief  协商 SPI 时钟：从最慢的分频档开始逐档提速，每档连续做多图样回环写读，
+  *         锁定最快的可靠速率
+  * @note   SPI2 挂在 APB1 上，SPI1 挂在 APB2 上，可用速率为 PCLK / 2^n（n = 1~8），且不超过 NRF24_SPI_MAX_HZ；
+  *         某一档出现失败即停止提速，并在最后通过的速率上再回退 NRF24_SPI_MARGIN_STEPS 档作为余量，
+  *         若一直通过到 10MHz 上限，则上限本身就是手册保证的余量，不再回退
+  * @retval RT_EOK 成功  RT_ERROR 最慢的速率也无法通过（SPI 硬件链路有误）
+  */
+int nRF24L01_SPI_Negotiate_Speed(nrf24_t nrf24)
+{
+    rt_uint32_t pclk = nrf24->port_api.hw->apb2 ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    rt_uint32_t pass_hz[8];
+    rt_uint8_t  pass_cnt = 0;
+    rt_bool_t   failed = RT_FALSE;
+
+    for (rt_int8_t shift = 8; shift >= 1; shift--)
+    {
+        rt_uint32_t hz = pclk >> shift;
+        if (hz > NRF24_SPI_MAX_HZ){
+            break;
+        }
+
+        nrf24->nrf24_ops.nrf24_set_spi_hz(&nrf24->port_api, hz);
+        for (rt_uint8_t i = 0; i < NRF24_SPI_CHECK_ROUNDS; i++)
+        {
+            if (nRF24L01_Check_SPI_Community(nrf24) != RT_EOK){
+                failed = RT_TRUE;
+                break;
+            }
+        }
+        if (failed == RT_TRUE){
+            LOG_W("LOG:%d. nRF24 spi loopback failed at %d Hz.",Record.ulog_cnt++, hz);
+            break;
+        }
+        pass_hz[pass_cnt++] = hz;
+    }
+
+    if (pass_cnt == 0){
+        nrf24->nrf24_ops.nrf24_set_spi_hz(&nrf24->port_api, NRF24_SPI_DEFAULT_HZ);
+        return RT_ERROR;
+    }
+
+    if (failed == RT_TRUE){
+        pass_cnt = (pass_cnt > NRF24_SPI_MARGIN_STEPS) ? (pass_cnt - NRF24_SPI_MARGIN_STEPS) : 1;
+    }
+    nrf24->nrf24_ops.nrf24_set_spi_hz(&nrf24->port_api, pass_hz[pass_cnt - 1]);
+    LOG_I("LOG:%d. %s spi clock locked at %d Hz.",Record.ulog_cnt++, nrf24->name, nrf24->port_api.spi_hz);
+
+    return RT_EOK;
+}
+
+
+
+/***
+ * @brief msh 命令：查看当前 SPI 时钟，或重新协商
+ * @note  nrf24_spi            打印当前速率
+ *        nrf24_spi negotiate  重新协商（会短暂改写 RX_ADDR_P1 后恢复，建议在链路空闲时运行）
+ */
+static void nrf24_spi_cmd(int argc, char **argv)
+{
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+
+    if (argc > 1 && rt_strcmp(argv[1], "negotiate") == 0){
+        if (nRF24L01_SPI_Negotiate_Speed(_nrf24) != RT_EOK){
+            rt_kprintf("[nrf24] spi negotiate failed, fall back to %d Hz.\r\n", NRF24_SPI_DEFAULT_HZ);
+        }
+    }
+    if (_nrf24->port_api.hw->apb2){
+        rt_kprintf("[nrf24] spi clock = %d Hz (pclk2 = %d Hz)\r\n", _nrf24->port_api.spi_hz, HAL_RCC_GetPCLK2Freq());
+    }
+    else{
+        rt_kprintf("[nrf24] spi clock = %d Hz (pclk1 = %d Hz)\r\n", _nrf24->port_api.spi_hz, HAL_RCC_GetPCLK1Freq());
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_spi_cmd, nrf24_spi, show or renegotiate nrf24 spi clock [negotiate]);
+
+
+
 
 
 /**
   * @brief  nRF24L01 的IRQ引脚的中断回调函数(把入口挂载到这个里面)
+  * @param  args 产生中断的 nRF24L01 实例
   * @retval void
   */
 static void nRF24L01_INT_Callback(void *args)
 {
     rt_interrupt_enter();
-    rt_sem_release(nrf24_irq_sem);
+    nRF24L01_Debug_Mark_IRQ((nrf24_t)args);
+    nRF24L01_Wakeup((nrf24_t)args);
     rt_interrupt_leave();
 }
 
@@ -80,14 +196,18 @@ static void nRF24L01_INT_Callback(void *args)
   * @brief  nRF24L01 的中断引脚初始化
   * @retval void
   */
-int nRF24L01_IQR_GPIO_Config(nrf24_port_api_t port_api)
+int nRF24L01_IQR_GPIO_Config(nrf24_t nrf24)
 {
-    rt_pin_mode(GET_PIN(C, 7), PIN_MODE_INPUT);         /* 保险起见 */
-    rt_pin_attach_irq(  GET_PIN(C, 7),
-                        PIN_IRQ_MODE_FALLING,           /* 与 CubeMX 极性一致 */
-                        nRF24L01_INT_Callback,
-                        RT_NULL);                       /* 不需要参数 */
-    rt_pin_irq_enable(GET_PIN(C, 7), PIN_IRQ_ENABLE);
+    rt_base_t pin = nrf24->port_api.hw->irq_pin;
+
+    rt_pin_mode(pin, PIN_MODE_INPUT);                   /* 保险起见 */
+    if (rt_pin_attach_irq(  pin,
+                            PIN_IRQ_MODE_FALLING,       /* 与 CubeMX 极性一致 */
+                            nRF24L01_INT_Callback,
+                            nrf24) != RT_EOK){          /* 回调按参数找到实例 */
+        return RT_ERROR;
+    }
+    rt_pin_irq_enable(pin, PIN_IRQ_ENABLE);
     return RT_EOK;
 }
 
@@ -131,21 +251,45 @@ static int nrf24_write(nrf24_port_api_t port_api, const uint8_t *buf, uint8_t le
     return rt_spi_send(port_api->spi_dev_nrf24, buf, len);
 }
 
+/***
+ * 向 nRF24L01 全双工收发 len 字节数据，只占用一次片选
+ * nRF24L01 在指令字节期间移出 STATUS，因此 rbuf[0] 总是 STATUS
+ */
+static int nrf24_transfer(nrf24_port_api_t port_api, const uint8_t *tbuf, uint8_t *rbuf, uint8_t len)
+{
+    return rt_spi_transfer(port_api->spi_dev_nrf24, tbuf, rbuf, len);
+}
+
+/***
+ * 修改 SPI 时钟，drv_spi 会选取不超过 hz 的最快分频档
+ */
+static int nrf24_set_spi_hz(nrf24_port_api_t port_api, rt_uint32_t hz)
+{
+    struct rt_spi_configuration nrf24_spi_cfg;
+
+    nrf24_spi_cfg.data_width = 8;
+    nrf24_spi_cfg.max_hz = hz;
+    nrf24_spi_cfg.mode = RT_SPI_MASTER | RT_SPI_MODE_0 | RT_SPI_MSB;
+    port_api->spi_hz = hz;
+
+    return rt_spi_configure(port_api->spi_dev_nrf24, &nrf24_spi_cfg);
+}
+
 /***
  * 拉高nRF24L01的CE引脚
  */
-static int nrf24_set_ce(void)
+static int nrf24_set_ce(nrf24_port_api_t port_api)
 {
-    nRF24_CS_SET(1);
+    nRF24_CE_SET(port_api->hw, 1);
     return RT_EOK;
 }
 
 /***
  * 拉低nRF24L01的CE引脚
  */
-static int nrf24_reset_ce(void)
+static int nrf24_reset_ce(nrf24_port_api_t port_api)
 {
-    nRF24_CS_SET(0);
+    nRF24_CE_SET(port_api->hw, 0);
     return RT_EOK;
 }
 
@@ -154,6 +298,8 @@ const struct nRF24L01_FUNC_OPS g_nrf24_func_ops = {
     .nrf24_send_then_recv = nrf24_send_then_recv,
     .nrf24_send_then_send = nrf24_send_then_send,
     .nrf24_write = nrf24_write,
+    .nrf24_transfer = nrf24_transfer,
+    .nrf24_set_spi_hz = nrf24_set_spi_hz,
     .nrf24_set_ce = nrf24_set_ce,
     .nrf24_reset_ce = nrf24_reset_ce,
 };
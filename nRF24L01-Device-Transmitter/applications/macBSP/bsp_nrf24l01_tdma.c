@@ -0,0 +1,590 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-21     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_tdma.h"
+
+
+#if defined(RT_USING_HWTIMER) && (NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0)
+/* 占用时隙定时器的实例 */
+static nrf24_t tdma_nrf24 = RT_NULL;
+#endif
+
+
+
+#if NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0
+static rt_uint32_t nRF24L01_Tdma_Us_To_Cycles(rt_uint32_t us)
+{
+    return us * (SystemCoreClock / 1000000U);
+}
+
+
+#if NRF24_TDMA_NODE_ID != 0
+/***
+ * @brief   一包 32 字节数据从 CE 拉高到收到自动应答的时间，CE 至少提前这么久拉低，最后一包才能在时隙内发完
+ */
+static rt_uint32_t nRF24L01_Tdma_Exchange_Us(nrf24_t nrf24)
+{
+    return 2 * NRF24_TURN_SETTLE_US + nRF24L01_Air_Us(&nrf24->nrf24_cfg, 32) + nRF24L01_Air_Us(&nrf24->nrf24_cfg, 0);
+}
+#endif
+
+
+static void nRF24L01_Tdma_Arm(nrf24_t nrf24, rt_uint8_t action, rt_uint32_t at_cycles);
+
+/***
+ * @brief   定时器到期，运行在中断上下文
+ * @note    CE 只是一次 GPIO 写，直接在中断里完成，时隙边界不受线程调度影响；需要 SPI 的工作交回射频线程
+ */
+static void nRF24L01_Tdma_Fire(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_uint32_t now = nRF24L01_Debug_Get_Cycles();
+    rt_int32_t late = (rt_int32_t)(now - tdma->timer_at_cycles);
+
+    if(tdma->edges == 0 || late < tdma->late_min){
+        tdma->late_min = late;
+    }
+    if(tdma->edges == 0 || late > tdma->late_max){
+        tdma->late_max = late;
+    }
+    tdma->late_sum += late;
+    tdma->edges++;
+
+    switch(tdma->timer_action)
+    {
+    case NRF24_TDMA_TIMER_SLOT_START:
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        tdma->state = NRF24_TDMA_IN_SLOT;
+        nRF24L01_Tdma_Arm(nrf24, NRF24_TDMA_TIMER_CE_LOW, tdma->ce_low_cycles);
+        break;
+    case NRF24_TDMA_TIMER_CE_LOW:
+        nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+        tdma->state = NRF24_TDMA_DRAIN;
+        nRF24L01_Tdma_Arm(nrf24, NRF24_TDMA_TIMER_FINISH, tdma->finish_cycles);
+        break;
+    case NRF24_TDMA_TIMER_JOIN:
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        tdma->state = NRF24_TDMA_JOIN_TX;
+        break;
+    case NRF24_TDMA_TIMER_BEACON:
+        tdma->timer_at_cycles = now + nRF24L01_Tdma_Us_To_Cycles(NRF24_TDMA_SUPERFRAME_US);
+        tdma->due = 1;
+        nRF24L01_Wakeup(nrf24);
+        break;
+    default:
+        tdma->due = 1;
+        nRF24L01_Wakeup(nrf24);
+        break;
+    }
+}
+
+
+#ifdef RT_USING_HWTIMER
+static rt_err_t nRF24L01_Tdma_Timer_Isr(rt_device_t dev, rt_size_t size)
+{
+    if(tdma_nrf24 != RT_NULL){
+        nRF24L01_Tdma_Fire(tdma_nrf24);
+    }
+    return RT_EOK;
+}
+#endif
+
+
+static void nRF24L01_Tdma_Soft_Timeout(void *parameter)
+{
+    nRF24L01_Tdma_Fire((nrf24_t)parameter);
+}
+
+
+/***
+ * @brief   在 DWT 计数到达 at_cycles 时执行 action，已经过了则尽快执行
+ * @note    中心的 BEACON 为周期定时，只在初始化时启动一次
+ */
+static void nRF24L01_Tdma_Arm(nrf24_t nrf24, rt_uint8_t action, rt_uint32_t at_cycles)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_int32_t left = (rt_int32_t)(at_cycles - nRF24L01_Debug_Get_Cycles());
+    rt_uint32_t us = (left > 0) ? nRF24L01_Debug_Cycles_To_Us(left) : 1;
+    rt_tick_t ticks;
+
+    tdma->timer_action = action;
+    tdma->timer_at_cycles = at_cycles;
+
+#ifdef RT_USING_HWTIMER
+    if(tdma->timer != RT_NULL){
+        rt_hwtimerval_t tv;
+        tv.sec  = us / 1000000;
+        tv.usec = (us % 1000000) ? (us % 1000000) : 1;
+        if(rt_device_write(tdma->timer, 0, &tv, sizeof(tv)) == sizeof(tv)){
+            return;
+        }
+    }
+#endif
+
+    ticks = ((rt_uint64_t)us * RT_TICK_PER_SECOND + 999999) / 1000000;
+    rt_timer_control(&tdma->soft_timer, RT_TIMER_CTRL_SET_TIME, &ticks);
+    rt_timer_start(&tdma->soft_timer);
+}
+#endif
+
+
+/***
+ * @brief   节点回到 PRX 监听信标
+ * @note    监听时关闭管道 0：其它节点发给中心的数据也是这个地址，节点不能抢着回自动应答
+ */
+static void nRF24L01_Tdma_Listen(nrf24_t nrf24)
+{
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nrf24->nrf24_cfg.en_rxaddr.p0 = RT_FALSE;
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
+    nRF24L01_Set_Role_Mode(nrf24, ROLE_PRX);
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+    nrf24->tdma.state = NRF24_TDMA_LISTEN;
+}
+
+
+#if NRF24_TDMA_NODE_ID != 0
+/***
+ * @brief   节点切换为 PTX，CE 保持低电平直到定时器拉高
+ */
+static void nRF24L01_Tdma_Enter_PTX(nrf24_t nrf24)
+{
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nrf24->nrf24_cfg.en_rxaddr.p0 = RT_TRUE;
+    nRF24L01_Shadow_Stage(nrf24);
+    nRF24L01_Shadow_Flush(nrf24);
+    nRF24L01_Set_Role_Mode(nrf24, ROLE_PTX);
+}
+#endif
+
+
+#if NRF24_TDMA_HUB
+/***
+ * @brief   中心：收回长时间没有数据的时隙，广播信标
+ * @note    TX FIFO 中可能有给节点的 ACK 载荷，切换为 PTX 前必须清掉，否则会被当作普通数据包发出
+ */
+static void nRF24L01_Tdma_Send_Beacon(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_uint8_t beacon[NRF24_TDMA_BEACON_HEADER + NRF24_TDMA_SLOTS];
+
+    tdma->superframes++;
+    for(rt_uint8_t i = 0; i < NRF24_TDMA_SLOTS; i++){
+        if(tdma->owner[i] != 0 && tdma->superframes - tdma->seen[i] > NRF24_TDMA_EXPIRE){
+            LOG_I("LOG:%d. nrf24 tdma slot %d of node %d expired.",Record.ulog_cnt++, i, tdma->owner[i]);
+            tdma->owner[i] = 0;
+            tdma->expired++;
+        }
+    }
+
+    beacon[0] = NRF24_TDMA_MARK | NRF24_TDMA_BEACON;
+    beacon[1] = ++tdma->seq;
+    beacon[2] = NRF24_TDMA_SLOTS;
+    beacon[3] = NRF24_TDMA_SLOT_US & 0xFF;
+    beacon[4] = NRF24_TDMA_SLOT_US >> 8;
+    beacon[5] = NRF24_TDMA_JOIN_US & 0xFF;
+    beacon[6] = NRF24_TDMA_JOIN_US >> 8;
+    rt_memcpy(&beacon[NRF24_TDMA_BEACON_HEADER], tdma->owner, NRF24_TDMA_SLOTS);
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    nRF24L01_Set_Role_Mode(nrf24, ROLE_PTX);
+    nRF24L01_Write_Tx_Payload_NoAck(nrf24, beacon, sizeof(beacon));
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+    tdma->state = NRF24_TDMA_BEACON_TX;
+}
+#endif
+
+
+#if NRF24_TDMA_NODE_ID != 0
+/***
+ * @brief   节点：按信标安排本超帧的时隙，或在竞争时隙中申请时隙
+ * @param   t0 收到信标的 IRQ 时刻，时隙 i 从 t0 + BEACON_US + i * slot_us 开始
+ */
+static void nRF24L01_Tdma_Schedule(nrf24_t nrf24, const uint8_t *data, rt_uint32_t t0)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_uint8_t slots = data[2];
+    rt_uint32_t slot_us = data[3] | (data[4] << 8);
+    rt_uint32_t join_us = data[5] | (data[6] << 8);
+    rt_uint32_t exchange_us = nRF24L01_Tdma_Exchange_Us(nrf24);
+    rt_uint32_t start;
+    rt_uint8_t frame[2] = { 0, NRF24_TDMA_NODE_ID };
+
+    tdma->my_slot = -1;
+    for(rt_uint8_t i = 0; i < slots; i++){
+        if(data[NRF24_TDMA_BEACON_HEADER + i] == NRF24_TDMA_NODE_ID){
+            tdma->my_slot = i;
+            break;
+        }
+    }
+
+    // 1. 有时隙：CE 在时隙开始 + 保护时间拉高，在结束 - 保护时间 - 一包交换时间拉低，结束 - 保护时间回到监听
+    if(tdma->my_slot >= 0)
+    {
+        if(slot_us <= 2 * NRF24_TDMA_GUARD_US + exchange_us){
+            return;
+        }
+        start = t0 + nRF24L01_Tdma_Us_To_Cycles(NRF24_TDMA_BEACON_US + tdma->my_slot * slot_us);
+        tdma->ce_low_cycles = start + nRF24L01_Tdma_Us_To_Cycles(slot_us - NRF24_TDMA_GUARD_US - exchange_us);
+        tdma->finish_cycles = start + nRF24L01_Tdma_Us_To_Cycles(slot_us - NRF24_TDMA_GUARD_US);
+
+        nRF24L01_Tdma_Enter_PTX(nrf24);
+        tdma->state = NRF24_TDMA_WAIT_SLOT;
+        if(nrf24->tx_queue.put == nrf24->tx_queue.done){
+            frame[0] = NRF24_TDMA_MARK | NRF24_TDMA_KEEP;
+            nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, sizeof(frame));
+            tdma->keep_inflight = 1;
+        }
+        nRF24L01_Tdma_Arm(nrf24, NRF24_TDMA_TIMER_SLOT_START, start + nRF24L01_Tdma_Us_To_Cycles(NRF24_TDMA_GUARD_US));
+        return;
+    }
+
+    // 2. 没有时隙：在竞争时隙前半段随机退避后发 JOIN，后半段留给最后一包和中心发下一个信标前的切换
+    if(join_us > 2 * NRF24_TDMA_GUARD_US + exchange_us)
+    {
+        tdma->rand = tdma->rand * 1103515245 + 12345;
+        start = t0 + nRF24L01_Tdma_Us_To_Cycles(NRF24_TDMA_BEACON_US + slots * slot_us + NRF24_TDMA_GUARD_US
+                                                + (tdma->rand >> 8) % (join_us / 2));
+        nRF24L01_Tdma_Enter_PTX(nrf24);
+        frame[0] = NRF24_TDMA_MARK | NRF24_TDMA_JOIN;
+        nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, sizeof(frame));
+        tdma->state = NRF24_TDMA_JOIN_WAIT;
+        tdma->join_sent++;
+        nRF24L01_Tdma_Arm(nrf24, NRF24_TDMA_TIMER_JOIN, start);
+    }
+}
+#endif
+
+
+#if NRF24_TDMA_HUB
+/***
+ * @brief   中心：按收到数据的 IRQ 时刻推算所在时隙，刷新该时隙的存活时间
+ */
+static void nRF24L01_Tdma_Account(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_uint32_t offset = nRF24L01_Debug_Cycles_To_Us(nrf24->latency.irq_cycles - tdma->beacon_cycles);
+    rt_uint32_t slot;
+
+    if(offset >= NRF24_TDMA_BEACON_US){
+        slot = (offset - NRF24_TDMA_BEACON_US) / NRF24_TDMA_SLOT_US;
+        if(slot < NRF24_TDMA_SLOTS && tdma->owner[slot] != 0){
+            tdma->slot_rx[slot]++;
+            tdma->seen[slot] = tdma->superframes;
+            return;
+        }
+    }
+    tdma->outside++;
+}
+
+
+/***
+ * @brief   中心：找到节点的时隙，没有则分配一个空闲时隙
+ */
+static void nRF24L01_Tdma_Assign(struct nRF24L01_TDMA_STRUCT *tdma, rt_uint8_t id)
+{
+    rt_int8_t free = -1;
+
+    for(rt_uint8_t i = 0; i < NRF24_TDMA_SLOTS; i++){
+        if(tdma->owner[i] == id){
+            tdma->seen[i] = tdma->superframes;
+            return;
+        }
+        if(tdma->owner[i] == 0 && free < 0){
+            free = i;
+        }
+    }
+    if(free >= 0){
+        tdma->owner[free] = id;
+        tdma->seen[free]  = tdma->superframes;
+        tdma->joins++;
+        LOG_I("LOG:%d. nrf24 tdma slot %d assigned to node %d.",Record.ulog_cnt++, free, id);
+    }
+}
+#endif
+
+
+
+/***
+ * @brief   初始化 TDMA：打开时隙定时器，中心立即开始周期发信标，节点在射频线程第一次运行时开始监听
+ */
+void nRF24L01_Tdma_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+
+    rt_memset(tdma, 0, sizeof(struct nRF24L01_TDMA_STRUCT));
+    tdma->my_slot = -1;
+    tdma->rand = NRF24_TDMA_NODE_ID * 2654435761UL ^ nRF24L01_Debug_Get_Cycles();
+
+#if NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0
+    rt_timer_init(&tdma->soft_timer, "nrf24_tdma", nRF24L01_Tdma_Soft_Timeout, nrf24, 1,
+                  NRF24_TDMA_HUB ? RT_TIMER_FLAG_PERIODIC : RT_TIMER_FLAG_ONE_SHOT);
+
+#ifdef RT_USING_HWTIMER
+    /* 时隙定时器只有一个，归第一个初始化的实例，其余实例用软件定时器 */
+    tdma->timer = (tdma_nrf24 == RT_NULL) ? rt_device_find(NRF24_TDMA_TIMER_NAME) : RT_NULL;
+    if(tdma->timer != RT_NULL){
+        rt_hwtimer_mode_t mode = NRF24_TDMA_HUB ? HWTIMER_MODE_PERIOD : HWTIMER_MODE_ONESHOT;
+        rt_uint32_t freq = NRF24_TDMA_TIMER_HZ;
+
+        if(rt_device_open(tdma->timer, RT_DEVICE_OFLAG_RDWR) != RT_EOK){
+            tdma->timer = RT_NULL;
+        }
+        else if(rt_device_control(tdma->timer, HWTIMER_CTRL_FREQ_SET, &freq) != RT_EOK ||
+                rt_device_control(tdma->timer, HWTIMER_CTRL_MODE_SET, &mode) != RT_EOK){
+            rt_device_close(tdma->timer);
+            tdma->timer = RT_NULL;
+        }
+        else{
+            tdma_nrf24 = nrf24;
+            rt_device_set_rx_indicate(tdma->timer, nRF24L01_Tdma_Timer_Isr);
+        }
+    }
+#endif
+
+    if(tdma->timer == RT_NULL){
+        LOG_W("LOG:%d. nrf24 tdma without hwtimer, slot edges have tick resolution.",Record.ulog_cnt++);
+    }
+    LOG_I("LOG:%d. nrf24 tdma %s, %d slots x %dus, superframe %dus.",Record.ulog_cnt++,
+          NRF24_TDMA_HUB ? "hub" : "node", NRF24_TDMA_SLOTS, NRF24_TDMA_SLOT_US, NRF24_TDMA_SUPERFRAME_US);
+#endif
+
+#if NRF24_TDMA_HUB
+    nRF24L01_Tdma_Arm(nrf24, NRF24_TDMA_TIMER_BEACON,
+                      nRF24L01_Debug_Get_Cycles() + nRF24L01_Tdma_Us_To_Cycles(NRF24_TDMA_SUPERFRAME_US));
+#endif
+}
+
+
+/***
+ * @brief   处理收到的 TDMA 报文；中心顺带按时刻统计各时隙的数据
+ * @return  1 : TDMA 报文，已处理   0 : 其它数据，由调用者继续处理
+ */
+int nRF24L01_Tdma_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+    rt_uint8_t type;
+
+    if(len < 2 || (data[0] & NRF24_TDMA_MARK_MASK) != NRF24_TDMA_MARK){
+#if NRF24_TDMA_HUB
+        if(pipe == NRF24_PIPE_0){
+            nRF24L01_Tdma_Account(nrf24);
+        }
+#endif
+        return 0;
+    }
+    type = data[0] & NRF24_TDMA_TYPE_MASK;
+
+#if NRF24_TDMA_HUB
+    if(type == NRF24_TDMA_JOIN || type == NRF24_TDMA_KEEP){
+        if(data[1] != 0){
+            nRF24L01_Tdma_Assign(tdma, data[1]);
+        }
+    }
+#elif NRF24_TDMA_NODE_ID != 0
+    // 信标结束时刻就是 RX_DR 的 IRQ 时刻，线程的调度延时不影响时隙对齐
+    if(type == NRF24_TDMA_BEACON && pipe == NRF24_PIPE_1 && len >= NRF24_TDMA_BEACON_HEADER
+       && len >= NRF24_TDMA_BEACON_HEADER + data[2] && tdma->state == NRF24_TDMA_LISTEN)
+    {
+        if(tdma->beacons != 0){
+            tdma->beacons_lost += (rt_uint8_t)(data[1] - tdma->seq - 1);
+        }
+        tdma->seq = data[1];
+        tdma->beacons++;
+        tdma->beacon_cycles = nrf24->latency.irq_cycles;
+        nRF24L01_Tdma_Schedule(nrf24, data, tdma->beacon_cycles);
+    }
+#else
+    // 没有启用 TDMA，标记范围内的包按普通数据交给应用
+    RT_UNUSED(tdma);
+    RT_UNUSED(type);
+    return 0;
+#endif
+
+    return 1;
+}
+
+
+/***
+ * @brief   TDMA 自己发出的包的 TX_DS / MAX_RT：信标、JOIN、保活
+ * @return  1 : 已处理   0 : 时隙内的普通数据，交给软件发送队列
+ */
+int nRF24L01_Tdma_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+
+    // 1. 中心：信标发完立即回到 PRX，记下时刻用于推算各时隙
+    if(tdma->state == NRF24_TDMA_BEACON_TX)
+    {
+        tdma->beacon_cycles = nrf24->latency.irq_cycles;
+        nRF24L01_Set_Role_Mode(nrf24, ROLE_PRX);
+        tdma->state = NRF24_TDMA_IDLE;
+        return 1;
+    }
+
+    // 2. 节点：JOIN 成功与否都回到监听，分配结果看下一个信标
+    if(tdma->state == NRF24_TDMA_JOIN_TX || tdma->state == NRF24_TDMA_JOIN_WAIT)
+    {
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+        }
+        nRF24L01_Tdma_Listen(nrf24);
+        return 1;
+    }
+
+    // 3. 节点：保活包
+    if(tdma->keep_inflight)
+    {
+        tdma->keep_inflight = 0;
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/***
+ * @brief   推进 TDMA，在射频线程中调用
+ * @note    中心：信标定时到期后发信标
+ *          节点：第一次运行时开始监听；时隙结束后放弃没发完的包（留在软件队列下个超帧再发），回到监听
+ */
+void nRF24L01_Tdma_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+
+#if NRF24_TDMA_HUB
+    if(tdma->due && tdma->state == NRF24_TDMA_IDLE && nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX && !nRF24L01_Turn_Busy(nrf24)){
+        tdma->due = 0;
+        nRF24L01_Tdma_Send_Beacon(nrf24);
+    }
+#elif NRF24_TDMA_NODE_ID != 0
+    if(tdma->state == NRF24_TDMA_IDLE){
+        nRF24L01_Tdma_Listen(nrf24);
+        return;
+    }
+    if(tdma->due && tdma->state == NRF24_TDMA_DRAIN)
+    {
+        // 还有 TX_DS / MAX_RT 没处理时先交给发送队列统计，下一轮循环再收尾
+        if(nRF24L01_Read_Status_Register(nrf24) & (NRF24BITMASK_TX_DS | NRF24BITMASK_MAX_RT)){
+            return;
+        }
+        tdma->due = 0;
+        tdma->keep_inflight = 0;
+        tdma->slots_used++;
+        nRF24L01_TxQueue_Rewind(nrf24);
+        nRF24L01_Tdma_Listen(nrf24);
+    }
+#else
+    RT_UNUSED(tdma);
+#endif
+}
+
+
+/***
+ * @brief   现在能否把软件队列中的数据写入芯片
+ * @note    节点只在自己的时隙（含时隙开始前的预装）内且没有保活包在途时可以；中心发信标期间不可以
+ */
+rt_bool_t nRF24L01_Tdma_Tx_Allowed(nrf24_t nrf24)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma = &nrf24->tdma;
+
+#if NRF24_TDMA_NODE_ID != 0
+    return ((tdma->state == NRF24_TDMA_WAIT_SLOT || tdma->state == NRF24_TDMA_IN_SLOT) && !tdma->keep_inflight) ? RT_TRUE : RT_FALSE;
+#else
+    return (tdma->state != NRF24_TDMA_BEACON_TX) ? RT_TRUE : RT_FALSE;
+#endif
+}
+
+
+/***
+ * @brief   射频线程等待 IRQ 信号量的超时：其余时刻都由定时器唤醒
+ */
+rt_int32_t nRF24L01_Tdma_Next_Timeout(nrf24_t nrf24)
+{
+#if NRF24_TDMA_NODE_ID != 0
+    if(nrf24->tdma.state == NRF24_TDMA_IDLE){
+        return 1;
+    }
+#endif
+    return nrf24->tdma.due ? 1 : RT_WAITING_FOREVER;
+}
+
+
+
+/***
+ * @brief msh 命令：TDMA 状态
+ * @note  nrf24_tdma                打印时隙表和统计
+ *        nrf24_tdma free <slot>    中心：立即收回时隙
+ *        nrf24_tdma reset          清零统计
+ */
+static void nrf24_tdma_cmd(int argc, char **argv)
+{
+    struct nRF24L01_TDMA_STRUCT *tdma;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    tdma = &_nrf24->tdma;
+
+    if (argc > 2 && rt_strcmp(argv[1], "free") == 0)
+    {
+        rt_uint8_t slot = atoi(argv[2]);
+        if (slot < NRF24_TDMA_SLOTS){
+            tdma->owner[slot] = 0;
+        }
+    }
+    else if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        rt_memset(tdma->slot_rx, 0, sizeof(tdma->slot_rx));
+        tdma->outside = tdma->joins = tdma->expired = 0;
+        tdma->beacons = tdma->beacons_lost = tdma->slots_used = tdma->join_sent = 0;
+        tdma->edges = 0;
+        tdma->late_sum = 0;
+        rt_exit_critical();
+    }
+
+#if NRF24_TDMA_HUB
+    rt_kprintf("[nrf24] tdma hub: %d slots x %dus, superframe %dus, %s\r\n", NRF24_TDMA_SLOTS, NRF24_TDMA_SLOT_US,
+               NRF24_TDMA_SUPERFRAME_US, (tdma->timer != RT_NULL) ? NRF24_TDMA_TIMER_NAME : "rt_timer");
+    rt_kprintf("  %d superframes, %d joins, %d expired, %d packets outside slots\r\n",
+               tdma->superframes, tdma->joins, tdma->expired, tdma->outside);
+    rt_kprintf("  slot node  packets  idle(superframes)\r\n");
+    for (rt_uint8_t i = 0; i < NRF24_TDMA_SLOTS; i++)
+    {
+        if (tdma->owner[i] != 0){
+            rt_kprintf("  %4d %4d %8d %8d\r\n", i, tdma->owner[i], tdma->slot_rx[i], tdma->superframes - tdma->seen[i]);
+        }
+        else{
+            rt_kprintf("  %4d    -\r\n", i);
+        }
+    }
+#elif NRF24_TDMA_NODE_ID != 0
+    rt_kprintf("[nrf24] tdma node %d: slot %d, state %d, %s\r\n", NRF24_TDMA_NODE_ID, tdma->my_slot, tdma->state,
+               (tdma->timer != RT_NULL) ? NRF24_TDMA_TIMER_NAME : "rt_timer");
+    rt_kprintf("  %d beacons, %d lost, %d slots used, %d joins sent\r\n",
+               tdma->beacons, tdma->beacons_lost, tdma->slots_used, tdma->join_sent);
+#else
+    rt_kprintf("[nrf24] tdma off.\r\n");
+#endif
+#if NRF24_TDMA_HUB || NRF24_TDMA_NODE_ID != 0
+    if (tdma->edges != 0){
+        rt_kprintf("  timer edges %d, late min %d, avg %d, max %d cycles (%d cycles/us)\r\n", tdma->edges, tdma->late_min,
+                   (rt_int32_t)(tdma->late_sum / (rt_int32_t)tdma->edges), tdma->late_max, SystemCoreClock / 1000000U);
+    }
+#endif
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_tdma_cmd, nrf24_tdma, tdma superframe slot table and stats [free <slot> | reset]);
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-26     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_TRACE_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_TRACE_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 二进制跟踪
+ * 启用后应用层的 LOG_E/W/I/D 不再在 MCU 上格式化，每个调用点只写一条紧凑记录：
+ * 格式串本身放进 .nrf24_trace 段，链接脚本把该段定位在地址 0 且不装入 Flash（INFO），
+ * 格式串的地址即记录中的编号；参数按 32 位原样拷贝，时间戳为 DWT 周期计数；
+ * 记录先进入 RAM 环形缓冲，由低优先级线程定时整块写到 NRF24_TRACE_DEVICE，
+ * PC 端 tools/nrf24_trace.py 从 ELF 的 .nrf24_trace 段取回格式串还原文本，%s 参数按地址从 ELF 中读取
+ *
+ * NRF24_TRACE_BINARY   : 1 启用二进制跟踪，0 保持 ulog 文本输出
+ * NRF24_TRACE_DEVICE   : 输出设备，为控制台时跟踪记录与 msh 文本混在一起，解码工具会把帧以外的字节原样当作文本输出
+ * NRF24_TRACE_RING_SIZE: 环形缓冲字节数，必须为 2 的幂；写满时丢弃新记录并计数，不阻塞
+ * NRF24_TRACE_FLUSH_MS : 输出线程的轮询周期，生产者不发信号量，热路径上只有一次短暂关中断
+ * NRF24_TRACE_MAX_ARGS : 每条记录最多的参数个数（不超过 14，0xF 留给十六进制数据），只支持 32 位以内的整数和指针参数
+ */
+#define NRF24_TRACE_BINARY          0
+#define NRF24_TRACE_DEVICE          RT_CONSOLE_DEVICE_NAME
+#define NRF24_TRACE_RING_SIZE       2048
+#define NRF24_TRACE_FLUSH_MS        10
+#define NRF24_TRACE_THREAD_PRIORITY 29
+#define NRF24_TRACE_MAX_ARGS        12
+
+#if (NRF24_TRACE_RING_SIZE & (NRF24_TRACE_RING_SIZE - 1)) != 0
+#error "NRF24_TRACE_RING_SIZE must be a power of 2"
+#endif
+
+
+/***
+ * 记录格式（小端）
+ * byte0      : 帧头 NRF24_TRACE_SYNC
+ * byte1      : 高 4 位 级别（与 ulog 相同：3 E  4 W  6 I  7 D）  低 4 位 参数个数，NRF24_TRACE_HEX 为十六进制数据
+ * byte2~3    : 编号，即格式串在 .nrf24_trace 段中的地址；为 0 时是跟踪自身的丢弃报告，参数为丢弃的条数
+ * byte4~7    : DWT 周期计数
+ * 参数       : 每个 4 字节；十六进制数据为 名称地址(4) + 长度(1) + 数据
+ * 最后 1 字节: 从 byte1 起所有字节的累加和
+ */
+#define NRF24_TRACE_SYNC            0xA5
+#define NRF24_TRACE_HEADER_SIZE     8
+#define NRF24_TRACE_HEX             0x0F
+#define NRF24_TRACE_ID_DROP         0
+
+#define NRF24_TRACE_LVL_E           3
+#define NRF24_TRACE_LVL_W           4
+#define NRF24_TRACE_LVL_I           6
+#define NRF24_TRACE_LVL_D           7
+
+
+/***
+ * 跟踪统计
+ */
+struct nRF24L01_TRACE_STRUCT
+{
+    rt_uint8_t  ring[NRF24_TRACE_RING_SIZE];
+    /* 自由递增的写 / 读下标 */
+    volatile rt_uint32_t head;
+    volatile rt_uint32_t tail;
+    /* 运行时级别，高于该级别的记录直接丢弃 */
+    rt_uint8_t  level;
+
+    rt_uint32_t records;
+    rt_uint32_t bytes;
+    rt_uint32_t drops;
+    rt_uint32_t drops_reported;
+    rt_uint32_t high_water;
+};
+
+extern struct nRF24L01_TRACE_STRUCT nrf24_trace;
+
+
+// 函数声明 -------------------------------------------------------------------
+void nRF24L01_Trace_Write(rt_uint8_t level, const char *fmt, rt_uint8_t nargs, ...);
+void nRF24L01_Trace_Hex(const char *name, const rt_uint8_t *buf, rt_uint8_t len);
+
+
+#if NRF24_TRACE_BINARY
+
+/* 参数个数，最多 NRF24_TRACE_MAX_ARGS 个 */
+#define NRF24_TRACE_NARGS(...)      NRF24_TRACE_NARGS_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define NRF24_TRACE_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, N, ...)  N
+
+/* 每个调用点一份格式串，只进 .nrf24_trace 段，不占 Flash */
+#define NRF24_TRACE(level, fmt, ...)                                                                  \
+    do {                                                                                              \
+        static const char nrf24_trace_fmt[] __attribute__((section(".nrf24_trace"), used)) = fmt;     \
+        nRF24L01_Trace_Write((level), nrf24_trace_fmt, NRF24_TRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__); \
+    } while(0)
+
+#undef LOG_E
+#undef LOG_W
+#undef LOG_I
+#undef LOG_D
+#undef LOG_HEX
+#define LOG_E(...)                  NRF24_TRACE(NRF24_TRACE_LVL_E, __VA_ARGS__)
+#define LOG_W(...)                  NRF24_TRACE(NRF24_TRACE_LVL_W, __VA_ARGS__)
+#define LOG_I(...)                  NRF24_TRACE(NRF24_TRACE_LVL_I, __VA_ARGS__)
+#define LOG_D(...)                  NRF24_TRACE(NRF24_TRACE_LVL_D, __VA_ARGS__)
+#define LOG_HEX(name, width, buf, size)     nRF24L01_Trace_Hex((name), (buf), (size))
+
+#endif /* NRF24_TRACE_BINARY */
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_TRACE_H_ */
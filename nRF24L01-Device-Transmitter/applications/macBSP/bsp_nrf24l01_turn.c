@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-18     Administrator       the first version
+ */
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_turn.h"
+
+
+#ifdef RT_USING_HWTIMER
+/* 占用硬件定时器的实例，定时器中断里要操作它 */
+static nrf24_t turn_nrf24 = RT_NULL;
+#endif
+
+
+
+static rt_uint32_t nRF24L01_Turn_Us_To_Cycles(rt_uint32_t us)
+{
+    return us * (SystemCoreClock / 1000000U);
+}
+
+
+#ifdef RT_USING_HWTIMER
+/***
+ * @brief   硬件定时器到期回调，运行在中断上下文
+ * @note    CE 只是一次 GPIO 写，可以直接在中断里完成；其余工作需要 SPI，交回射频线程
+ */
+static rt_err_t nRF24L01_Turn_Timer_Isr(rt_device_t dev, rt_size_t size)
+{
+    struct nRF24L01_TURN_STRUCT *turn;
+
+    if(turn_nrf24 == RT_NULL){
+        return RT_EOK;
+    }
+    turn = &turn_nrf24->turn;
+
+    if(turn->timer_action == NRF24_TURN_TIMER_CE_LOW){
+        turn_nrf24->nrf24_ops.nrf24_reset_ce(&turn_nrf24->port_api);
+    }
+    else{
+        turn->expired = 1;
+        nRF24L01_Wakeup(turn_nrf24);
+    }
+
+    return RT_EOK;
+}
+#endif
+
+
+/***
+ * @brief   启动一次微秒级定时，到期后执行 action
+ * @note    没有硬件定时器时，CE 脉冲在这里忙等结束，WAKE 由 nRF24L01_Turn_Expired 比较 DWT 计数得出
+ */
+static void nRF24L01_Turn_Arm(nrf24_t nrf24, rt_uint8_t action, rt_uint32_t us)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+
+    turn->expired = 0;
+    turn->timer_action = action;
+    turn->deadline_cycles = nRF24L01_Debug_Get_Cycles() + nRF24L01_Turn_Us_To_Cycles(us);
+
+#ifdef RT_USING_HWTIMER
+    if(turn->timer != RT_NULL){
+        rt_hwtimerval_t tv;
+        tv.sec  = us / 1000000;
+        tv.usec = us % 1000000;
+        if(rt_device_write(turn->timer, 0, &tv, sizeof(tv)) == sizeof(tv)){
+            return;
+        }
+    }
+#endif
+
+    if(action == NRF24_TURN_TIMER_CE_LOW){
+        while((rt_int32_t)(nRF24L01_Debug_Get_Cycles() - turn->deadline_cycles) < 0);
+        nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    }
+}
+
+
+/***
+ * @brief   取消尚未到期的定时
+ */
+static void nRF24L01_Turn_Disarm(nrf24_t nrf24)
+{
+#ifdef RT_USING_HWTIMER
+    if(nrf24->turn.timer != RT_NULL){
+        rt_device_control(nrf24->turn.timer, HWTIMER_CTRL_STOP, RT_NULL);
+    }
+#endif
+    nrf24->turn.expired = 0;
+}
+
+
+/***
+ * @brief   WAKE 定时是否已到期
+ * @note    硬件定时器与 DWT 的时钟略有差异，两者谁先到都算到期
+ */
+static rt_bool_t nRF24L01_Turn_Expired(struct nRF24L01_TURN_STRUCT *turn)
+{
+    if(turn->expired){
+        return RT_TRUE;
+    }
+    return (rt_int32_t)(nRF24L01_Debug_Get_Cycles() - turn->deadline_cycles) >= 0;
+}
+
+
+/***
+ * @brief   拉高 CE 发射 TX FIFO 顶部的一包，NRF24_TURN_CE_PULSE_US 后由定时器拉低，芯片发完即回到 Standby-I
+ */
+static void nRF24L01_Turn_Pulse_CE(nrf24_t nrf24)
+{
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+    nRF24L01_Turn_Arm(nrf24, NRF24_TURN_TIMER_CE_LOW, NRF24_TURN_CE_PULSE_US);
+}
+
+
+/***
+ * @brief   应答方收到 REQ 后，芯片要先经过 130us 切换再发出自动应答，这段时间内不能改 PRIM_RX
+ * @return  从现在起需要等待的微秒数：切换时间 + 空应答包的空中时间 + 余量
+ */
+static rt_uint32_t nRF24L01_Turn_Ack_Guard_Us(nrf24_t nrf24)
+{
+    struct nRF24L01_PARAMETER_STRUCT *cfg = &nrf24->nrf24_cfg;
+    /* 前导 1 字节 + 地址 + CRC，再加 9 位包控制字段 */
+    rt_uint32_t bits = 8 * (1 + (cfg->setup_aw.aw + 2) + (cfg->config.crco + 1)) + 9;
+
+    if(cfg->rf_setup.rf_dr_low){
+        bits *= 4;
+    }
+    else if(cfg->rf_setup.rf_dr_high){
+        bits = (bits + 1) / 2;
+    }
+
+    return NRF24_TURN_SETTLE_US + bits + NRF24_TURN_MARGIN_US;
+}
+
+
+/***
+ * @brief   记录一次往返时延
+ */
+static void nRF24L01_Turn_Record_RTT(struct nRF24L01_TURN_STRUCT *turn, rt_uint32_t us)
+{
+    rt_uint32_t bin = us / NRF24_RTT_BIN_US;
+
+    turn->rtt_us = us;
+    if(us < turn->rtt_min_us){
+        turn->rtt_min_us = us;
+    }
+    if(us > turn->rtt_max_us){
+        turn->rtt_max_us = us;
+    }
+    turn->rtt_sum_us += us;
+    turn->rtt_bin[(bin < NRF24_RTT_BINS) ? bin : (NRF24_RTT_BINS - 1)]++;
+}
+
+
+static void nRF24L01_Turn_Reset_Stats(struct nRF24L01_TURN_STRUCT *turn)
+{
+    turn->requests     = 0;
+    turn->responses    = 0;
+    turn->timeouts     = 0;
+    turn->tx_failed    = 0;
+    turn->served       = 0;
+    turn->reply_failed = 0;
+    turn->rtt_min_us   = 0xFFFFFFFF;
+    turn->rtt_max_us   = 0;
+    turn->rtt_sum_us   = 0;
+    rt_memset(turn->rtt_bin, 0, sizeof(turn->rtt_bin));
+}
+
+
+
+/***
+ * @brief   初始化收发切换引擎，打开硬件定时器
+ */
+void nRF24L01_Turn_Init(nrf24_t nrf24)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+
+    rt_memset(turn, 0, sizeof(struct nRF24L01_TURN_STRUCT));
+    rt_mutex_init(&turn->lock, "nrf24_turn", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&turn->done_sem, "nrf24_rtt", 0, RT_IPC_FLAG_FIFO);
+    nRF24L01_Turn_Reset_Stats(turn);
+
+#ifdef RT_USING_HWTIMER
+    /* 硬件定时器只有一个，归第一个初始化的实例，其余实例用 DWT 计时 */
+    turn->timer = (turn_nrf24 == RT_NULL) ? rt_device_find(NRF24_TURN_TIMER_NAME) : RT_NULL;
+    if(turn->timer != RT_NULL){
+        rt_hwtimer_mode_t mode = HWTIMER_MODE_ONESHOT;
+        rt_uint32_t freq = NRF24_TURN_TIMER_HZ;
+
+        if(rt_device_open(turn->timer, RT_DEVICE_OFLAG_RDWR) != RT_EOK){
+            turn->timer = RT_NULL;
+        }
+        else if(rt_device_control(turn->timer, HWTIMER_CTRL_FREQ_SET, &freq) != RT_EOK ||
+                rt_device_control(turn->timer, HWTIMER_CTRL_MODE_SET, &mode) != RT_EOK){
+            rt_device_close(turn->timer);
+            turn->timer = RT_NULL;
+        }
+        else{
+            turn_nrf24 = nrf24;
+            rt_device_set_rx_indicate(turn->timer, nRF24L01_Turn_Timer_Isr);
+        }
+    }
+#endif
+
+    if(turn->timer == RT_NULL){
+        LOG_W("LOG:%d. nrf24 turnaround without hwtimer, using DWT timing.",Record.ulog_cnt++);
+    }
+    else{
+        LOG_I("LOG:%d. nrf24 turnaround on %s.",Record.ulog_cnt++, NRF24_TURN_TIMER_NAME);
+    }
+}
+
+
+
+/***
+ * @brief   发起方：切换为 PTX，写入 REQ 并触发 CE 脉冲
+ * @note    PRX 的 TX FIFO 里是待回的 ACK 载荷，切换到 PTX 后会被当作数据发出，因此先清空
+ */
+static void nRF24L01_Turn_Start(nrf24_t nrf24)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+    uint8_t frame[32];
+
+    turn->home_role = nrf24->nrf24_cfg.config.prim_rx;
+    turn->seq++;
+    frame[0] = NRF24_TURN_MARK | NRF24_TURN_REQ;
+    frame[1] = turn->seq;
+    rt_memcpy(&frame[NRF24_TURN_HEADER_SIZE], turn->req, turn->req_len);
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    if(turn->home_role != ROLE_PTX){
+        nRF24L01_Flush_TX_FIFO(nrf24);
+        nRF24L01_Set_Role_Mode(nrf24, ROLE_PTX);
+    }
+    nRF24L01_Write_Tx_Payload_Ack(nrf24, frame, NRF24_TURN_HEADER_SIZE + turn->req_len);
+
+    turn->state = NRF24_TURN_REQ_TX;
+    turn->requests++;
+    turn->start_cycles = nRF24L01_Debug_Get_Cycles();
+    nRF24L01_Turn_Pulse_CE(nrf24);
+}
+
+
+/***
+ * @brief   发起方：事务结束，恢复原来的角色并拉高 CE，唤醒 nRF24L01_Transact
+ */
+static void nRF24L01_Turn_Finish(nrf24_t nrf24, int result)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+
+    nRF24L01_Turn_Disarm(nrf24);
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    if(nrf24->nrf24_cfg.config.prim_rx != turn->home_role){
+        nRF24L01_Set_Role_Mode(nrf24, (nrf24_role_et)turn->home_role);
+    }
+    nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+
+    turn->result = result;
+    turn->state  = NRF24_TURN_IDLE;
+    rt_sem_release(&turn->done_sem);
+}
+
+
+/***
+ * @brief   应答方：自己的自动应答已发完，切换为 PTX 发出 RESP
+ */
+static void nRF24L01_Turn_Send_Reply(nrf24_t nrf24)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+
+    nrf24->nrf24_ops.nrf24_reset_ce(&nrf24->port_api);
+    nRF24L01_Flush_TX_FIFO(nrf24);
+    nRF24L01_Set_Role_Mode(nrf24, ROLE_PTX);
+    nRF24L01_Write_Tx_Payload_Ack(nrf24, turn->reply, turn->reply_len);
+
+    turn->state = NRF24_TURN_REPLY_TX;
+    nRF24L01_Turn_Pulse_CE(nrf24);
+}
+
+
+
+/***
+ * @brief   请求 / 应答往返：发出 req，对方的 RESP 载荷写入 resp
+ * @param   req/len    请求内容，0 ~ NRF24_TURN_PAYLOAD_SIZE 字节
+ *          resp       应答缓冲区，至少 NRF24_TURN_PAYLOAD_SIZE 字节
+ *          timeout_us 从发出请求到收到应答的最长时间
+ *          rtt_us     可为 RT_NULL，返回本次往返时延
+ * @return  >=0 : 应答长度   -RT_EINVAL : 参数错误   -RT_ETIMEOUT : 没有收到应答   -RT_ERROR : 请求达到最大重发次数
+ * @note    收发切换和定时全部由射频线程完成，调用者只阻塞等待结果，因此不能在 nRF24L01 服务线程中调用；
+ *          对方需处于 PRX 且运行同一引擎，默认原样回送请求，可用 nrf24l01_req_ind 回调生成应答
+ */
+int nRF24L01_Transact(nrf24_t nrf24, const uint8_t *req, uint8_t len, uint8_t *resp, rt_uint32_t timeout_us, rt_uint32_t *rtt_us)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+    int result;
+
+    if(!NRF24_USE_TURN){
+        return -RT_ENOSYS;
+    }
+    if(len > NRF24_TURN_PAYLOAD_SIZE || timeout_us == 0 || timeout_us > 1000000){
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&turn->lock, RT_WAITING_FOREVER);
+    rt_sem_control(&turn->done_sem, RT_IPC_CMD_RESET, RT_NULL);
+    rt_memcpy(turn->req, req, len);
+    turn->req_len    = len;
+    turn->timeout_us = timeout_us;
+    turn->pending    = 1;
+    nRF24L01_Wakeup(nrf24);
+
+    /* 多等 1s，只防射频线程长时间不运行 */
+    if(rt_sem_take(&turn->done_sem, rt_tick_from_millisecond(timeout_us / 1000 + 1000)) != RT_EOK){
+        turn->pending = 0;
+        result = -RT_ETIMEOUT;
+    }
+    else{
+        result = turn->result;
+        if(result == RT_EOK){
+            rt_memcpy(resp, turn->resp, turn->resp_len);
+            result = turn->resp_len;
+            if(rtt_us != RT_NULL){
+                *rtt_us = turn->rtt_us;
+            }
+        }
+    }
+    rt_mutex_release(&turn->lock);
+
+    return result;
+}
+
+
+
+/***
+ * @brief   处理收到的切换引擎报文
+ * @return  1 : 已处理（调用者不再交给其他层）   0 : 不是切换引擎报文
+ */
+int nRF24L01_Turn_Input(nrf24_t nrf24, const uint8_t *data, uint8_t len, rt_uint8_t pipe)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+    rt_uint8_t type;
+
+    if(!NRF24_USE_TURN || len < NRF24_TURN_HEADER_SIZE || (data[0] & NRF24_TURN_MARK_MASK) != NRF24_TURN_MARK){
+        return 0;
+    }
+    type = data[0] & NRF24_TURN_TYPE_MASK;
+
+    // 1. 发起方收到应答：时延从 CE 脉冲算到线程拿到数据，即调用者实际感受到的往返时间
+    if(type == NRF24_TURN_RESP)
+    {
+        if(turn->state == NRF24_TURN_RESP_RX && data[1] == turn->seq){
+            turn->resp_len = len - NRF24_TURN_HEADER_SIZE;
+            rt_memcpy(turn->resp, &data[NRF24_TURN_HEADER_SIZE], turn->resp_len);
+            nRF24L01_Turn_Record_RTT(turn, nRF24L01_Debug_Cycles_To_Us(nRF24L01_Debug_Get_Cycles() - turn->start_cycles));
+            turn->responses++;
+            nRF24L01_Turn_Finish(nrf24, RT_EOK);
+        }
+        return 1;
+    }
+
+    // 2. 应答方收到请求：先准备好 RESP，等自动应答发完后再切换，忙时直接丢弃由发起方超时
+    if(type == NRF24_TURN_REQ)
+    {
+        if(turn->state != NRF24_TURN_IDLE || nrf24->nrf24_cfg.config.prim_rx != ROLE_PRX){
+            return 1;
+        }
+        turn->reply[0] = NRF24_TURN_MARK | NRF24_TURN_RESP;
+        turn->reply[1] = data[1];
+        if(nrf24->nrf24_cb.nrf24l01_req_ind){
+            turn->reply_len = nrf24->nrf24_cb.nrf24l01_req_ind(nrf24, &data[NRF24_TURN_HEADER_SIZE],
+                                                              len - NRF24_TURN_HEADER_SIZE, &turn->reply[NRF24_TURN_HEADER_SIZE]);
+            if(turn->reply_len > NRF24_TURN_PAYLOAD_SIZE){
+                turn->reply_len = NRF24_TURN_PAYLOAD_SIZE;
+            }
+        }
+        else{
+            turn->reply_len = len - NRF24_TURN_HEADER_SIZE;
+            rt_memcpy(&turn->reply[NRF24_TURN_HEADER_SIZE], &data[NRF24_TURN_HEADER_SIZE], turn->reply_len);
+        }
+        turn->reply_len += NRF24_TURN_HEADER_SIZE;
+
+        turn->state = NRF24_TURN_REPLY_WAIT;
+        nRF24L01_Turn_Arm(nrf24, NRF24_TURN_TIMER_WAKE, nRF24L01_Turn_Ack_Guard_Us(nrf24));
+    }
+
+    return 1;
+}
+
+
+
+/***
+ * @brief   处理切换引擎自己发出的数据包的 TX_DS / MAX_RT
+ * @return  1 : 已处理   0 : 不是引擎发出的，交给软件发送队列
+ */
+int nRF24L01_Turn_Tx_Event(nrf24_t nrf24, rt_uint8_t irq_flags)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+    rt_uint32_t elapsed;
+
+    // 1. 发起方：请求已送达则立即切到 PRX 监听，130us 的 PLL 建立与对方等待自动应答发完的时间重叠
+    if(turn->state == NRF24_TURN_REQ_TX)
+    {
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+            turn->tx_failed++;
+            nRF24L01_Turn_Finish(nrf24, -RT_ERROR);
+            return 1;
+        }
+
+        nRF24L01_Set_Role_Mode(nrf24, ROLE_PRX);
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        turn->state = NRF24_TURN_RESP_RX;
+
+        elapsed = nRF24L01_Debug_Cycles_To_Us(nRF24L01_Debug_Get_Cycles() - turn->start_cycles);
+        nRF24L01_Turn_Arm(nrf24, NRF24_TURN_TIMER_WAKE, (elapsed < turn->timeout_us) ? (turn->timeout_us - elapsed) : 1);
+        return 1;
+    }
+
+    // 2. 应答方：RESP 发完（或失败）后回到 PRX 继续监听
+    if(turn->state == NRF24_TURN_REPLY_TX)
+    {
+        if(irq_flags & NRF24BITMASK_MAX_RT){
+            nRF24L01_Flush_TX_FIFO(nrf24);
+            turn->reply_failed++;
+        }
+        else{
+            turn->served++;
+        }
+        nRF24L01_Set_Role_Mode(nrf24, ROLE_PRX);
+        nrf24->nrf24_ops.nrf24_set_ce(&nrf24->port_api);
+        turn->state = NRF24_TURN_IDLE;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+/***
+ * @brief   切换引擎的服务函数，在 nRF24L01_Run 的每轮循环中调用
+ * @note    软件发送队列在途的数据包全部完成后才开始新的请求，避免 REQ 排在它们后面
+ */
+void nRF24L01_Turn_Service(nrf24_t nrf24)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+
+    switch(turn->state)
+    {
+    case NRF24_TURN_IDLE:
+        if(turn->pending && nrf24->tx_queue.sent == nrf24->tx_queue.done){
+            turn->pending = 0;
+            nRF24L01_Turn_Start(nrf24);
+        }
+        break;
+
+    case NRF24_TURN_RESP_RX:
+        if(nRF24L01_Turn_Expired(turn)){
+            turn->timeouts++;
+            nRF24L01_Turn_Finish(nrf24, -RT_ETIMEOUT);
+        }
+        break;
+
+    case NRF24_TURN_REPLY_WAIT:
+        /* 没有硬件定时器时等待时间只有 200us 左右，直接忙等 */
+        if(turn->timer == RT_NULL){
+            while(nRF24L01_Turn_Expired(turn) == RT_FALSE);
+        }
+        if(nRF24L01_Turn_Expired(turn)){
+            nRF24L01_Turn_Send_Reply(nrf24);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/***
+ * @brief   切换引擎是否占用芯片 TX FIFO，占用期间软件发送队列暂停补充
+ */
+rt_bool_t nRF24L01_Turn_Busy(nrf24_t nrf24)
+{
+    return (nrf24->turn.state != NRF24_TURN_IDLE || nrf24->turn.pending) ? RT_TRUE : RT_FALSE;
+}
+
+
+/***
+ * @brief   nRF24L01_Run 等待 IRQ 信号量的超时时间
+ * @return  有硬件定时器时由定时器中断唤醒，为 RT_WAITING_FOREVER；
+ *          否则等待应答期间返回距超时的 tick 数（向上取整）
+ */
+rt_int32_t nRF24L01_Turn_Next_Timeout(nrf24_t nrf24)
+{
+    struct nRF24L01_TURN_STRUCT *turn = &nrf24->turn;
+    rt_int32_t left;
+
+    if(turn->timer != RT_NULL || turn->state != NRF24_TURN_RESP_RX){
+        return RT_WAITING_FOREVER;
+    }
+
+    left = (rt_int32_t)(turn->deadline_cycles - nRF24L01_Debug_Get_Cycles());
+    if(left <= 0){
+        return 1;
+    }
+    left = nRF24L01_Debug_Cycles_To_Us(left);
+    return (left * RT_TICK_PER_SECOND + 999999) / 1000000;
+}
+
+
+
+/***
+ * @brief msh 命令：请求 / 应答往返时延测试
+ * @note  nrf24_ping                          打印统计
+ *        nrf24_ping <n> [len] [timeout_us]   连续发起 n 次往返，打印时延分布
+ *        nrf24_ping reset                    清零统计
+ */
+static void nrf24_ping_cmd(int argc, char **argv)
+{
+    struct nRF24L01_TURN_STRUCT *turn;
+
+    if (_nrf24 == RT_NULL){
+        rt_kprintf("[nrf24] not initialized.\r\n");
+        return;
+    }
+    turn = &_nrf24->turn;
+
+    if (argc > 1 && rt_strcmp(argv[1], "reset") == 0)
+    {
+        rt_enter_critical();
+        nRF24L01_Turn_Reset_Stats(turn);
+        rt_exit_critical();
+    }
+    else if (argc > 1)
+    {
+        rt_uint32_t n = atoi(argv[1]);
+        rt_uint8_t  len = (argc > 2) ? atoi(argv[2]) : 4;
+        rt_uint32_t timeout_us = (argc > 3) ? atoi(argv[3]) : 5000;
+        rt_uint8_t  req[NRF24_TURN_PAYLOAD_SIZE], resp[NRF24_TURN_PAYLOAD_SIZE];
+        rt_uint32_t rtt, ok = 0;
+        int ret;
+
+        if (len > NRF24_TURN_PAYLOAD_SIZE){
+            len = NRF24_TURN_PAYLOAD_SIZE;
+        }
+        for (rt_uint32_t i = 0; i < n; i++)
+        {
+            rt_memset(req, (rt_uint8_t)i, len);
+            ret = nRF24L01_Transact(_nrf24, req, len, resp, timeout_us, &rtt);
+            if (ret == len && rt_memcmp(req, resp, len) == 0){
+                ok++;
+            }
+            else if (n <= 10){
+                rt_kprintf("[nrf24] ping %d failed (%d).\r\n", i, ret);
+            }
+        }
+        rt_kprintf("[nrf24] ping %d/%d ok, %d bytes, timeout %dus\r\n", ok, n, len, timeout_us);
+    }
+
+    rt_kprintf("[nrf24] turnaround (%s): requests %d, responses %d, timeouts %d, tx failed %d, served %d, reply failed %d\r\n",
+               (turn->timer != RT_NULL) ? NRF24_TURN_TIMER_NAME : "dwt",
+               turn->requests, turn->responses, turn->timeouts, turn->tx_failed, turn->served, turn->reply_failed);
+    if (turn->responses > 0)
+    {
+        rt_uint32_t below_1ms = 0;
+
+        rt_kprintf("            rtt min %dus, avg %dus, max %dus\r\n",
+                   turn->rtt_min_us, (rt_uint32_t)(turn->rtt_sum_us / turn->responses), turn->rtt_max_us);
+        for (rt_uint8_t i = 0; i < NRF24_RTT_BINS; i++)
+        {
+            if (i < NRF24_RTT_BINS - 1){
+                rt_kprintf("            %4d ~ %4dus : %d\r\n", i * NRF24_RTT_BIN_US, (i + 1) * NRF24_RTT_BIN_US, turn->rtt_bin[i]);
+            }
+            else{
+                rt_kprintf("            >= %4dus    : %d\r\n", i * NRF24_RTT_BIN_US, turn->rtt_bin[i]);
+            }
+            if ((i + 1) * NRF24_RTT_BIN_US <= 1000){
+                below_1ms += turn->rtt_bin[i];
+            }
+        }
+        rt_kprintf("            < 1ms : %d%%\r\n", below_1ms * 100 / turn->responses);
+    }
+}
+MSH_CMD_EXPORT_ALIAS(nrf24_ping_cmd, nrf24_ping, turnaround round trip test [<n> [len] [timeout_us] | reset]);
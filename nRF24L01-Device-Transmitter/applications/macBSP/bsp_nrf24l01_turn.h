@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-18     Administrator       the first version
+ */
+#ifndef APPLICATIONS_MACBSP_BSP_NRF24L01_TURN_H_
+#define APPLICATIONS_MACBSP_BSP_NRF24L01_TURN_H_
+#include "bsp_sys.h"
+
+
+/***
+ * 收发切换请求 / 应答报文头（2 字节）
+ * byte0 : 高 4 位 = 0100 切换引擎标记（可靠传输为 10xxxxxx，分片为 11xxxxxx，协议帧以 0x55 开头）
+ *         低 4 位        报文类型
+ * byte1 : 请求序号，应答原样带回
+ *
+ * REQ  : 发起方以 PTX 发出，随后立即切换为 PRX 等待应答
+ * RESP : 应答方收到 REQ 后切换为 PTX 发出，发送完成后回到 PRX
+ */
+#define NRF24_TURN_MARK             0x40
+#define NRF24_TURN_MARK_MASK        0xF0
+#define NRF24_TURN_TYPE_MASK        0x0F
+#define NRF24_TURN_REQ              0x01
+#define NRF24_TURN_RESP             0x02
+#define NRF24_TURN_HEADER_SIZE      2
+#define NRF24_TURN_PAYLOAD_SIZE     (32 - NRF24_TURN_HEADER_SIZE)
+
+
+/***
+ * 时序参数
+ * NRF24_USE_TURN         : 1 -> 启用切换引擎；为 0 时本层不认领 0100xxxx 的包，按普通数据交给应用
+ * NRF24_TURN_TIMER_NAME  : 提供微秒定时的硬件定时器（components/drivers/hwtimer），
+ *                          需要开启 RT_USING_HWTIMER 和对应的 BSP_USING_TIMx；
+ *                          未开启时短延时退化为 DWT 忙等，应答超时退化为 tick 精度
+ * NRF24_TURN_TIMER_HZ    : 定时器计数频率，1MHz 即 1us 分辨率
+ * NRF24_TURN_CE_PULSE_US : PTX 单包发射的 CE 高电平脉宽，手册要求不小于 10us
+ * NRF24_TURN_SETTLE_US   : CE 拉高到开始收发的 PLL 建立时间，也是芯片自动应答的收发切换时间
+ * NRF24_TURN_MARGIN_US   : 应答方等待自己的自动应答发完时额外留出的余量
+ */
+#define NRF24_USE_TURN              1
+#define NRF24_TURN_TIMER_NAME       "timer3"
+#define NRF24_TURN_TIMER_HZ         1000000
+#define NRF24_TURN_CE_PULSE_US      15
+#define NRF24_TURN_SETTLE_US        130
+#define NRF24_TURN_MARGIN_US        20
+
+#if NRF24_TURN_CE_PULSE_US < 10
+#error "NRF24_TURN_CE_PULSE_US must be at least 10us"
+#endif
+
+
+/***
+ * 往返时延直方图：每格 NRF24_RTT_BIN_US，最后一格收纳其余所有样本
+ */
+#define NRF24_RTT_BIN_US            100
+#define NRF24_RTT_BINS              12
+
+
+/***
+ * 切换引擎的状态
+ * IDLE       : 空闲，芯片处于原来的角色
+ * REQ_TX     : 发起方，REQ 已写入并触发 CE 脉冲，等待 TX_DS / MAX_RT
+ * RESP_RX    : 发起方，已切换为 PRX，等待 RESP 或超时
+ * REPLY_WAIT : 应答方，已收到 REQ，等待自己的自动应答发完再切换为 PTX
+ * REPLY_TX   : 应答方，RESP 已写入并触发 CE 脉冲，等待 TX_DS / MAX_RT
+ */
+typedef enum
+{
+    NRF24_TURN_IDLE = 0,
+    NRF24_TURN_REQ_TX,
+    NRF24_TURN_RESP_RX,
+    NRF24_TURN_REPLY_WAIT,
+    NRF24_TURN_REPLY_TX,
+}nrf24_turn_state_et;
+
+
+/***
+ * 硬件定时器到期后在中断里要做的事
+ * CE_LOW : 结束 CE 脉冲
+ * WAKE   : 置位 expired 并唤醒射频线程（应答超时 / 应答方的等待结束）
+ */
+typedef enum
+{
+    NRF24_TURN_TIMER_CE_LOW = 0,
+    NRF24_TURN_TIMER_WAKE,
+}nrf24_turn_timer_et;
+
+
+/***
+ * 快速收发切换引擎
+ */
+struct nRF24L01_TURN_STRUCT
+{
+    /* 硬件定时器，RT_NULL 时使用 DWT / tick 退化方案 */
+    rt_device_t timer;
+    volatile rt_uint8_t timer_action;
+    volatile rt_uint8_t expired;
+    rt_uint32_t deadline_cycles;
+
+    rt_uint8_t  state;
+    /* 事务开始前的角色，结束后恢复 */
+    rt_uint8_t  home_role;
+    rt_uint8_t  seq;
+    rt_uint32_t start_cycles;
+    rt_uint32_t timeout_us;
+
+    /* 发起方：nRF24L01_Transact 投递的请求和收到的应答 */
+    struct rt_mutex     lock;
+    struct rt_semaphore done_sem;
+    volatile rt_uint8_t pending;
+    rt_uint8_t  req_len;
+    rt_uint8_t  req[NRF24_TURN_PAYLOAD_SIZE];
+    rt_uint8_t  resp_len;
+    rt_uint8_t  resp[NRF24_TURN_PAYLOAD_SIZE];
+    int         result;
+    rt_uint32_t rtt_us;
+
+    /* 应答方：待发送的 RESP */
+    rt_uint8_t  reply_len;
+    rt_uint8_t  reply[32];
+
+    /* 统计 */
+    rt_uint32_t requests;
+    rt_uint32_t responses;
+    rt_uint32_t timeouts;
+    rt_uint32_t tx_failed;
+    rt_uint32_t served;
+    rt_uint32_t reply_failed;
+    rt_uint32_t rtt_min_us;
+    rt_uint32_t rtt_max_us;
+    rt_uint64_t rtt_sum_us;
+    rt_uint32_t rtt_bin[NRF24_RTT_BINS];
+};
+
+
+
+#endif /* APPLICATIONS_MACBSP_BSP_NRF24L01_TURN_H_ */
@@ -17,11 +17,29 @@
 #include <board.h>
 #include <rtdevice.h>
 #include <rthw.h>
+/* 应用层日志统一使用 nrf24 标签，运行时可用 ulog_tag_lvl nrf24 <level> 单独调整 */
+#define DBG_TAG         "nrf24"
+#define DBG_LVL         DBG_LOG
 #include <rtdbg.h>
 #include <drv_spi.h>
 #include "main.h"
 #include "bsp_typedef.h"
+#include "bsp_nrf24l01_trace.h"
 #include "bsp_nrf24l01_message.h"
+#include "bsp_nrf24l01_frag.h"
+#include "bsp_nrf24l01_arq.h"
+#include "bsp_nrf24l01_turn.h"
+#include "bsp_nrf24l01_hub.h"
+#include "bsp_nrf24l01_pkt.h"
+#include "bsp_nrf24l01_rotate.h"
+#include "bsp_nrf24l01_tdma.h"
+#include "bsp_nrf24l01_link.h"
+#include "bsp_nrf24l01_chan.h"
+#include "bsp_nrf24l01_hop.h"
+#include "bsp_nrf24l01_stat.h"
+#include "bsp_nrf24l01_duplex.h"
+#include "bsp_nrf24l01_dev.h"
+#include "bsp_nrf24l01_debug.h"
 #include "bsp_nrf24l01_driver.h"
 
 
@@ -13,153 +13,116 @@
 
 /* 前向声明一下nrf24l01的事件回调句柄 */
 const static struct nrf24_callback g_cb;
-/* 创建nRF24L01发送数据的二值信号量 */
-rt_sem_t nrf24_send_sem = RT_NULL;
-/* 创建nRF24L01进入中断的二值信号量 */
-rt_sem_t nrf24_irq_sem = RT_NULL;
-/* 定义为全局变量 */
-nrf24_t _nrf24 = NULL;
-/**
-  * @brief  This thread entry is used for nRF24L01
-  * @retval void
-  */
-void nRF24L01_Thread_entry(void* parameter)
-{
-
-    /* 0. 给nrf24开创一个实际空间 */
-    _nrf24 = malloc(sizeof(nrf24_t));
-    if (_nrf24 == NULL) {
-        LOG_E("LOG:%d. nrf24 malloc error.",Record.ulog_cnt++);
-    }
-    else{
-        LOG_I("LOG:%d. nrf24 malloc successful.",Record.ulog_cnt++);
-    }
-
 
-    /* 1. 创建二值信号量 */
-    nrf24_send_sem = rt_sem_create("nrf24_send", 0, RT_IPC_FLAG_FIFO);
-    if(nrf24_send_sem == RT_NULL){
-        LOG_E("Failed to create nrf24l01 send semaphore.");
-    }
-    else{
-        LOG_I("Succeed to create nrf24l01 send semaphore.");
-    }
-
-    nrf24_irq_sem = rt_sem_create("nrf24_irq", 0, RT_IPC_FLAG_FIFO);
-    if(nrf24_irq_sem == RT_NULL){
-        LOG_E("Failed to create nrf24l01 irq semaphore.");
-    }
-    else{
-        LOG_I("Succeed to create nrf24l01 irq semaphore.");
-        _nrf24->nrf24_flags.using_irq = RT_TRUE;
-    }
+/* nRF24L01 实例及其射频线程，全部静态分配 */
+#define NRF24_THREAD_STACK_SIZE     4096
+#define NRF24_THREAD_PRIORITY       9
 
+static struct nRF24L01_STRUCT nrf24_radio0;
+static struct rt_thread nrf24_thread0;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t nrf24_thread0_stack[NRF24_THREAD_STACK_SIZE];
 
-    /* 2. 获取中断引脚编号 */
-    _nrf24->port_api.nRF24L01_IRQ_Pin_Num = GET_PIN(C, 7);
+#if NRF24_USE_DUAL_RADIO
+static struct nRF24L01_STRUCT nrf24_radio1;
+static struct rt_thread nrf24_thread1;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t nrf24_thread1_stack[NRF24_THREAD_STACK_SIZE];
+#endif
 
+#if NRF24_USE_DUAL_RADIO && NRF24_USE_DUPLEX
+/* 两片组成的全双工链路：radio0 常驻发送，radio1 常驻接收 */
+static struct nRF24L01_DUPLEX_STRUCT nrf24_duplex;
+static void nrf24l01_duplex_rx_ind(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len);
+#endif
 
-    /* 3. 初始化SPI */
-    nRF24L01_SPI_Init(&_nrf24->port_api);
-
-
-    /* 4. 把spi底层函数整体拷贝到ops结构体中 */
-    _nrf24->nrf24_ops = g_nrf24_func_ops;
-    _nrf24->nrf24_cb  = g_cb;
-
-    /* 5. 配置nRF24L01的参数*/
-    if(nRF24L01_Param_Config(&_nrf24->nrf24_cfg) != RT_EOK){
-        LOG_E("LOG:%d. nrf24 parameter config error.",Record.ulog_cnt++);
-    }
-    else{
-        LOG_I("LOG:%d. nrf24 parameter config successfully.",Record.ulog_cnt++);
-    }
-
-    /* 6. 配置启用中断引脚和中断回调函数 */
-    if(nRF24L01_IQR_GPIO_Config(&_nrf24->port_api) != RT_EOK){
-        LOG_E("LOG:%d. nrf24 irq config error.",Record.ulog_cnt++);
-    }
-    else{
-        LOG_I("LOG:%d. nrf24 irq config successfully.",Record.ulog_cnt++);
-    }
 
+/**
+  * @brief  This thread entry is used for nRF24L01
+  * @param  parameter 本线程服务的 nRF24L01 实例
+  * @retval void
+  */
+void nRF24L01_Thread_entry(void* parameter)
+{
+    nrf24_t nrf24 = (nrf24_t)parameter;
 
-    /* 7. 通过回环通信，检测SPI硬件链路是否有误 */
-    if (nRF24L01_Check_SPI_Community(_nrf24) != RT_EOK){
-        LOG_E("LOG:%d. nRF24L01 check spi hardware false.",Record.ulog_cnt++);
+    /* 1. 启动硬件：挂载SPI、配置中断、协商SPI时钟、写入寄存器并上电 */
+    if(nRF24L01_Start(nrf24) != RT_EOK){
+        LOG_E("LOG:%d. %s start false.",Record.ulog_cnt++, nrf24->name);
     }
     else{
-        LOG_I("LOG:%d. nRF24L01 check spi hardware successful.",Record.ulog_cnt++);
+        LOG_I("LOG:%d. %s successfully initialized",Record.ulog_cnt++, nrf24->name);
     }
+    rt_kprintf("\r\n\r\n");
+    rt_kprintf("----------------------------------\r\n");
+    rt_kprintf("[nrf24/demo] %s running %s.\r\n", nrf24->name,
+               (nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX) ? "receiver" : "transmitter");
 
+    /* 连接测试指令只在 PTX 下发出 */
+    nrf24l01_order_to_pipe(nrf24, Order_nRF24L01_Connect_Control_Panel);
 
-    /* 8. 先进入掉电模式 */
-    _nrf24->nrf24_ops.nrf24_reset_ce();
-    nRF24L01_Enter_Power_Down_Mode(_nrf24);
 
-    /* 9. 解锁高级扩展功能 */
-    nRF24L01_Ensure_RWW_Features_Activated(_nrf24);
+    /* 事件驱动：nRF24L01_Run 阻塞在 IRQ 信号量上，每次唤醒处理完全部挂起事件 */
+    for(;;)
+    {
+        nRF24L01_Run(nrf24);
 
-    /* 10. 更新寄存器参数 */
-    if (nRF24L01_Update_Parameter(_nrf24) != RT_EOK){
-        LOG_E("LOG:%d. nRF24L01 update_onchip_config false.",Record.ulog_cnt++);
-    }
-    else{
-        nRF24L01_Set_Role_Mode(_nrf24, ROLE_PTX);
-        LOG_I("LOG:%d. nRF24L01 update_onchip_config successful.",Record.ulog_cnt++);
+        /* 没有IRQ信号量时退化为1个tick的轮询 */
+        if(nrf24->nrf24_flags.using_irq != RT_TRUE){
+            rt_thread_mdelay(1);
+        }
     }
+}
 
-    /* 11. 读取寄存器参数 */
-    if (nRF24L01_Read_Onchip_Parameter(_nrf24) != RT_EOK){
-        LOG_E("LOG:%d. nRF24L01 read parameter false.",Record.ulog_cnt++);
-    }
-    else{
-        LOG_I("LOG:%d. nRF24L01 read parameter successful.",Record.ulog_cnt++);
-    }
 
-    /* 12. 清空"发送/接收"队列 */
-    nRF24L01_Flush_RX_FIFO(_nrf24);
-    nRF24L01_Flush_TX_FIFO(_nrf24);
-    /* 13. 清除中断标志*/
-    nRF24L01_Clear_IRQ_Flags(_nrf24);
-    /* 14. 清除重发计数和丢包计数*/
-    nRF24L01_Clear_Observe_TX(_nrf24);
-    /* 15. 配置完成，进入上电模式 */
-    nRF24L01_Enter_Power_Up_Mode(_nrf24);
-    _nrf24->nrf24_ops.nrf24_set_ce();
-    LOG_I("LOG:%d. Successfully initialized",Record.ulog_cnt++);
-    rt_kprintf("\r\n\r\n");
-    rt_kprintf("----------------------------------\r\n");
-    rt_kprintf("[nrf24/demo] running transmitter.\r\n");
 
-    nrf24l01_order_to_pipe(_nrf24, Order_nRF24L01_Connect_Control_Panel, NRF24_DEFAULT_PIPE);
+/**
+  * @brief  启动已初始化的 nRF24L01 实例的射频线程，线程与实例同名
+  * @retval int
+  */
+static int nRF24L01_Thread_Start(nrf24_t nrf24, struct rt_thread *thread, rt_uint8_t *stack)
+{
+    rt_thread_init(thread, nrf24->name, nRF24L01_Thread_entry, nrf24, stack, NRF24_THREAD_STACK_SIZE, NRF24_THREAD_PRIORITY, 50);
+    rt_thread_startup(thread);
+    LOG_I("[nRF24L01]%s thread is Succeed!! \r\n", nrf24->name);
 
-    for(;;)
-    {
-        nRF24L01_Run(_nrf24);
-        rt_thread_mdelay(500);
-    }
+    return RT_EOK;
 }
 
 
-
 /**
   * @brief  This is a Initialization for nRF24L01
+  * @note   双射频时 radio1 取相反的角色，一片常驻接收、一片常驻发送；
+  *         射频线程优先级高于初始化线程，全部实例初始化（及组成全双工链路）之后才启动线程
   * @retval int
   */
-rt_thread_t nRF24L01_Task_Handle = RT_NULL;
 int nRF24L01_Thread_Init(void)
 {
-    nRF24L01_Task_Handle = rt_thread_create("nRF24L01_Thread_entry", nRF24L01_Thread_entry, RT_NULL, 4096, 9, 50);
-    /* 检查是否创建成功,成功就启动线程 */
-    if(nRF24L01_Task_Handle != RT_NULL)
-    {
-        LOG_I("[nRF24L01]nRF24L01_Thread_entry is Succeed!! \r\n");
-        rt_thread_startup(nRF24L01_Task_Handle);
+    int ret0 = nRF24L01_Init(&nrf24_radio0, "nrf0", &g_nrf24_hw_radio0, &g_cb, ROLE_PTX);
+    if(ret0 != RT_EOK){
+        LOG_E("[nRF24L01]nrf0 init failed \r\n");
+    }
+#if NRF24_USE_DUAL_RADIO
+    int ret1 = nRF24L01_Init(&nrf24_radio1, "nrf1", &g_nrf24_hw_radio1, &g_cb, ROLE_PRX);
+    if(ret1 != RT_EOK){
+        LOG_E("[nRF24L01]nrf1 init failed \r\n");
+    }
+#if NRF24_USE_DUPLEX
+    if(ret0 == RT_EOK && ret1 == RT_EOK
+       && nRF24L01_Duplex_Init(&nrf24_duplex, &nrf24_radio0, &nrf24_radio1, nrf24l01_duplex_rx_ind) != RT_EOK){
+        LOG_E("[nRF24L01]duplex init failed \r\n");
+    }
+#endif
+#endif
+
+    if(ret0 == RT_EOK){
+        nRF24L01_Thread_Start(&nrf24_radio0, &nrf24_thread0, nrf24_thread0_stack);
     }
-    else {
-        LOG_E("[nRF24L01]nRF24L01_Thread_entry is Failed \r\n");
+#if NRF24_USE_DUAL_RADIO
+    if(ret1 == RT_EOK){
+        nRF24L01_Thread_Start(&nrf24_radio1, &nrf24_thread1, nrf24_thread1_stack);
     }
+#endif
 
     return RT_EOK;
 }
@@ -174,7 +137,7 @@ INIT_APP_EXPORT(nRF24L01_Thread_Init);
 
 
 
-static void nrf24l01_tx_done(nrf24_t nrf24, rt_uint8_t pipe)
+static void nrf24l01_tx_done(nrf24_t nrf24, rt_uint8_t pipe, rt_uint16_t packet_id)
 {
     /*! Here just want to tell the user when the role is ROLE_PTX
         the pipe have no special meaning except indicating (send) FAILED or OK
@@ -183,15 +146,15 @@ static void nrf24l01_tx_done(nrf24_t nrf24, rt_uint8_t pipe)
     if(nrf24->nrf24_cfg.config.prim_rx == ROLE_PTX)
     {
         if(pipe == NRF24_PIPE_NONE){
-            rt_kprintf("tx_done failed");
+            LOG_W("tx_done failed, id = %d", packet_id);
         }
         else{
-            rt_kprintf("tx_done ok");
+            LOG_D("tx_done ok, id = %d", packet_id);
         }
     }
     else
     {
-        rt_kprintf("tx_done ok");
+        LOG_D("tx_done ok");
     }
 }
 
@@ -201,15 +164,29 @@ static void nrf24l01_tx_done(nrf24_t nrf24, rt_uint8_t pipe)
 static void nrf24l01_rx_ind(nrf24_t nrf24, uint8_t *data, uint8_t len, int pipe)
 {
     /*! Don't need to care the pipe if the role is ROLE_PTX */
-    rt_kprintf("(p%d): ", pipe);
-    rt_kprintf((char *)data);
+    LOG_D("(p%d): %.*s", pipe, len, (char *)data);
 }
 
 
 
+static void nrf24l01_msg_ind(nrf24_t nrf24, uint8_t *data, rt_uint16_t len, int pipe)
+{
+    LOG_I("(p%d): message %d bytes reassembled.", pipe, len);
+}
+
+
+#if NRF24_USE_DUAL_RADIO && NRF24_USE_DUPLEX
+static void nrf24l01_duplex_rx_ind(struct nRF24L01_DUPLEX_STRUCT *duplex, const uint8_t *data, uint8_t len)
+{
+    LOG_D("duplex: %d bytes from %s.", len, duplex->rx->name);
+}
+#endif
+
+
 const static struct nrf24_callback g_cb = {
     .nrf24l01_rx_ind = nrf24l01_rx_ind,
     .nrf24l01_tx_done = nrf24l01_tx_done,
+    .nrf24l01_msg_ind = nrf24l01_msg_ind,
 };
 
 
@@ -116,10 +116,15 @@ extern "C"
  *                 such as     #define HAL_SPI_MODULE_ENABLED
  */
 
+/* SPI1 carries the second nRF24L01, enable it together with NRF24_USE_DUAL_RADIO */
 /*#define BSP_USING_SPI1*/
 #define BSP_USING_SPI2
 /*#define BSP_USING_SPI3*/
 
+/* nRF24L01 payload transfers (up to 33 bytes) use DMA, the thread sleeps on an rt_completion meanwhile */
+#define BSP_SPI2_TX_USING_DMA
+#define BSP_SPI2_RX_USING_DMA
+
 /*-------------------------- SPI CONFIG END --------------------------*/
 
 /*-------------------------- QSPI CONFIG BEGIN --------------------------*/
@@ -221,8 +226,10 @@ extern "C"
  *
  */
 
-/*#define BSP_USING_TIM*/
+#define BSP_USING_TIM
 #ifdef BSP_USING_TIM
+#define BSP_USING_TIM3      /* "timer3"：nRF24L01 收发切换的微秒定时（bsp_nrf24l01_turn.c） */
+#define BSP_USING_TIM4      /* "timer4"：nRF24L01 TDMA 时隙边界（bsp_nrf24l01_tdma.c） */
 /*#define BSP_USING_TIM15*/
 /*#define BSP_USING_TIM16*/
 /*#define BSP_USING_TIM17*/
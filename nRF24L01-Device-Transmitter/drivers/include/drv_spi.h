@@ -42,6 +42,12 @@ struct stm32_spi_device
 #define SPI_USING_RX_DMA_FLAG   (1<<0)
 #define SPI_USING_TX_DMA_FLAG   (1<<1)
 
+/* transfers shorter than this stay in polling mode: for a few bytes the
+   DMA setup and the context switch cost more than the transfer itself */
+#ifndef SPI_DMA_MIN_LENGTH
+#define SPI_DMA_MIN_LENGTH      8
+#endif
+
 /* stm32 spi dirver class */
 struct stm32_spi
 {
@@ -56,6 +62,8 @@ struct stm32_spi
     } dma;
     
     rt_uint8_t spi_dma_flag;
+    /* released from the DMA transfer complete callback */
+    struct rt_completion cpt;
     struct rt_spi_bus spi_bus;
 };
 
@@ -82,6 +82,7 @@ void ulog_flush(void);
 void ulog_async_output(void);
 void ulog_async_output_enabled(rt_bool_t enabled);
 void ulog_async_waiting_log(rt_int32_t time);
+rt_uint32_t ulog_async_drops(void);
 #endif
 
 /*
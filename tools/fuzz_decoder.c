@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_message.h"
+
+
+/***
+ * 帧解码器的主机模糊测试：fuzz_decoder [次数] [种子]
+ * bsp_nrf24l01_message.c 用 -fsanitize=address,undefined 编译，越界读写和未定义行为直接终止；
+ * 每次送入后检查解码状态，每次回调检查帧长和设备 ID，另外检查：
+ *   1. 随机字节流（帧头、合法 / 非法长度字节加权出现），随机切片
+ *   2. 任意噪声 + 合法帧 + 填充，随机切片，合法帧必须恰好解出一次且内容一致
+ *   3. 假帧头（设备 ID 不匹配）后紧跟合法帧，合法帧不能被吞掉
+ *   4. 设备 ID 正确、LEN 覆盖整个合法帧的假帧头，CRC 失败后要从帧头的下一个字节重扫出合法帧
+ */
+static rt_uint32_t fuzz_seed = 1;
+static rt_uint32_t fuzz_failed;
+
+static rt_uint32_t Fuzz_Random(void)
+{
+    fuzz_seed ^= fuzz_seed << 13;
+    fuzz_seed ^= fuzz_seed >> 17;
+    fuzz_seed ^= fuzz_seed << 5;
+    return fuzz_seed;
+}
+
+
+/***
+ * 期望的帧：frame[0] = LEN，之后为 ID_H ID_L TYPE STATE DATA
+ */
+struct fuzz_expect
+{
+    uint8_t     frame[FRAME_BUFFER_SIZE];
+    uint8_t     length;
+    rt_uint32_t matched;
+    rt_uint32_t frames;
+};
+
+
+static void Fuzz_Fail(const char *test, rt_uint32_t loop, const char *what)
+{
+    if (fuzz_failed++ < 10){
+        printf("FAIL %s loop %u: %s\n", test, loop, what);
+    }
+}
+
+
+static void Fuzz_Handler(void *parameter, uint8_t *frame, uint8_t length)
+{
+    struct fuzz_expect *expect = parameter;
+
+    if (length < CMD_MINI_LENGTH + 1 || length > FRAME_BUFFER_SIZE || length != frame[0] + 1){
+        Fuzz_Fail("handler", 0, "bad frame length");
+        return;
+    }
+    if (frame[1] != DEVICE_ID_H || frame[2] != DEVICE_ID_L){
+        Fuzz_Fail("handler", 0, "bad device id");
+        return;
+    }
+    if (expect == NULL){
+        return;
+    }
+    expect->frames++;
+    if (length == expect->length && memcmp(frame, expect->frame, length) == 0){
+        expect->matched++;
+    }
+}
+
+
+static void Fuzz_Check_State(nrf24_decoder_t dec, const char *test, rt_uint32_t loop)
+{
+    if (dec->step > Decode_Step_7 || dec->count > FRAME_BUFFER_SIZE){
+        Fuzz_Fail(test, loop, "decoder state out of range");
+    }
+    if (dec->step >= Decode_Step_3 && dec->step <= Decode_Step_5 && dec->count > dec->length + 1){
+        Fuzz_Fail(test, loop, "CMD_buffer written past LEN + 1");
+    }
+}
+
+
+/***
+ * 按 1~32 字节的随机切片送入，模拟一个个无线数据包
+ */
+static void Fuzz_Feed(nrf24_decoder_t dec, const uint8_t *buf, rt_uint32_t len, struct fuzz_expect *expect,
+                      const char *test, rt_uint32_t loop)
+{
+    rt_uint32_t pos, chunk;
+
+    for (pos = 0; pos < len; pos += chunk)
+    {
+        chunk = 1 + Fuzz_Random() % 32;
+        if (chunk > len - pos){
+            chunk = len - pos;
+        }
+        nrf24l01_decoder_feed(dec, &buf[pos], chunk, Fuzz_Handler, expect);
+        Fuzz_Check_State(dec, test, loop);
+    }
+}
+
+
+/***
+ * 组一帧随机的合法帧，返回总帧长，expect 记下解码后应得到的 LEN + 数据域
+ */
+static uint8_t Fuzz_Build(uint8_t *out, uint8_t data_len, struct fuzz_expect *expect)
+{
+    uint8_t data[FRAME_MAX_LENGTH], len;
+
+    for (uint8_t i = 0; i < data_len; i++){
+        data[i] = Fuzz_Random();
+    }
+    len = nrf24l01_build_frame(FRAME_TYPE_ACT, FRAME_STATE_ASK, data, data_len, out);
+
+    expect->length = len - 4;
+    memcpy(expect->frame, &out[2], expect->length);
+    expect->matched = expect->frames = 0;
+    return len;
+}
+
+
+/***
+ * 填充：0x00 不是帧头也不是合法 LEN，足够长时能让任何未完成的假帧走到 CRC 校验
+ */
+static rt_uint32_t Fuzz_Pad(uint8_t *out)
+{
+    memset(out, 0x00, FRAME_BUFFER_SIZE + 2);
+    return FRAME_BUFFER_SIZE + 2;
+}
+
+
+static void Fuzz_Expect_One(struct fuzz_expect *expect, const char *test, rt_uint32_t loop)
+{
+    if (expect->matched != 1){
+        Fuzz_Fail(test, loop, expect->matched ? "frame decoded twice" : "frame lost");
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    struct nRF24L01_DECODER_STRUCT dec;
+    struct fuzz_expect expect;
+    rt_uint32_t loops = 100000, len, data_len, noise, failed;
+    uint8_t buf[256];
+
+    if (argc > 1){
+        loops = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2){
+        fuzz_seed = strtoul(argv[2], NULL, 0) | 1;
+    }
+    printf("fuzz_decoder: %u loops, seed 0x%08x, FRAME_BUFFER_SIZE %d\n", loops, fuzz_seed, FRAME_BUFFER_SIZE);
+
+    // 1. 随机字节流
+    nrf24l01_decoder_init(&dec);
+    for (rt_uint32_t n = 0; n < loops; n++)
+    {
+        len = Fuzz_Random() % sizeof(buf);
+        for (rt_uint32_t i = 0; i < len; i++){
+            rt_uint32_t r = Fuzz_Random();
+            switch (r & 0x07){
+                case 0:  buf[i] = FRAME_HEAD1;                          break;
+                case 1:  buf[i] = FRAME_HEAD2;                          break;
+                case 2:  buf[i] = (r >> 8) % (FRAME_BUFFER_SIZE + 8);   break;
+                case 3:  buf[i] = (r & 0x100) ? DEVICE_ID_H : DEVICE_ID_L; break;
+                default: buf[i] = r >> 8;                               break;
+            }
+        }
+        Fuzz_Feed(&dec, buf, len, NULL, "random", n);
+    }
+    printf("  random : frames %u, crc_err %u, len_err %u, id_err %u, sync_drop %u\n",
+           dec.frames, dec.crc_errors, dec.length_errors, dec.id_errors, dec.sync_drops);
+
+    failed = fuzz_failed;
+    // 2. 任意噪声 + 合法帧 + 填充
+    for (rt_uint32_t n = 0; n < loops; n++)
+    {
+        nrf24l01_decoder_init(&dec);
+        noise = Fuzz_Random() % 64;
+        for (rt_uint32_t i = 0; i < noise; i++){
+            rt_uint32_t r = Fuzz_Random();
+            buf[i] = (r & 0x300) ? (uint8_t)r : ((r & 0x400) ? FRAME_HEAD2 : FRAME_HEAD1);
+        }
+        data_len = Fuzz_Random() % (FRAME_MAX_LENGTH - CMD_MINI_LENGTH + 1);
+        len = noise + Fuzz_Build(&buf[noise], data_len, &expect);
+        len += Fuzz_Pad(&buf[len]);
+        Fuzz_Feed(&dec, buf, len, &expect, "noise", n);
+        Fuzz_Expect_One(&expect, "noise", n);
+    }
+    printf("  noise  : %s\n", (fuzz_failed == failed) ? "ok" : "FAILED");
+
+    failed = fuzz_failed;
+    // 3. 假帧头：55 AA LEN 之后设备 ID 不匹配，合法帧紧跟在后面或就是不匹配的那个字节
+    for (rt_uint32_t n = 0; n < loops; n++)
+    {
+        nrf24l01_decoder_init(&dec);
+        len = 0;
+        buf[len++] = FRAME_HEAD1;
+        buf[len++] = FRAME_HEAD2;
+        buf[len++] = CMD_MINI_LENGTH + Fuzz_Random() % (FRAME_MAX_LENGTH - CMD_MINI_LENGTH + 1);
+        if (Fuzz_Random() & 1){
+            buf[len++] = DEVICE_ID_H;
+        }
+        data_len = Fuzz_Random() % (FRAME_MAX_LENGTH - CMD_MINI_LENGTH + 1);
+        len += Fuzz_Build(&buf[len], data_len, &expect);
+        len += Fuzz_Pad(&buf[len]);
+        Fuzz_Feed(&dec, buf, len, &expect, "false header", n);
+        Fuzz_Expect_One(&expect, "false header", n);
+    }
+    printf("  header : %s\n", (fuzz_failed == failed) ? "ok" : "FAILED");
+
+    failed = fuzz_failed;
+    // 4. 假帧头的 LEN 覆盖整个合法帧，CRC 失败后重扫
+    for (rt_uint32_t n = 0; n < loops; n++)
+    {
+        rt_uint32_t frame_len, lead, span;
+
+        nrf24l01_decoder_init(&dec);
+        data_len  = Fuzz_Random() % (FRAME_MAX_LENGTH - CMD_MINI_LENGTH - 8 + 1);
+        frame_len = data_len + CMD_MINI_LENGTH + 5;
+        lead      = Fuzz_Random() % (FRAME_MAX_LENGTH - 2 - frame_len + 1);
+        span      = 2 + lead + frame_len + Fuzz_Random() % (FRAME_MAX_LENGTH - 2 - lead - frame_len + 1);
+
+        len = 0;
+        buf[len++] = FRAME_HEAD1;
+        buf[len++] = FRAME_HEAD2;
+        buf[len++] = span;
+        buf[len++] = DEVICE_ID_H;
+        buf[len++] = DEVICE_ID_L;
+        for (rt_uint32_t i = 0; i < lead; i++){
+            buf[len++] = Fuzz_Random() & 0x3F;
+        }
+        len += Fuzz_Build(&buf[len], data_len, &expect);
+        while (len < 3 + span){
+            buf[len++] = Fuzz_Random() & 0x3F;
+        }
+        // 假帧的 CRC 故意取反，保证校验失败
+        {
+            uint16_t crc = ~CrcCalc_Crc16Modbus(&buf[2], span + 1);
+            buf[len++] = crc >> 8;
+            buf[len++] = crc & 0xFF;
+        }
+        len += Fuzz_Pad(&buf[len]);
+        Fuzz_Feed(&dec, buf, len, &expect, "crc resync", n);
+        Fuzz_Expect_One(&expect, "crc resync", n);
+        if (dec.crc_errors == 0){
+            Fuzz_Fail("crc resync", n, "false frame passed CRC");
+        }
+    }
+    printf("  crc    : %s\n", (fuzz_failed == failed) ? "ok" : "FAILED");
+
+    printf("fuzz_decoder: %s\n", fuzz_failed ? "FAILED" : "PASSED");
+    return fuzz_failed ? 1 : 0;
+}
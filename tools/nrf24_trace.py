@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+nRF24L01 binary trace decoder.
+
+Firmware built with NRF24_TRACE_BINARY = 1 (applications/macBSP/bsp_nrf24l01_trace.h)
+writes compact records instead of formatted log lines. The format strings live in
+the ELF's non-loaded .nrf24_trace section; this tool reads them back and prints
+the text. Bytes outside valid records (msh output, rt_kprintf) pass through as-is.
+
+Record (little endian):
+    A5 | level<<4 | nargs | id(2) | DWT cycles(4) | args(4 * nargs) | sum8
+    nargs == 0xF : hex dump, args are name address(4) + len(1) + data
+    id == 0      : trace drop report, arg0 is the number of dropped records
+
+Usage:
+    nrf24_trace.py rtthread.elf /dev/ttyUSB0 [--baud 115200]
+    nrf24_trace.py rtthread.elf capture.bin
+    nrf24_trace.py rtthread.elf - < capture.bin
+
+pyserial is only needed when reading from a serial port.
+"""
+
+import argparse
+import codecs
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_SIZE = 8
+TYPE_HEX = 0x0F
+ID_DROP = 0
+LEVEL_NAME = {3: 'E', 4: 'W', 6: 'I', 7: 'D'}
+
+
+class Elf(object):
+    """Minimal ELF32 little endian reader: section headers only."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b'\x7fELF' or d[4] != 1 or d[5] != 1:
+            raise ValueError('%s: not a 32-bit little endian ELF' % path)
+        shoff, = struct.unpack_from('<I', d, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', d, 0x2E)
+        raw = []
+        for i in range(shnum):
+            raw.append(struct.unpack_from('<IIIIIIIIII', d, shoff + i * shentsize))
+        strtab = raw[shstrndx]
+        self.sections = []
+        for (name, typ, flags, addr, off, size, _, _, _, _) in raw:
+            end = d.index(b'\0', strtab[4] + name)
+            sname = d[strtab[4] + name:end].decode('ascii', 'replace')
+            self.sections.append((sname, typ, flags, addr, off, size))
+
+    def section(self, name):
+        for s in self.sections:
+            if s[0] == name:
+                return s
+        return None
+
+    def cstring(self, addr):
+        """Read a NUL terminated string from an allocated, file backed section."""
+        for (_, typ, flags, base, off, size) in self.sections:
+            # SHF_ALLOC and not SHT_NOBITS
+            if (flags & 0x2) and typ != 8 and base <= addr < base + size:
+                start = off + addr - base
+                end = self.data.find(b'\0', start, off + size)
+                if end < 0:
+                    end = off + size
+                return self.data[start:end].decode('utf-8', 'replace')
+        return None
+
+
+class Formats(object):
+    def __init__(self, elf):
+        sec = elf.section('.nrf24_trace')
+        if sec is None:
+            raise ValueError('no .nrf24_trace section, was the firmware built with NRF24_TRACE_BINARY = 1?')
+        _, _, _, base, off, size = sec
+        self.elf = elf
+        self.base = base
+        self.blob = elf.data[off:off + size]
+
+    def get(self, fid):
+        pos = fid - self.base
+        if pos < 0 or pos >= len(self.blob):
+            return None
+        end = self.blob.find(b'\0', pos)
+        return self.blob[pos:end if end >= 0 else len(self.blob)].decode('utf-8', 'replace')
+
+
+SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|t)?([diouxXcsp%])')
+
+
+def render(fmt, args, elf):
+    """Apply a C printf format to 32-bit raw arguments."""
+    args = list(args)
+    out = []
+    last = 0
+
+    def take():
+        return args.pop(0) if args else 0
+
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, _, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        if width == '*':
+            width = str(struct.unpack('<i', struct.pack('<I', take()))[0])
+        if prec == '*':
+            prec = str(take())
+        v = take()
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        if conv in 'di':
+            out.append((spec + 'd') % struct.unpack('<i', struct.pack('<I', v))[0])
+        elif conv == 'c':
+            out.append((spec + 's') % chr(v & 0xFF))
+        elif conv == 's':
+            s = elf.cstring(v)
+            # RAM strings are gone by the time the record is decoded, print the address instead
+            out.append((spec + 's') % s if s is not None else '<0x%08x>' % v)
+        elif conv == 'p':
+            out.append((spec + 's') % ('0x%08x' % v))
+        else:
+            out.append((spec + conv) % v)
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+class Clock(object):
+    """Unwrap the 32-bit DWT cycle counter into seconds since the first record."""
+
+    def __init__(self, hz):
+        self.hz = hz
+        self.last = None
+        self.total = 0
+
+    def seconds(self, cycles):
+        if self.last is not None:
+            self.total += (cycles - self.last) & 0xFFFFFFFF
+        self.last = cycles
+        return self.total / float(self.hz)
+
+
+class Decoder(object):
+    def __init__(self, elf, formats, clock, out, stream):
+        self.elf = elf
+        self.formats = formats
+        self.clock = clock
+        self.out = out
+        self.stream = stream
+        self.buf = bytearray()
+        self.pending_cr = False
+        self.utf8 = codecs.getincrementaldecoder('utf-8')('replace')
+        self.records = 0
+        self.bad = 0
+
+    def _undo_stream(self, data):
+        # The console opened with RT_DEVICE_FLAG_STREAM turns every 0x0A into 0x0D 0x0A
+        res = bytearray()
+        for b in data:
+            if self.pending_cr:
+                self.pending_cr = False
+                if b != 0x0A:
+                    res.append(0x0D)
+            if b == 0x0D:
+                self.pending_cr = True
+                continue
+            res.append(b)
+        return res
+
+    def _text(self, data):
+        if data:
+            self.out.write(self.utf8.decode(data))
+
+    def _record_length(self):
+        """Length of the record at buf[0], None when more bytes are needed, 0 when invalid."""
+        if len(self.buf) < HEADER_SIZE:
+            return None
+        nargs = self.buf[1] & 0x0F
+        if (self.buf[1] >> 4) not in LEVEL_NAME:
+            return 0
+        if nargs == TYPE_HEX:
+            if len(self.buf) < HEADER_SIZE + 5:
+                return None
+            return HEADER_SIZE + 5 + self.buf[HEADER_SIZE + 4] + 1
+        return HEADER_SIZE + 4 * nargs + 1
+
+    def _emit(self, rec):
+        level = rec[1] >> 4
+        nargs = rec[1] & 0x0F
+        fid, cycles = struct.unpack_from('<HI', rec, 2)
+        ts = self.clock.seconds(cycles)
+        prefix = '[%12.6f] %s/nrf24: ' % (ts, LEVEL_NAME[level])
+
+        if nargs == TYPE_HEX:
+            name_addr, n = struct.unpack_from('<IB', rec, HEADER_SIZE)
+            name = self.elf.cstring(name_addr) or '<0x%08x>' % name_addr
+            data = rec[HEADER_SIZE + 5:HEADER_SIZE + 5 + n]
+            self.out.write('%s%s: %s\n' % (prefix, name, ' '.join('%02X' % b for b in data)))
+            return
+
+        args = struct.unpack_from('<%dI' % nargs, rec, HEADER_SIZE)
+        if fid == ID_DROP:
+            self.out.write('%s<trace: %d records dropped>\n' % (prefix, args[0] if args else 0))
+            return
+        fmt = self.formats.get(fid)
+        if fmt is None:
+            self.out.write('%s<unknown id 0x%04x> %s\n' % (prefix, fid, ' '.join('%08x' % a for a in args)))
+            return
+        self.out.write(prefix + render(fmt, args, self.elf) + '\n')
+
+    def feed(self, data):
+        if self.stream:
+            data = self._undo_stream(data)
+        self.buf += data
+        while self.buf:
+            start = self.buf.find(bytes([SYNC]))
+            if start < 0:
+                self._text(bytes(self.buf))
+                self.buf = bytearray()
+                break
+            if start > 0:
+                self._text(bytes(self.buf[:start]))
+                del self.buf[:start]
+            n = self._record_length()
+            if n is None:
+                break
+            if n and len(self.buf) < n:
+                break
+            if n and (sum(self.buf[1:n - 1]) & 0xFF) == self.buf[n - 1]:
+                self._emit(bytes(self.buf[:n]))
+                self.records += 1
+                del self.buf[:n]
+            else:
+                # Not a record, the 0xA5 belongs to the text stream
+                self.bad += 1
+                self._text(bytes(self.buf[:1]))
+                del self.buf[:1]
+        self.out.flush()
+
+
+def open_input(path, baud):
+    if path == '-':
+        return getattr(sys.stdin, 'buffer', sys.stdin)
+    if path.startswith('/dev/') or path.upper().startswith('COM'):
+        try:
+            import serial
+        except ImportError:
+            sys.exit('reading a serial port needs pyserial: pip install pyserial')
+        return serial.Serial(path, baud, timeout=0.1)
+    return open(path, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode nRF24L01 binary trace records.')
+    parser.add_argument('elf', help='firmware ELF built with NRF24_TRACE_BINARY = 1')
+    parser.add_argument('input', help='serial port, capture file, or - for stdin')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--hz', type=int, default=72000000, help='core clock of the DWT cycle counter')
+    parser.add_argument('--no-stream', dest='stream', action='store_false',
+                        help='the trace device is not opened in stream mode (no CR before LF)')
+    opts = parser.parse_args()
+
+    elf = Elf(opts.elf)
+    dec = Decoder(elf, Formats(elf), Clock(opts.hz), sys.stdout, opts.stream)
+    src = open_input(opts.input, opts.baud)
+    try:
+        while True:
+            data = src.read(256)
+            if not data:
+                if hasattr(src, 'in_waiting'):
+                    continue
+                break
+            dec.feed(bytearray(data))
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write('%d records, %d resyncs\n' % (dec.records, dec.bad))
+
+
+if __name__ == '__main__':
+    main()
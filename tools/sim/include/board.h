@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#ifndef __BOARD_H__
+#define __BOARD_H__
+
+#include <rtthread.h>
+#include <stm32f1xx.h>
+#include <drv_common.h>
+
+/* 主机构建只有 SPI2 上的一片 nRF24L01（由软件模型代替） */
+#define BSP_USING_SPI2
+
+/* 硬件定时器由 rthost.c 按虚拟时钟实现，设备名与 tim_config.h 相同 */
+#define BSP_USING_TIM
+#define BSP_USING_TIM2
+#define BSP_USING_TIM3
+#define BSP_USING_TIM4
+
+#endif /* __BOARD_H__ */
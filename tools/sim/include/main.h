@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include "stm32f1xx.h"
+#include "bsp_sys.h"
+
+/* 与 cubemx/Inc/main.h 相同的引脚定义 */
+#define nRF24L01_CSN_Pin GPIO_PIN_12
+#define nRF24L01_CSN_GPIO_Port GPIOB
+#define nRF24L01_CE_Pin GPIO_PIN_6
+#define nRF24L01_CE_GPIO_Port GPIOC
+#define nRF24L01_IRQ_Pin GPIO_PIN_7
+#define nRF24L01_IRQ_GPIO_Port GPIOC
+
+#endif /* __MAIN_H */
@@ -0,0 +1,8 @@
+#ifndef RTCONFIG_PREINC_H__
+#define RTCONFIG_PREINC_H__
+
+/* 主机构建：RT-Thread pre-include file */
+
+#define __RTTHREAD__
+
+#endif /*RTCONFIG_PREINC_H__*/
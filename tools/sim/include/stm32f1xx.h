@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#ifndef TOOLS_SIM_STM32F1XX_H_
+#define TOOLS_SIM_STM32F1XX_H_
+
+#include <stdint.h>
+
+/***
+ * 主机构建用的 CMSIS / HAL 子集
+ * DWT / SysTick 每次访问都从 rthost.c 的虚拟时钟刷新，读一次计一个 CPU 周期，
+ * 因此驱动里按 DWT 忙等的代码在主机上同样会结束；GPIO / RCC 只保留驱动用到的类型和常量
+ */
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t DHCSR;
+    volatile uint32_t DCRSR;
+    volatile uint32_t DCRDR;
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+DWT_Type       *host_dwt(void);
+SysTick_Type   *host_systick(void);
+extern CoreDebug_Type host_core_debug;
+extern uint32_t SystemCoreClock;
+
+#define DWT         (host_dwt())
+#define SysTick     (host_systick())
+#define CoreDebug   (&host_core_debug)
+
+
+typedef struct
+{
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef host_gpio[5];
+
+/* 只用于 GET_PIN 计算引脚编号，与芯片的外设地址一致 */
+#define GPIOA_BASE              0x40010800UL
+#define GPIOB_BASE              0x40010C00UL
+#define GPIOC_BASE              0x40011000UL
+#define GPIOD_BASE              0x40011400UL
+#define GPIOE_BASE              0x40011800UL
+#define GPIOA                   (&host_gpio[0])
+#define GPIOB                   (&host_gpio[1])
+#define GPIOC                   (&host_gpio[2])
+#define GPIOD                   (&host_gpio[3])
+#define GPIOE                   (&host_gpio[4])
+
+#define GPIO_PIN_0              ((uint16_t)0x0001)
+#define GPIO_PIN_1              ((uint16_t)0x0002)
+#define GPIO_PIN_2              ((uint16_t)0x0004)
+#define GPIO_PIN_3              ((uint16_t)0x0008)
+#define GPIO_PIN_4              ((uint16_t)0x0010)
+#define GPIO_PIN_5              ((uint16_t)0x0020)
+#define GPIO_PIN_6              ((uint16_t)0x0040)
+#define GPIO_PIN_7              ((uint16_t)0x0080)
+#define GPIO_PIN_8              ((uint16_t)0x0100)
+#define GPIO_PIN_9              ((uint16_t)0x0200)
+#define GPIO_PIN_10             ((uint16_t)0x0400)
+#define GPIO_PIN_11             ((uint16_t)0x0800)
+#define GPIO_PIN_12             ((uint16_t)0x1000)
+#define GPIO_PIN_13             ((uint16_t)0x2000)
+#define GPIO_PIN_14             ((uint16_t)0x4000)
+#define GPIO_PIN_15             ((uint16_t)0x8000)
+
+#define GPIO_MODE_OUTPUT_PP     0x00000001U
+#define GPIO_NOPULL             0x00000000U
+#define GPIO_SPEED_FREQ_HIGH    0x00000003U
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+#endif /* TOOLS_SIM_STM32F1XX_H_ */
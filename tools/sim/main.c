@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <finsh.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/***
+ * 主机上运行整个驱动：nrf24_host [-q] "<msh 命令>" ["<msh 命令>" ...]
+ * 启动后先执行全部 INIT_xxx_EXPORT（nRF24L01_Thread_Init 会启动射频线程，实例占用节点 0，其余节点为模型内置的对端，nrf24_sim node 可再加实例），
+ * 然后每个参数作为一行 msh 命令在 tshell 优先级下依次执行；
+ * sleep <ms> 让虚拟时钟前进，help 列出全部命令；-q 只输出 INFO 及以上的日志
+ */
+void rt_host_startup(void);
+
+extern const struct finsh_syscall __start_FSymTab[];
+extern const struct finsh_syscall __stop_FSymTab[];
+
+
+/***
+ * @brief x86_64 上 gcc 把每个 finsh_syscall 按 16 字节对齐，表项之间有填充，与 shell.c 的 finsh_syscall_next 一样跳过全零的填充
+ */
+static const struct finsh_syscall *host_msh_next(const struct finsh_syscall *call)
+{
+    const rt_ubase_t *ptr = (const rt_ubase_t *)(call + 1);
+
+    while((const void *)ptr < (const void *)__stop_FSymTab && *ptr == 0){
+        ptr++;
+    }
+    return (const struct finsh_syscall *)ptr;
+}
+
+
+static const struct finsh_syscall *host_msh_find(const char *name)
+{
+    for(const struct finsh_syscall *call = __start_FSymTab; call < __stop_FSymTab; call = host_msh_next(call))
+    {
+        if(strcmp(call->name, name) == 0){
+            return call;
+        }
+    }
+    return RT_NULL;
+}
+
+
+static int host_msh_exec(char *line)
+{
+    char *argv[FINSH_ARG_MAX];
+    int argc = 0;
+    const struct finsh_syscall *call;
+
+    for(char *tok = strtok(line, " \t"); tok != RT_NULL && argc < FINSH_ARG_MAX; tok = strtok(RT_NULL, " \t")){
+        argv[argc++] = tok;
+    }
+    if(argc == 0){
+        return 0;
+    }
+    rt_kprintf("msh >%s", argv[0]);
+    for(int i = 1; i < argc; i++){
+        rt_kprintf(" %s", argv[i]);
+    }
+    rt_kprintf("\n");
+
+    if(strcmp(argv[0], "sleep") == 0){
+        rt_thread_mdelay(argc > 1 ? atoi(argv[1]) : 1000);
+        return 0;
+    }
+    if(strcmp(argv[0], "help") == 0){
+        for(call = __start_FSymTab; call < __stop_FSymTab; call = host_msh_next(call)){
+            rt_kprintf("%-16s - %s\n", call->name, call->desc);
+        }
+        return 0;
+    }
+    call = host_msh_find(argv[0]);
+    if(call == RT_NULL){
+        rt_kprintf("%s: command not found.\n", argv[0]);
+        return -1;
+    }
+    ((int (*)(int, char **))call->func)(argc, argv);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    int first = 1, result = 0;
+
+    setvbuf(stdout, RT_NULL, _IOLBF, 0);
+    if(argc > 1 && strcmp(argv[1], "-q") == 0){
+        ulog_global_filter_lvl_set(LOG_LVL_INFO);
+        first = 2;
+    }
+
+    rt_host_startup();
+    for(int i = first; i < argc; i++)
+    {
+        if(host_msh_exec(argv[i]) != 0){
+            result = 1;
+        }
+    }
+    fflush(stdout);
+    return result;
+}
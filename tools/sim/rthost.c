@@ -0,0 +1,1230 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <rthw.h>
+#include <rtdevice.h>
+#include <board.h>
+#include <drv_spi.h>
+#include <ulog.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+
+/***
+ * 主机上的 RT-Thread 内核
+ * 每个 rt_thread 对应一个 pthread，但任何时刻只有持有 host_lock 且等于 host_current 的线程在运行，
+ * 调度按优先级抢占：释放信号量 / 内存块、启动线程、退出临界区时，若有更高优先级的线程就绪则立即切换；
+ * 时间是虚拟的：全部线程挂起时直接跳到下一个定时器到期的时刻，读 DWT / SysTick 时走一个 CPU 周期，
+ * 因此 60s 的仿真只需要很短的实际时间，并且每次运行的结果完全相同；
+ * 定时器按软定时器处理，在调度点（线程挂起、释放 IPC、退出临界区）检查到期，调度器上锁时不执行
+ */
+#define HOST_CORE_CLOCK         72000000U
+#define HOST_CYCLES_PER_TICK    (HOST_CORE_CLOCK / RT_TICK_PER_SECOND)
+
+struct host_context
+{
+    pthread_t       pthread;
+    pthread_cond_t  cond;
+};
+
+uint32_t SystemCoreClock = HOST_CORE_CLOCK;
+CoreDebug_Type host_core_debug;
+GPIO_TypeDef host_gpio[5];
+
+static pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+static rt_uint64_t host_cycles;
+static rt_thread_t host_current;
+static struct rt_thread host_main_thread;
+static struct rt_thread host_idle_thread;
+static rt_list_t host_ready[RT_THREAD_PRIORITY_MAX];
+static rt_list_t host_timers = RT_LIST_OBJECT_INIT(host_timers);
+static rt_list_t host_devices = RT_LIST_OBJECT_INIT(host_devices);
+static rt_uint16_t host_sched_lock;
+static rt_uint8_t  host_irq_nest;
+static rt_base_t   host_irq_off;
+static rt_err_t    host_errno;
+static void (*host_sched_hook)(struct rt_thread *from, struct rt_thread *to);
+
+
+
+//以下是虚拟时钟和 CMSIS 外设---------------------------------------------------------------------------------------------
+
+/***
+ * @brief DWT：写 CYCCNT 只改变计数的起点，读一次走一个 CPU 周期
+ */
+DWT_Type *host_dwt(void)
+{
+    static DWT_Type   dwt;
+    static rt_uint32_t base, last;
+
+    if(dwt.CYCCNT != last){
+        base = (rt_uint32_t)host_cycles - dwt.CYCCNT;
+    }
+    host_cycles++;
+    dwt.CYCCNT = last = (rt_uint32_t)host_cycles - base;
+    return &dwt;
+}
+
+
+/***
+ * @brief SysTick：每个 tick 重装一次，VAL 向下计数
+ */
+SysTick_Type *host_systick(void)
+{
+    static SysTick_Type systick;
+
+    host_cycles++;
+    systick.LOAD = HOST_CYCLES_PER_TICK - 1;
+    systick.VAL  = systick.LOAD - (rt_uint32_t)(host_cycles % HOST_CYCLES_PER_TICK);
+    return &systick;
+}
+
+
+rt_tick_t rt_tick_get(void)
+{
+    return (rt_tick_t)(host_cycles / HOST_CYCLES_PER_TICK);
+}
+
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    if(ms < 0){
+        return (rt_tick_t)RT_WAITING_FOREVER;
+    }
+    return (rt_tick_t)(((rt_uint64_t)ms * RT_TICK_PER_SECOND + 999) / 1000);
+}
+
+
+
+//以下是定时器---------------------------------------------------------------------------------------------
+
+void rt_timer_init(rt_timer_t timer, const char *name, void (*timeout)(void *parameter), void *parameter, rt_tick_t time, rt_uint8_t flag)
+{
+    rt_strncpy(timer->parent.name, name, RT_NAME_MAX);
+    timer->parent.type   = RT_Object_Class_Timer;
+    timer->parent.flag   = flag & ~RT_TIMER_FLAG_ACTIVATED;
+    timer->timeout_func  = timeout;
+    timer->parameter     = parameter;
+    timer->init_tick     = time;
+    timer->timeout_tick  = 0;
+    rt_list_init(&timer->row[0]);
+}
+
+
+rt_err_t rt_timer_stop(rt_timer_t timer)
+{
+    if(!(timer->parent.flag & RT_TIMER_FLAG_ACTIVATED)){
+        return -RT_ERROR;
+    }
+    rt_list_remove(&timer->row[0]);
+    timer->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+    return RT_EOK;
+}
+
+
+/***
+ * @brief 按到期时刻有序插入，同一时刻先启动的先执行
+ */
+rt_err_t rt_timer_start(rt_timer_t timer)
+{
+    rt_list_t *pos;
+
+    rt_timer_stop(timer);
+    timer->timeout_tick = rt_tick_get() + timer->init_tick;
+    for(pos = host_timers.next; pos != &host_timers; pos = pos->next)
+    {
+        rt_timer_t t = rt_list_entry(pos, struct rt_timer, row[0]);
+        if((rt_int32_t)(t->timeout_tick - timer->timeout_tick) > 0){
+            break;
+        }
+    }
+    rt_list_insert_before(pos, &timer->row[0]);
+    timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
+    return RT_EOK;
+}
+
+
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg)
+{
+    switch(cmd)
+    {
+    case RT_TIMER_CTRL_SET_TIME:
+        timer->init_tick = *(rt_tick_t *)arg;
+        break;
+    case RT_TIMER_CTRL_GET_TIME:
+        *(rt_tick_t *)arg = timer->init_tick;
+        break;
+    case RT_TIMER_CTRL_SET_ONESHOT:
+        timer->parent.flag &= ~RT_TIMER_FLAG_PERIODIC;
+        break;
+    case RT_TIMER_CTRL_SET_PERIODIC:
+        timer->parent.flag |= RT_TIMER_FLAG_PERIODIC;
+        break;
+    case RT_TIMER_CTRL_GET_STATE:
+        *(rt_uint32_t *)arg = (timer->parent.flag & RT_TIMER_FLAG_ACTIVATED) ? RT_TIMER_FLAG_ACTIVATED : RT_TIMER_FLAG_DEACTIVATED;
+        break;
+    default:
+        return -RT_ERROR;
+    }
+    return RT_EOK;
+}
+
+
+#ifdef BSP_USING_TIM
+/***
+ * 硬件定时器：上层仍是 RT-Thread 的 hwtimer 框架，这里只代替 drv_hwtimer.c，参数与 tim_config.h 的 TIM_DEV_INFO_CONFIG 相同；
+ * 计数按虚拟时钟折算，溢出时刻精确到 CPU 周期，与软定时器一样在调度点检查，全部线程挂起时虚拟时钟直接跳到溢出时刻
+ */
+struct host_hwtimer
+{
+    rt_hwtimer_t        time_device;
+    const char         *name;
+    rt_uint32_t         div;            // 每个计数的 CPU 周期数
+    rt_uint32_t         period;         // 溢出的计数值
+    rt_hwtimer_mode_t   opm;
+    rt_uint64_t         start;          // 本轮开始计数的时刻
+    rt_uint64_t         deadline;       // 本轮溢出的时刻，0 表示停止
+};
+
+static const struct rt_hwtimer_info host_hwtimer_info =
+{
+    .maxfreq = 1000000,
+    .minfreq = 2000,
+    .maxcnt  = 0xFFFF,
+    .cntmode = HWTIMER_CNTMODE_UP,
+};
+
+static struct host_hwtimer host_hwtimer_obj[] =
+{
+#ifdef BSP_USING_TIM2
+    { .name = "timer2" },
+#endif
+#ifdef BSP_USING_TIM3
+    { .name = "timer3" },
+#endif
+#ifdef BSP_USING_TIM4
+    { .name = "timer4" },
+#endif
+};
+
+
+static void host_hwtimer_init(rt_hwtimer_t *timer, rt_uint32_t state)
+{
+    struct host_hwtimer *tim = (struct host_hwtimer *)timer;
+
+    tim->div = HOST_CORE_CLOCK / 10000;
+    tim->deadline = 0;
+}
+
+
+static rt_err_t host_hwtimer_start(rt_hwtimer_t *timer, rt_uint32_t cnt, rt_hwtimer_mode_t mode)
+{
+    struct host_hwtimer *tim = (struct host_hwtimer *)timer;
+
+    tim->period   = (cnt > 1) ? cnt : 1;
+    tim->opm      = mode;
+    tim->start    = host_cycles;
+    tim->deadline = host_cycles + (rt_uint64_t)tim->period * tim->div;
+    return RT_EOK;
+}
+
+
+static void host_hwtimer_stop(rt_hwtimer_t *timer)
+{
+    ((struct host_hwtimer *)timer)->deadline = 0;
+}
+
+
+static rt_uint32_t host_hwtimer_count_get(rt_hwtimer_t *timer)
+{
+    struct host_hwtimer *tim = (struct host_hwtimer *)timer;
+
+    if(tim->deadline == 0){
+        return 0;
+    }
+    return (rt_uint32_t)((host_cycles - tim->start) / tim->div);
+}
+
+
+static rt_err_t host_hwtimer_control(rt_hwtimer_t *timer, rt_uint32_t cmd, void *arg)
+{
+    if(cmd != HWTIMER_CTRL_FREQ_SET){
+        return -RT_ENOSYS;
+    }
+    ((struct host_hwtimer *)timer)->div = HOST_CORE_CLOCK / *(rt_uint32_t *)arg;
+    return RT_EOK;
+}
+
+
+static const struct rt_hwtimer_ops host_hwtimer_ops =
+{
+    .init      = host_hwtimer_init,
+    .start     = host_hwtimer_start,
+    .stop      = host_hwtimer_stop,
+    .count_get = host_hwtimer_count_get,
+    .control   = host_hwtimer_control,
+};
+
+
+static int host_hwtimer_register(void)
+{
+    for(rt_size_t i = 0; i < sizeof(host_hwtimer_obj) / sizeof(host_hwtimer_obj[0]); i++)
+    {
+        host_hwtimer_obj[i].time_device.info = &host_hwtimer_info;
+        host_hwtimer_obj[i].time_device.ops  = &host_hwtimer_ops;
+        rt_device_hwtimer_register(&host_hwtimer_obj[i].time_device, host_hwtimer_obj[i].name, RT_NULL);
+    }
+    return 0;
+}
+INIT_BOARD_EXPORT(host_hwtimer_register);
+
+
+/***
+ * @brief 执行已溢出的硬件定时器，单次模式溢出后停止，周期模式从溢出时刻开始下一轮
+ */
+static void host_hwtimer_check(void)
+{
+    for(rt_size_t i = 0; i < sizeof(host_hwtimer_obj) / sizeof(host_hwtimer_obj[0]); i++)
+    {
+        struct host_hwtimer *tim = &host_hwtimer_obj[i];
+        if(tim->deadline == 0 || tim->deadline > host_cycles){
+            continue;
+        }
+        tim->start    = tim->deadline;
+        tim->deadline = (tim->opm == HWTIMER_MODE_PERIOD) ? tim->deadline + (rt_uint64_t)tim->period * tim->div : 0;
+        host_irq_nest++;
+        rt_device_hwtimer_isr(&tim->time_device);
+        host_irq_nest--;
+    }
+}
+
+
+/***
+ * @brief 最早一个硬件定时器的溢出时刻，早于 *at 时写入 *at，没有运行中的定时器时返回 RT_FALSE
+ */
+static rt_bool_t host_hwtimer_next(rt_uint64_t *at, rt_bool_t valid)
+{
+    for(rt_size_t i = 0; i < sizeof(host_hwtimer_obj) / sizeof(host_hwtimer_obj[0]); i++)
+    {
+        rt_uint64_t deadline = host_hwtimer_obj[i].deadline;
+        if(deadline != 0 && (!valid || deadline < *at)){
+            *at = deadline;
+            valid = RT_TRUE;
+        }
+    }
+    return valid;
+}
+#endif
+
+
+/***
+ * @brief 执行全部已到期的定时器，回调按中断上下文处理，不会在回调中切换线程
+ */
+static void host_timer_check(void)
+{
+    rt_tick_t now = rt_tick_get();
+
+    if(host_sched_lock > 0 || host_irq_nest > 0 || host_irq_off){
+        return;
+    }
+#ifdef BSP_USING_TIM
+    host_hwtimer_check();
+#endif
+    while(!rt_list_isempty(&host_timers))
+    {
+        rt_timer_t t = rt_list_entry(host_timers.next, struct rt_timer, row[0]);
+        if((rt_int32_t)(now - t->timeout_tick) < 0){
+            break;
+        }
+        rt_timer_stop(t);
+        host_irq_nest++;
+        t->timeout_func(t->parameter);
+        host_irq_nest--;
+        if((t->parent.flag & RT_TIMER_FLAG_PERIODIC) && !(t->parent.flag & RT_TIMER_FLAG_ACTIVATED)){
+            rt_timer_start(t);
+        }
+    }
+}
+
+
+
+//以下是调度器---------------------------------------------------------------------------------------------
+
+static struct host_context *host_ctx(rt_thread_t thread)
+{
+    return (struct host_context *)thread->sp;
+}
+
+
+static void host_ready_insert(rt_thread_t thread, rt_bool_t head)
+{
+    thread->stat = RT_THREAD_READY;
+    if(head){
+        rt_list_insert_after(&host_ready[thread->current_priority], &thread->tlist);
+    }
+    else{
+        rt_list_insert_before(&host_ready[thread->current_priority], &thread->tlist);
+    }
+}
+
+
+static rt_thread_t host_highest(void)
+{
+    for(int prio = 0; prio < RT_THREAD_PRIORITY_MAX; prio++)
+    {
+        if(!rt_list_isempty(&host_ready[prio])){
+            return rt_list_entry(host_ready[prio].next, struct rt_thread, tlist);
+        }
+    }
+    return RT_NULL;
+}
+
+
+/***
+ * @brief 没有就绪线程：虚拟时钟跳到最早的定时器（软定时器或硬件定时器）并执行到期的定时器
+ */
+static void host_idle(void)
+{
+    rt_bool_t valid = !rt_list_isempty(&host_timers);
+    rt_uint64_t at = 0;
+
+    if(valid){
+        rt_timer_t t = rt_list_entry(host_timers.next, struct rt_timer, row[0]);
+        at = (host_cycles / HOST_CYCLES_PER_TICK + (rt_int32_t)(t->timeout_tick - rt_tick_get())) * HOST_CYCLES_PER_TICK;
+    }
+#ifdef BSP_USING_TIM
+    valid = host_hwtimer_next(&at, valid);
+#endif
+    if(!valid){
+        rt_kprintf("[host] all threads are suspended and no timer is running.\n");
+        exit(2);
+    }
+    if(at > host_cycles){
+        host_cycles = at;
+    }
+    host_timer_check();
+}
+
+
+/***
+ * @brief 当前线程已挂起或已放回就绪队列，切换到优先级最高的就绪线程
+ * @note  当前线程退出时 leaving 为真，交出运行权后不再等待
+ */
+static void host_switch(rt_bool_t leaving)
+{
+    rt_thread_t self = host_current, next;
+
+    host_timer_check();
+    next = host_highest();
+    if(next == RT_NULL){
+        if(host_sched_hook){
+            host_sched_hook(self, &host_idle_thread);
+        }
+        while((next = host_highest()) == RT_NULL){
+            host_idle();
+        }
+        if(host_sched_hook){
+            host_sched_hook(&host_idle_thread, next);
+        }
+    }
+    else if(next != self && host_sched_hook){
+        host_sched_hook(self, next);
+    }
+
+    rt_list_remove(&next->tlist);
+    next->stat = RT_THREAD_RUNNING;
+    if(next == self){
+        return;
+    }
+    host_current = next;
+    pthread_cond_signal(&host_ctx(next)->cond);
+    if(!leaving){
+        while(host_current != self){
+            pthread_cond_wait(&host_ctx(self)->cond, &host_lock);
+        }
+    }
+}
+
+
+/***
+ * @brief 调度点：检查定时器，有更高优先级的线程就绪时让出 CPU
+ */
+static void host_preempt(void)
+{
+    rt_thread_t next;
+
+    if(host_sched_lock > 0 || host_irq_nest > 0 || host_irq_off || host_current == RT_NULL){
+        return;
+    }
+    host_timer_check();
+    next = host_highest();
+    if(next != RT_NULL && next->current_priority < host_current->current_priority){
+        host_ready_insert(host_current, RT_TRUE);
+        host_switch(RT_FALSE);
+    }
+}
+
+
+static void host_suspend(rt_thread_t thread, rt_list_t *list, rt_uint8_t flag)
+{
+    rt_list_t *pos = list;
+
+    thread->stat = RT_THREAD_SUSPEND;
+    if(list == RT_NULL){
+        return;
+    }
+    if(flag == RT_IPC_FLAG_PRIO){
+        for(pos = list->next; pos != list; pos = pos->next)
+        {
+            if(rt_list_entry(pos, struct rt_thread, tlist)->current_priority > thread->current_priority){
+                break;
+            }
+        }
+    }
+    rt_list_insert_before(pos, &thread->tlist);
+}
+
+
+static void host_resume(rt_thread_t thread, rt_err_t error)
+{
+    rt_list_remove(&thread->tlist);
+    rt_timer_stop(&thread->thread_timer);
+    thread->error = error;
+    host_ready_insert(thread, RT_FALSE);
+}
+
+
+/***
+ * @brief 挂起当前线程直到被唤醒或超时，返回唤醒原因
+ */
+static rt_err_t host_wait(rt_list_t *list, rt_uint8_t flag, rt_int32_t time)
+{
+    rt_thread_t self = host_current;
+
+    RT_ASSERT(host_irq_nest == 0 && host_sched_lock == 0);
+    self->error = RT_EOK;
+    host_suspend(self, list, flag);
+    if(time > 0){
+        rt_tick_t tick = (rt_tick_t)time;
+        rt_timer_control(&self->thread_timer, RT_TIMER_CTRL_SET_TIME, &tick);
+        rt_timer_start(&self->thread_timer);
+    }
+    host_switch(RT_FALSE);
+    return self->error;
+}
+
+
+static void host_thread_timeout(void *parameter)
+{
+    rt_thread_t thread = (rt_thread_t)parameter;
+
+    if(thread->stat == RT_THREAD_SUSPEND){
+        host_resume(thread, -RT_ETIMEOUT);
+    }
+}
+
+
+void rt_enter_critical(void)
+{
+    host_sched_lock++;
+}
+
+
+void rt_exit_critical(void)
+{
+    if(host_sched_lock > 0 && --host_sched_lock == 0){
+        host_preempt();
+    }
+}
+
+
+rt_uint16_t rt_critical_level(void)
+{
+    return host_sched_lock;
+}
+
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    rt_base_t level = host_irq_off;
+
+    host_irq_off = 1;
+    return level;
+}
+
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    host_irq_off = level;
+}
+
+
+void rt_interrupt_enter(void)
+{
+    host_irq_nest++;
+}
+
+
+void rt_interrupt_leave(void)
+{
+    host_irq_nest--;
+}
+
+
+rt_uint8_t rt_interrupt_get_nest(void)
+{
+    return host_irq_nest;
+}
+
+
+void rt_scheduler_sethook(void (*hook)(struct rt_thread *from, struct rt_thread *to))
+{
+    host_sched_hook = hook;
+}
+
+
+
+//以下是线程---------------------------------------------------------------------------------------------
+
+static void *host_thread_entry(void *parameter)
+{
+    rt_thread_t thread = (rt_thread_t)parameter;
+
+    pthread_mutex_lock(&host_lock);
+    while(host_current != thread){
+        pthread_cond_wait(&host_ctx(thread)->cond, &host_lock);
+    }
+    ((void (*)(void *))thread->entry)(thread->parameter);
+
+    thread->stat = RT_THREAD_CLOSE;
+    host_switch(RT_TRUE);
+    pthread_mutex_unlock(&host_lock);
+    return RT_NULL;
+}
+
+
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *parameter), void *parameter,
+                        void *stack_start, rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    struct host_context *ctx = calloc(1, sizeof(struct host_context));
+
+    RT_ASSERT(ctx != RT_NULL && priority < RT_THREAD_PRIORITY_MAX);
+    rt_memset(thread, 0, sizeof(struct rt_thread));
+    rt_strncpy(thread->name, name, RT_NAME_MAX);
+    thread->type             = RT_Object_Class_Thread;
+    thread->entry            = (void *)entry;
+    thread->parameter        = parameter;
+    thread->stack_addr       = stack_start;
+    thread->stack_size       = stack_size;
+    thread->current_priority = priority;
+    thread->init_tick        = tick;
+    thread->remaining_tick   = tick;
+    thread->stat             = RT_THREAD_INIT;
+    thread->sp               = ctx;
+    rt_list_init(&thread->tlist);
+    pthread_cond_init(&ctx->cond, RT_NULL);
+    rt_timer_init(&thread->thread_timer, thread->name, host_thread_timeout, thread, 0, RT_TIMER_FLAG_ONE_SHOT);
+    return RT_EOK;
+}
+
+
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    rt_thread_t thread = rt_malloc(sizeof(struct rt_thread));
+
+    if(thread != RT_NULL){
+        rt_thread_init(thread, name, entry, parameter, RT_NULL, stack_size, priority, tick);
+    }
+    return thread;
+}
+
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    if(pthread_create(&host_ctx(thread)->pthread, RT_NULL, host_thread_entry, thread) != 0){
+        return -RT_ERROR;
+    }
+    pthread_detach(host_ctx(thread)->pthread);
+    host_ready_insert(thread, RT_FALSE);
+    host_preempt();
+    return RT_EOK;
+}
+
+
+rt_thread_t rt_thread_self(void)
+{
+    return host_current;
+}
+
+
+rt_thread_t rt_thread_idle_gethandler(void)
+{
+    return &host_idle_thread;
+}
+
+
+rt_err_t rt_thread_yield(void)
+{
+    host_ready_insert(host_current, RT_FALSE);
+    host_switch(RT_FALSE);
+    return RT_EOK;
+}
+
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    if(tick == 0){
+        return rt_thread_yield();
+    }
+    host_wait(RT_NULL, RT_IPC_FLAG_FIFO, (rt_int32_t)tick);
+    return RT_EOK;
+}
+
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    return rt_thread_delay(rt_tick_from_millisecond(ms));
+}
+
+
+
+//以下是信号量、互斥量、内存池---------------------------------------------------------------------------------------------
+
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    rt_strncpy(sem->parent.parent.name, name, RT_NAME_MAX);
+    sem->parent.parent.type = RT_Object_Class_Semaphore;
+    sem->parent.parent.flag = flag;
+    rt_list_init(&sem->parent.suspend_thread);
+    sem->value = (rt_uint16_t)value;
+    return RT_EOK;
+}
+
+
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
+{
+    if(sem->value > 0){
+        sem->value--;
+        return RT_EOK;
+    }
+    if(time == 0){
+        return -RT_ETIMEOUT;
+    }
+    return host_wait(&sem->parent.suspend_thread, sem->parent.parent.flag, time);
+}
+
+
+rt_err_t rt_sem_trytake(rt_sem_t sem)
+{
+    return rt_sem_take(sem, 0);
+}
+
+
+rt_err_t rt_sem_release(rt_sem_t sem)
+{
+    if(!rt_list_isempty(&sem->parent.suspend_thread)){
+        host_resume(rt_list_entry(sem->parent.suspend_thread.next, struct rt_thread, tlist), RT_EOK);
+    }
+    else if(sem->value < 0xFFFF){
+        sem->value++;
+    }
+    else{
+        return -RT_EFULL;
+    }
+    host_preempt();
+    return RT_EOK;
+}
+
+
+rt_err_t rt_sem_control(rt_sem_t sem, int cmd, void *arg)
+{
+    if(cmd != RT_IPC_CMD_RESET){
+        return -RT_ERROR;
+    }
+    while(!rt_list_isempty(&sem->parent.suspend_thread)){
+        host_resume(rt_list_entry(sem->parent.suspend_thread.next, struct rt_thread, tlist), -RT_ERROR);
+    }
+    sem->value = (rt_uint16_t)(rt_ubase_t)arg;
+    host_preempt();
+    return RT_EOK;
+}
+
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    rt_strncpy(mutex->parent.parent.name, name, RT_NAME_MAX);
+    mutex->parent.parent.type = RT_Object_Class_Mutex;
+    mutex->parent.parent.flag = flag;
+    rt_list_init(&mutex->parent.suspend_thread);
+    mutex->value = 1;
+    mutex->hold  = 0;
+    mutex->owner = RT_NULL;
+    return RT_EOK;
+}
+
+
+/***
+ * @brief 不做优先级继承；释放时直接把互斥量交给第一个等待者
+ */
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    if(mutex->owner == host_current){
+        mutex->hold++;
+        return RT_EOK;
+    }
+    if(mutex->owner == RT_NULL){
+        mutex->owner = host_current;
+        mutex->hold  = 1;
+        mutex->value = 0;
+        return RT_EOK;
+    }
+    if(time == 0){
+        return -RT_ETIMEOUT;
+    }
+    return host_wait(&mutex->parent.suspend_thread, mutex->parent.parent.flag, time);
+}
+
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    if(mutex->owner != host_current){
+        return -RT_ERROR;
+    }
+    if(--mutex->hold > 0){
+        return RT_EOK;
+    }
+    if(!rt_list_isempty(&mutex->parent.suspend_thread)){
+        rt_thread_t next = rt_list_entry(mutex->parent.suspend_thread.next, struct rt_thread, tlist);
+        mutex->owner = next;
+        mutex->hold  = 1;
+        host_resume(next, RT_EOK);
+    }
+    else{
+        mutex->owner = RT_NULL;
+        mutex->value = 1;
+    }
+    host_preempt();
+    return RT_EOK;
+}
+
+
+/***
+ * @brief 与内核相同的布局：每块前面有一个指针，空闲时指向下一空闲块，分配后指向所属内存池
+ */
+rt_err_t rt_mp_init(struct rt_mempool *mp, const char *name, void *start, rt_size_t size, rt_size_t block_size)
+{
+    rt_uint8_t *block;
+    rt_size_t i;
+
+    rt_strncpy(mp->parent.name, name, RT_NAME_MAX);
+    mp->parent.type       = RT_Object_Class_MemPool;
+    mp->start_address     = start;
+    mp->size              = RT_ALIGN_DOWN(size, RT_ALIGN_SIZE);
+    mp->block_size        = RT_ALIGN(block_size, RT_ALIGN_SIZE);
+    mp->block_total_count = mp->size / (mp->block_size + sizeof(rt_uint8_t *));
+    mp->block_free_count  = mp->block_total_count;
+    rt_list_init(&mp->suspend_thread);
+
+    block = (rt_uint8_t *)start;
+    for(i = 0; i < mp->block_total_count; i++)
+    {
+        rt_uint8_t *next = (i + 1 < mp->block_total_count) ? block + mp->block_size + sizeof(rt_uint8_t *) : RT_NULL;
+        *(rt_uint8_t **)block = next;
+        block += mp->block_size + sizeof(rt_uint8_t *);
+    }
+    mp->block_list = (mp->block_total_count > 0) ? (rt_uint8_t *)start : RT_NULL;
+    return RT_EOK;
+}
+
+
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
+{
+    rt_uint8_t *block;
+
+    while(mp->block_free_count == 0)
+    {
+        if(time == 0 || host_wait(&mp->suspend_thread, RT_IPC_FLAG_FIFO, time) != RT_EOK){
+            return RT_NULL;
+        }
+    }
+    block = mp->block_list;
+    mp->block_list = *(rt_uint8_t **)block;
+    mp->block_free_count--;
+    *(rt_uint8_t **)block = (rt_uint8_t *)mp;
+    return block + sizeof(rt_uint8_t *);
+}
+
+
+void rt_mp_free(void *block)
+{
+    rt_uint8_t **header = (rt_uint8_t **)((rt_uint8_t *)block - sizeof(rt_uint8_t *));
+    rt_mp_t mp = (rt_mp_t)*header;
+
+    *header = mp->block_list;
+    mp->block_list = (rt_uint8_t *)header;
+    mp->block_free_count++;
+    if(!rt_list_isempty(&mp->suspend_thread)){
+        host_resume(rt_list_entry(mp->suspend_thread.next, struct rt_thread, tlist), RT_EOK);
+    }
+    host_preempt();
+}
+
+
+
+//以下是设备框架---------------------------------------------------------------------------------------------
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if(rt_device_find(name) != RT_NULL){
+        return -RT_ERROR;
+    }
+    rt_strncpy(dev->parent.name, name, RT_NAME_MAX);
+    dev->parent.type = RT_Object_Class_Device;
+    dev->flag        = flags;
+    dev->ref_count   = 0;
+    dev->open_flag   = 0;
+    rt_list_insert_before(&host_devices, &dev->parent.list);
+    return RT_EOK;
+}
+
+
+rt_device_t rt_device_find(const char *name)
+{
+    rt_list_t *pos;
+
+    for(pos = host_devices.next; pos != &host_devices; pos = pos->next)
+    {
+        rt_device_t dev = rt_list_entry(pos, struct rt_device, parent.list);
+        if(rt_strncmp(dev->parent.name, name, RT_NAME_MAX) == 0){
+            return dev;
+        }
+    }
+    return RT_NULL;
+}
+
+
+rt_err_t rt_device_open(rt_device_t dev, rt_uint16_t oflag)
+{
+    rt_err_t result = RT_EOK;
+
+    if(!(dev->flag & RT_DEVICE_FLAG_ACTIVATED)){
+        if(dev->init != RT_NULL && (result = dev->init(dev)) != RT_EOK){
+            return result;
+        }
+        dev->flag |= RT_DEVICE_FLAG_ACTIVATED;
+    }
+    if((dev->flag & RT_DEVICE_FLAG_STANDALONE) && (dev->open_flag & RT_DEVICE_OFLAG_OPEN)){
+        return -RT_EBUSY;
+    }
+    if(dev->open != RT_NULL){
+        result = dev->open(dev, oflag);
+    }
+    else{
+        dev->open_flag = (oflag & RT_DEVICE_OFLAG_MASK);
+    }
+    if(result == RT_EOK || result == -RT_ENOSYS){
+        dev->open_flag |= RT_DEVICE_OFLAG_OPEN;
+        dev->ref_count++;
+        result = RT_EOK;
+    }
+    return result;
+}
+
+
+rt_err_t rt_device_close(rt_device_t dev)
+{
+    rt_err_t result = RT_EOK;
+
+    if(dev->ref_count == 0){
+        return -RT_ERROR;
+    }
+    if(--dev->ref_count != 0){
+        return RT_EOK;
+    }
+    if(dev->close != RT_NULL){
+        result = dev->close(dev);
+    }
+    if(result == RT_EOK || result == -RT_ENOSYS){
+        dev->open_flag = RT_DEVICE_OFLAG_CLOSE;
+    }
+    return result;
+}
+
+
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    if(dev->ref_count == 0 || dev->read == RT_NULL){
+        rt_set_errno(-RT_ERROR);
+        return 0;
+    }
+    return dev->read(dev, pos, buffer, size);
+}
+
+
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    if(dev->ref_count == 0 || dev->write == RT_NULL){
+        rt_set_errno(-RT_ERROR);
+        return 0;
+    }
+    return dev->write(dev, pos, buffer, size);
+}
+
+
+rt_err_t rt_device_control(rt_device_t dev, int cmd, void *arg)
+{
+    return (dev->control != RT_NULL) ? dev->control(dev, cmd, arg) : -RT_ENOSYS;
+}
+
+
+rt_err_t rt_device_set_rx_indicate(rt_device_t dev, rt_err_t (*rx_ind)(rt_device_t dev, rt_size_t size))
+{
+    dev->rx_indicate = rx_ind;
+    return RT_EOK;
+}
+
+
+
+//以下是主机上没有的硬件：SPI 总线和引脚中断都不存在，GPIO 只记录输出---------------------------------------------------------------------------------------------
+
+rt_err_t rt_hw_spi_device_attach(const char *bus_name, const char *device_name, GPIO_TypeDef *cs_gpiox, uint16_t cs_gpio_pin)
+{
+    return -RT_ENOSYS;
+}
+
+
+rt_err_t rt_spi_configure(struct rt_spi_device *device, struct rt_spi_configuration *cfg)
+{
+    return -RT_ENOSYS;
+}
+
+
+rt_err_t rt_spi_send_then_recv(struct rt_spi_device *device, const void *send_buf, rt_size_t send_length, void *recv_buf, rt_size_t recv_length)
+{
+    return -RT_ENOSYS;
+}
+
+
+rt_err_t rt_spi_send_then_send(struct rt_spi_device *device, const void *send_buf1, rt_size_t send_length1, const void *send_buf2, rt_size_t send_length2)
+{
+    return -RT_ENOSYS;
+}
+
+
+rt_size_t rt_spi_transfer(struct rt_spi_device *device, const void *send_buf, void *recv_buf, rt_size_t length)
+{
+    return 0;
+}
+
+
+void rt_pin_mode(rt_base_t pin, rt_base_t mode)
+{
+}
+
+
+rt_err_t rt_pin_attach_irq(rt_int32_t pin, rt_uint32_t mode, void (*hdr)(void *args), void *args)
+{
+    return -RT_ENOSYS;
+}
+
+
+rt_err_t rt_pin_irq_enable(rt_base_t pin, rt_uint32_t enabled)
+{
+    return -RT_ENOSYS;
+}
+
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+}
+
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if(PinState == GPIO_PIN_SET){
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else{
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return HOST_CORE_CLOCK / 2;
+}
+
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return HOST_CORE_CLOCK;
+}
+
+
+
+//以下是内核服务和 ulog---------------------------------------------------------------------------------------------
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+
+void rt_set_errno(rt_err_t error)
+{
+    host_errno = error;
+}
+
+
+rt_err_t rt_get_errno(void)
+{
+    return host_errno;
+}
+
+
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return n;
+}
+
+
+void rt_assert_handler(const char *ex, const char *func, rt_size_t line)
+{
+    fprintf(stderr, "(%s) assertion failed at function:%s, line number:%d\n", ex, func, (int)line);
+    abort();
+}
+
+
+static rt_uint32_t host_log_level = LOG_LVL_DBG;
+
+void ulog_global_filter_lvl_set(rt_uint32_t level)
+{
+    host_log_level = level;
+}
+
+
+rt_uint32_t ulog_global_filter_lvl_get(void)
+{
+    return host_log_level;
+}
+
+
+void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const char *format, va_list args)
+{
+    static const char level_name[] = { 'A', ' ', ' ', 'E', 'W', ' ', 'I', 'D' };
+
+    if(level > host_log_level){
+        return;
+    }
+    printf("[%u] %c/%s: ", (unsigned)rt_tick_get(), level_name[level & 0x07], tag);
+    vprintf(format, args);
+    if(newline){
+        printf("\n");
+    }
+}
+
+
+void ulog_output(rt_uint32_t level, const char *tag, rt_bool_t newline, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    ulog_voutput(level, tag, newline, format, args);
+    va_end(args);
+}
+
+
+void ulog_hexdump(const char *tag, rt_size_t width, rt_uint8_t *buf, rt_size_t size)
+{
+    rt_size_t i, j;
+
+    if(LOG_LVL_DBG > host_log_level){
+        return;
+    }
+    for(i = 0; i < size; i += width)
+    {
+        printf("[%u] D/HEX %s: %04X-%04X: ", (unsigned)rt_tick_get(), tag, (unsigned)i, (unsigned)(i + width - 1));
+        for(j = i; j < i + width && j < size; j++){
+            printf("%02X ", buf[j]);
+        }
+        printf("\n");
+    }
+}
+
+
+void ulog_flush(void)
+{
+    fflush(stdout);
+}
+
+
+rt_uint32_t ulog_async_drops(void)
+{
+    return 0;
+}
+
+
+
+//以下是启动流程：主线程依次执行各级 INIT_xxx_EXPORT，随后作为 tshell 执行命令---------------------------------------------------------------------------------------------
+
+extern const init_fn_t __rt_init_start[];
+extern const init_fn_t __rt_init_end[];
+
+void rt_host_startup(void)
+{
+    for(int prio = 0; prio < RT_THREAD_PRIORITY_MAX; prio++){
+        rt_list_init(&host_ready[prio]);
+    }
+    rt_strncpy(host_idle_thread.name, "tidle0", RT_NAME_MAX);
+    host_idle_thread.current_priority = RT_THREAD_PRIORITY_MAX - 1;
+
+    pthread_mutex_lock(&host_lock);
+    rt_thread_init(&host_main_thread, "main", RT_NULL, RT_NULL, RT_NULL, 0, RT_MAIN_THREAD_PRIORITY, 20);
+    host_ctx(&host_main_thread)->pthread = pthread_self();
+    host_main_thread.stat = RT_THREAD_RUNNING;
+    host_current = &host_main_thread;
+
+    for(const init_fn_t *fn = __rt_init_start; fn < __rt_init_end; fn++){
+        (*fn)();
+    }
+
+    /* 组件初始化完成，主线程降到 tshell 的优先级执行命令 */
+    rt_strncpy(host_main_thread.name, FINSH_THREAD_NAME, RT_NAME_MAX);
+    host_main_thread.current_priority = FINSH_THREAD_PRIORITY;
+    host_preempt();
+}
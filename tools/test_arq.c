@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp_nrf24l01_driver.h"
+
+
+/***
+ * 可靠传输层的主机测试：test_arq [每档报文数] [种子]
+ * 启动后 nrf24l01_task.c 的实例占用节点 0，再用 nRF24L01_Sim_Add_Node 在虚拟空口上加一个角色相反的实例，
+ * 两端都跑完整的协议栈；PTX 端用 nRF24L01_ARQ_Send 连续发送，PRX 端按 loss_percent 0~50% 人为丢弃收到的 DATA，
+ * 每一档检查：
+ *   1. 报文按发送顺序交付，每个恰好一次（报文前 4 字节为全局序号，其余字节由序号导出）
+ *   2. 全部报文在限定时间内被确认
+ * 并打印该档的有效吞吐、重传和超时次数
+ */
+#define ARQ_TEST_TIMEOUT_MS     60000
+
+void rt_host_startup(void);
+
+static rt_uint32_t arq_seed = 1;
+static rt_uint32_t arq_failed;
+static volatile rt_uint32_t arq_expect;
+static volatile rt_uint32_t arq_delivered;
+
+static const rt_uint8_t arq_loss[] = { 0, 10, 20, 30, 40, 50 };
+
+
+static void Arq_Fail(const char *what, rt_uint32_t index, rt_uint32_t value)
+{
+    if (arq_failed++ < 10){
+        printf("FAIL %s: segment %u, got %u\n", what, index, value);
+    }
+}
+
+
+/***
+ * @brief 报文内容：前 4 字节为序号（小端），之后每个字节由序号和位置导出
+ */
+static void Arq_Fill(rt_uint8_t *buf, rt_uint32_t index)
+{
+    rt_memcpy(buf, &index, 4);
+    for (rt_uint8_t i = 4; i < NRF24_ARQ_PAYLOAD_SIZE; i++){
+        buf[i] = (rt_uint8_t)(index * 7 + i);
+    }
+}
+
+
+static void Arq_Msg_Ind(nrf24_t nrf24, uint8_t *data, rt_uint16_t len, int pipe)
+{
+    rt_uint8_t expect[NRF24_ARQ_PAYLOAD_SIZE];
+    rt_uint32_t index;
+
+    if (len != NRF24_ARQ_PAYLOAD_SIZE){
+        Arq_Fail("length", arq_expect, len);
+        return;
+    }
+    rt_memcpy(&index, data, 4);
+    if (index != arq_expect){
+        Arq_Fail(index < arq_expect ? "duplicate" : "out of order", arq_expect, index);
+    }
+    Arq_Fill(expect, index);
+    if (rt_memcmp(expect, data, len) != 0){
+        Arq_Fail("content", index, data[4]);
+    }
+    arq_expect = index + 1;
+    arq_delivered++;
+}
+
+
+int main(int argc, char **argv)
+{
+    rt_uint32_t count = 200, index = 0;
+    nrf24_t ptx, prx;
+    rt_uint8_t buf[NRF24_ARQ_PAYLOAD_SIZE];
+
+    if (argc > 1){
+        count = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2){
+        arq_seed = strtoul(argv[2], NULL, 0) | 1;
+    }
+    setvbuf(stdout, RT_NULL, _IOLBF, 0);
+    ulog_global_filter_lvl_set(LOG_LVL_WARNING);
+    srand(arq_seed);
+    printf("test_arq: %u segments per step, seed 0x%08x, window %d\n", count, arq_seed, NRF24_ARQ_WINDOW);
+
+    // 1. 节点 0 为 nrf24l01_task.c 的实例，再加一个角色相反的实例
+    rt_host_startup();
+    ptx = _nrf24;
+    prx = nRF24L01_Sim_Add_Node("nrf_t", (ptx->nrf24_cfg.config.prim_rx == ROLE_PTX) ? ROLE_PRX : ROLE_PTX, RT_NULL);
+    if (prx == RT_NULL){
+        printf("test_arq: FAILED, can not add the second node\n");
+        return 1;
+    }
+    if (prx->nrf24_cfg.config.prim_rx == ROLE_PTX){
+        ptx = prx;
+        prx = _nrf24;
+    }
+    prx->nrf24_cb.nrf24l01_msg_ind = Arq_Msg_Ind;
+    rt_thread_mdelay(200);
+
+    // 2. 逐档扫描 PRX 端的人为丢包率，序号在各档之间连续
+    printf("  loss   goodput B/s   retransmits   timeouts   polls\n");
+    for (rt_uint8_t k = 0; k < sizeof(arq_loss); k++)
+    {
+        struct nRF24L01_ARQ_STRUCT *arq = &ptx->arq;
+        rt_uint32_t retransmits = arq->retransmits, timeouts = arq->timeouts, polls = arq->polls;
+        rt_uint32_t delivered = arq_delivered, failed = arq_failed;
+        rt_tick_t start, used;
+
+        prx->arq.loss_percent = arq_loss[k];
+        start = rt_tick_get();
+        for (rt_uint32_t n = 0; n < count; n++, index++)
+        {
+            Arq_Fill(buf, index);
+            if (nRF24L01_ARQ_Send(ptx, buf, sizeof(buf), rt_tick_from_millisecond(ARQ_TEST_TIMEOUT_MS)) < 0){
+                Arq_Fail("send timeout", index, arq_loss[k]);
+                break;
+            }
+        }
+        while (arq_delivered - delivered < count || arq->snd_una != arq->snd_nxt)
+        {
+            if (rt_tick_get() - start > rt_tick_from_millisecond(ARQ_TEST_TIMEOUT_MS)){
+                Arq_Fail("ack timeout", arq_delivered, arq_loss[k]);
+                break;
+            }
+            rt_thread_mdelay(1);
+        }
+        used = rt_tick_get() - start;
+        if (arq_delivered - delivered != count){
+            Arq_Fail("delivered", count, arq_delivered - delivered);
+        }
+
+        printf("  %3d%%  %12u  %12u  %9u  %6u  %s\n", arq_loss[k],
+               (rt_uint32_t)((rt_uint64_t)count * NRF24_ARQ_PAYLOAD_SIZE * RT_TICK_PER_SECOND / (used ? used : 1)),
+               arq->retransmits - retransmits, arq->timeouts - timeouts, arq->polls - polls,
+               (arq_failed == failed) ? "ok" : "FAILED");
+    }
+
+    printf("test_arq: %s\n", arq_failed ? "FAILED" : "PASSED");
+    return arq_failed ? 1 : 0;
+}
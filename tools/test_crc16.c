@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp_nrf24l01_driver.h"
+#include "bsp_nrf24l01_message.h"
+
+
+/***
+ * CRC16-Modbus 的主机测试：test_crc16 [次数] [种子]
+ * bsp_nrf24l01_message.c 按 NRF24_CRC16_IMPL 分别编译成三个程序，每个程序把本次编进来的全部实现
+ * （BITWISE 总有，TABLE 在非 BITWISE 时有，SLICE4 只在 SLICE4 时有）以及 CrcCalc_Crc16Modbus 本身
+ * 与下面原样拷贝的原始逐位算法对比：
+ *   1. 标准测试向量 "123456789" -> 0x4B37，空数据 -> 0xFFFF
+ *   2. 长度 0~255 逐个测试，起始地址错开 0~3 字节
+ *   3. 随机长度、随机内容、随机对齐
+ */
+static rt_uint32_t crc_seed = 1;
+static rt_uint32_t crc_failed;
+
+static rt_uint32_t Crc_Random(void)
+{
+    crc_seed ^= crc_seed << 13;
+    crc_seed ^= crc_seed >> 17;
+    crc_seed ^= crc_seed << 5;
+    return crc_seed;
+}
+
+
+/***
+ * 原始的 CrcCalc_Crc16Modbus，作为参考
+ */
+static uint16_t Crc16_Reference(uint8_t *dat,uint8_t len)
+{
+    uint16_t    CRC_index = 0xffff;
+    uint16_t    buffer;
+    volatile    uint8_t i = 0, j = 0;
+    for(i = 0; i < len; i++){
+        buffer = dat[i];                            // 把数据取出来放在缓冲区
+        CRC_index ^= buffer;
+        for(j = 0; j < 8; j++){
+            if(CRC_index & 0x0001){
+                CRC_index >>= 1;
+                CRC_index ^= 0xa001;
+            }else{
+                CRC_index >>= 1;
+            }
+        }
+    }
+    return CRC_index;
+}
+
+
+/***
+ * 本次编译进来的各个实现
+ */
+static const struct
+{
+    const char *name;
+    uint16_t  (*calc)(const uint8_t *dat, uint8_t len);
+} crc_impls[] = {
+    { "bitwise", CrcCalc_Crc16Modbus_Bitwise },
+#if (NRF24_CRC16_IMPL != NRF24_CRC16_BITWISE)
+    { "table",   CrcCalc_Crc16Modbus_Table },
+#endif
+#if (NRF24_CRC16_IMPL == NRF24_CRC16_SLICE4)
+    { "slice4",  CrcCalc_Crc16Modbus_Slice4 },
+#endif
+};
+
+#define CRC_IMPL_NUM    (sizeof(crc_impls) / sizeof(crc_impls[0]))
+
+
+static void Crc_Check(uint8_t *dat, uint8_t len, uint16_t expect, const char *test)
+{
+    uint16_t crc;
+
+    for (rt_uint32_t k = 0; k < CRC_IMPL_NUM; k++)
+    {
+        crc = crc_impls[k].calc(dat, len);
+        if (crc != expect && crc_failed++ < 10){
+            printf("FAIL %s: %s len %d = 0x%04X, expect 0x%04X\n", test, crc_impls[k].name, len, crc, expect);
+        }
+    }
+    crc = CrcCalc_Crc16Modbus(dat, len);
+    if (crc != expect && crc_failed++ < 10){
+        printf("FAIL %s: CrcCalc_Crc16Modbus len %d = 0x%04X, expect 0x%04X\n", test, len, crc, expect);
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    static const char *impl_name[] = { "BITWISE", "TABLE", "SLICE4" };
+    uint8_t vector[] = "123456789";
+    uint8_t buf[256 + 4];
+    rt_uint32_t loops = 100000;
+    uint8_t len, align;
+
+    if (argc > 1){
+        loops = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2){
+        crc_seed = strtoul(argv[2], NULL, 0) | 1;
+    }
+    printf("test_crc16: NRF24_CRC16_IMPL = %s, %d implementations, %u loops, seed 0x%08x\n",
+           impl_name[NRF24_CRC16_IMPL], (int)CRC_IMPL_NUM, loops, crc_seed);
+
+    // 1. 标准测试向量，先确认参考算法本身
+    if (Crc16_Reference(vector, 9) != 0x4B37 || Crc16_Reference(vector, 0) != 0xFFFF){
+        printf("FAIL reference: 0x%04X\n", Crc16_Reference(vector, 9));
+        crc_failed++;
+    }
+    Crc_Check(vector, 9, 0x4B37, "vector");
+    Crc_Check(vector, 0, 0xFFFF, "empty");
+
+    // 2. 长度 0~255，起始地址错开
+    for (rt_uint32_t i = 0; i < sizeof(buf); i++){
+        buf[i] = Crc_Random();
+    }
+    for (align = 0; align < 4; align++){
+        for (rt_uint32_t n = 0; n < 256; n++){
+            Crc_Check(&buf[align], n, Crc16_Reference(&buf[align], n), "length");
+        }
+    }
+
+    // 3. 随机长度、内容、对齐
+    for (rt_uint32_t n = 0; n < loops; n++)
+    {
+        len   = Crc_Random();
+        align = Crc_Random() & 0x03;
+        for (rt_uint32_t i = 0; i < len; i++){
+            buf[align + i] = Crc_Random();
+        }
+        Crc_Check(&buf[align], len, Crc16_Reference(&buf[align], len), "random");
+    }
+
+    printf("test_crc16: %s\n", crc_failed ? "FAILED" : "PASSED");
+    return crc_failed ? 1 : 0;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2025-09-22     Administrator       the first version
+ */
+#include <rtthread.h>
+#include <ulog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp_nrf24l01_driver.h"
+
+
+/***
+ * 地址轮换的主机测试：test_rotate [每档秒数] [上报周期ms]
+ * 需要同时编译中心和节点两部分（NRF24_USE_HUB = 1，NRF24_ROTATE_NODES > 0，NRF24_ROTATE_NODE_ID >= 0），
+ * 虚拟空口上的节点全部由实例占用：一个 PRX 作为中心，其余 PTX 作为节点，都跑完整的协议栈，没有内置对端
+ * （内置对端会应答任何地址，和轮换冲突）；中心的节点数从 4 逐档加到实例数，多出来的节点退出轮换不发送。
+ * 每档跑两遍：
+ *   periodic  : 每个节点每 period_ms 产生一包 32 字节数据（初始相位错开），检查不丢包，时延不超过一个轮换周期加一个时隙
+ *   saturated : 每个节点的软件发送队列始终填满，测总吞吐
+ * 两遍都检查：
+ *   1. 每个节点的数据按产生顺序交付，每包恰好一次（包内带节点编号和该节点的序号）
+ *   2. 数据包从该节点对应的管道（2 + 编号 % 4）收到，中心按当前组统计到的包数与包内编号统计的一致，即没有串组
+ * 空口模型不模拟碰撞，组内节点先来先服务，所以吞吐是轮换本身（时隙切换、保护时间、同步）的上限
+ */
+#define ROT_TEST_LEN            32
+#define ROT_TEST_SYNC_MS        5000
+
+void rt_host_startup(void);
+
+static const rt_uint8_t rot_counts[] = { 4, 8, 16, 32 };
+
+static nrf24_t rot_hub;
+static nrf24_t rot_node[NRF24_ROTATE_MAX_NODES];
+static rt_uint8_t rot_node_count;
+static volatile rt_uint8_t rot_nodes;
+
+static rt_uint32_t rot_failed;
+static rt_uint32_t rot_sent[NRF24_ROTATE_MAX_NODES];
+static volatile rt_uint32_t rot_expect[NRF24_ROTATE_MAX_NODES];
+static volatile rt_uint32_t rot_delivered[NRF24_ROTATE_MAX_NODES];
+/* 中心的按组统计在 Rot_Setup 时清零，对应时刻的交付数 */
+static rt_uint32_t rot_step_base[NRF24_ROTATE_MAX_NODES];
+static volatile rt_uint32_t rot_worst_ms[NRF24_ROTATE_MAX_NODES];
+static volatile rt_uint64_t rot_sum_ms;
+
+
+static void Rot_Fail(const char *what, rt_uint32_t node, rt_uint32_t value)
+{
+    if (rot_failed++ < 10){
+        printf("FAIL %s: node %u, got %u\n", what, node, value);
+    }
+}
+
+
+/***
+ * @brief 中心线程中的管道 2~5 消费者：byte0 NRF24_DEV_MARK  byte1 节点编号  byte2~5 序号  byte6~9 产生时的 tick
+ */
+static void Rot_Consumer(nrf24_t nrf24, nrf24_pkt_t pkt)
+{
+    rt_uint32_t seq, gen, lat;
+    rt_uint8_t id = pkt->data[1];
+
+    // 扫描开始前只有 nrf24l01_task.c 启动时发出的连接测试帧
+    if (rot_nodes == 0){
+        nRF24L01_Pkt_Free(pkt);
+        return;
+    }
+    if (pkt->len != ROT_TEST_LEN || pkt->data[0] != NRF24_DEV_MARK || id >= rot_nodes){
+        Rot_Fail("foreign packet", id, pkt->len);
+        nRF24L01_Pkt_Free(pkt);
+        return;
+    }
+    if (pkt->pipe != NRF24_PIPE_2 + id % NRF24_ROTATE_GROUP_SIZE){
+        Rot_Fail("wrong pipe", id, pkt->pipe);
+    }
+
+    rt_memcpy(&seq, &pkt->data[2], 4);
+    rt_memcpy(&gen, &pkt->data[6], 4);
+    if (seq != rot_expect[id]){
+        Rot_Fail(seq < rot_expect[id] ? "duplicate" : "out of order", id, seq);
+    }
+    rot_expect[id] = seq + 1;
+    rot_delivered[id]++;
+
+    lat = (rt_tick_get() - gen) * 1000 / RT_TICK_PER_SECOND;
+    rot_sum_ms += lat;
+    if (lat > rot_worst_ms[id]){
+        rot_worst_ms[id] = lat;
+    }
+    nRF24L01_Pkt_Free(pkt);
+}
+
+
+/***
+ * @brief 节点 id 产生下一包数据
+ * @return RT_EOK : 已进入软件发送队列   其它 : 队列满，序号不前进
+ */
+static int Rot_Send(rt_uint8_t id)
+{
+    rt_uint8_t buf[ROT_TEST_LEN];
+    rt_tick_t now = rt_tick_get();
+
+    rt_memset(buf, 0, sizeof(buf));
+    buf[0] = NRF24_DEV_MARK;
+    buf[1] = id;
+    rt_memcpy(&buf[2], &rot_sent[id], 4);
+    rt_memcpy(&buf[6], &now, 4);
+    if (nRF24L01_Send_Async(rot_node[id], buf, sizeof(buf), nRF24_SEND_NEED_ACK) <= 0){
+        return -RT_EFULL;
+    }
+    rot_sent[id]++;
+    return RT_EOK;
+}
+
+
+/***
+ * @brief 中心改为 nodes 个节点，其余节点退出轮换，等参与的节点全部同步
+ */
+static int Rot_Setup(rt_uint8_t nodes)
+{
+    rt_tick_t start = rt_tick_get();
+    rt_uint8_t synced;
+
+    rot_nodes = nodes;
+    if (nRF24L01_Rotate_Set_Nodes(rot_hub, nodes) != RT_EOK){
+        return -RT_ERROR;
+    }
+    for (rt_uint8_t i = 0; i < rot_node_count; i++){
+        nRF24L01_Rotate_Set_Node(rot_node[i], (i < nodes) ? (rt_int8_t)i : -1);
+        rot_step_base[i] = rot_delivered[i];
+    }
+
+    do
+    {
+        rt_thread_mdelay(10);
+        synced = 0;
+        for (rt_uint8_t i = 0; i < nodes; i++){
+            synced += (rot_node[i]->rotate.synced && rot_node[i]->rotate.on_data_addr) ? 1 : 0;
+        }
+    } while (synced < nodes && rt_tick_get() - start < rt_tick_from_millisecond(ROT_TEST_SYNC_MS));
+
+    return (synced == nodes) ? RT_EOK : -RT_ETIMEOUT;
+}
+
+
+/***
+ * @brief 跑一遍：period_ms 为 0 时为饱和负载；结束后停止产生数据，等队列发完再统计
+ */
+static void Rot_Run(rt_uint8_t nodes, rt_uint32_t seconds, rt_uint32_t period_ms)
+{
+    rt_uint32_t cycle_ms = (nodes + NRF24_ROTATE_GROUP_SIZE - 1) / NRF24_ROTATE_GROUP_SIZE * NRF24_ROTATE_SLOT_MS;
+    rt_uint32_t sent = 0, delivered = 0, in_run = 0, dropped = 0, worst = 0, worst_node = 0, failed = rot_failed;
+    rt_uint32_t base_sent[NRF24_ROTATE_MAX_NODES], base_delivered[NRF24_ROTATE_MAX_NODES];
+    rt_tick_t next[NRF24_ROTATE_MAX_NODES];
+    rt_tick_t start = rt_tick_get(), end = start + rt_tick_from_millisecond(seconds * 1000);
+    rt_uint8_t pending;
+
+    rt_enter_critical();
+    for (rt_uint8_t i = 0; i < nodes; i++){
+        base_sent[i] = rot_sent[i];
+        base_delivered[i] = rot_delivered[i];
+        rot_worst_ms[i] = 0;
+        next[i] = start + (period_ms ? rt_tick_from_millisecond(period_ms) * i / nodes : 0);
+    }
+    rot_sum_ms = 0;
+    rt_exit_critical();
+
+    // 1. 产生数据：周期负载按各自的相位每 period_ms 一包，饱和负载每个 tick 把队列补满
+    while ((rt_int32_t)(rt_tick_get() - end) < 0)
+    {
+        rt_tick_t now = rt_tick_get();
+
+        for (rt_uint8_t i = 0; i < nodes; i++)
+        {
+            if (period_ms == 0){
+                while (Rot_Send(i) == RT_EOK);
+                continue;
+            }
+            while ((rt_int32_t)(now - next[i]) >= 0){
+                if (Rot_Send(i) != RT_EOK){
+                    dropped++;
+                }
+                next[i] += rt_tick_from_millisecond(period_ms);
+            }
+        }
+        rt_thread_mdelay(1);
+    }
+    for (rt_uint8_t i = 0; i < nodes; i++){
+        in_run += rot_delivered[i] - base_delivered[i];
+    }
+
+    // 2. 等各节点队列发完（最多两个轮换周期）再让中心线程取完
+    start = rt_tick_get();
+    do
+    {
+        rt_thread_mdelay(10);
+        pending = 0;
+        for (rt_uint8_t i = 0; i < nodes; i++){
+            pending += (rot_node[i]->tx_queue.put != rot_node[i]->tx_queue.done) ? 1 : 0;
+        }
+    } while (pending && rt_tick_get() - start < rt_tick_from_millisecond(2 * cycle_ms + NRF24_ROTATE_SLOT_MS));
+    rt_thread_mdelay(NRF24_ROTATE_SLOT_MS);
+
+    for (rt_uint8_t i = 0; i < nodes; i++)
+    {
+        sent      += rot_sent[i] - base_sent[i];
+        delivered += rot_delivered[i] - base_delivered[i];
+        if (rot_worst_ms[i] > worst){
+            worst = rot_worst_ms[i];
+            worst_node = i;
+        }
+        if (rot_hub->rotate.node[i].rx_packets != rot_delivered[i] - rot_step_base[i]){
+            Rot_Fail("hub counted", i, rot_hub->rotate.node[i].rx_packets);
+        }
+    }
+    if (delivered != sent){
+        Rot_Fail("lost", nodes, sent - delivered);
+    }
+    if (period_ms != 0 && dropped != 0){
+        Rot_Fail("queue full", nodes, dropped);
+    }
+    if (period_ms != 0 && worst > cycle_ms + NRF24_ROTATE_SLOT_MS){
+        Rot_Fail("latency", worst_node, worst);
+    }
+
+    printf("  %5u %6u %10s %9u %6u %8u %10u %10u(n%u)  %s\n", nodes, cycle_ms / NRF24_ROTATE_SLOT_MS,
+           period_ms ? "periodic" : "saturated", in_run * ROT_TEST_LEN / seconds, sent - delivered, dropped,
+           delivered ? (rt_uint32_t)(rot_sum_ms / delivered) : 0, worst, worst_node,
+           (rot_failed == failed) ? "ok" : "FAILED");
+}
+
+
+int main(int argc, char **argv)
+{
+    rt_uint32_t seconds = 10, period_ms = 100;
+    char name[RT_NAME_MAX];
+
+    if (argc > 1){
+        seconds = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2){
+        period_ms = strtoul(argv[2], NULL, 0);
+    }
+    if (seconds == 0 || period_ms == 0){
+        printf("usage: test_rotate [seconds] [period_ms]\n");
+        return 1;
+    }
+    setvbuf(stdout, RT_NULL, _IOLBF, 0);
+    ulog_global_filter_lvl_set(LOG_LVL_WARNING);
+
+    // 1. 节点 0 为 nrf24l01_task.c 的实例，按它的角色补齐一个中心，其余空闲节点全部加成轮换节点
+    rt_host_startup();
+    if (_nrf24->nrf24_cfg.config.prim_rx == ROLE_PRX){
+        rot_hub = _nrf24;
+    }
+    else{
+        rot_hub = nRF24L01_Sim_Add_Node("nrf_hub", ROLE_PRX, RT_NULL);
+        rot_node[rot_node_count++] = _nrf24;
+    }
+    while (rot_node_count < NRF24_ROTATE_MAX_NODES)
+    {
+        rt_snprintf(name, sizeof(name), "nrf_n%d", rot_node_count);
+        rot_node[rot_node_count] = nRF24L01_Sim_Add_Node(name, ROLE_PTX, RT_NULL);
+        if (rot_node[rot_node_count] == RT_NULL){
+            break;
+        }
+        rot_node_count++;
+    }
+    if (rot_hub == RT_NULL || rot_hub->rotate.groups == 0 || rot_node_count == 0 || rot_node[0]->rotate.node_id < 0){
+        printf("test_rotate: FAILED, needs a rotating hub and nodes (NRF24_USE_HUB, NRF24_ROTATE_NODES, NRF24_ROTATE_NODE_ID)\n");
+        return 1;
+    }
+    for (rt_uint8_t pipe = NRF24_PIPE_2; pipe <= NRF24_PIPE_5; pipe++){
+        nRF24L01_Hub_Set_Consumer(rot_hub, pipe, Rot_Consumer, 0);
+    }
+    rt_thread_mdelay(100);
+    printf("test_rotate: %u nodes available, %dms slot, %dms guard, one %dB packet per %ums per node, %us per run\n",
+           rot_node_count, NRF24_ROTATE_SLOT_MS, NRF24_ROTATE_GUARD_MS, ROT_TEST_LEN, period_ms, seconds);
+
+    // 2. 逐档增加节点数，每档先周期负载再饱和负载
+    printf("  nodes groups       load thru(B/s)   lost  dropped avg lat(ms) worst lat(ms)\n");
+    for (rt_uint8_t k = 0; k < sizeof(rot_counts); k++)
+    {
+        if (rot_counts[k] > rot_node_count){
+            break;
+        }
+        if (Rot_Setup(rot_counts[k]) != RT_EOK){
+            Rot_Fail("sync", rot_counts[k], 0);
+            break;
+        }
+        Rot_Run(rot_counts[k], seconds, period_ms);
+        Rot_Run(rot_counts[k], seconds, 0);
+    }
+
+    printf("test_rotate: %s\n", rot_failed ? "FAILED" : "PASSED");
+    return rot_failed ? 1 : 0;
+}